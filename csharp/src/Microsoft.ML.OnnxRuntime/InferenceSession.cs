@@ -6,6 +6,7 @@ using System.Runtime.InteropServices;
 using System.Collections.Generic;
 using System.IO;
 using System.Linq;
+using System.Threading.Tasks;
 
 
 namespace Microsoft.ML.OnnxRuntime
@@ -198,6 +199,125 @@ namespace Microsoft.ML.OnnxRuntime
 
         }
 
+        /// <summary>
+        /// Runs the loaded model for the given inputs without blocking the calling thread, and fetches all the outputs.
+        /// </summary>
+        /// <param name="inputs"></param>
+        /// <returns>A task that completes with the output Tensors in a Collection of NamedOnnxValue. User must dispose the output.</returns>
+        public Task<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>> RunAsync(IReadOnlyCollection<NamedOnnxValue> inputs)
+        {
+            string[] outputNames = new string[_outputMetadata.Count];
+            _outputMetadata.Keys.CopyTo(outputNames, 0);
+            return RunAsync(inputs, outputNames);
+        }
+
+        /// <summary>
+        /// Runs the loaded model for the given inputs without blocking the calling thread, and fetches the outputs specified in <paramref name="outputNames"/>.
+        /// </summary>
+        /// <param name="inputs"></param>
+        /// <param name="outputNames"></param>
+        /// <returns>A task that completes with the output Tensors in a Collection of NamedOnnxValue. User must dispose the output.</returns>
+        public Task<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>> RunAsync(IReadOnlyCollection<NamedOnnxValue> inputs, IReadOnlyCollection<string> outputNames)
+        {
+            return RunAsync(inputs, outputNames, _builtInRunOptions);
+        }
+
+        /// <summary>
+        /// Runs the loaded model for the given inputs without blocking the calling thread, and fetches the specified outputs in <paramref name="outputNames"/>. Uses the given RunOptions for this run.
+        /// The run executes on threads of the native session that are separate from its compute thread pools, global or not,
+        /// so the number of runs in flight isn't limited by the number of threads waiting for them.
+        /// The input buffers stay pinned, and <paramref name="options"/> must not be disposed, until the task completes.
+        /// </summary>
+        /// <param name="inputs"></param>
+        /// <param name="outputNames"></param>
+        /// <param name="options"></param>
+        /// <returns>A task that completes with the output Tensors in a Collection of NamedOnnxValue. User must dispose the output.</returns>
+        public Task<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>> RunAsync(IReadOnlyCollection<NamedOnnxValue> inputs, IReadOnlyCollection<string> outputNames, RunOptions options)
+        {
+            var inputNames = new string[inputs.Count];
+            var inputTensors = new IntPtr[inputs.Count];
+            var pinnedBufferHandles = new System.Buffers.MemoryHandle[inputs.Count];
+
+            int inputIndex = 0;
+            foreach (var input in inputs)
+            {
+                inputNames[inputIndex] = input.Name;
+
+                // create Tensor from the input if feasible, else throw notsupported exception for now
+                input.ToNativeOnnxValue(out inputTensors[inputIndex], out pinnedBufferHandles[inputIndex]);
+
+                inputIndex++;
+            }
+
+            var run = new AsyncRun(outputNames.ToArray(), pinnedBufferHandles, options);
+            var userData = GCHandle.ToIntPtr(GCHandle.Alloc(run));
+
+            IntPtr status;
+            try
+            {
+                status = NativeMethods.OrtRunAsync(
+                                                this._nativeHandle,
+                                                options.Handle,
+                                                inputNames,
+                                                inputTensors,
+                                                (UIntPtr)(inputTensors.Length),
+                                                run.OutputNames,
+                                                (UIntPtr)run.OutputNames.Length,
+                                                run.OutputValues,
+                                                _runAsyncCallback,
+                                                userData
+                                                );
+            }
+            finally
+            {
+                // the queued run keeps its own references to the native input values
+                for (int i = 0; i < inputs.Count; i++)
+                {
+                    NativeMethods.OrtReleaseValue(inputTensors[i]);
+                }
+            }
+
+            if (status != IntPtr.Zero)
+            {
+                // the run wasn't queued, so the callback won't be called
+                GCHandle.FromIntPtr(userData).Free();
+                run.ReleasePinnedMemory();
+                NativeApiStatus.VerifySuccess(status);
+            }
+
+            return run.Task;
+        }
+
+        /// <summary>
+        /// Creates an IoBinding to bind inputs and outputs of this session once and run it on them repeatedly with Run(IoBinding).
+        /// The binding must be disposed before the session.
+        /// </summary>
+        /// <returns>The binding. User must dispose it.</returns>
+        public IoBinding CreateIoBinding()
+        {
+            return new IoBinding(_nativeHandle);
+        }
+
+        /// <summary>
+        /// Runs the loaded model on the inputs bound to <paramref name="ioBinding"/>, and writes the outputs bound to it.
+        /// </summary>
+        /// <param name="ioBinding"></param>
+        public void Run(IoBinding ioBinding)
+        {
+            Run(ioBinding, _builtInRunOptions);
+        }
+
+        /// <summary>
+        /// Runs the loaded model on the inputs bound to <paramref name="ioBinding"/>, and writes the outputs bound to it. Uses the given RunOptions for this run.
+        /// Outputs bound to preallocated tensors are written into their buffers; outputs bound by name are read with IoBinding.GetOutputValues().
+        /// </summary>
+        /// <param name="ioBinding"></param>
+        /// <param name="options"></param>
+        public void Run(IoBinding ioBinding, RunOptions options)
+        {
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtRunWithBinding(_nativeHandle, options.Handle, ioBinding.Handle));
+        }
+
         //TODO: kept internal until implemented
         internal ModelMetadata ModelMetadata
         {
@@ -477,6 +597,115 @@ namespace Microsoft.ML.OnnxRuntime
 
         #endregion
 
+        #region async run
+
+        // Kept in a static field so that the delegate handed to the native library is never collected.
+        private static readonly NativeMethods.DOrtRunAsyncCallback _runAsyncCallback = OnRunAsyncCompleted;
+
+        private static void OnRunAsyncCompleted(IntPtr userData, IntPtr outputValues, UIntPtr outputCount, IntPtr status)
+        {
+            var handle = GCHandle.FromIntPtr(userData);
+            var run = (AsyncRun)handle.Target;
+            handle.Free();
+            run.Complete(status);
+        }
+
+        /// <summary>
+        /// State of a run queued by RunAsync, from the call until the native callback.
+        /// </summary>
+        private class AsyncRun
+        {
+            private readonly TaskCompletionSource<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>> _completion;
+            private readonly string[] _outputNames;
+            private readonly IntPtr[] _outputValues;
+            private GCHandle _outputValuesHandle;
+            private readonly System.Buffers.MemoryHandle[] _pinnedBufferHandles;
+            private readonly RunOptions _options;  // referenced so that the native run options outlive the run
+
+            internal AsyncRun(string[] outputNames, System.Buffers.MemoryHandle[] pinnedBufferHandles, RunOptions options)
+            {
+                _completion = new TaskCompletionSource<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>>();
+                _outputNames = outputNames;
+                _outputValues = new IntPtr[outputNames.Length];
+                _outputValuesHandle = GCHandle.Alloc(_outputValues, GCHandleType.Pinned);
+                _pinnedBufferHandles = pinnedBufferHandles;
+                _options = options;
+            }
+
+            internal string[] OutputNames
+            {
+                get { return _outputNames; }
+            }
+
+            // The native library fills this array in place, so it stays pinned until the run completes.
+            internal IntPtr OutputValues
+            {
+                get { return _outputValuesHandle.AddrOfPinnedObject(); }
+            }
+
+            internal Task<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>> Task
+            {
+                get { return _completion.Task; }
+            }
+
+            internal void ReleasePinnedMemory()
+            {
+                for (int i = 0; i < _pinnedBufferHandles.Length; i++)
+                {
+                    _pinnedBufferHandles[i].Dispose();
+                }
+                _outputValuesHandle.Free();
+            }
+
+            // Called on the native thread that ran the model. The task is completed from the .NET thread pool instead,
+            // so that continuations never run on the native thread: disposing the session from one would wait for itself.
+            internal void Complete(IntPtr status)
+            {
+                var result = new DisposableList<DisposableNamedOnnxValue>();
+                try
+                {
+                    ReleasePinnedMemory();
+
+                    if (status != IntPtr.Zero)
+                    {
+                        var exception = new OnnxRuntimeException(NativeMethods.OrtGetErrorCode(status), NativeApiStatus.GetErrorMessage(status));
+                        ReleaseOutputValues();
+                        System.Threading.Tasks.Task.Run(() => _completion.SetException(exception));
+                        return;
+                    }
+
+                    for (int i = 0; i < _outputValues.Length; i++)
+                    {
+                        result.Add(DisposableNamedOnnxValue.CreateFromOnnxValue(_outputNames[i], _outputValues[i]));
+                        _outputValues[i] = IntPtr.Zero;
+                    }
+                    System.Threading.Tasks.Task.Run(() => _completion.SetResult(result));
+                }
+                catch (Exception e)
+                {
+                    // exceptions must not propagate into the native library. the outputs wrapped already own
+                    // their native values, the others are released directly.
+                    result.Dispose();
+                    ReleaseOutputValues();
+                    System.Threading.Tasks.Task.Run(() => _completion.TrySetException(e));
+                }
+            }
+
+            private void ReleaseOutputValues()
+            {
+                for (int i = 0; i < _outputValues.Length; i++)
+                {
+                    if (_outputValues[i] != IntPtr.Zero)
+                    {
+                        NativeMethods.OrtReleaseValue(_outputValues[i]);
+                        _outputValues[i] = IntPtr.Zero;
+                    }
+                }
+            }
+        }
+
+        #endregion
+
         #region destructors disposers
 
 
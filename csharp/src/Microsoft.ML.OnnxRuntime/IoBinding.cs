@@ -0,0 +1,193 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+using System;
+using System.Buffers;
+using System.Collections.Generic;
+
+namespace Microsoft.ML.OnnxRuntime
+{
+    /// <summary>
+    /// Inputs and outputs bound once and used by every InferenceSession.Run(IoBinding) call.
+    /// Bound tensors are used by the native session in place: inputs are read from, and outputs written into, their buffers,
+    /// so repeated runs on bound tensors don't allocate any tensors.
+    /// The buffers of bound tensors stay pinned until they are unbound or the binding is disposed.
+    /// Create it with InferenceSession.CreateIoBinding(), and dispose it before the session.
+    /// </summary>
+    public class IoBinding : IDisposable
+    {
+        private IntPtr _nativeHandle;
+        private readonly Dictionary<string, MemoryHandle> _pinnedInputs = new Dictionary<string, MemoryHandle>();
+        private readonly Dictionary<string, MemoryHandle> _pinnedOutputs = new Dictionary<string, MemoryHandle>();
+        private readonly List<string> _outputNames = new List<string>();  // in the order the native binding indexes them
+
+        internal IoBinding(IntPtr sessionHandle)
+        {
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtCreateIoBinding(sessionHandle, out _nativeHandle));
+        }
+
+        internal IntPtr Handle
+        {
+            get
+            {
+                return _nativeHandle;
+            }
+        }
+
+        /// <summary>
+        /// Binds a tensor to the input of the same name, replacing any tensor bound to it before.
+        /// Runs read the tensor's buffer as it is when they start.
+        /// </summary>
+        /// <param name="input"></param>
+        public void BindInput(NamedOnnxValue input)
+        {
+            Bind(input, _pinnedInputs, (ioBinding, name, value) => NativeMethods.OrtBindInput(ioBinding, name, value));
+        }
+
+        /// <summary>
+        /// Binds a preallocated tensor to the output of the same name, replacing any tensor bound to it before.
+        /// The tensor must have the output's shape and element type. Runs write the output into its buffer.
+        /// </summary>
+        /// <param name="output"></param>
+        public void BindOutput(NamedOnnxValue output)
+        {
+            Bind(output, _pinnedOutputs, (ioBinding, name, value) => NativeMethods.OrtBindOutput(ioBinding, name, value));
+            AddOutputName(output.Name);
+        }
+
+        /// <summary>
+        /// Binds an output by name. The first run allocates it and later runs reuse it, so its shape must not change
+        /// between runs. Bind it again to have the next run allocate it anew. Read it with GetOutputValues().
+        /// </summary>
+        /// <param name="name"></param>
+        public void BindOutput(string name)
+        {
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtBindOutput(_nativeHandle, name, IntPtr.Zero));
+            Unpin(_pinnedOutputs, name);
+            AddOutputName(name);
+        }
+
+        public void ClearBoundInputs()
+        {
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtClearBoundInputs(_nativeHandle));
+            UnpinAll(_pinnedInputs);
+        }
+
+        public void ClearBoundOutputs()
+        {
+            NativeApiStatus.VerifySuccess(NativeMethods.OrtClearBoundOutputs(_nativeHandle));
+            UnpinAll(_pinnedOutputs);
+            _outputNames.Clear();
+        }
+
+        /// <summary>
+        /// Gets the bound outputs after a run, in the order they were first bound.
+        /// The values share their buffers with the binding, so the next run overwrites them.
+        /// </summary>
+        /// <returns>Output Tensors in a Collection of NamedOnnxValue. User must dispose the output.</returns>
+        public IDisposableReadOnlyCollection<DisposableNamedOnnxValue> GetOutputValues()
+        {
+            var result = new DisposableList<DisposableNamedOnnxValue>();
+            try
+            {
+                for (int i = 0; i < _outputNames.Count; i++)
+                {
+                    IntPtr value;
+                    NativeApiStatus.VerifySuccess(NativeMethods.OrtGetBoundOutputValue(_nativeHandle, (UIntPtr)i, out value));
+                    result.Add(DisposableNamedOnnxValue.CreateFromOnnxValue(_outputNames[i], value));
+                }
+            }
+            catch
+            {
+                result.Dispose();
+                throw;
+            }
+
+            return result;
+        }
+
+        private delegate IntPtr DBind(IntPtr ioBinding, string name, IntPtr value);
+
+        private void Bind(NamedOnnxValue namedValue, Dictionary<string, MemoryHandle> pinned, DBind bind)
+        {
+            IntPtr value;
+            MemoryHandle pinnedMemoryHandle;
+            namedValue.ToNativeOnnxValue(out value, out pinnedMemoryHandle);
+
+            try
+            {
+                NativeApiStatus.VerifySuccess(bind(_nativeHandle, namedValue.Name, value));
+            }
+            catch
+            {
+                pinnedMemoryHandle.Dispose();
+                throw;
+            }
+            finally
+            {
+                // the native binding keeps its own reference to the value
+                NativeMethods.OrtReleaseValue(value);
+            }
+
+            Unpin(pinned, namedValue.Name);
+            pinned[namedValue.Name] = pinnedMemoryHandle;
+        }
+
+        private void AddOutputName(string name)
+        {
+            if (!_outputNames.Contains(name))
+            {
+                _outputNames.Add(name);
+            }
+        }
+
+        private static void Unpin(Dictionary<string, MemoryHandle> pinned, string name)
+        {
+            MemoryHandle pinnedMemoryHandle;
+            if (pinned.TryGetValue(name, out pinnedMemoryHandle))
+            {
+                pinnedMemoryHandle.Dispose();
+                pinned.Remove(name);
+            }
+        }
+
+        private static void UnpinAll(Dictionary<string, MemoryHandle> pinned)
+        {
+            foreach (var pinnedMemoryHandle in pinned.Values)
+            {
+                pinnedMemoryHandle.Dispose();
+            }
+            pinned.Clear();
+        }
+
+        #region destructors disposers
+
+        ~IoBinding()
+        {
+            Dispose(false);
+        }
+
+        public void Dispose()
+        {
+            GC.SuppressFinalize(this);
+            Dispose(true);
+        }
+
+        protected virtual void Dispose(bool disposing)
+        {
+            // release the native binding before unpinning the buffers it refers to
+            if (_nativeHandle != IntPtr.Zero)
+            {
+                NativeMethods.OrtReleaseIoBinding(_nativeHandle);
+                _nativeHandle = IntPtr.Zero;
+            }
+
+            // the pins are GC handles, which the finalizer must free too or the buffers stay pinned for good.
+            // the dictionaries holding them aren't finalizable, so they're still usable here.
+            UnpinAll(_pinnedInputs);
+            UnpinAll(_pinnedOutputs);
+        }
+
+        #endregion
+    }
+}
@@ -8,7 +8,7 @@ namespace Microsoft.ML.OnnxRuntime
 {
     class NativeApiStatus
     {
-        private static string GetErrorMessage(IntPtr /*(ONNXStatus*)*/status)
+        internal static string GetErrorMessage(IntPtr /*(ONNXStatus*)*/status)
         {
             IntPtr nativeString = NativeMethods.OrtGetErrorMessage(status);
             string str = Marshal.PtrToStringAnsi(nativeString); //assumes charset = ANSI
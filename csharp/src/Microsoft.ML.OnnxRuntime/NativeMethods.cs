@@ -126,6 +126,33 @@ namespace Microsoft.ML.OnnxRuntime
         public IntPtr ReleaseTensorTypeAndShapeInfo;
         public IntPtr ReleaseSessionOptions;
         public IntPtr ReleaseCustomOpDomain;
+
+        public IntPtr CreateThreadingOptions;
+        public IntPtr SetGlobalIntraOpNumThreads;
+        public IntPtr SetGlobalInterOpNumThreads;
+        public IntPtr CreateEnvWithGlobalThreadPools;
+        public IntPtr DisablePerSessionThreads;
+        public IntPtr ReleaseThreadingOptions;
+        public IntPtr SetIntraOpThreadAffinity;
+        public IntPtr SetSessionNumaNode;
+        public IntPtr EnableExecutionFramePool;
+        public IntPtr DisableExecutionFramePool;
+        public IntPtr SetMemPatternDimBuckets;
+        public IntPtr SetMemPatternCacheCapacity;
+        public IntPtr EnableModelMmap;
+        public IntPtr DisableModelMmap;
+        public IntPtr RunAsync;
+        public IntPtr CreateIoBinding;
+        public IntPtr ReleaseIoBinding;
+        public IntPtr BindInput;
+        public IntPtr BindOutput;
+        public IntPtr ClearBoundInputs;
+        public IntPtr ClearBoundOutputs;
+        public IntPtr RunWithBinding;
+        public IntPtr GetBoundOutputCount;
+        public IntPtr GetBoundOutputValue;
+        public IntPtr EnableRunArena;
+        public IntPtr DisableRunArena;
     }
 
     internal static class NativeMethods
@@ -142,7 +169,7 @@ namespace Microsoft.ML.OnnxRuntime
             DOrtGetApi OrtGetApi = (DOrtGetApi)Marshal.GetDelegateForFunctionPointer(OrtGetApiBase().GetApi, typeof(DOrtGetApi));
 
             // TODO: Make this save the pointer, and not copy the whole structure across
-            api_ = (OrtApi)OrtGetApi(1 /*ORT_API_VERSION*/);
+            api_ = (OrtApi)OrtGetApi(2 /*ORT_API_VERSION*/);
 
             OrtCreateEnv = (DOrtCreateEnv)Marshal.GetDelegateForFunctionPointer(api_.CreateEnv, typeof(DOrtCreateEnv));
             OrtReleaseEnv = (DOrtReleaseEnv)Marshal.GetDelegateForFunctionPointer(api_.ReleaseEnv, typeof(DOrtReleaseEnv));
@@ -153,6 +180,8 @@ namespace Microsoft.ML.OnnxRuntime
             OrtCreateSession = (DOrtCreateSession)Marshal.GetDelegateForFunctionPointer(api_.CreateSession, typeof(DOrtCreateSession));
             OrtCreateSessionFromArray = (DOrtCreateSessionFromArray)Marshal.GetDelegateForFunctionPointer(api_.CreateSessionFromArray, typeof(DOrtCreateSessionFromArray));
             OrtRun = (DOrtRun)Marshal.GetDelegateForFunctionPointer(api_.Run, typeof(DOrtRun));
+            OrtRunAsync = (DOrtRunAsync)Marshal.GetDelegateForFunctionPointer(api_.RunAsync, typeof(DOrtRunAsync));
+            OrtRunWithBinding = (DOrtRunWithBinding)Marshal.GetDelegateForFunctionPointer(api_.RunWithBinding, typeof(DOrtRunWithBinding));
             OrtSessionGetInputCount = (DOrtSessionGetInputCount)Marshal.GetDelegateForFunctionPointer(api_.SessionGetInputCount, typeof(DOrtSessionGetInputCount));
             OrtSessionGetOutputCount = (DOrtSessionGetOutputCount)Marshal.GetDelegateForFunctionPointer(api_.SessionGetOutputCount, typeof(DOrtSessionGetOutputCount));
             OrtSessionGetOverridableInitializerCount = (DOrtSessionGetOverridableInitializerCount)Marshal.GetDelegateForFunctionPointer(api_.SessionGetOverridableInitializerCount, typeof(DOrtSessionGetOverridableInitializerCount));
@@ -164,6 +193,15 @@ namespace Microsoft.ML.OnnxRuntime
             OrtSessionGetOutputTypeInfo = (DOrtSessionGetOutputTypeInfo)Marshal.GetDelegateForFunctionPointer(api_.SessionGetOutputTypeInfo, typeof(DOrtSessionGetOutputTypeInfo));
             OrtSessionGetOverridableInitializerTypeInfo = (DOrtSessionGetOverridableInitializerTypeInfo)Marshal.GetDelegateForFunctionPointer(api_.SessionGetOverridableInitializerTypeInfo, typeof(DOrtSessionGetOverridableInitializerTypeInfo));
 
+            OrtCreateIoBinding = (DOrtCreateIoBinding)Marshal.GetDelegateForFunctionPointer(api_.CreateIoBinding, typeof(DOrtCreateIoBinding));
+            OrtReleaseIoBinding = (DOrtReleaseIoBinding)Marshal.GetDelegateForFunctionPointer(api_.ReleaseIoBinding, typeof(DOrtReleaseIoBinding));
+            OrtBindInput = (DOrtBindInput)Marshal.GetDelegateForFunctionPointer(api_.BindInput, typeof(DOrtBindInput));
+            OrtBindOutput = (DOrtBindOutput)Marshal.GetDelegateForFunctionPointer(api_.BindOutput, typeof(DOrtBindOutput));
+            OrtClearBoundInputs = (DOrtClearBoundInputs)Marshal.GetDelegateForFunctionPointer(api_.ClearBoundInputs, typeof(DOrtClearBoundInputs));
+            OrtClearBoundOutputs = (DOrtClearBoundOutputs)Marshal.GetDelegateForFunctionPointer(api_.ClearBoundOutputs, typeof(DOrtClearBoundOutputs));
+            OrtGetBoundOutputCount = (DOrtGetBoundOutputCount)Marshal.GetDelegateForFunctionPointer(api_.GetBoundOutputCount, typeof(DOrtGetBoundOutputCount));
+            OrtGetBoundOutputValue = (DOrtGetBoundOutputValue)Marshal.GetDelegateForFunctionPointer(api_.GetBoundOutputValue, typeof(DOrtGetBoundOutputValue));
+
             OrtReleaseTypeInfo = (DOrtReleaseTypeInfo)Marshal.GetDelegateForFunctionPointer(api_.ReleaseTypeInfo, typeof(DOrtReleaseTypeInfo));
             OrtReleaseSession = (DOrtReleaseSession)Marshal.GetDelegateForFunctionPointer(api_.ReleaseSession, typeof(DOrtReleaseSession));
 
@@ -282,6 +320,35 @@ namespace Microsoft.ML.OnnxRuntime
                                                 );
         public static DOrtRun OrtRun;
 
+        // Called on a native thread when a run queued by OrtRunAsync completes.
+        // status is owned by the native library and must not be released.
+        public delegate void DOrtRunAsyncCallback(
+                                                IntPtr /*(void*)*/ userData,
+                                                IntPtr /*(OrtValue**)*/ outputValues,
+                                                UIntPtr outputCount,
+                                                IntPtr /*(OrtStatus*)*/ status);
+
+        public delegate IntPtr /*(ONNStatus*)*/ DOrtRunAsync(
+                                                IntPtr /*(OrtSession*)*/ session,
+                                                IntPtr /*(OrtSessionRunOptions*)*/ runOptions,  // can be null to use the default options
+                                                string[] inputNames,
+                                                IntPtr[] /* (OrtValue*[])*/ inputValues,
+                                                UIntPtr inputCount,
+                                                string[] outputNames,
+                                                UIntPtr outputCount,
+                                                IntPtr /* (OrtValue*[])*/ outputValues, /* Must stay valid until the callback is called */
+                                                DOrtRunAsyncCallback callback,
+                                                IntPtr /*(void*)*/ userData
+                                                );
+        public static DOrtRunAsync OrtRunAsync;
+
+        public delegate IntPtr /*(ONNStatus*)*/ DOrtRunWithBinding(
+                                                IntPtr /*(OrtSession*)*/ session,
+                                                IntPtr /*(OrtSessionRunOptions*)*/ runOptions,  // can be null to use the default options
+                                                IntPtr /*(OrtIoBinding*)*/ ioBinding
+                                                );
+        public static DOrtRunWithBinding OrtRunWithBinding;
+
         public delegate IntPtr /*(OrtStatus*)*/ DOrtSessionGetInputCount(
                                                 IntPtr /*(OrtSession*)*/ session,
                                                 out UIntPtr count);
@@ -348,6 +415,48 @@ namespace Microsoft.ML.OnnxRuntime
 
         #endregion InferenceSession API
 
+        #region IoBinding API
+
+        public delegate IntPtr /*(OrtStatus*)*/ DOrtCreateIoBinding(
+                                                IntPtr /*(OrtSession*)*/ session,
+                                                out IntPtr /*(OrtIoBinding**)*/ ioBinding);
+        public static DOrtCreateIoBinding OrtCreateIoBinding;
+
+        public delegate void DOrtReleaseIoBinding(IntPtr /*(OrtIoBinding*)*/ ioBinding);
+        public static DOrtReleaseIoBinding OrtReleaseIoBinding;
+
+        public delegate IntPtr /*(OrtStatus*)*/ DOrtBindInput(
+                                                IntPtr /*(OrtIoBinding*)*/ ioBinding,
+                                                string name,
+                                                IntPtr /*(const OrtValue*)*/ value);
+        public static DOrtBindInput OrtBindInput;
+
+        public delegate IntPtr /*(OrtStatus*)*/ DOrtBindOutput(
+                                                IntPtr /*(OrtIoBinding*)*/ ioBinding,
+                                                string name,
+                                                IntPtr /*(const OrtValue*)*/ value);  // can be null to have the first run allocate the output
+        public static DOrtBindOutput OrtBindOutput;
+
+        public delegate IntPtr /*(OrtStatus*)*/ DOrtClearBoundInputs(IntPtr /*(OrtIoBinding*)*/ ioBinding);
+        public static DOrtClearBoundInputs OrtClearBoundInputs;
+
+        public delegate IntPtr /*(OrtStatus*)*/ DOrtClearBoundOutputs(IntPtr /*(OrtIoBinding*)*/ ioBinding);
+        public static DOrtClearBoundOutputs OrtClearBoundOutputs;
+
+        public delegate IntPtr /*(OrtStatus*)*/ DOrtGetBoundOutputCount(
+                                                IntPtr /*(const OrtIoBinding*)*/ ioBinding,
+                                                out UIntPtr count);
+        public static DOrtGetBoundOutputCount OrtGetBoundOutputCount;
+
+        // release the value using OrtReleaseValue
+        public delegate IntPtr /*(OrtStatus*)*/ DOrtGetBoundOutputValue(
+                                                IntPtr /*(const OrtIoBinding*)*/ ioBinding,
+                                                UIntPtr index,
+                                                out IntPtr /*(OrtValue**)*/ value);
+        public static DOrtGetBoundOutputValue OrtGetBoundOutputValue;
+
+        #endregion IoBinding API
+
         #region SessionOptions API
 
         public delegate IntPtr /*(OrtStatus*)*/ DOrtCreateSessionOptions(out IntPtr /*(OrtSessionOptions**)*/ sessionOptions);
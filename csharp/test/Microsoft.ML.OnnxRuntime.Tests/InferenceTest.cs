@@ -209,6 +209,89 @@ namespace Microsoft.ML.OnnxRuntime.Tests
             }
         }
 
+        [Fact]
+        private async Task CanRunInferenceOnAModelAsync()
+        {
+            string modelPath = Path.Combine(Directory.GetCurrentDirectory(), "squeezenet.onnx");
+
+            using (var session = new InferenceSession(modelPath))
+            {
+                var inputMeta = session.InputMetadata;
+                var container = new List<NamedOnnxValue>();
+
+                float[] inputData = LoadTensorFromFile(@"bench.in"); // this is the data for only one input tensor for this model
+
+                foreach (var name in inputMeta.Keys)
+                {
+                    var tensor = new DenseTensor<float>(inputData, inputMeta[name].Dimensions);
+                    container.Add(NamedOnnxValue.CreateFromTensor<float>(name, tensor));
+                }
+
+                // several runs in flight at once, none of them holding a thread while it waits
+                var runs = new List<Task<IDisposableReadOnlyCollection<DisposableNamedOnnxValue>>>();
+                for (int i = 0; i < 8; i++)
+                {
+                    runs.Add(session.RunAsync(container));
+                }
+
+                foreach (var run in runs)
+                {
+                    using (var results = await run)
+                    {
+                        validateRunResults(results);
+                    }
+                }
+
+                // errors of the run are reported through the task
+                var badInput = new List<NamedOnnxValue>();
+                badInput.Add(NamedOnnxValue.CreateFromTensor<float>(inputMeta.Keys.First(), new DenseTensor<float>(new float[] { 1.0f }, new int[] { 1 })));
+                await Assert.ThrowsAsync<OnnxRuntimeException>(() => session.RunAsync(badInput));
+            }
+        }
+
+        [Fact]
+        private void CanRunInferenceOnAModelWithIoBinding()
+        {
+            string modelPath = Path.Combine(Directory.GetCurrentDirectory(), "squeezenet.onnx");
+
+            using (var session = new InferenceSession(modelPath))
+            using (var ioBinding = session.CreateIoBinding())
+            {
+                var inputMeta = session.InputMetadata;
+                float[] inputData = LoadTensorFromFile(@"bench.in"); // this is the data for only one input tensor for this model
+                float[] expectedOutput = LoadTensorFromFile(@"bench.expected_out");
+
+                foreach (var name in inputMeta.Keys)
+                {
+                    var tensor = new DenseTensor<float>(inputData, inputMeta[name].Dimensions);
+                    ioBinding.BindInput(NamedOnnxValue.CreateFromTensor<float>(name, tensor));
+                }
+
+                // the runs write into the preallocated output in place
+                var outputData = new float[expectedOutput.Length];
+                var outputTensor = new DenseTensor<float>(outputData, new int[] { 1, 1000, 1, 1 });
+                ioBinding.BindOutput(NamedOnnxValue.CreateFromTensor<float>("softmaxout_1", outputTensor));
+
+                for (int i = 0; i < 2; i++)
+                {
+                    Array.Clear(outputData, 0, outputData.Length);
+                    session.Run(ioBinding);
+                    Assert.Equal(expectedOutput, outputData, new floatComparer());
+                }
+
+                // an output bound by name is allocated by the first run and read back from the binding
+                ioBinding.BindOutput("softmaxout_1");
+                for (int i = 0; i < 2; i++)
+                {
+                    session.Run(ioBinding);
+                    using (var results = ioBinding.GetOutputValues())
+                    {
+                        validateRunResults(results);
+                    }
+                }
+            }
+        }
+
         private void validateRunResults(IDisposableReadOnlyCollection<DisposableNamedOnnxValue> results)
         {
             float[] expectedOutput = LoadTensorFromFile(@"bench.expected_out");
@@ -4,6 +4,8 @@
 #pragma once
 
 #include <functional>
+#include <string>
+#include <unordered_map>
 
 #include "core/common/exceptions.h"
 #include "core/common/logging/logging.h"
@@ -28,6 +30,28 @@ namespace concurrency {
 class ThreadPool;
 }
 
+// The packed copies of one constant initializer. A session keeps one of these per initializer, so kernels that
+// pack the same initializer the same way share a single copy.
+class PrePackedWeights {
+ public:
+  // Returns the copy packed as 'format', calling 'pack' to create it if no kernel has asked for that format yet.
+  // Returns nullptr if 'pack' returns false because the tensor can't be packed that way.
+  const void* GetOrPack(const std::string& format, const std::function<bool(BufferUniquePtr&)>& pack) {
+    auto it = buffers_.find(format);
+    if (it == buffers_.end()) {
+      BufferUniquePtr buffer;
+      if (!pack(buffer)) {
+        buffer.reset();
+      }
+      it = buffers_.emplace(format, std::move(buffer)).first;
+    }
+    return it->second.get();
+  }
+
+ private:
+  std::unordered_map<std::string, BufferUniquePtr> buffers_;
+};
+
 class OpKernel {
  public:
   using DoneCallback = std::function<void()>;
@@ -49,6 +73,18 @@ class OpKernel {
     ORT_NOT_IMPLEMENTED(__FUNCTION__, " is not implemented");
   }
 
+  // Override this function to pre-process a constant initializer input once at session creation, e.g. to
+  // pack weights into the layout used by Compute. It is called for each input of the node that is a
+  // constant initializer, after the kernel is created and before it is first run.
+  // Packed copies should be created through prepacked_weights, which holds those of this initializer made for
+  // other kernels of the session, and which owns them.
+  // Set is_packed to true if the kernel will use a packed copy instead of the input tensor.
+  virtual Status PrePack(const Tensor& /*tensor*/, int /*input_idx*/, PrePackedWeights& /*prepacked_weights*/,
+                         bool& is_packed) {
+    is_packed = false;
+    return Status::OK();
+  }
+
   const OrtMemoryInfo& Allocator(int id, OrtMemType mem_type) const {
     return op_kernel_info_.GetMemoryInfo(id, mem_type);
   }
@@ -99,6 +99,11 @@ class Tensor final {
   */
   const OrtMemoryInfo& Location() const { return alloc_info_; }
 
+  /**
+     Returns true if the tensor owns its buffer and releases it when destroyed
+  */
+  bool OwnsBuffer() const noexcept { return buffer_deleter_ != nullptr; }
+
   /**
      May return nullptr if tensor size is zero
   */
@@ -19,6 +19,7 @@
 #include "core/graph/node_arg.h"
 #include "core/graph/onnx_protobuf.h"
 #include "core/graph/function.h"
+#include "core/session/onnxruntime_c_api.h"
 #include "gsl/gsl"
 
 namespace onnxruntime {
@@ -780,6 +781,12 @@ class Graph {
   /** Returns the Node containing the GraphProto for this Graph instance if IsSubgraph is true */
   const Node* ParentNode() const { return parent_node_; }
 
+  /** Returns the path of the file the model was loaded from, or an empty string if it wasn't loaded from a file.
+  Relative external data locations of the initializers are relative to the directory of this file. */
+  const std::basic_string<ORTCHAR_T>& ModelPath() const {
+    return parent_graph_ != nullptr ? parent_graph_->ModelPath() : model_path_;
+  }
+
   /** Returns true if the name is for a value that is coming from outer scope */
   bool IsOuterScopeValue(const std::string& name) const {
     return resolve_context_.outer_scope_node_args.find(name) != resolve_context_.outer_scope_node_args.cend();
@@ -1024,6 +1031,9 @@ class Graph {
 
   // number of times Resolve has run.
   int num_resolves_ = 0;
+
+  // file the model was loaded from. only set on the main graph.
+  std::basic_string<ORTCHAR_T> model_path_;
 };
 
 }  // namespace onnxruntime
@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 
 #pragma once
+#include <atomic>
+#include <cstddef>
 #include <string>
 #include <vector>
 #include <functional>
@@ -25,6 +27,32 @@ namespace onnxruntime {
 
 namespace concurrency {
 
+/**
+ * Placement of the worker threads of a pool.
+ */
+struct ThreadAffinity {
+  // logical processors the workers may run on. Empty means no restriction.
+  std::vector<int> processor_ids;
+
+  // if true, worker i is pinned to processor_ids[i % processor_ids.size()] alone.
+  // Otherwise every worker may run on any of processor_ids.
+  bool one_processor_per_thread = false;
+};
+
+/**
+ * Thread environment of the Eigen pool. Applies a ThreadAffinity to each worker as it starts.
+ */
+struct ThreadPoolEnvironment : Eigen::StlThreadEnvironment {
+  ThreadPoolEnvironment() = default;
+  explicit ThreadPoolEnvironment(const ThreadAffinity& affinity) : affinity_(affinity) {}
+
+  EnvThread* CreateThread(std::function<void()> f);
+
+ private:
+  ThreadAffinity affinity_;
+  size_t num_created_ = 0;
+};
+
 /**
  * Generic class for instantiating thread pools.
  * Don't put any object of this type into a global variable in a Win32 DLL.
@@ -36,6 +64,22 @@ class ThreadPool {
   */
   ThreadPool(const std::string& name, int num_threads);
 
+  /*
+  Initializes a thread pool whose workers are restricted to the given processors.
+  */
+  ThreadPool(const std::string& name, int num_threads, const ThreadAffinity& affinity);
+
+  /*
+  Creates a view onto an existing pool, typically one shared by several sessions.
+  Work issued through the view runs on the threads of shared_pool, but the view keeps at
+  most max_parallelism of its tasks queued or running there at any time. This applies to
+  every entry point: parallel loops run the blocks they get no helper for on the calling
+  thread, while Schedule() and the tasks of GetHandler() wait in the view until one of its
+  earlier tasks finishes. This stops one busy session from monopolizing the shared workers.
+  max_parallelism <= 0 means the whole shared pool. The view must not outlive shared_pool.
+  */
+  ThreadPool(ThreadPool& shared_pool, int max_parallelism);
+
   /*
   Enqueue a unit of work.
   */
@@ -43,14 +87,43 @@ class ThreadPool {
 
   /*
   Schedule work in the interval [0, total).
+  Each iteration is treated as an independent, reasonably large unit of work.
+  At most NumThreads() tasks are scheduled; they and the calling thread
+  claim iterations from a shared counter until all of them are done.
   */
   void ParallelFor(int32_t total, std::function<void(int32_t)> fn);
 
   /*
-  Schedule work in the interval [first, last].
+  Schedule work in the interval [first, last).
+  fn is invoked on disjoint sub-ranges [begin, end) that cover the interval.
   */
   void ParallelForRange(int64_t first, int64_t last, std::function<void(int64_t, int64_t)> fn);
 
+  /*
+  Cost-model driven parallel loop over [0, total).
+  cost_per_unit is the estimated number of CPU cycles needed to process one
+  iteration. The range is split into a small number of blocks per worker,
+  and idle workers (including the calling thread) steal the next unclaimed
+  block until none are left. When the total cost is too small to amortize
+  the scheduling overhead the loop runs inline on the calling thread.
+  fn is invoked on disjoint sub-ranges [first, last).
+  */
+  void ParallelFor(std::ptrdiff_t total, double cost_per_unit,
+                   const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn);
+
+  /*
+  Same as ParallelFor(total, cost_per_unit, fn), but runs the whole range
+  inline on the calling thread when tp is nullptr.
+  */
+  static void TryParallelFor(ThreadPool* tp, std::ptrdiff_t total, double cost_per_unit,
+                             const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn);
+
+  /*
+  Returns the number of blocks ParallelFor(total, cost_per_unit, fn) would
+  split the range into on a pool with num_threads workers.
+  */
+  static std::ptrdiff_t ComputeNumBlocks(std::ptrdiff_t total, double cost_per_unit, int num_threads);
+
   // This is not supported until the latest Eigen
   // void SetStealPartitions(const std::vector<std::pair<unsigned, unsigned>>& partitions);
 
@@ -58,10 +131,26 @@ class ThreadPool {
 
   int CurrentThreadId() const;
 
-  Eigen::ThreadPool& GetHandler() { return impl_; }
+  Eigen::ThreadPoolInterface& GetHandler();
 
  private:
-  Eigen::ThreadPool impl_;
+  class ViewState;
+
+  // Runs fn over [0, total) split into num_blocks contiguous blocks.
+  void RunInParallel(std::ptrdiff_t total, std::ptrdiff_t num_blocks,
+                     const std::function<void(std::ptrdiff_t first, std::ptrdiff_t last)>& fn);
+
+  using Impl = Eigen::ThreadPoolTempl<ThreadPoolEnvironment>;
+
+  std::unique_ptr<Impl> owned_impl_;
+  Impl* impl_;
+
+  // Number of workers this pool may use. Smaller than impl_->NumThreads() for a restricted view.
+  int num_threads_;
+
+  // Tasks of a view that are queued or running on the shared pool, and the ones waiting for a slot.
+  // nullptr if the pool owns its threads. Shared with the tasks, which may outlive the view.
+  std::shared_ptr<ViewState> view_state_;
 };
 
 }  // namespace concurrency
@@ -9,6 +9,25 @@
 #include "core/common/status.h"
 
 namespace onnxruntime {
+namespace concurrency {
+class ThreadPool;
+}
+
+/**
+   Sizes of the thread pools shared by all sessions that opt out of per session threads.
+   A value of 0 means ORT picks a default.
+*/
+struct ThreadingOptions {
+  // number of threads in the global pool used to parallelize the execution within nodes.
+  // 0 creates one thread per physical core.
+  int intra_op_num_threads = 0;
+
+  // number of threads in the global pool used to execute nodes in parallel.
+  // 0 means no separate pool is created and parallel executors share the intra op pool,
+  // so the total number of worker threads stays bounded by intra_op_num_threads.
+  int inter_op_num_threads = 0;
+};
+
 /**
    Provides the runtime environment for onnxruntime.
    Create one instance for the duration of execution.
@@ -17,8 +36,11 @@ class Environment {
  public:
   /**
      Create and initialize the runtime environment.
+     @param tp_options If provided, global thread pools are created with these settings and shared by
+     all sessions created with SessionOptions::use_per_session_threads set to false.
   */
-  static Status Create(std::unique_ptr<Environment>& environment);
+  static Status Create(std::unique_ptr<Environment>& environment,
+                       const ThreadingOptions* tp_options = nullptr);
 
   /**
      This function will call ::google::protobuf::ShutdownProtobufLibrary
@@ -30,12 +52,33 @@ class Environment {
   */
   static bool IsInitialized() { return is_initialized_; }
 
+  /**
+     Returns whether this environment owns global thread pools that sessions can share.
+  */
+  bool EnvCreatedWithGlobalThreadPools() const { return intra_op_thread_pool_ != nullptr; }
+
+  /**
+     Global pool for parallelism within nodes. nullptr if the environment was created without global thread pools.
+  */
+  concurrency::ThreadPool* GetIntraOpThreadPool() const { return intra_op_thread_pool_.get(); }
+
+  /**
+     Global pool for running nodes in parallel. Falls back to the intra op pool if no separate
+     inter op pool was requested. nullptr if the environment was created without global thread pools.
+  */
+  concurrency::ThreadPool* GetInterOpThreadPool() const {
+    return inter_op_thread_pool_ ? inter_op_thread_pool_.get() : intra_op_thread_pool_.get();
+  }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(Environment);
 
-  Environment() = default;
-  Status Initialize();
+  Environment();
+  Status Initialize(const ThreadingOptions* tp_options);
 
   static std::atomic<bool> is_initialized_;
+
+  std::unique_ptr<concurrency::ThreadPool> intra_op_thread_pool_;
+  std::unique_ptr<concurrency::ThreadPool> inter_op_thread_pool_;
 };
 }  // namespace onnxruntime
@@ -7,7 +7,7 @@
 #include <string.h>
 
 // This value is used in structures passed to ORT so that a newer version of ORT will still work with
-#define ORT_API_VERSION 1
+#define ORT_API_VERSION 2
 
 #ifdef __cplusplus
 extern "C" {
@@ -156,6 +156,8 @@ ORT_RUNTIME_CLASS(TypeInfo);
 ORT_RUNTIME_CLASS(TensorTypeAndShapeInfo);
 ORT_RUNTIME_CLASS(SessionOptions);
 ORT_RUNTIME_CLASS(CustomOpDomain);
+ORT_RUNTIME_CLASS(ThreadingOptions);
+ORT_RUNTIME_CLASS(IoBinding);
 
 // When passing in an allocator to any ORT function, be sure that the allocator object
 // is not destroyed until the last allocated object using it is freed.
@@ -170,6 +172,11 @@ typedef void(ORT_API_CALL* OrtLoggingFunction)(
     void* param, OrtLoggingLevel severity, const char* category, const char* logid, const char* code_location,
     const char* message);
 
+// Called when a run queued by RunAsync completes. outputs is the output array given to RunAsync and holds the outputs
+// of the run if status is nullptr. status is owned by onnxruntime and is only valid for the duration of the call.
+typedef void(ORT_API_CALL* RunAsyncCallbackFn)(_In_ void* user_data, _Inout_ OrtValue** outputs, size_t num_outputs,
+                                               _In_opt_ OrtStatus* status);
+
 // Set Graph optimization level.
 // Refer https://github.com/microsoft/onnxruntime/blob/master/docs/ONNX_Runtime_Graph_Optimizations.md
 // for in-depth undersrtanding of Graph Optimizations in ORT
@@ -643,6 +650,124 @@ struct OrtApi {
   ORT_CLASS_RELEASE(TensorTypeAndShapeInfo);
   ORT_CLASS_RELEASE(SessionOptions);
   ORT_CLASS_RELEASE(CustomOpDomain);
+
+  // End of version 1. Functions below were added in version 2; entries must only ever be appended.
+
+  /**
+   * Options for the global thread pools created by CreateEnvWithGlobalThreadPools.
+   * \param out Should be freed by `OrtReleaseThreadingOptions` after use
+   */
+  OrtStatus*(ORT_API_CALL* CreateThreadingOptions)(_Outptr_ OrtThreadingOptions** out)NO_EXCEPTION;
+
+  // Sets the number of threads of the global pool used to parallelize the execution within nodes.
+  // A value of 0 creates one thread per physical core.
+  OrtStatus*(ORT_API_CALL* SetGlobalIntraOpNumThreads)(_Inout_ OrtThreadingOptions* tp_options, int intra_op_num_threads)NO_EXCEPTION;
+
+  // Sets the number of threads of the global pool used to execute nodes in parallel.
+  // A value of 0 makes parallel executors share the global intra op pool.
+  OrtStatus*(ORT_API_CALL* SetGlobalInterOpNumThreads)(_Inout_ OrtThreadingOptions* tp_options, int inter_op_num_threads)NO_EXCEPTION;
+
+  /**
+   * Creates an environment that owns thread pools shared by all sessions created with per session threads disabled.
+   * \param out Should be freed by `OrtReleaseEnv` after use
+   */
+  OrtStatus*(ORT_API_CALL* CreateEnvWithGlobalThreadPools)(OrtLoggingLevel default_logging_level, _In_ const char* logid,
+                                                           _In_ const OrtThreadingOptions* tp_options, _Outptr_ OrtEnv** out)
+      NO_EXCEPTION ORT_ALL_ARGS_NONNULL;
+
+  // Makes the session use the global thread pools of its environment instead of creating its own.
+  // The values given to SetIntraOpNumThreads/SetInterOpNumThreads then cap how many of the shared
+  // workers the session may occupy at once (0 = no cap).
+  OrtStatus*(ORT_API_CALL* DisablePerSessionThreads)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+
+  ORT_CLASS_RELEASE(ThreadingOptions);
+
+  // Pins the intra op worker threads of the session to the given logical processors, one worker per
+  // processor in round-robin order. Ignored for sessions that use the global thread pools. Creating the session
+  // fails if the intra op pool resolves to a single thread, since the calling thread then does all the work.
+  OrtStatus*(ORT_API_CALL* SetIntraOpThreadAffinity)(_Inout_ OrtSessionOptions* options,
+                                                     _In_ const int* processor_ids, size_t processor_ids_len)NO_EXCEPTION;
+
+  // Runs the session on a NUMA node: worker threads are restricted to the node's processors and the thread
+  // creating the session is moved onto the node while it initializes, so initializers are allocated in the
+  // node's local memory. Threads calling Run are not moved. A value of -1 removes the restriction.
+  OrtStatus*(ORT_API_CALL* SetSessionNumaNode)(_Inout_ OrtSessionOptions* options, int numa_node)NO_EXCEPTION;
+
+  // Reuse execution frames across Run calls with the same input shapes. Concurrent Run calls on the session each
+  // take a frame from a lock-free pool, skipping the per-run frame construction and memory pattern lookup.
+  // Pooled frames keep their memory pattern buffers, so this uses more memory. Sequential execution mode only.
+  OrtStatus*(ORT_API_CALL* EnableExecutionFramePool)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+  OrtStatus*(ORT_API_CALL* DisableExecutionFramePool)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+
+  // Rounds input dimensions up to the given bucket boundaries (ascending, positive) when looking up cached memory
+  // patterns, so that inputs with variable dimensions share one pattern per bucket. Pass 0 boundaries to key
+  // the cache on exact shapes.
+  OrtStatus*(ORT_API_CALL* SetMemPatternDimBuckets)(_Inout_ OrtSessionOptions* options, _In_ const int64_t* dim_buckets,
+                                                    size_t dim_buckets_len)NO_EXCEPTION;
+
+  // Maximum number of memory patterns cached by the session; the least recently used one is evicted when full.
+  // 0 = unbounded.
+  OrtStatus*(ORT_API_CALL* SetMemPatternCacheCapacity)(_Inout_ OrtSessionOptions* options, size_t capacity)NO_EXCEPTION;
+
+  // Memory-map the model file when the session loads a model from a path. Large initializers aren't copied: the
+  // session uses their data in place from the mapping, so the pages are shared by every session and process that
+  // loads the same file. The file must not be modified while sessions created from it are alive.
+  OrtStatus*(ORT_API_CALL* EnableModelMmap)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+  OrtStatus*(ORT_API_CALL* DisableModelMmap)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+
+  /**
+   * Queues a Run and returns without waiting for it; callback is called on a worker thread once the run completes.
+   * Runs execute on threads owned by the session, never on the intra or inter op pools (global or not), so the number
+   * of runs in flight isn't tied to the number of calling threads.
+   * run_options (if not null), the data of the input values and the output array must stay valid until callback is
+   * called. As with Run, null entries of output are allocated by the run and must be released by the caller.
+   * If this returns an error the run wasn't queued and callback isn't called.
+   * Releasing the session waits for its queued runs, so it must not be released from within callback.
+   */
+  OrtStatus*(ORT_API_CALL* RunAsync)(_Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                                     _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                                     _In_ const char* const* output_names, size_t output_names_len, _Inout_ OrtValue** output,
+                                     _In_ RunAsyncCallbackFn callback, _In_opt_ void* user_data)NO_EXCEPTION;
+
+  /**
+   * Creates a binding of inputs and outputs for repeated runs of a session with RunWithBinding. The bound values are
+   * used by every run, so runs on preallocated inputs and outputs don't allocate any tensors.
+   * \param out Should be freed by `ReleaseIoBinding` after use. Must not outlive the session.
+   */
+  OrtStatus*(ORT_API_CALL* CreateIoBinding)(_Inout_ OrtSession* session, _Outptr_ OrtIoBinding** out)NO_EXCEPTION;
+
+  ORT_CLASS_RELEASE(IoBinding);
+
+  // Binds an input by name, replacing any value bound to it before. The value is copied to the device that the session
+  // reads the input from if it isn't there already. Otherwise its data is used in place and must stay valid while bound.
+  OrtStatus*(ORT_API_CALL* BindInput)(_Inout_ OrtIoBinding* binding, _In_ const char* name, _In_ const OrtValue* val)NO_EXCEPTION;
+
+  // Binds an output by name, replacing any value bound to it before. Runs write the output into the data of val, which
+  // must have the output's shape and stay valid while bound. If val is null the first run allocates the output and
+  // later runs reuse it, so its shape must not change between runs; bind it again to have the next run allocate it anew.
+  OrtStatus*(ORT_API_CALL* BindOutput)(_Inout_ OrtIoBinding* binding, _In_ const char* name, _In_opt_ const OrtValue* val)NO_EXCEPTION;
+
+  OrtStatus*(ORT_API_CALL* ClearBoundInputs)(_Inout_ OrtIoBinding* binding)NO_EXCEPTION;
+  OrtStatus*(ORT_API_CALL* ClearBoundOutputs)(_Inout_ OrtIoBinding* binding)NO_EXCEPTION;
+
+  // Runs the session on the bound inputs, writing the bound outputs. binding must have been created for sess.
+  OrtStatus*(ORT_API_CALL* RunWithBinding)(_Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                                           _Inout_ OrtIoBinding* binding)NO_EXCEPTION;
+
+  // Number of bound outputs. Outputs are indexed in the order they were first bound.
+  OrtStatus*(ORT_API_CALL* GetBoundOutputCount)(_In_ const OrtIoBinding* binding, _Out_ size_t* out)NO_EXCEPTION;
+
+  /**
+   * Gets the value of a bound output after a run. It shares its data with the binding, so the next run overwrites it.
+   * \param out Should be freed by `ReleaseValue` after use
+   */
+  OrtStatus*(ORT_API_CALL* GetBoundOutputValue)(_In_ const OrtIoBinding* binding, size_t index, _Outptr_ OrtValue** out)NO_EXCEPTION;
+
+  // Allocate the intermediate values of each run on the CPU from a per-run arena that is reset in one step when the
+  // run ends, instead of allocating and freeing them one by one. Outputs still come from the regular allocator.
+  // Freed intermediates are only partly reused before the run ends, so this may use more memory.
+  OrtStatus*(ORT_API_CALL* EnableRunArena)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
+  OrtStatus*(ORT_API_CALL* DisableRunArena)(_Inout_ OrtSessionOptions* options)NO_EXCEPTION;
 };
 
 /*
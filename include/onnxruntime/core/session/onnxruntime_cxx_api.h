@@ -48,9 +48,11 @@ struct Exception : std::exception {
 ORT_DEFINE_RELEASE(MemoryInfo);
 ORT_DEFINE_RELEASE(CustomOpDomain);
 ORT_DEFINE_RELEASE(Env);
+ORT_DEFINE_RELEASE(IoBinding);
 ORT_DEFINE_RELEASE(RunOptions);
 ORT_DEFINE_RELEASE(Session);
 ORT_DEFINE_RELEASE(SessionOptions);
+ORT_DEFINE_RELEASE(ThreadingOptions);
 ORT_DEFINE_RELEASE(TensorTypeAndShapeInfo);
 ORT_DEFINE_RELEASE(TypeInfo);
 ORT_DEFINE_RELEASE(Value);
@@ -98,13 +100,24 @@ struct Unowned : T {
 struct AllocatorWithDefaultOptions;
 struct MemoryInfo;
 struct Env;
+struct IoBinding;
 struct TypeInfo;
 struct Value;
 
+struct ThreadingOptions : Base<OrtThreadingOptions> {
+  explicit ThreadingOptions(nullptr_t) {}
+  ThreadingOptions();
+
+  ThreadingOptions& SetGlobalIntraOpNumThreads(int intra_op_num_threads);
+  ThreadingOptions& SetGlobalInterOpNumThreads(int inter_op_num_threads);
+};
+
 struct Env : Base<OrtEnv> {
   Env(nullptr_t) {}
   Env(OrtLoggingLevel default_logging_level, _In_ const char* logid);
   Env(OrtLoggingLevel default_logging_level, const char* logid, OrtLoggingFunction logging_function, void* logger_param);
+  // Creates an environment with thread pools shared by sessions that call SessionOptions::DisablePerSessionThreads
+  Env(OrtLoggingLevel default_logging_level, const char* logid, const OrtThreadingOptions* tp_options);
   explicit Env(OrtEnv* p) : Base<OrtEnv>{p} {}
 
   static const OrtApi* s_api;
@@ -160,6 +173,22 @@ struct SessionOptions : Base<OrtSessionOptions> {
 
   SessionOptions& SetExecutionMode(ExecutionMode execution_mode);
 
+  SessionOptions& DisablePerSessionThreads();
+  SessionOptions& SetIntraOpThreadAffinity(const int* processor_ids, size_t processor_ids_len);
+  SessionOptions& SetNumaNode(int numa_node);
+
+  SessionOptions& EnableExecutionFramePool();
+  SessionOptions& DisableExecutionFramePool();
+
+  SessionOptions& EnableRunArena();
+  SessionOptions& DisableRunArena();
+
+  SessionOptions& SetMemPatternDimBuckets(const int64_t* dim_buckets, size_t dim_buckets_len);
+  SessionOptions& SetMemPatternCacheCapacity(size_t capacity);
+
+  SessionOptions& EnableModelMmap();
+  SessionOptions& DisableModelMmap();
+
   SessionOptions& SetLogId(const char* logid);
 
   SessionOptions& Add(OrtCustomOpDomain* custom_op_domain);
@@ -176,6 +205,13 @@ struct Session : Base<OrtSession> {
   // Run for when there is a list of prealloated outputs
   void Run(const RunOptions& run_options, const char* const* input_names, Value* input_values, size_t input_count,
            const char* const* output_names, Value* output_values, size_t output_count);
+  // Queues a run and returns; callback is called with output_values when it completes. run_options, the input data
+  // and output_values must stay valid until then. See OrtApi::RunAsync.
+  void RunAsync(const RunOptions& run_options, const char* const* input_names, Value* input_values, size_t input_count,
+                const char* const* output_names, Value* output_values, size_t output_count,
+                RunAsyncCallbackFn callback, void* user_data);
+  // Run on the inputs and outputs of a binding created for this session
+  void Run(const RunOptions& run_options, IoBinding& io_binding);
 
   size_t GetInputCount() const;
   size_t GetOutputCount() const;
@@ -249,6 +285,25 @@ struct Value : Base<OrtValue> {
   TensorTypeAndShapeInfo GetTensorTypeAndShapeInfo() const;
 };
 
+// Inputs and outputs bound once and used by every Session::Run(const RunOptions&, IoBinding&), so that runs on
+// preallocated values don't allocate any tensors. See OrtApi::CreateIoBinding.
+struct IoBinding : Base<OrtIoBinding> {
+  explicit IoBinding(nullptr_t) {}
+  explicit IoBinding(Session& session);
+
+  void BindInput(const char* name, const Value& value);
+  // Runs write the output into the data of value
+  void BindOutput(const char* name, const Value& value);
+  // The first run allocates the output and later runs reuse it
+  void BindOutput(const char* name);
+  void ClearBoundInputs();
+  void ClearBoundOutputs();
+
+  size_t GetOutputCount() const;
+  // Shares its data with the binding, so the next run overwrites it
+  Value GetOutputValue(size_t index) const;
+};
+
 struct AllocatorWithDefaultOptions {
   AllocatorWithDefaultOptions();
 
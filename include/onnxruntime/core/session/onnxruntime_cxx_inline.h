@@ -93,6 +93,24 @@ inline Env::Env(OrtLoggingLevel default_warning_level, const char* logid, OrtLog
   ThrowOnError(g_api->CreateEnvWithCustomLogger(logging_function, logger_param, default_warning_level, logid, &p_));
 }
 
+inline Env::Env(OrtLoggingLevel default_warning_level, const char* logid, const OrtThreadingOptions* tp_options) {
+  ThrowOnError(g_api->CreateEnvWithGlobalThreadPools(default_warning_level, logid, tp_options, &p_));
+}
+
+inline ThreadingOptions::ThreadingOptions() {
+  ThrowOnError(g_api->CreateThreadingOptions(&p_));
+}
+
+inline ThreadingOptions& ThreadingOptions::SetGlobalIntraOpNumThreads(int intra_op_num_threads) {
+  ThrowOnError(g_api->SetGlobalIntraOpNumThreads(p_, intra_op_num_threads));
+  return *this;
+}
+
+inline ThreadingOptions& ThreadingOptions::SetGlobalInterOpNumThreads(int inter_op_num_threads) {
+  ThrowOnError(g_api->SetGlobalInterOpNumThreads(p_, inter_op_num_threads));
+  return *this;
+}
+
 inline CustomOpDomain::CustomOpDomain(const char* domain) {
   ThrowOnError(g_api->CreateCustomOpDomain(domain, &p_));
 }
@@ -207,6 +225,61 @@ inline SessionOptions& SessionOptions::SetExecutionMode(ExecutionMode execution_
   return *this;
 }
 
+inline SessionOptions& SessionOptions::DisablePerSessionThreads() {
+  ThrowOnError(g_api->DisablePerSessionThreads(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetIntraOpThreadAffinity(const int* processor_ids, size_t processor_ids_len) {
+  ThrowOnError(g_api->SetIntraOpThreadAffinity(p_, processor_ids, processor_ids_len));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetNumaNode(int numa_node) {
+  ThrowOnError(g_api->SetSessionNumaNode(p_, numa_node));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableExecutionFramePool() {
+  ThrowOnError(g_api->EnableExecutionFramePool(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableExecutionFramePool() {
+  ThrowOnError(g_api->DisableExecutionFramePool(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableRunArena() {
+  ThrowOnError(g_api->EnableRunArena(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableRunArena() {
+  ThrowOnError(g_api->DisableRunArena(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetMemPatternDimBuckets(const int64_t* dim_buckets, size_t dim_buckets_len) {
+  ThrowOnError(g_api->SetMemPatternDimBuckets(p_, dim_buckets, dim_buckets_len));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::SetMemPatternCacheCapacity(size_t capacity) {
+  ThrowOnError(g_api->SetMemPatternCacheCapacity(p_, capacity));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::EnableModelMmap() {
+  ThrowOnError(g_api->EnableModelMmap(p_));
+  return *this;
+}
+
+inline SessionOptions& SessionOptions::DisableModelMmap() {
+  ThrowOnError(g_api->DisableModelMmap(p_));
+  return *this;
+}
+
 inline SessionOptions& SessionOptions::SetLogId(const char* logid) {
   ThrowOnError(g_api->SetSessionLogId(p_, logid));
   return *this;
@@ -241,6 +314,56 @@ inline void Session::Run(const RunOptions& run_options, const char* const* input
   ThrowOnError(g_api->Run(p_, run_options, input_names, ort_input_values, input_count, output_names, output_count, ort_output_values));
 }
 
+inline void Session::RunAsync(const RunOptions& run_options, const char* const* input_names, Value* input_values, size_t input_count,
+                              const char* const* output_names, Value* output_values, size_t output_count,
+                              RunAsyncCallbackFn callback, void* user_data) {
+  static_assert(sizeof(Value) == sizeof(OrtValue*), "Value is really just an array of OrtValue* in memory, so we can reinterpret_cast safely");
+  auto ort_input_values = reinterpret_cast<OrtValue**>(input_values);
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values);
+  ThrowOnError(g_api->RunAsync(p_, run_options, input_names, ort_input_values, input_count, output_names, output_count,
+                               ort_output_values, callback, user_data));
+}
+
+inline void Session::Run(const RunOptions& run_options, IoBinding& io_binding) {
+  ThrowOnError(g_api->RunWithBinding(p_, run_options, io_binding));
+}
+
+inline IoBinding::IoBinding(Session& session) {
+  ThrowOnError(g_api->CreateIoBinding(session, &p_));
+}
+
+inline void IoBinding::BindInput(const char* name, const Value& value) {
+  ThrowOnError(g_api->BindInput(p_, name, value));
+}
+
+inline void IoBinding::BindOutput(const char* name, const Value& value) {
+  ThrowOnError(g_api->BindOutput(p_, name, value));
+}
+
+inline void IoBinding::BindOutput(const char* name) {
+  ThrowOnError(g_api->BindOutput(p_, name, nullptr));
+}
+
+inline void IoBinding::ClearBoundInputs() {
+  ThrowOnError(g_api->ClearBoundInputs(p_));
+}
+
+inline void IoBinding::ClearBoundOutputs() {
+  ThrowOnError(g_api->ClearBoundOutputs(p_));
+}
+
+inline size_t IoBinding::GetOutputCount() const {
+  size_t out;
+  ThrowOnError(g_api->GetBoundOutputCount(p_, &out));
+  return out;
+}
+
+inline Value IoBinding::GetOutputValue(size_t index) const {
+  OrtValue* out;
+  ThrowOnError(g_api->GetBoundOutputValue(p_, index, &out));
+  return Value{out};
+}
+
 inline size_t Session::GetInputCount() const {
   size_t out;
   ThrowOnError(g_api->SessionGetInputCount(p_, &out));
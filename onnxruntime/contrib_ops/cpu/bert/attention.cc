@@ -0,0 +1,233 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "attention.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+#include "core/providers/cpu/math/gemm.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      Attention,                                                  \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCpuExecutionProvider,                                      \
+      KernelDefBuilder()                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      Attention<T>);
+
+REGISTER_KERNEL_TYPED(float)
+
+template <typename T>
+Attention<T>::Attention(const OpKernelInfo& info) : OpKernel(info) {
+  int64_t num_heads = 0;
+  ORT_ENFORCE(info.GetAttr("num_heads", &num_heads).IsOK() && num_heads > 0);
+  num_heads_ = static_cast<int>(num_heads);
+}
+
+template <typename T>
+Status Attention<T>::PrePack(const Tensor& tensor, int input_idx, PrePackedWeights& prepacked_weights,
+                             bool& is_packed) {
+  is_packed = false;
+
+  // only pack the weights
+  if (input_idx == 1) {
+    is_packed = GemmPackBFp32(Info(), tensor, false, prepacked_weights, packed_weights_);
+  }
+  return Status::OK();
+}
+
+template <typename T>
+Status Attention<T>::Compute(OpKernelContext* context) const {
+  // Input and output shapes:
+  //   Input 0 - input       : (batch_size, sequence_length, hidden_size)
+  //   Input 1 - weights     : (hidden_size, 3 * hidden_size)
+  //   Input 2 - bias        : (3 * hidden_size)
+  //   Input 3 - mask_index  : (batch_size) or (batch_size, sequence_length)
+  //   Output                : (batch_size, sequence_length, hidden_size)
+
+  const Tensor* input = context->Input<Tensor>(0);
+  const auto dims = input->Shape().GetDims();
+  if (dims.size() != 3) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 0 is expected to have 3 dimensions, got ", dims.size());
+  }
+  const int batch_size = static_cast<int>(dims[0]);
+  const int sequence_length = static_cast<int>(dims[1]);
+  const int hidden_size = static_cast<int>(dims[2]);
+  if (hidden_size % num_heads_ != 0) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 0 dimension 2 should be divisiable by value of the num_heads attribute.");
+  }
+  const int head_size = hidden_size / num_heads_;
+
+  const Tensor* weights = context->Input<Tensor>(1);
+  const auto weights_dims = weights->Shape().GetDims();
+  if (weights_dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 1 is expected to have 2 dimensions, got ", weights_dims.size());
+  }
+  if (weights_dims[0] != dims[2]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 1 dimension 0 should have same length as dimension 2 of input 0");
+  }
+  if (weights_dims[1] != 3 * weights_dims[0]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 1 dimension 1 should be 3 times of dimension 0");
+  }
+
+  const Tensor* bias = context->Input<Tensor>(2);
+  const auto bias_dims = bias->Shape().GetDims();
+  if (bias_dims.size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 2 is expected to have 1 dimension, got ", bias_dims.size());
+  }
+  if (bias_dims[0] != weights_dims[1]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 2 dimension 0 should have same length as dimension 1 of input 1");
+  }
+
+  // mask_index is either the number of unmasked tokens at the start of each sequence, or the 0/1 attention mask
+  // itself when the masked tokens may be anywhere in the sequence.
+  const Tensor* mask_index = context->Input<Tensor>(3);
+  const auto mask_dims = mask_index->Shape().GetDims();
+  if (mask_dims.size() != 1 && mask_dims.size() != 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input 3 is expected to have 1 or 2 dimensions, got ", mask_dims.size());
+  }
+  if (static_cast<int>(mask_dims[0]) != batch_size) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Inputs 3 and 0 shall have same length at dimension 0");
+  }
+  if (mask_dims.size() == 2 && static_cast<int>(mask_dims[1]) != sequence_length) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Inputs 3 and 0 shall have same length at dimension 1");
+  }
+
+  Tensor* output = context->Output(0, input->Shape());
+  if (output->Shape().Size() == 0) {
+    return Status::OK();
+  }
+
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  const size_t S = static_cast<size_t>(sequence_length);
+  const size_t H = static_cast<size_t>(hidden_size);
+  const size_t h = static_cast<size_t>(head_size);
+  const size_t num_heads = static_cast<size_t>(num_heads_);
+  const size_t qkv_ld = 3 * H;
+
+  // Project the input with one GEMM into a (batch_size * sequence_length, 3 * hidden_size) buffer, so
+  // that each row holds the Q, K and V vectors of one token. The Q, K and V matrices of a head are then
+  // read in place as strided views of this buffer, which avoids the reshape and transpose copies.
+  const size_t qkv_rows = static_cast<size_t>(batch_size) * S;
+  auto* qkv_data = static_cast<T*>(allocator->Alloc(sizeof(T) * qkv_rows * qkv_ld));
+  BufferUniquePtr qkv_buffer(qkv_data, BufferDeleter(allocator));
+
+  const T* bias_data = bias->template Data<T>();
+  for (size_t row = 0; row < qkv_rows; row++) {
+    std::copy(bias_data, bias_data + qkv_ld, qkv_data + row * qkv_ld);
+  }
+
+  if (packed_weights_) {
+    MlasGemm(CblasNoTrans, qkv_rows, qkv_ld, H, 1.0f, input->template Data<T>(), H,
+             packed_weights_, 1.0f, qkv_data, qkv_ld, tp);
+  } else {
+    MlasGemm(CblasNoTrans, CblasNoTrans, qkv_rows, qkv_ld, H, 1.0f, input->template Data<T>(), H,
+             weights->template Data<T>(), qkv_ld, 1.0f, qkv_data, qkv_ld, tp);
+  }
+
+  // Scratch space for the attention probabilities, one (sequence_length, sequence_length) block per head.
+  const size_t head_count = static_cast<size_t>(batch_size) * num_heads;
+  auto* probs_data = static_cast<T*>(allocator->Alloc(sizeof(T) * head_count * S * S));
+  BufferUniquePtr probs_buffer(probs_data, BufferDeleter(allocator));
+
+  const int32_t* mask_data = mask_index->template Data<int32_t>();
+  T* output_data = output->template MutableData<T>();
+  const float alpha = 1.0f / std::sqrt(static_cast<float>(head_size));
+
+  // A 2D mask is applied like the unfused BERT subgraph does, by adding (1 - mask) * -10000 to the scores.
+  // valid_lengths holds the length of each sequence up to its last unmasked token, and the additive mask
+  // covers the masked tokens before it.
+  std::vector<size_t> valid_lengths(static_cast<size_t>(batch_size), S);
+  std::vector<T> additive_mask;
+  if (mask_dims.size() == 1) {
+    for (size_t batch = 0; batch < valid_lengths.size(); batch++) {
+      // A sequence without unmasked tokens adds the same mask value to every score, which the softmax
+      // cancels, so like the unfused subgraph it attends to the whole sequence.
+      if (mask_data[batch] > 0) {
+        valid_lengths[batch] = static_cast<size_t>(std::min(mask_data[batch], sequence_length));
+      }
+    }
+  } else {
+    additive_mask.resize(static_cast<size_t>(batch_size) * S);
+    for (size_t i = 0; i < additive_mask.size(); i++) {
+      additive_mask[i] = static_cast<T>((1 - mask_data[i]) * -10000.0f);
+    }
+    for (size_t batch = 0; batch < valid_lengths.size(); batch++) {
+      const int32_t* mask_row = mask_data + batch * S;
+      size_t length = S;
+      while (length > 0 && mask_row[length - 1] == 0) {
+        length--;
+      }
+      if (length > 0) {
+        valid_lengths[batch] = length;
+      }
+    }
+  }
+
+  // Each head computes softmax(Q x K' / sqrt(head_size) + mask) x V independently. Tokens beyond the
+  // valid length get zero probability, so they are left out of both GEMMs and the softmax instead of
+  // being computed and then masked.
+  const double cost = static_cast<double>(S) * S * (4 * h + 16);
+  concurrency::ThreadPool::TryParallelFor(tp, static_cast<std::ptrdiff_t>(head_count), cost,
+                                          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t i = first; i < last; i++) {
+      const size_t batch = static_cast<size_t>(i) / num_heads;
+      const size_t head = static_cast<size_t>(i) % num_heads;
+
+      const T* q = qkv_data + batch * S * qkv_ld + head * h;
+      const T* k = q + H;
+      const T* v = k + H;
+      T* context_data = output_data + batch * S * H + head * h;
+      const size_t valid_length = valid_lengths[batch];
+
+      // scores: (sequence_length, valid_length), stored densely so the softmax runs over whole rows
+      T* scores = probs_data + static_cast<size_t>(i) * S * S;
+      MlasGemm(CblasNoTrans, CblasTrans, S, valid_length, h, alpha, q, qkv_ld, k, qkv_ld,
+               0.0f, scores, valid_length, nullptr);
+      if (!additive_mask.empty()) {
+        const T* mask_row = additive_mask.data() + batch * S;
+        for (size_t row = 0; row < S; row++) {
+          T* scores_row = scores + row * valid_length;
+          for (size_t col = 0; col < valid_length; col++) {
+            scores_row[col] += mask_row[col];
+          }
+        }
+      }
+      MlasComputeSoftmax(scores, scores, S, valid_length, false, nullptr);
+
+      // context: (sequence_length, head_size), written straight into the output at [batch, s, head, :]
+      MlasGemm(CblasNoTrans, CblasNoTrans, S, h, valid_length, 1.0f, scores, valid_length, v, qkv_ld,
+               0.0f, context_data, H, nullptr);
+    }
+  });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+template <typename T>
+class Attention final : public OpKernel {
+ public:
+  Attention(const OpKernelInfo& info);
+
+  Status PrePack(const Tensor& tensor, int input_idx, PrePackedWeights& prepacked_weights,
+                 bool& is_packed) override;
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  int num_heads_;  // number of attention heads
+
+  // weights pre-packed by PrePack when they are a constant initializer. Owned by the session.
+  const void* packed_weights_ = nullptr;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "skip_layer_norm.h"
+#include "contrib_ops/cpu/layer_norm.h"
+#include "core/framework/tensor.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+#define REGISTER_KERNEL_TYPED(T)                                  \
+  ONNX_OPERATOR_TYPED_KERNEL_EX(                                  \
+      SkipLayerNormalization,                                     \
+      kMSDomain,                                                  \
+      1,                                                          \
+      T,                                                          \
+      kCpuExecutionProvider,                                      \
+      KernelDefBuilder()                                          \
+          .TypeConstraint("T", DataTypeImpl::GetTensorType<T>()), \
+      SkipLayerNorm<T>);
+
+REGISTER_KERNEL_TYPED(float)
+
+template <typename T>
+SkipLayerNorm<T>::SkipLayerNorm(const OpKernelInfo& op_kernel_info) : OpKernel(op_kernel_info) {
+  epsilon_ = op_kernel_info.GetAttrOrDefault<float>("epsilon", 1e-12f);
+  ORT_ENFORCE(epsilon_ >= 0);
+}
+
+template <typename T>
+Status SkipLayerNorm<T>::Compute(OpKernelContext* ctx) const {
+  const Tensor* input = ctx->Input<Tensor>(0);
+  const Tensor* skip = ctx->Input<Tensor>(1);
+  const Tensor* gamma = ctx->Input<Tensor>(2);
+  const Tensor* beta = ctx->Input<Tensor>(3);
+  Tensor* output = ctx->Output(0, input->Shape());
+
+  const auto input_dims = input->Shape().GetDims();
+  if (input_dims.size() != 3) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "input is expected to have 3 dimensions, got ", input_dims.size());
+  }
+
+  if (input->Shape() != skip->Shape()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "skip is expected to have same shape as input");
+  }
+
+  const auto gamma_dims = gamma->Shape().GetDims();
+  if (gamma_dims.size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "gamma is expected to have 1 dimension, got ", gamma_dims.size());
+  }
+  if (gamma_dims[0] != input_dims[2]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Last dimension of gamma and input does not match");
+  }
+
+  const auto beta_dims = beta->Shape().GetDims();
+  if (beta_dims.size() != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "beta is expected to have 1 dimension, got ", beta_dims.size());
+  }
+  if (beta_dims[0] != input_dims[2]) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Last dimension of beta and input does not match");
+  }
+
+  const int64_t hidden_size = input_dims[2];
+  const int64_t row_count = input_dims[0] * input_dims[1];
+
+  const T* input_data = input->template Data<T>();
+  const T* skip_data = skip->template Data<T>();
+  const T* gamma_data = gamma->template Data<T>();
+  const T* beta_data = beta->template Data<T>();
+  T* output_data = output->template MutableData<T>();
+
+  // The residual add and the normalization of a row are done in one pass over it.
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), row_count, static_cast<double>(hidden_size) * 10,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          T mean, inv_std_var;
+          ComputeLayerNormRow<T>(input_data + i * hidden_size, skip_data + i * hidden_size, gamma_data, beta_data,
+                                 epsilon_, hidden_size, output_data + i * hidden_size, mean, inv_std_var);
+        }
+      });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -6,6 +6,7 @@
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/tensor.h"
+#include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -21,5 +22,24 @@ class LayerNorm final : public OpKernel {
   float epsilon_;
 };
 
+// Normalizes one row of n elements as y = (x - mean) / sqrt(var + epsilon) * scale + bias, where x is the
+// input, plus skip when it is not null. The sum of input and skip is staged in output, so both are read
+// once. The expressions are evaluated with vectorized Eigen array maps.
+template <typename T>
+void ComputeLayerNormRow(const T* input, const T* skip, const T* scale, const T* bias, float epsilon, int64_t n,
+                         T* output, T& mean, T& inv_std_var) {
+  EigenVectorArrayMap<T> y(output, n);
+  if (skip != nullptr) {
+    y = ConstEigenVectorArrayMap<T>(input, n) + ConstEigenVectorArrayMap<T>(skip, n);
+    input = output;
+  }
+
+  ConstEigenVectorArrayMap<T> x(input, n);
+  mean = x.mean();
+  inv_std_var = T(1) / std::sqrt((x - mean).square().mean() + static_cast<T>(epsilon));
+
+  y = (x - mean) * inv_std_var * ConstEigenVectorArrayMap<T>(scale, n) + ConstEigenVectorArrayMap<T>(bias, n);
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
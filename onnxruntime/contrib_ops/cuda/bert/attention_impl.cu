@@ -115,7 +115,8 @@ __global__ void MaskedSoftmaxKernelSmall(const int sequence_length, const int* m
   __shared__ int last_valid;
 
   if (threadIdx.x == 0) {
-    last_valid = min(sequence_length, mask_index[blockIdx.y]);
+    // a sequence without unmasked tokens attends to all of them, as the unfused subgraph does
+    last_valid = mask_index[blockIdx.y] > 0 ? min(sequence_length, mask_index[blockIdx.y]) : sequence_length;
   }
   __syncthreads();
 
@@ -127,7 +128,8 @@ __global__ void MaskedSoftmaxKernel(const int sequence_length, const int* mask_i
   __shared__ int last_valid;
 
   if (threadIdx.x == 0) {
-    last_valid = min(sequence_length, mask_index[blockIdx.y]);
+    // a sequence without unmasked tokens attends to all of them, as the unfused subgraph does
+    last_valid = mask_index[blockIdx.y] > 0 ? min(sequence_length, mask_index[blockIdx.y]) : sequence_length;
   }
   __syncthreads();
 
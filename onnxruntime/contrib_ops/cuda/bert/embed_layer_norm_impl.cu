@@ -145,8 +145,8 @@ __global__ void EmbedLayerNormKernel(
     thread_data = pair_sum(thread_data, cub::KeyValuePair<T, T>(rldval, rldval * val));
   }
 
-  // 3. layer norm on the sum
-  LayerNorm<T, TPB>(thread_data, hidden_size, output_offset, beta, gamma, output);
+  // 3. layer norm on the sum. the op has no epsilon attribute and normalizes without one.
+  LayerNorm<T, TPB>(thread_data, hidden_size, output_offset, beta, gamma, T(0), output);
 }
 
 template <typename T>
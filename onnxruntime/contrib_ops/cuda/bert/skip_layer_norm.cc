@@ -30,6 +30,8 @@ using namespace ONNX_NAMESPACE;
 
 template <typename T>
 SkipLayerNorm<T>::SkipLayerNorm(const OpKernelInfo& op_kernel_info) : CudaKernel(op_kernel_info) {
+  epsilon_ = op_kernel_info.GetAttrOrDefault<float>("epsilon", 1e-12f);
+  ORT_ENFORCE(epsilon_ >= 0);
 }
 
 template <typename T>
@@ -86,7 +88,8 @@ Status SkipLayerNorm<T>::ComputeInternal(OpKernelContext* ctx) const {
           batch_size,
           hidden_size,
           element_count,
-          element_size)) {
+          element_size,
+          epsilon_)) {
     // Get last error to reset it to cudaSuccess.
     CUDA_CALL(cudaGetLastError());
     return Status(common::ONNXRUNTIME, common::FAIL);
@@ -29,7 +29,7 @@ namespace cuda {
 
 template <typename T, unsigned TPB>
 __global__ void SkipLayerNormKernelSmall(
-    const int ld, const T* input, const T* skip, const T* beta, const T* gamma, T* output) {
+    const int ld, const T* input, const T* skip, const T* beta, const T* gamma, const T epsilon, T* output) {
   const T reverse_ld = T(1) / T(ld);
   const int offset = blockIdx.x * ld;
 
@@ -45,12 +45,12 @@ __global__ void SkipLayerNormKernelSmall(
     thread_data = pair_sum(thread_data, cub::KeyValuePair<T, T>(rldval, rldval * val));
   }
 
-  LayerNormSmall<T, TPB>(val, thread_data, ld, idx, beta, gamma, output);
+  LayerNormSmall<T, TPB>(val, thread_data, ld, idx, beta, gamma, epsilon, output);
 }
 
 template <typename T, unsigned TPB>
 __global__ void SkipLayerNormKernel(
-    const int ld, const T* input, const T* skip, const T* beta, const T* gamma, T* output) {
+    const int ld, const T* input, const T* skip, const T* beta, const T* gamma, const T epsilon, T* output) {
   const T reverse_ld = T(1) / T(ld);
   const int offset = blockIdx.x * ld;
 
@@ -66,13 +66,13 @@ __global__ void SkipLayerNormKernel(
     output[idx] = val;
   }
 
-  LayerNorm<T, TPB>(thread_data, ld, offset, beta, gamma, output);
+  LayerNorm<T, TPB>(thread_data, ld, offset, beta, gamma, epsilon, output);
 }
 
 template <typename T>
 bool ComputeSkipLayerNorm(
     cudaStream_t stream, const int ld, const int n, const T* input, const T* skip,
-    const T* beta, const T* gamma, T* output) {
+    const T* beta, const T* gamma, const T epsilon, T* output) {
   // this must be true because n is the total size of the tensor
   assert(n % ld == 0);
   const int grid_size = n / ld;
@@ -80,18 +80,18 @@ bool ComputeSkipLayerNorm(
   if (ld <= 32) {
     constexpr int block_size = 32;
     SkipLayerNormKernelSmall<T, block_size>
-        <<<grid_size, block_size, 0, stream>>>(ld, input, skip, beta, gamma, output);
+        <<<grid_size, block_size, 0, stream>>>(ld, input, skip, beta, gamma, epsilon, output);
   } else if (ld <= 128) {
     constexpr int block_size = 128;
     SkipLayerNormKernelSmall<T, block_size>
-        <<<grid_size, block_size, 0, stream>>>(ld, input, skip, beta, gamma, output);
+        <<<grid_size, block_size, 0, stream>>>(ld, input, skip, beta, gamma, epsilon, output);
   } else if (ld == 384) {
     constexpr int block_size = 384;
     SkipLayerNormKernelSmall<T, block_size>
-        <<<grid_size, block_size, 0, stream>>>(ld, input, skip, beta, gamma, output);
+        <<<grid_size, block_size, 0, stream>>>(ld, input, skip, beta, gamma, epsilon, output);
   } else {
     constexpr int block_size = 256;
-    SkipLayerNormKernel<T, block_size><<<grid_size, block_size, 0, stream>>>(ld, input, skip, beta, gamma, output);
+    SkipLayerNormKernel<T, block_size><<<grid_size, block_size, 0, stream>>>(ld, input, skip, beta, gamma, epsilon, output);
   }
   return CUDA_CALL(cudaPeekAtLastError());
 }
@@ -105,7 +105,8 @@ bool LaunchSkipLayerNormKernel(
     const int batch_size,
     const int hidden_size,
     const int element_count,
-    const size_t element_size) {
+    const size_t element_size,
+    const float epsilon) {
   // use default stream
   const cudaStream_t stream = nullptr;
 
@@ -114,13 +115,13 @@ bool LaunchSkipLayerNormKernel(
         stream, hidden_size, element_count,
         reinterpret_cast<const half*>(input), reinterpret_cast<const half*>(skip),
         reinterpret_cast<const half*>(beta), reinterpret_cast<const half*>(gamma),
-        reinterpret_cast<half*>(output));
+        half(epsilon), reinterpret_cast<half*>(output));
   } else {
     return ComputeSkipLayerNorm(
         stream, hidden_size, element_count,
         reinterpret_cast<const float*>(input), reinterpret_cast<const float*>(skip),
         reinterpret_cast<const float*>(beta), reinterpret_cast<const float*>(gamma),
-        reinterpret_cast<float*>(output));
+        epsilon, reinterpret_cast<float*>(output));
   }
 }
 
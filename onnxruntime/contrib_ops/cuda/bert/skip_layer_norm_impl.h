@@ -16,7 +16,8 @@ bool LaunchSkipLayerNormKernel(
     const int batch_size,      // batch size (B)
     const int hidden_size,     // hidden size, it is the leading dimension (ld)
     const int element_count,   // number of elements in input tensor
-    const size_t element_size  // element size of input tensor
+    const size_t element_size, // element size of input tensor
+    const float epsilon        // value added to the variance to avoid division by zero
 );
 
 }  // namespace cuda
@@ -3,8 +3,14 @@
 
 #include "core/platform/threadpool.h"
 #include "core/common/common.h"
+#include "core/platform/env.h"
+#include "core/platform/ort_mutex.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <deque>
+#include <memory>
 
 #if defined(__GNUC__)
 #pragma GCC diagnostic push
@@ -25,12 +31,229 @@ using Eigen::Barrier;
 namespace onnxruntime {
 
 namespace concurrency {
+
+ThreadPoolEnvironment::EnvThread* ThreadPoolEnvironment::CreateThread(std::function<void()> f) {
+  if (affinity_.processor_ids.empty()) {
+    return new EnvThread(std::move(f));
+  }
+
+  std::vector<int> processor_ids;
+  if (affinity_.one_processor_per_thread) {
+    processor_ids.push_back(affinity_.processor_ids[num_created_ % affinity_.processor_ids.size()]);
+  } else {
+    processor_ids = affinity_.processor_ids;
+  }
+  ++num_created_;
+
+  return new EnvThread([processor_ids, f]() {
+    // Pinning is best effort. The processor ids are validated when the session options are applied,
+    // and an unpinned worker is still correct, just potentially slower.
+    auto status = Env::Default().SetThreadAffinity(processor_ids);
+    ORT_UNUSED_PARAMETER(status);
+    f();
+  });
+}
+
+//
+// ThreadPool::ViewState
+//
+// Keeps the tasks a view has on the shared pool at or below max_active. Tasks that find no free
+// slot wait in pending, and each task that finishes hands its slot to the next one waiting.
+// This is also the handler the view gives to Eigen, so Eigen devices are limited the same way.
+class ThreadPool::ViewState : public Eigen::ThreadPoolInterface,
+                              public std::enable_shared_from_this<ThreadPool::ViewState> {
+ public:
+  ViewState(Impl& impl, int max_active) : impl_(impl), max_active_(max_active) {}
+
+  // Claims up to n free slots without waiting and returns how many were claimed.
+  int TryAcquire(int n) {
+    int active = active_.load(std::memory_order_relaxed);
+    int granted;
+    do {
+      granted = std::min(n, max_active_ - active);
+      if (granted <= 0)
+        return 0;
+    } while (!active_.compare_exchange_weak(active, active + granted, std::memory_order_relaxed));
+    return granted;
+  }
+
+  // Runs fn on the shared pool in a slot claimed by the caller.
+  void Submit(std::function<void()> fn) {
+    auto self = shared_from_this();
+    impl_.Schedule([self, fn]() {
+      fn();
+      self->Release();
+    });
+  }
+
+  void Schedule(std::function<void()> fn) override {
+    {
+      // Release() takes the lock before giving up a slot, so a task queued here is always picked up
+      std::lock_guard<OrtMutex> lock(mutex_);
+      if (TryAcquire(1) == 0) {
+        pending_.push_back(std::move(fn));
+        return;
+      }
+    }
+    Submit(std::move(fn));
+  }
+
+  // Eigen uses these to size per-thread state, so they describe the shared pool rather than the limit.
+  int NumThreads() const override { return impl_.NumThreads(); }
+  int CurrentThreadId() const override { return impl_.CurrentThreadId(); }
+
+ private:
+  // Passes the slot of a finished task to the next pending one, or frees it.
+  void Release() {
+    std::function<void()> next;
+    {
+      std::lock_guard<OrtMutex> lock(mutex_);
+      if (pending_.empty()) {
+        active_.fetch_sub(1, std::memory_order_relaxed);
+        return;
+      }
+      next = std::move(pending_.front());
+      pending_.pop_front();
+    }
+    Submit(std::move(next));
+  }
+
+  Impl& impl_;
+  const int max_active_;
+  std::atomic<int> active_{0};
+  OrtMutex mutex_;
+  std::deque<std::function<void()>> pending_;
+};
+
 //
 // ThreadPool
 //
-ThreadPool::ThreadPool(const std::string&, int num_threads) : impl_(num_threads) {}
+ThreadPool::ThreadPool(const std::string& name, int num_threads)
+    : ThreadPool(name, num_threads, ThreadAffinity()) {}
+
+ThreadPool::ThreadPool(const std::string&, int num_threads, const ThreadAffinity& affinity)
+    : owned_impl_(new Impl(num_threads, ThreadPoolEnvironment(affinity))),
+      impl_(owned_impl_.get()),
+      num_threads_(impl_->NumThreads()) {}
+
+ThreadPool::ThreadPool(ThreadPool& shared_pool, int max_parallelism)
+    : impl_(shared_pool.impl_),
+      num_threads_(max_parallelism <= 0 ? shared_pool.num_threads_
+                                        : std::min(max_parallelism, shared_pool.num_threads_)),
+      view_state_(std::make_shared<ViewState>(*impl_, num_threads_)) {}
+
+void ThreadPool::Schedule(std::function<void()> fn) {
+  if (view_state_) {
+    view_state_->Schedule(std::move(fn));
+  } else {
+    impl_->Schedule(std::move(fn));
+  }
+}
+
+Eigen::ThreadPoolInterface& ThreadPool::GetHandler() {
+  if (view_state_)
+    return *view_state_;
+  return *impl_;
+}
+
+namespace {
+// Estimated cost, in CPU cycles, of handing a task to the pool and waking a worker.
+// Loops whose total cost is below a few multiples of this run inline.
+constexpr double kTaskOverheadCycles = 10000;
+
+// Smallest amount of work worth putting in a separate block.
+constexpr double kMinBlockCostCycles = 4 * kTaskOverheadCycles;
+
+// Splitting into a few blocks per worker lets faster workers steal from
+// slower ones without paying per-iteration scheduling costs.
+constexpr std::ptrdiff_t kBlocksPerThread = 4;
+}  // namespace
 
-void ThreadPool::Schedule(std::function<void()> fn) { impl_.Schedule(fn); }
+std::ptrdiff_t ThreadPool::ComputeNumBlocks(std::ptrdiff_t total, double cost_per_unit, int num_threads) {
+  if (total <= 1 || num_threads <= 1)
+    return total > 0 ? 1 : 0;
+
+  const double total_cost = static_cast<double>(total) * std::max(cost_per_unit, 0.0);
+  if (total_cost < kMinBlockCostCycles)
+    return 1;
+
+  // num_threads workers plus the calling thread
+  const std::ptrdiff_t max_blocks_by_threads = (static_cast<std::ptrdiff_t>(num_threads) + 1) * kBlocksPerThread;
+  const double max_blocks_by_cost = total_cost / kMinBlockCostCycles;
+
+  std::ptrdiff_t num_blocks = std::min(total, max_blocks_by_threads);
+  if (max_blocks_by_cost < static_cast<double>(num_blocks))
+    num_blocks = std::max<std::ptrdiff_t>(1, static_cast<std::ptrdiff_t>(max_blocks_by_cost));
+  return num_blocks;
+}
+
+namespace {
+// State shared between the caller of a parallel loop and the helper tasks it schedules.
+// Helpers may start after the loop has finished (e.g. when every worker is busy), so the
+// state is reference counted and fn is only touched after successfully claiming a block.
+struct ParallelLoop {
+  ParallelLoop(std::ptrdiff_t total, std::ptrdiff_t num_blocks, std::ptrdiff_t block_size,
+               const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn)
+      : total(total),
+        num_blocks(num_blocks),
+        block_size(block_size),
+        fn(fn),
+        blocks_done(static_cast<unsigned int>(num_blocks)) {}
+
+  // Claims and runs blocks until none are left.
+  void RunBlocks() {
+    for (;;) {
+      const std::ptrdiff_t block = next_block.fetch_add(1, std::memory_order_relaxed);
+      if (block >= num_blocks)
+        break;
+      const std::ptrdiff_t first = block * block_size;
+      fn(first, std::min(total, first + block_size));
+      blocks_done.Notify();
+    }
+  }
+
+  const std::ptrdiff_t total;
+  const std::ptrdiff_t num_blocks;
+  const std::ptrdiff_t block_size;
+  const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn;
+  std::atomic<std::ptrdiff_t> next_block{0};
+  Barrier blocks_done;
+};
+}  // namespace
+
+void ThreadPool::RunInParallel(std::ptrdiff_t total, std::ptrdiff_t num_blocks,
+                               const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn) {
+  const std::ptrdiff_t block_size = (total + num_blocks - 1) / num_blocks;
+  num_blocks = (total + block_size - 1) / block_size;
+
+  if (num_blocks <= 1) {
+    fn(0, total);
+    return;
+  }
+
+  // The calling thread takes part in the loop, so at most num_blocks - 1 helpers are useful.
+  // Every participant claims the next unprocessed block until none are left, which lets idle
+  // workers steal from busy ones. The caller waits for blocks rather than helpers, so nested
+  // loops issued from pool threads cannot deadlock on helpers stuck behind them in a queue.
+  auto loop = std::make_shared<ParallelLoop>(total, num_blocks, block_size, fn);
+  int num_helpers = static_cast<int>(std::min<std::ptrdiff_t>(num_blocks - 1, NumThreads()));
+
+  if (view_state_) {
+    // A view only gets the helper slots that are free right now; anything it cannot
+    // get is made up for by the calling thread rather than waiting for a slot.
+    num_helpers = view_state_->TryAcquire(num_helpers);
+    for (int i = 0; i < num_helpers; ++i) {
+      view_state_->Submit([loop]() { loop->RunBlocks(); });
+    }
+  } else {
+    for (int i = 0; i < num_helpers; ++i) {
+      impl_->Schedule([loop]() { loop->RunBlocks(); });
+    }
+  }
+
+  loop->RunBlocks();
+  loop->blocks_done.Wait();
+}
 
 void ThreadPool::ParallelFor(int32_t total, std::function<void(int32_t)> fn) {
   if (total <= 0)
@@ -41,51 +264,58 @@ void ThreadPool::ParallelFor(int32_t total, std::function<void(int32_t)> fn) {
     return;
   }
 
-  // TODO: Eigen supports a more efficient ThreadPoolDevice mechanism
-  // We will simply rely on the work queue and stealing in the short term.
-  Barrier barrier(static_cast<unsigned int>(total - 1));
-  std::function<void(int32_t)> handle_iteration = [&barrier, &fn](int iteration) {
-    fn(iteration);
-    barrier.Notify();
-  };
-
-  for (int32_t id = 1; id < total; ++id) {
-    Schedule([=, &handle_iteration]() { handle_iteration(id); });
-  }
-
-  fn(0);
-  barrier.Wait();
+  // One iteration per block: callers such as MLAS already size each iteration
+  // to a thread's worth of work.
+  RunInParallel(total, total, [&fn](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t i = first; i < last; ++i) {
+      fn(static_cast<int32_t>(i));
+    }
+  });
 }
 
 void ThreadPool::ParallelForRange(int64_t first, int64_t last, std::function<void(int64_t, int64_t)> fn) {
   if (last <= first) return;
-  if (last - first == 1) {
+  const std::ptrdiff_t total = static_cast<std::ptrdiff_t>(last - first);
+  if (total == 1) {
     fn(first, last);
     return;
   }
 
-  // TODO: Eigen supports a more efficient ThreadPoolDevice mechanism
-  // We will simply rely on the work queue and stealing in the short term.
-  Barrier barrier(static_cast<unsigned int>(last - first));
-  std::function<void(int64_t, int64_t)> handle_range = [&barrier, &fn](int64_t first, int64_t last) {
-    fn(first, last);
-    barrier.Notify();
-  };
+  const std::ptrdiff_t num_blocks = std::min<std::ptrdiff_t>(total, (NumThreads() + 1) * kBlocksPerThread);
+  RunInParallel(total, num_blocks, [first, &fn](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    fn(first + begin, first + end);
+  });
+}
 
-  for (int64_t id = first + 1; id <= last; ++id) {
-    Schedule([=, &handle_range]() { handle_range(id, id + 1); });
+void ThreadPool::ParallelFor(std::ptrdiff_t total, double cost_per_unit,
+                             const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn) {
+  if (total <= 0)
+    return;
+
+  const std::ptrdiff_t num_blocks = ComputeNumBlocks(total, cost_per_unit, NumThreads());
+  if (num_blocks <= 1) {
+    fn(0, total);
+    return;
   }
 
-  fn(first, first + 1);
-  barrier.Wait();
+  RunInParallel(total, num_blocks, fn);
+}
+
+void ThreadPool::TryParallelFor(ThreadPool* tp, std::ptrdiff_t total, double cost_per_unit,
+                                const std::function<void(std::ptrdiff_t, std::ptrdiff_t)>& fn) {
+  if (tp != nullptr) {
+    tp->ParallelFor(total, cost_per_unit, fn);
+  } else if (total > 0) {
+    fn(0, total);
+  }
 }
 
 // void ThreadPool::SetStealPartitions(const std::vector<std::pair<unsigned, unsigned>>& partitions) {
 //   impl_->SetStealPartitions(partitions);
 // }
 
-int ThreadPool::NumThreads() const { return impl_.NumThreads(); }
+int ThreadPool::NumThreads() const { return num_threads_; }
 
-int ThreadPool::CurrentThreadId() const { return impl_.CurrentThreadId(); }
+int ThreadPool::CurrentThreadId() const { return impl_->CurrentThreadId(); }
 }  // namespace concurrency
 }  // namespace onnxruntime
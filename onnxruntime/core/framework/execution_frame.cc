@@ -11,6 +11,7 @@
 #include "core/framework/ort_value_pattern_planner.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/run_arena.h"
 #include "core/framework/session_state.h"
 #include "core/framework/utils.h"
 
@@ -98,6 +99,10 @@ Status IExecutionFrame::ReleaseMLValueImpl(int ort_value_idx) {
   return Status::OK();
 }
 
+void IExecutionFrame::ClearValues() {
+  std::fill(all_values_.begin(), all_values_.end(), OrtValue());
+}
+
 int IExecutionFrame::GetNodeIdxToMLValueIdx(int index) const {
   // the validity of index is checked by GetMLValueIndex
   int ort_value_idx = node_index_info_.GetMLValueIndex(index);
@@ -172,7 +177,6 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
     : IExecutionFrame(feed_mlvalue_idxs, feeds, session_state.GetInitializedTensors(), fetch_mlvalue_idxs, fetches,
                       session_state.GetOrtValueNameIdxMap(), session_state.GetNodeIndexInfo()),
       session_state_(session_state),
-      mem_patterns_(nullptr),
       planner_(nullptr) {
   // map the custom allocators to ort_value_idx entries
   if (!fetch_allocators.empty()) {
@@ -186,6 +190,11 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
     }
   }
 
+  RunArenaPool* run_arena_pool = session_state.GetRunArenaPool();
+  if (run_arena_pool != nullptr) {
+    run_arena_ = run_arena_pool->Acquire();
+  }
+
   // If the session enable memory pattern optimization
   // and we have execution plan generated, try to setup
   // memory pattern optimization.
@@ -206,6 +215,10 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
     //if there are some traditional ml value type in inputs disable the memory pattern optimization.
     if (all_tensors) {
       mem_patterns_ = session_state.GetMemoryPatternGroup(input_shapes);
+      // work the patterns out from the symbolic shapes of the graph if we can, rather than tracing this run
+      if (!mem_patterns_) {
+        mem_patterns_ = session_state.PlanMemoryPatternGroup(feed_mlvalue_idxs, feeds, input_shapes);
+      }
       // if no existing patterns, generate one in this executionframe
       if (!mem_patterns_) {
         planner_ = onnxruntime::make_unique<OrtValuePatternPlanner>(*session_state.GetExecutionPlan());
@@ -225,7 +238,23 @@ ExecutionFrame::ExecutionFrame(const std::vector<int>& feed_mlvalue_idxs, const
   }
 }
 
-ExecutionFrame::~ExecutionFrame() = default;
+ExecutionFrame::~ExecutionFrame() {
+  if (run_arena_) {
+    // the values must be gone before the arena is reset and handed to another run
+    ClearValues();
+    session_state_.GetRunArenaPool()->Release(std::move(run_arena_));
+  }
+}
+
+void ExecutionFrame::Reuse(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                           const std::vector<OrtValue>& fetches) {
+  ORT_ENFORCE(planner_ == nullptr && custom_allocators_.empty(), "Only frames without per-run state can be reused.");
+  if (run_arena_) {
+    // the frame's values were cleared when it went back to the pool
+    run_arena_->Reset();
+  }
+  Init(feed_mlvalue_idxs, feeds, session_state_.GetInitializedTensors(), fetches);
+}
 
 Status ExecutionFrame::AllocateMLValueTensorSelfOwnBuffer(OrtValue& ort_value, int ort_value_index,
                                                           MLDataType element_type, const OrtMemoryInfo& location,
@@ -272,15 +301,17 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
       // if block not found, fall back to default behavior
       if (block) {
         auto it = buffers_.find(location);
-        // if the block is not correct, log message then fall back to default behavior
-        if (it != buffers_.end() && block->size_ == size) {
+        // if the block is not correct, log message then fall back to default behavior.
+        // the pattern may have been traced with larger shapes from the same bucket, so any block that is
+        // large enough will do.
+        if (it != buffers_.end() && block->size_ >= size) {
           void* buffer = it->second.get();
           auto status = AllocateTensorWithPreAllocateBufferHelper(
               ort_value, static_cast<void*>(static_cast<char*>(buffer) + block->offset_), element_type, location,
               shape);
           return status;
         }
-        if (block->size_ != size) {
+        if (block->size_ < size) {
           // the block size may vary especially if the model has NonZero ops, or different sequence lengths are
           // fed in, so use VERBOSE as the log level as it's expected.
           // TODO: Should we re-use the block if the size is large enough? Would probably need to allow it
@@ -296,8 +327,14 @@ Status ExecutionFrame::AllocateMLValueTensorSelfOwnBufferHelper(OrtValue& ort_va
       }
     }
   }
-  //no memory pattern, or the pattern is not correct.
-  std::unique_ptr<Tensor> p_tensor = onnxruntime::make_unique<Tensor>(element_type, shape, alloc);
+  // no memory pattern, or the pattern is not correct.
+  // intermediate values bump through the run arena. outputs outlive the run so they use the allocator.
+  AllocatorPtr tensor_alloc = alloc;
+  if (run_arena_ && location == run_arena_->Info() && per_alloc_plan.alloc_kind != AllocKind::kAllocateOutput &&
+      !IsOutput(ort_value_index)) {
+    tensor_alloc = run_arena_;
+  }
+  std::unique_ptr<Tensor> p_tensor = onnxruntime::make_unique<Tensor>(element_type, shape, tensor_alloc);
 
   ort_value.Init(p_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
 
@@ -20,6 +20,7 @@ namespace onnxruntime {
 class SessionState;
 class OrtValueNameIdxMap;
 class OrtValuePatternPlanner;
+class RunArena;
 struct MemoryPatternGroup;
 class NodeIndexInfo;
 
@@ -58,6 +59,9 @@ class IExecutionFrame {
 
   Status ReleaseMLValue(int ort_value_idx);
 
+  // Drops every value held by the frame, so that it can be kept around and reused for another run.
+  void ClearValues();
+
  protected:
   // get the ort_value_idx from NodeIndexInfo
   int GetNodeIdxToMLValueIdx(int index) const;
@@ -69,13 +73,13 @@ class IExecutionFrame {
   // returns true if the ort_value_idx is an output from the graph
   bool IsOutput(int ort_value_idx) const;
 
- private:
-  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IExecutionFrame);
-
   void Init(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
             const std::unordered_map<int, OrtValue>& initializers,
             const std::vector<OrtValue>& fetches);
 
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(IExecutionFrame);
+
   const OrtValue& GetMLValue(int ort_value_index) const {
     ORT_ENFORCE(ort_value_index >= 0 && static_cast<size_t>(ort_value_index) < all_values_size_);
     return all_values_[ort_value_index];
@@ -107,6 +111,11 @@ class ExecutionFrame final : public IExecutionFrame {
 
   ~ExecutionFrame() override;
 
+  // Sets up a frame taken from an ExecutionFramePool for a new run. The feeds must have the shapes, and the
+  // feed and fetch indices must be the ones, the frame was built with. The memory pattern buffers are kept.
+  void Reuse(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+             const std::vector<OrtValue>& fetches);
+
   // TODO: These two AllocateMLValue... methods are in the API purely for unit test usage.
   // Fix the unit tests so they set an execution plan that results in these methods being called by
   // GetOrCreateNodeOutputMLValue instead
@@ -155,7 +164,7 @@ class ExecutionFrame final : public IExecutionFrame {
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
-  const MemoryPatternGroup* mem_patterns_;
+  std::shared_ptr<const MemoryPatternGroup> mem_patterns_;
 
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
@@ -163,5 +172,9 @@ class ExecutionFrame final : public IExecutionFrame {
 
   // Big chunks on different locations that will be used by mem_pattern.
   std::map<OrtMemoryInfo, BufferUniquePtr> buffers_;
+
+  // Arena for the intermediate values that don't get a block of the memory pattern, taken from the
+  // session's RunArenaPool. null if the session doesn't use run arenas.
+  std::shared_ptr<RunArena> run_arena_;
 };
 }  // namespace onnxruntime
@@ -0,0 +1,121 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/execution_frame_pool.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace onnxruntime {
+
+namespace {
+inline void HashCombine(int64_t value, size_t& seed) {
+  seed ^= std::hash<int64_t>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+}  // namespace
+
+ExecutionFramePool::Entry::Entry(int64_t key_in, const std::vector<int>& feed_mlvalue_idxs_in,
+                                 const std::vector<OrtValue>& feeds, const std::vector<int>& fetch_mlvalue_idxs_in,
+                                 std::unique_ptr<ExecutionFrame> frame_in)
+    : key(key_in),
+      feed_mlvalue_idxs(feed_mlvalue_idxs_in),
+      fetch_mlvalue_idxs(fetch_mlvalue_idxs_in),
+      frame(std::move(frame_in)) {
+  feed_shapes.reserve(feeds.size());
+  for (const auto& feed : feeds) {
+    feed_shapes.push_back(feed.Get<Tensor>().Shape().GetDims());
+  }
+}
+
+bool ExecutionFramePool::Entry::Matches(const std::vector<int>& feed_mlvalue_idxs_in,
+                                        const std::vector<OrtValue>& feeds,
+                                        const std::vector<int>& fetch_mlvalue_idxs_in) const {
+  if (feed_mlvalue_idxs != feed_mlvalue_idxs_in || fetch_mlvalue_idxs != fetch_mlvalue_idxs_in ||
+      feed_shapes.size() != feeds.size()) {
+    return false;
+  }
+  for (size_t i = 0; i < feeds.size(); ++i) {
+    if (!feeds[i].IsTensor() || feeds[i].Get<Tensor>().Shape().GetDims() != feed_shapes[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+ExecutionFramePool::ExecutionFramePool(size_t capacity)
+    : capacity_(std::max<size_t>(capacity, 1)),
+      slots_(new std::atomic<Entry*>[capacity_]) {
+  for (size_t i = 0; i < capacity_; ++i) {
+    slots_[i].store(nullptr, std::memory_order_relaxed);
+  }
+}
+
+ExecutionFramePool::~ExecutionFramePool() {
+  for (size_t i = 0; i < capacity_; ++i) {
+    delete slots_[i].exchange(nullptr);
+  }
+}
+
+bool ExecutionFramePool::ComputeKey(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                                    const std::vector<int>& fetch_mlvalue_idxs, int64_t& key) {
+  size_t seed = 0;
+  for (int idx : feed_mlvalue_idxs) {
+    HashCombine(idx, seed);
+  }
+  for (int idx : fetch_mlvalue_idxs) {
+    HashCombine(idx, seed);
+  }
+  for (const auto& feed : feeds) {
+    if (!feed.IsTensor()) {
+      return false;
+    }
+    const auto& dims = feed.Get<Tensor>().Shape().GetDims();
+    HashCombine(static_cast<int64_t>(dims.size()), seed);
+    for (auto dim : dims) {
+      HashCombine(dim, seed);
+    }
+  }
+
+  key = static_cast<int64_t>(seed);
+  return true;
+}
+
+std::unique_ptr<ExecutionFramePool::Entry> ExecutionFramePool::Acquire(int64_t key,
+                                                                       const std::vector<int>& feed_mlvalue_idxs,
+                                                                       const std::vector<OrtValue>& feeds,
+                                                                       const std::vector<int>& fetch_mlvalue_idxs) {
+  const size_t start = StartSlot(key);
+  for (size_t i = 0; i < capacity_; ++i) {
+    auto& slot = slots_[(start + i) % capacity_];
+    Entry* entry = slot.load(std::memory_order_acquire);
+    if (entry == nullptr || !slot.compare_exchange_strong(entry, nullptr, std::memory_order_acquire)) {
+      continue;
+    }
+
+    // The entry is ours now, so it is safe to look at it. Equal keys may still be a hash collision,
+    // so the shapes are compared too.
+    std::unique_ptr<Entry> owned(entry);
+    if (owned->key == key && owned->Matches(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs)) {
+      return owned;
+    }
+
+    // Built for other feeds. Put it back where another caller may want it.
+    Release(std::move(owned));
+  }
+
+  return nullptr;
+}
+
+void ExecutionFramePool::Release(std::unique_ptr<Entry> entry) {
+  const size_t start = StartSlot(entry->key);
+  for (size_t i = 0; i < capacity_; ++i) {
+    Entry* expected = nullptr;
+    if (slots_[(start + i) % capacity_].compare_exchange_strong(expected, entry.get(), std::memory_order_release)) {
+      entry.release();
+      return;
+    }
+  }
+  // pool is full. entry is freed on return.
+}
+
+}  // namespace onnxruntime
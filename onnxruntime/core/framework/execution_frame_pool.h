@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/execution_frame.h"
+
+namespace onnxruntime {
+
+/**
+ * Pool of ExecutionFrame instances that are reused across Run calls.
+ *
+ * A frame is keyed by its feed and fetch indices and the shapes of its feeds. The key is a hash that picks
+ * the slots to look in, and a frame is only handed out if its indices and feed shapes match exactly.
+ * A reused frame keeps the memory pattern it was built with and the buffers allocated for it, so a run with the same key skips the
+ * frame construction, the memory pattern lookup and the allocation of the pattern buffers.
+ *
+ * Acquire and Release are lock-free. Frames sit in a fixed number of slots that concurrent callers claim
+ * with a compare-and-swap. When every slot is taken, released frames are freed.
+ */
+class ExecutionFramePool {
+ public:
+  struct Entry {
+    // feeds must all be tensors, as checked by ComputeKey.
+    Entry(int64_t key_in, const std::vector<int>& feed_mlvalue_idxs_in, const std::vector<OrtValue>& feeds,
+          const std::vector<int>& fetch_mlvalue_idxs_in, std::unique_ptr<ExecutionFrame> frame_in);
+
+    // Whether the frame was built for exactly these feeds and fetches.
+    bool Matches(const std::vector<int>& feed_mlvalue_idxs_in, const std::vector<OrtValue>& feeds,
+                 const std::vector<int>& fetch_mlvalue_idxs_in) const;
+
+    const int64_t key;
+    const std::vector<int> feed_mlvalue_idxs;
+    const std::vector<int> fetch_mlvalue_idxs;
+    std::vector<std::vector<int64_t>> feed_shapes;
+    std::unique_ptr<ExecutionFrame> frame;
+  };
+
+  explicit ExecutionFramePool(size_t capacity);
+  ~ExecutionFramePool();
+
+  /**
+   * Computes the pool key for a run. Returns false if the feeds can't use a pooled frame,
+   * i.e. if any of them is not a tensor.
+   */
+  static bool ComputeKey(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                         const std::vector<int>& fetch_mlvalue_idxs, int64_t& key);
+
+  // Takes a frame built for the given feeds and fetches. Returns nullptr if there is none.
+  std::unique_ptr<Entry> Acquire(int64_t key, const std::vector<int>& feed_mlvalue_idxs,
+                                 const std::vector<OrtValue>& feeds, const std::vector<int>& fetch_mlvalue_idxs);
+
+  // Returns a frame to the pool. Its values must have been cleared. Frees the frame if the pool is full.
+  void Release(std::unique_ptr<Entry> entry);
+
+  size_t Capacity() const { return capacity_; }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ExecutionFramePool);
+
+  size_t StartSlot(int64_t key) const { return static_cast<size_t>(key) % capacity_; }
+
+  const size_t capacity_;
+  std::unique_ptr<std::atomic<Entry*>[]> slots_;
+};
+
+}  // namespace onnxruntime
@@ -0,0 +1,92 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+
+#include <algorithm>
+
+namespace onnxruntime {
+
+MemoryPatternCache::MemoryPatternCache(std::vector<int64_t> dim_buckets, size_t capacity)
+    : dim_buckets_(std::move(dim_buckets)), capacity_(capacity) {
+  ORT_ENFORCE(std::is_sorted(dim_buckets_.begin(), dim_buckets_.end()),
+              "Memory pattern dimension buckets must be in ascending order.");
+}
+
+int64_t MemoryPatternCache::BucketDim(int64_t dim) const {
+  auto it = std::lower_bound(dim_buckets_.begin(), dim_buckets_.end(), dim);
+  return it == dim_buckets_.end() ? dim : *it;
+}
+
+void MemoryPatternCache::MakeKey(const InputShapes& input_shapes, Key& key, std::vector<int64_t>& dims) const {
+  for (const auto& shape : input_shapes) {
+    const auto& input_dims = shape.get().GetDims();
+    key.push_back(static_cast<int64_t>(input_dims.size()));
+    dims.push_back(static_cast<int64_t>(input_dims.size()));
+    for (auto dim : input_dims) {
+      key.push_back(BucketDim(dim));
+      dims.push_back(dim);
+    }
+  }
+}
+
+std::shared_ptr<const MemoryPatternGroup> MemoryPatternCache::Get(const InputShapes& input_shapes) {
+  Key key;
+  std::vector<int64_t> dims;
+  MakeKey(input_shapes, key, dims);
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = index_.find(key);
+  // the ranks are at the same positions in both, so comparing them element-wise is fine
+  if (it == index_.end() ||
+      !std::equal(dims.begin(), dims.end(), it->second->traced_dims.begin(),
+                  [](int64_t dim, int64_t traced_dim) { return dim <= traced_dim; })) {
+    ++stats_.misses;
+    return nullptr;
+  }
+
+  ++stats_.hits;
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->mem_patterns;
+}
+
+void MemoryPatternCache::Put(const InputShapes& input_shapes,
+                             std::shared_ptr<const MemoryPatternGroup> mem_patterns) {
+  Key key;
+  std::vector<int64_t> dims;
+  MakeKey(input_shapes, key, dims);
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    // a pattern traced with larger shapes serves more of the bucket. keep the one we have otherwise,
+    // as frames created since this pattern was traced may already be using it.
+    auto& entry = *it->second;
+    if (std::equal(dims.begin(), dims.end(), entry.traced_dims.begin(),
+                   [](int64_t dim, int64_t traced_dim) { return dim <= traced_dim; })) {
+      return;
+    }
+    entry.traced_dims = std::move(dims);
+    entry.mem_patterns = std::move(mem_patterns);
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return;
+  }
+
+  if (capacity_ > 0 && entries_.size() >= capacity_) {
+    index_.erase(entries_.back().key);
+    entries_.pop_back();
+    ++stats_.evictions;
+  }
+
+  entries_.push_front(Entry{key, std::move(dims), std::move(mem_patterns)});
+  index_.emplace(std::move(key), entries_.begin());
+}
+
+MemoryPatternCacheStats MemoryPatternCache::GetStats() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  MemoryPatternCacheStats stats = stats_;
+  stats.size = entries_.size();
+  return stats;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,82 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/tensor_shape.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+struct MemoryPatternCacheStats {
+  uint64_t hits = 0;       // lookups served by a cached pattern
+  uint64_t misses = 0;     // lookups that had to trace a new pattern
+  uint64_t evictions = 0;  // patterns dropped to stay within the capacity
+  size_t size = 0;         // patterns currently cached
+};
+
+/**
+ * Cache of the memory patterns generated by the execution frames, keyed by the input shapes.
+ *
+ * Every input dimension is rounded up to the next bucket boundary before it is used as a key, so that
+ * inputs with variable dimensions (e.g. the sequence length) share one pattern per bucket instead of one
+ * per distinct shape. A cached pattern serves any shapes in its bucket that are no larger, dimension by
+ * dimension, than the shapes it was traced with. Larger shapes are a miss and the pattern traced for them
+ * replaces the cached one, so each bucket converges on a pattern traced at its largest shapes.
+ *
+ * The cache holds at most 'capacity' patterns and evicts the least recently used one when full.
+ * Patterns are handed out as shared pointers, so evicting a pattern doesn't affect frames still using it.
+ */
+class MemoryPatternCache {
+ public:
+  using InputShapes = std::vector<std::reference_wrapper<const TensorShape>>;
+
+  // 'dim_buckets' are the bucket boundaries in ascending order. Dimensions above the last boundary,
+  // or all dimensions if there are no boundaries, are used as they are. A capacity of 0 means unbounded.
+  MemoryPatternCache(std::vector<int64_t> dim_buckets, size_t capacity);
+
+  // Returns the dimension 'dim' is rounded up to.
+  int64_t BucketDim(int64_t dim) const;
+
+  // Returns a pattern that can serve the given shapes, or nullptr.
+  std::shared_ptr<const MemoryPatternGroup> Get(const InputShapes& input_shapes);
+
+  // Caches a pattern traced with the given shapes.
+  void Put(const InputShapes& input_shapes, std::shared_ptr<const MemoryPatternGroup> mem_patterns);
+
+  MemoryPatternCacheStats GetStats() const;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryPatternCache);
+
+  // bucketed dims of all the inputs, each input prefixed with its rank
+  using Key = std::vector<int64_t>;
+
+  struct Entry {
+    Key key;
+    // dims of all the inputs the pattern was traced with, laid out like the key
+    std::vector<int64_t> traced_dims;
+    std::shared_ptr<const MemoryPatternGroup> mem_patterns;
+  };
+
+  void MakeKey(const InputShapes& input_shapes, Key& key, std::vector<int64_t>& dims) const;
+
+  const std::vector<int64_t> dim_buckets_;
+  const size_t capacity_;
+
+  mutable OrtMutex mutex_;
+  // most recently used entry first
+  std::list<Entry> entries_;
+  std::map<Key, std::list<Entry>::iterator> index_;
+  MemoryPatternCacheStats stats_;
+};
+
+}  // namespace onnxruntime
@@ -3,6 +3,7 @@
 
 #include "core/framework/parallel_executor.h"
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
 #include <thread>
@@ -19,11 +20,55 @@
 namespace onnxruntime {
 
 ParallelExecutor::ParallelExecutor(const SessionState& session_state, const bool& terminate_flag)
-    : out_standings_(0), terminate_flag_(terminate_flag), executor_pool_(session_state.GetInterOpThreadPool()) {
+    : out_standings_(0),
+      has_errors_(false),
+      terminate_flag_(terminate_flag),
+      executor_pool_(session_state.GetInterOpThreadPool()) {
   auto graph_viewer = session_state.GetGraphViewer();
-  node_refs_.resize(graph_viewer->MaxNodeIndex());
+  node_refs_.reset(new std::atomic<size_t>[graph_viewer->MaxNodeIndex()]);
   for (auto& node : graph_viewer->Nodes()) {
-    node_refs_[node.Index()] = node.GetInputEdgesCount();
+    node_refs_[node.Index()].store(node.GetInputEdgesCount(), std::memory_order_relaxed);
+  }
+
+  ComputeNodePriorities(session_state);
+}
+
+void ParallelExecutor::ComputeNodePriorities(const SessionState& session_state) {
+  auto graph_viewer = session_state.GetGraphViewer();
+  node_priorities_.assign(graph_viewer->MaxNodeIndex(), 0.0);
+
+  const auto& order = graph_viewer->GetNodesInTopologicalOrder();
+  for (auto it = order.rbegin(); it != order.rend(); ++it) {
+    const Node* node = graph_viewer->GetNode(*it);
+    if (node == nullptr)
+      continue;
+
+    double cost = static_cast<double>(session_state.GetNodeCost(node->Index()));
+    if (cost == 0.0) {
+      // not measured yet. assume the kernel time scales with the number of output elements, at roughly
+      // a nanosecond each, and treat unknown dimensions as 1.
+      double output_elements = 0.0;
+      for (const auto* output_def : node->OutputDefs()) {
+        const auto* shape = output_def->Exists() ? output_def->Shape() : nullptr;
+        if (shape == nullptr)
+          continue;
+
+        double elements = 1.0;
+        for (const auto& dim : shape->dim()) {
+          if (dim.has_dim_value() && dim.dim_value() > 0)
+            elements *= static_cast<double>(dim.dim_value());
+        }
+        output_elements += elements;
+      }
+      cost = std::max(output_elements * 1e-3, 1.0);
+    }
+
+    double longest_successor = 0.0;
+    for (auto edge = node->OutputEdgesBegin(), end = node->OutputEdgesEnd(); edge != end; ++edge) {
+      longest_successor = std::max(longest_successor, node_priorities_[edge->GetNode().Index()]);
+    }
+
+    node_priorities_[node->Index()] = cost + longest_successor;
   }
 }
 
@@ -47,6 +92,7 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
       continue;
 
     //std::cout << "\t" << p_op_kernel->Node().Name() << std::endl;
+    ++out_standings_;
     EnqueueNode(node_index, session_state, logger);
   }
 
@@ -101,211 +147,274 @@ Status ParallelExecutor::Execute(const SessionState& session_state, const std::v
   }
 
   if (is_profiler_enabled) {
-    session_state.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "ParallelExecutor::Execute", tp);
+    const auto mem_pattern_stats = session_state.GetMemoryPatternCacheStats();
+    session_state.Profiler().EndTimeAndRecordEvent(
+        profiling::SESSION_EVENT, "ParallelExecutor::Execute", tp,
+        {{"mem_pattern_cache_hits", std::to_string(mem_pattern_stats.hits)},
+         {"mem_pattern_cache_misses", std::to_string(mem_pattern_stats.misses)},
+         {"mem_pattern_cache_evictions", std::to_string(mem_pattern_stats.evictions)},
+         {"mem_pattern_cache_size", std::to_string(mem_pattern_stats.size)}});
   }
 
   return Status::OK();
 }
 
-Status ParallelExecutor::RunNodeAsync(size_t p_node_index,
-                                      const SessionState& session_state,
-                                      const logging::Logger& logger) {
+void ParallelExecutor::RunNodeAsync(size_t p_node_index,
+                                    const SessionState& session_state,
+                                    const logging::Logger& logger) {
   LOGS(logger, INFO) << "Begin execution";
 
-  Status status = Status::OK();
-
   size_t node_index = p_node_index;
   bool keep_running = true;
   auto graph_viewer = session_state.GetGraphViewer();
-  TimePoint sync_time_begin;
-  TimePoint kernel_begin_time;
-  const bool f_profiler_enabled = session_state.Profiler().IsEnabled();
-  const SequentialExecutionPlan& exec_plan = *session_state.GetExecutionPlan();
+
+  auto create_exception_message = [&node_index, &graph_viewer](const std::exception* ex) {
+    const auto* node = graph_viewer->GetNode(node_index);
+
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exception running nodes starting at ", node->OpType(),
+                           " node '", node->Name(), "'. ",
+                           ex ? ex->what() : "Unknown exception was caught by catch-all handler.");
+  };
 
   // Avoid context switching if possible.
   while (keep_running) {
-    // TODO: Convert RunNodeAsync return Status.
-    // to also handle exception propagation
-    if (terminate_flag_) {
-      LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
-      ORT_THROW("Exiting due to terminate flag being set to true.");
-    }
-
-    const auto* p_op_kernel = session_state.GetKernel(node_index);
-    const auto& node = *graph_viewer->GetNode(node_index);
+    keep_running = false;
 
-    // if a kernel has been added in the session state, it better be NON-null.
-    if (p_op_kernel == nullptr) {
-      ORT_THROW("Got nullptr from GetKernel for node: ", node.Name());
+    // if there are errors there's no point running more nodes
+    if (has_errors_) {
+      FinishNodeRun(Status::OK());
+      break;
     }
 
-    OpKernelContextInternal op_kernel_context(session_state, *root_frame_, *p_op_kernel, logger, terminate_flag_);
+    Status status;
+    try {
+      status = RunNode(node_index, session_state, logger);
+    } catch (const std::exception& ex) {
+      status = create_exception_message(&ex);
+    } catch (...) {
+      // catch node processing failure exceptions here to prevent app crash.
+      status = create_exception_message(nullptr);
+    }
 
-    if (f_profiler_enabled) {
-      sync_time_begin = session_state.Profiler().StartTime();
+    if (!status.IsOK()) {
+      FinishNodeRun(status);
+      break;
     }
-    // sync before compute
-    int queue_id = p_op_kernel->KernelDef().ExecQueueId();
-    if (exec_plan.NodeHasFence(node_index)) {
-      for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
-        Fence_t fence = op_kernel_context.InputFence(input_index);
-        if (fence) {
-          auto execution_provider_type = node.GetExecutionProviderType();
-          if (OrtMemTypeCPUInput == p_op_kernel->KernelDef().InputMemoryType(input_index)) {
-            execution_provider_type = kCpuExecutionProvider;
-          }
-          fence->BeforeUsingAsInput(execution_provider_type, queue_id);
-        }
-      }
 
-      for (int input_index = 0; input_index < op_kernel_context.ImplicitInputCount(); ++input_index) {
-        Fence_t fence = op_kernel_context.ImplicitInputFence(input_index);
-        if (fence) {
-          auto execution_provider_type = node.GetExecutionProviderType();
-          if (OrtMemTypeCPUInput == p_op_kernel->KernelDef().InputMemoryType(input_index)) {
-            execution_provider_type = kCpuExecutionProvider;
-          }
-          fence->BeforeUsingAsInput(execution_provider_type, queue_id);
-        }
-      }
+    //std::cout << "Run async node finish: " << p_node_index << std::endl;
 
-      for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
-        Fence_t fence = op_kernel_context.OutputFence(output_index);
-        if (fence) {
-          fence->BeforeUsingAsOutput(node.GetExecutionProviderType(), queue_id);
+    // Checking which output nodes ready for running. The most critical one runs next on this thread.
+    // They are counted as outstanding before this node finishes so out_standings_ can't reach 0 early.
+    const auto& node = *graph_viewer->GetNode(node_index);
+    size_t next_node_index = 0;
+    for (auto it = node.OutputEdgesBegin(), end = node.OutputEdgesEnd(); it != end; ++it) {
+      auto idx = (*it).GetNode().Index();
+      if (node_refs_[idx].fetch_sub(1) == 1) {
+        ++out_standings_;
+        if (!keep_running) {
+          next_node_index = idx;
+          keep_running = true;
+        } else if (node_priorities_[idx] > node_priorities_[next_node_index]) {
+          EnqueueNode(next_node_index, session_state, logger);
+          next_node_index = idx;
+        } else {
+          EnqueueNode(idx, session_state, logger);
         }
       }
     }
 
-    if (f_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     node.Name() + "_fence_before",
-                                                     sync_time_begin,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}});
+    FinishNodeRun(Status::OK());
+    node_index = next_node_index;
+  }
+}
 
-      kernel_begin_time = session_state.Profiler().StartTime();
-    }
+Status ParallelExecutor::RunNode(size_t node_index,
+                                 const SessionState& session_state,
+                                 const logging::Logger& logger) {
+  if (terminate_flag_) {
+    LOGS(logger, WARNING) << "Exiting due to terminate flag being set to true.";
+    ORT_THROW("Exiting due to terminate flag being set to true.");
+  }
 
-    // call compute on the kernel
-    VLOGS(logger, 1) << "Computing kernel: " << node.Name();
+  auto graph_viewer = session_state.GetGraphViewer();
+  TimePoint sync_time_begin;
+  TimePoint kernel_begin_time;
+  const bool f_profiler_enabled = session_state.Profiler().IsEnabled();
+  const SequentialExecutionPlan& exec_plan = *session_state.GetExecutionPlan();
 
-    // Execute the kernel.
-    try {
-      status = p_op_kernel->Compute(&op_kernel_context);
-    } catch (const std::exception& ex) {
-      status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
-    }
+  const auto* p_op_kernel = session_state.GetKernel(node_index);
+  const auto& node = *graph_viewer->GetNode(node_index);
 
-    if (!status.IsOK()) {
-      std::ostringstream ss;
-      ss << "Non-zero status code returned while running " << node.OpType() << " node. Name:'" << node.Name()
-         << "' Status Message: " << status.ErrorMessage();
-      const auto msg_string = ss.str();
-      LOGS(logger, ERROR) << msg_string;
-      status = Status(status.Category(), status.Code(), msg_string);
-      break;
-    }
+  // if a kernel has been added in the session state, it better be NON-null.
+  if (p_op_kernel == nullptr) {
+    ORT_THROW("Got nullptr from GetKernel for node: ", node.Name());
+  }
 
-    if (f_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     node.Name() + "_kernel_time",
-                                                     kernel_begin_time,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}, {"provider", p_op_kernel->KernelDef().Provider()}});
+  OpKernelContextInternal op_kernel_context(session_state, *root_frame_, *p_op_kernel, logger, terminate_flag_);
 
-      sync_time_begin = session_state.Profiler().StartTime();
-    }
-    // sync after compute for outputs
-    if (exec_plan.NodeHasFence(node_index)) {
-      for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
-        Fence_t fence = op_kernel_context.InputFence(input_index);
-        if (fence) {
-          fence->AfterUsedAsInput(queue_id);
+  if (f_profiler_enabled) {
+    sync_time_begin = session_state.Profiler().StartTime();
+  }
+  // sync before compute
+  int queue_id = p_op_kernel->KernelDef().ExecQueueId();
+  if (exec_plan.NodeHasFence(node_index)) {
+    for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
+      Fence_t fence = op_kernel_context.InputFence(input_index);
+      if (fence) {
+        auto execution_provider_type = node.GetExecutionProviderType();
+        if (OrtMemTypeCPUInput == p_op_kernel->KernelDef().InputMemoryType(input_index)) {
+          execution_provider_type = kCpuExecutionProvider;
         }
+        fence->BeforeUsingAsInput(execution_provider_type, queue_id);
       }
+    }
 
-      for (int input_index = 0; input_index < op_kernel_context.ImplicitInputCount(); ++input_index) {
-        Fence_t fence = op_kernel_context.ImplicitInputFence(input_index);
-        if (fence) {
-          fence->AfterUsedAsInput(queue_id);
+    for (int input_index = 0; input_index < op_kernel_context.ImplicitInputCount(); ++input_index) {
+      Fence_t fence = op_kernel_context.ImplicitInputFence(input_index);
+      if (fence) {
+        auto execution_provider_type = node.GetExecutionProviderType();
+        if (OrtMemTypeCPUInput == p_op_kernel->KernelDef().InputMemoryType(input_index)) {
+          execution_provider_type = kCpuExecutionProvider;
         }
+        fence->BeforeUsingAsInput(execution_provider_type, queue_id);
       }
+    }
 
-      for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
-        Fence_t fence = op_kernel_context.OutputFence(output_index);
-        if (fence) {
-          fence->AfterUsedAsOutput(queue_id);
-        }
+    for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
+      Fence_t fence = op_kernel_context.OutputFence(output_index);
+      if (fence) {
+        fence->BeforeUsingAsOutput(node.GetExecutionProviderType(), queue_id);
       }
     }
+  }
 
-    if (f_profiler_enabled) {
-      session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
-                                                     node.Name() + "_fence_after",
-                                                     sync_time_begin,
-                                                     {{"op_name", p_op_kernel->KernelDef().OpName()}});
-    }
+  if (f_profiler_enabled) {
+    session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
+                                                   node.Name() + "_fence_before",
+                                                   sync_time_begin,
+                                                   {{"op_name", p_op_kernel->KernelDef().OpName()}});
 
-    //std::cout << "Run async node finish: " << p_node_index << std::endl;
+    kernel_begin_time = session_state.Profiler().StartTime();
+  }
 
-    keep_running = false;
+  // call compute on the kernel
+  VLOGS(logger, 1) << "Computing kernel: " << node.Name();
 
-    // Checking which output nodes ready for running.
-    {
-      auto begin = node.OutputEdgesBegin();
-      auto end = node.OutputEdgesEnd();
-
-      std::lock_guard<OrtMutex> lock(ref_mutex_);
-      for (auto it = begin; it != end; it++) {
-        auto idx = (*it).GetNode().Index();
-        if ((--node_refs_[idx]) == 0) {
-          if (!keep_running) {
-            node_index = idx;
-            keep_running = true;
-          } else {
-            EnqueueNode(idx, session_state, logger);
-          }
-        }
+  // Execute the kernel. When requested, or when the profiler reads the clock anyway, it's timed to refine the node
+  // priorities of later runs.
+  Status status;
+  const bool f_measure_cost = f_profiler_enabled || session_state.MeasureNodeCosts();
+  TimePoint compute_begin = kernel_begin_time;
+  if (f_measure_cost && !f_profiler_enabled) {
+    compute_begin = std::chrono::high_resolution_clock::now();
+  }
+  try {
+    status = p_op_kernel->Compute(&op_kernel_context);
+  } catch (const std::exception& ex) {
+    status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+  }
+
+  if (!status.IsOK()) {
+    std::ostringstream ss;
+    ss << "Non-zero status code returned while running " << node.OpType() << " node. Name:'" << node.Name()
+       << "' Status Message: " << status.ErrorMessage();
+    const auto msg_string = ss.str();
+    LOGS(logger, ERROR) << msg_string;
+    return Status(status.Category(), status.Code(), msg_string);
+  }
+
+  if (f_measure_cost) {
+    const auto compute_time = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::high_resolution_clock::now() - compute_begin);
+    session_state.UpdateNodeCost(node_index, compute_time.count());
+  }
+
+  if (f_profiler_enabled) {
+    session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
+                                                   node.Name() + "_kernel_time",
+                                                   kernel_begin_time,
+                                                   {{"op_name", p_op_kernel->KernelDef().OpName()}, {"provider", p_op_kernel->KernelDef().Provider()}});
+
+    sync_time_begin = session_state.Profiler().StartTime();
+  }
+  // sync after compute for outputs
+  if (exec_plan.NodeHasFence(node_index)) {
+    for (int input_index = 0; input_index < op_kernel_context.InputCount(); ++input_index) {
+      Fence_t fence = op_kernel_context.InputFence(input_index);
+      if (fence) {
+        fence->AfterUsedAsInput(queue_id);
+      }
+    }
+
+    for (int input_index = 0; input_index < op_kernel_context.ImplicitInputCount(); ++input_index) {
+      Fence_t fence = op_kernel_context.ImplicitInputFence(input_index);
+      if (fence) {
+        fence->AfterUsedAsInput(queue_id);
+      }
+    }
 
-        // std::cout << "handle output, current name: " << node.Name() << ", current index: "
-        // << p_node_index << ", output name: " << (*it)->GetNode().Name() << ", output index: "
-        // << (*it)->GetNode().Index() << ", after -- output ref: " << node_refs_[idx] << std::endl;
+    for (int output_index = 0; output_index < op_kernel_context.OutputCount(); ++output_index) {
+      Fence_t fence = op_kernel_context.OutputFence(output_index);
+      if (fence) {
+        fence->AfterUsedAsOutput(queue_id);
       }
     }
   }
 
-  return status;
+  if (f_profiler_enabled) {
+    session_state.Profiler().EndTimeAndRecordEvent(profiling::NODE_EVENT,
+                                                   node.Name() + "_fence_after",
+                                                   sync_time_begin,
+                                                   {{"op_name", p_op_kernel->KernelDef().OpName()}});
+  }
+
+  return Status::OK();
 }
 
-void ParallelExecutor::EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger) {
+void ParallelExecutor::EnqueueNode(size_t p_node_index, const SessionState& session_state,
+                                   const logging::Logger& logger) {
   {
-    std::unique_lock<OrtMutex> lock(complete_mutex_);
-    // if there are errors there's no point queuing more work
-    if (!errors_.empty())
-      return;
-
-    out_standings_++;
+    std::lock_guard<OrtMutex> lock(ready_mutex_);
+    ready_nodes_.push_back(p_node_index);
+    std::push_heap(ready_nodes_.begin(), ready_nodes_.end(), [this](size_t lhs, size_t rhs) {
+      return node_priorities_[lhs] < node_priorities_[rhs];
+    });
   }
 
-  executor_pool_->Schedule([this, p_node_index, &session_state, &logger]() {
-    auto create_exception_message = [p_node_index, &session_state](const std::exception* ex) {
-      const auto* node = session_state.GetGraphViewer()->GetNode(p_node_index);
+  executor_pool_->Schedule([this, &session_state, &logger]() {
+    RunNodeAsync(PopReadyNode(), session_state, logger);
+  });
+}
 
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exception running nodes starting at ", node->OpType(),
-                             " node '", node->Name(), "'. ",
-                             ex ? ex->what() : "Unknown exception was caught by catch-all handler.");
-    };
+size_t ParallelExecutor::PopReadyNode() {
+  std::lock_guard<OrtMutex> lock(ready_mutex_);
+  std::pop_heap(ready_nodes_.begin(), ready_nodes_.end(), [this](size_t lhs, size_t rhs) {
+    return node_priorities_[lhs] < node_priorities_[rhs];
+  });
+  size_t node_index = ready_nodes_.back();
+  ready_nodes_.pop_back();
+  return node_index;
+}
 
-    Status status;
-    try {
-      status = ParallelExecutor::RunNodeAsync(p_node_index, std::cref(session_state), std::cref(logger));
-    } catch (const std::exception& ex) {
-      status = create_exception_message(&ex);
-    } catch (...) {
-      // catch node processing failure exceptions here to prevent app crash.
-      status = create_exception_message(nullptr);
-    }
+void ParallelExecutor::FinishNodeRun(const Status& status) {
+  if (!status.IsOK()) {
+    std::lock_guard<OrtMutex> lock(complete_mutex_);
+    errors_.push_back(status);
+    has_errors_ = true;
+  }
 
-    FinishNodeRun(status);
-  });
+  // Decrement without the lock unless this is the last outstanding node. That update is made under the
+  // lock so Execute can't see out_standings_ reach 0, and return, while this thread still uses the executor.
+  int count = out_standings_.load();
+  while (count > 1 && !out_standings_.compare_exchange_weak(count, count - 1)) {
+  }
+
+  if (count == 1) {
+    std::lock_guard<OrtMutex> lock(complete_mutex_);
+    if (--out_standings_ == 0) {
+      //std::cout << "all out standing nodes are completed." << std::endl;
+      complete_cv_.notify_all();
+    }
+  }
 }
 }  // namespace onnxruntime
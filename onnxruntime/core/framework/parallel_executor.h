@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include <condition_variable>
 #include "core/common/common.h"
@@ -32,33 +33,42 @@ class ParallelExecutor : public IExecutor {
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ParallelExecutor);
 
-  Status RunNodeAsync(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger);
+  // Estimate the run time from each node to the end of the graph along its longest path, using the kernel
+  // run times measured on previous runs, or the output sizes for nodes that haven't been measured.
+  void ComputeNodePriorities(const SessionState& session_state);
 
+  // Run a node and then keep running its most critical ready successor on the same thread, queuing the
+  // other ready successors for the inter-op pool.
+  void RunNodeAsync(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger);
+
+  Status RunNode(size_t node_index, const SessionState& session_state, const logging::Logger& logger);
+
+  // Add a ready node to the queue and schedule a task on the inter-op pool to run the most critical
+  // queued node. Each task pops exactly one node, so the queue is never empty when a task starts.
   void EnqueueNode(size_t p_node_index, const SessionState& session_state, const logging::Logger& logger);
 
-  void FinishNodeRun(const Status& status) {
-    bool finished = false;
-    {
-      //Because we have a mutex here, it's not possible another thread is doing the test("while (out_standings_ > 0)"
-      std::lock_guard<OrtMutex> lock(complete_mutex_);
-      finished = --out_standings_ == 0;
-      if (!status.IsOK())
-        errors_.push_back(status);
-    }
-
-    if (finished) {
-      //std::cout << "all out standing nodes are completed." << std::endl;
-      complete_cv_.notify_all();
-    }
-  }
+  size_t PopReadyNode();
+
+  void FinishNodeRun(const Status& status);
 
   std::unique_ptr<ExecutionFrame> root_frame_;
-  std::vector<size_t> node_refs_;
-  OrtMutex ref_mutex_;
-  int out_standings_;  //protected by complete_mutex_
+
+  // number of inputs of each node that are still being produced
+  std::unique_ptr<std::atomic<size_t>[]> node_refs_;
+
+  // estimated run time in microseconds from each node to the end of the graph
+  std::vector<double> node_priorities_;
+
+  // nodes that are ready to run but haven't been picked up yet, as a heap ordered by node_priorities_
+  std::vector<size_t> ready_nodes_;
+  OrtMutex ready_mutex_;
+
+  // number of nodes that are ready or running. only the update that brings this to 0 takes complete_mutex_.
+  std::atomic<int> out_standings_;
   OrtMutex complete_mutex_;
   OrtCondVar complete_cv_;
-  std::vector<Status> errors_;
+  std::vector<Status> errors_;  // protected by complete_mutex_
+  std::atomic<bool> has_errors_;
 
   const bool& terminate_flag_;
   // TODO: Temporary threadpool for the executor.  This is a costly way to handle the problem.
@@ -5,6 +5,8 @@
 #include "core/common/status.h"
 #include "core/common/common.h"
 #include <assert.h>
+#include <cstdlib>
+#include <memory>
 #ifdef _WIN32
 
 // Desktop apps need to support back to Windows 7, so we can't use PathCch.lib as it was added in Windows 8
@@ -106,3 +108,18 @@ std::string GetLastComponent(const std::string& input) {
 }
 }  // namespace onnxruntime
 #endif
+
+namespace onnxruntime {
+common::Status GetAbsolutePath(const std::basic_string<ORTCHAR_T>& path, std::basic_string<ORTCHAR_T>& absolute_path) {
+#ifdef _WIN32
+  std::unique_ptr<wchar_t, decltype(&free)> full_path(_wfullpath(nullptr, path.c_str(), 0), free);
+#else
+  std::unique_ptr<char, decltype(&free)> full_path(realpath(path.c_str(), nullptr), free);
+#endif
+  if (full_path == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to get the absolute path of ", ToMBString(path));
+  }
+  absolute_path = full_path.get();
+  return Status::OK();
+}
+}  // namespace onnxruntime
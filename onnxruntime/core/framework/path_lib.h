@@ -83,6 +83,11 @@ namespace onnxruntime {
 common::Status GetDirNameFromFilePath(const std::basic_string<ORTCHAR_T>& s, std::basic_string<ORTCHAR_T>& output);
 std::basic_string<PATH_CHAR_TYPE> GetLastComponent(const std::basic_string<PATH_CHAR_TYPE>& s);
 
+/**
+ * Resolves a path to an absolute one. On POSIX systems the file must exist and symbolic links are resolved.
+ */
+common::Status GetAbsolutePath(const std::basic_string<ORTCHAR_T>& path, std::basic_string<ORTCHAR_T>& absolute_path);
+
 template <typename T>
 int CompareCString(const T* s1, const T* s2);
 
@@ -162,6 +167,17 @@ std::basic_string<PATH_CHAR_TYPE> ConcatPathComponent(const std::basic_string<PA
   return ret;
 }
 
+template <typename PATH_CHAR_TYPE>
+bool IsAbsolutePath(const std::basic_string<PATH_CHAR_TYPE>& s) {
+#ifdef _WIN32
+  // "\\server\share", "\dir" or "C:\dir"
+  if (!s.empty() && (s[0] == '\\' || s[0] == '/')) return true;
+  return s.size() >= 3 && s[1] == ':' && (s[2] == '\\' || s[2] == '/');
+#else
+  return !s.empty() && s[0] == '/';
+#endif
+}
+
 #ifdef _WIN32
 inline OrtFileType DTToFileType(DWORD dwFileAttributes) {
   if (dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
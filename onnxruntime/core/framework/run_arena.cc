@@ -0,0 +1,262 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/run_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace onnxruntime {
+
+constexpr size_t RunArena::kAlignment;
+constexpr size_t RunArena::kMinBlockSize;
+constexpr size_t RunArenaPool::kDefaultMaxFreeArenas;
+
+namespace {
+// The state of a block packs the offset of its next allocation in the low bits and the number of its allocations
+// that haven't been freed in the high bits, so that both change in one compare-exchange.
+constexpr int kOffsetBits = 40;
+constexpr uint64_t kOffsetMask = (uint64_t{1} << kOffsetBits) - 1;
+constexpr uint64_t kMaxLiveCount = (uint64_t{1} << (64 - kOffsetBits)) - 1;
+
+inline size_t Offset(uint64_t state) { return static_cast<size_t>(state & kOffsetMask); }
+inline uint64_t LiveCount(uint64_t state) { return state >> kOffsetBits; }
+inline uint64_t MakeState(size_t offset, uint64_t live_count) {
+  return (live_count << kOffsetBits) | static_cast<uint64_t>(offset);
+}
+}  // namespace
+
+struct RunArena::Block {
+  Block(void* data_in, size_t size_in) : data(static_cast<char*>(data_in)), size(size_in) {}
+
+  char* const data;
+  const size_t size;
+  std::atomic<uint64_t> state{0};
+  // whether the block served an allocation since the last Reset
+  std::atomic<bool> used{false};
+};
+
+namespace {
+// Written in the kAlignment bytes in front of every allocation, so Free can find its block.
+struct AllocationHeader {
+  void* block;
+  size_t size;  // including the header
+};
+static_assert(sizeof(AllocationHeader) <= RunArena::kAlignment, "the header must fit in front of the allocation");
+}  // namespace
+
+RunArena::RunArena(AllocatorPtr backing_allocator) : backing_allocator_(std::move(backing_allocator)) {
+  ORT_ENFORCE(backing_allocator_ != nullptr);
+}
+
+RunArena::~RunArena() {
+  FreeBlocks();
+}
+
+void RunArena::AddBlock(size_t size) {
+  ORT_ENFORCE(size <= kOffsetMask, "RunArena block of ", size, " bytes is too large");
+  void* data = backing_allocator_->Alloc(size);
+  if (data == nullptr) {
+    ORT_THROW("RunArena failed to allocate a block of ", size, " bytes");
+  }
+  blocks_.push_back(onnxruntime::make_unique<Block>(data, size));
+  current_.store(blocks_.back().get(), std::memory_order_release);
+}
+
+void RunArena::FreeBlocks() {
+  current_.store(nullptr, std::memory_order_relaxed);
+  for (const auto& block : blocks_) {
+    backing_allocator_->Free(block->data);
+  }
+  blocks_.clear();
+}
+
+char* RunArena::TryAlloc(Block& block, size_t size) {
+  uint64_t state = block.state.load(std::memory_order_relaxed);
+  size_t end;
+  do {
+    const size_t offset = Offset(state);
+    if (block.size - offset < size || LiveCount(state) == kMaxLiveCount) {
+      return nullptr;
+    }
+    end = offset + size;
+    // acquire, so that the memory of slices freed by other threads is reused after they are done with it
+  } while (!block.state.compare_exchange_weak(state, MakeState(end, LiveCount(state) + 1),
+                                              std::memory_order_acquire, std::memory_order_relaxed));
+
+  if (!block.used.load(std::memory_order_relaxed)) {
+    block.used.store(true, std::memory_order_relaxed);
+  }
+  return block.data + (end - size);
+}
+
+RunArena::Block* RunArena::Grow(Block* seen, size_t size) {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  Block* current = current_.load(std::memory_order_relaxed);
+  if (current != seen) {
+    return current;
+  }
+
+  // an earlier block whose slices have been freed may have room again
+  for (const auto& block : blocks_) {
+    if (block.get() != current && block->size - Offset(block->state.load(std::memory_order_relaxed)) >= size) {
+      current_.store(block.get(), std::memory_order_release);
+      return block.get();
+    }
+  }
+
+  // grow geometrically so a run that outgrows the arena only adds a few blocks
+  AddBlock(std::max({size, kMinBlockSize, current == nullptr ? size_t{0} : 2 * current->size}));
+  return blocks_.back().get();
+}
+
+void* RunArena::Alloc(size_t size) {
+  if (size == 0) {
+    return nullptr;
+  }
+
+  if (size > std::numeric_limits<size_t>::max() - 2 * kAlignment) {
+    ORT_THROW("RunArena allocation size overflow: ", size);
+  }
+  const size_t aligned_size = (size + kAlignment - 1) / kAlignment * kAlignment + kAlignment;
+
+  Block* block = current_.load(std::memory_order_acquire);
+  char* slot = block != nullptr ? TryAlloc(*block, aligned_size) : nullptr;
+  while (slot == nullptr) {
+    block = Grow(block, aligned_size);
+    slot = TryAlloc(*block, aligned_size);
+  }
+
+  const size_t in_use = in_use_.fetch_add(aligned_size, std::memory_order_relaxed) + aligned_size;
+  size_t peak = peak_in_use_.load(std::memory_order_relaxed);
+  while (in_use > peak && !peak_in_use_.compare_exchange_weak(peak, in_use, std::memory_order_relaxed)) {
+  }
+
+  auto* header = reinterpret_cast<AllocationHeader*>(slot);
+  header->block = block;
+  header->size = aligned_size;
+  return slot + kAlignment;
+}
+
+void RunArena::Free(void* p) {
+  if (p == nullptr) {
+    return;
+  }
+
+  char* slot = static_cast<char*>(p) - kAlignment;
+  const auto& header = *reinterpret_cast<const AllocationHeader*>(slot);
+  Block& block = *static_cast<Block*>(header.block);
+  const size_t offset = static_cast<size_t>(slot - block.data);
+  const size_t size = header.size;
+  in_use_.fetch_sub(size, std::memory_order_relaxed);
+
+  uint64_t state = block.state.load(std::memory_order_relaxed);
+  uint64_t next;
+  do {
+    const uint64_t live_count = LiveCount(state) - 1;
+    size_t next_offset = Offset(state);
+    if (live_count == 0) {
+      // nothing in the block is in use any more
+      next_offset = 0;
+    } else if (offset + size == next_offset) {
+      // the slice handed out last, so the next allocation can take its place
+      next_offset = offset;
+    }
+    next = MakeState(next_offset, live_count);
+    // release, so that the slice is only handed out again once this thread is done with it
+  } while (!block.state.compare_exchange_weak(state, next, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void RunArena::Reset() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  const size_t peak = peak_in_use_.exchange(0, std::memory_order_relaxed);
+  in_use_.store(0, std::memory_order_relaxed);
+  if (blocks_.empty()) {
+    return;
+  }
+
+  // decay slowly, so that a run smaller than the ones before it doesn't shrink the arena on its own
+  decayed_peak_ = std::max(peak, decayed_peak_ - decayed_peak_ / 8);
+  const size_t target_capacity = 2 * std::max(decayed_peak_, kMinBlockSize);
+
+  if (CapacityLocked() > target_capacity) {
+    // blocks the run didn't touch are only kept for runs larger than the recent ones
+    blocks_.erase(std::remove_if(blocks_.begin(), blocks_.end(),
+                                 [this](const std::unique_ptr<Block>& block) {
+                                   if (block->used.load(std::memory_order_relaxed)) {
+                                     return false;
+                                   }
+                                   backing_allocator_->Free(block->data);
+                                   return true;
+                                 }),
+                  blocks_.end());
+
+    // a single block left over from a larger run is replaced by one sized from the recent peak. the blocks of a
+    // run that used several are kept, as values outliving the ones around them split the peak over blocks.
+    if (blocks_.size() == 1 && CapacityLocked() > target_capacity) {
+      FreeBlocks();
+      AddBlock(target_capacity / 2);
+    }
+  }
+
+  for (const auto& block : blocks_) {
+    block->state.store(0, std::memory_order_relaxed);
+    block->used.store(false, std::memory_order_relaxed);
+  }
+  current_.store(blocks_.empty() ? nullptr : blocks_.front().get(), std::memory_order_relaxed);
+}
+
+size_t RunArena::CapacityLocked() const {
+  size_t capacity = 0;
+  for (const auto& block : blocks_) {
+    capacity += block->size;
+  }
+  return capacity;
+}
+
+size_t RunArena::Capacity() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return CapacityLocked();
+}
+
+RunArenaPool::RunArenaPool(AllocatorPtr backing_allocator, size_t max_free_arenas)
+    : backing_allocator_(std::move(backing_allocator)), max_free_arenas_(max_free_arenas) {
+  ORT_ENFORCE(backing_allocator_ != nullptr);
+}
+
+std::shared_ptr<RunArena> RunArenaPool::Acquire() {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    if (!free_arenas_.empty()) {
+      auto arena = std::move(free_arenas_.back());
+      free_arenas_.pop_back();
+      return arena;
+    }
+  }
+
+  return std::make_shared<RunArena>(backing_allocator_);
+}
+
+void RunArenaPool::Release(std::shared_ptr<RunArena> arena) {
+  {
+    std::lock_guard<OrtMutex> lock(mutex_);
+    if (free_arenas_.size() >= max_free_arenas_) {
+      // left over from more concurrent runs than the pool keeps arenas for. freed with its blocks on return.
+      return;
+    }
+  }
+
+  arena->Reset();
+  std::lock_guard<OrtMutex> lock(mutex_);
+  if (free_arenas_.size() < max_free_arenas_) {
+    free_arenas_.push_back(std::move(arena));
+  }
+}
+
+size_t RunArenaPool::NumFreeArenas() {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return free_arenas_.size();
+}
+
+}  // namespace onnxruntime
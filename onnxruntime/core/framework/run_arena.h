@@ -0,0 +1,119 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+ * Bump-pointer allocator for the intermediate tensors of a single run.
+ *
+ * Alloc hands out consecutive slices of large blocks taken from a backing allocator. A block is used from its
+ * start again once every slice taken from it has been freed, and freeing the slice handed out last gives its
+ * space straight back, so values with nested or short lifetimes keep reusing the same memory within a run.
+ * Anything else is released at once by Reset when the run ends.
+ *
+ * A run that needs more than the current block grows the arena by another block, and Reset keeps the blocks, so
+ * runs with a similar footprint don't call the backing allocator. Reset also tracks the peak of the memory in use
+ * at once, decaying slowly. Once the arena holds more than twice that peak, it drops the blocks the last run
+ * didn't touch and replaces a single oversized block by one sized from the peak, so an arena that served one
+ * large run shrinks again after a few smaller ones. Values allocated from it must not outlive the run.
+ */
+class RunArena final : public IAllocator {
+ public:
+  explicit RunArena(AllocatorPtr backing_allocator);
+  ~RunArena() override;
+
+  // Thread-safe, as nodes of a run may execute concurrently. Lock-free unless the arena has to grow.
+  void* Alloc(size_t size) override;
+
+  // Thread-safe and lock-free.
+  void Free(void* p) override;
+
+  const OrtMemoryInfo& Info() const override { return backing_allocator_->Info(); }
+
+  // Releases everything allocated since the last Reset. Must not be called while a run is using the arena,
+  // and the values allocated from it must have been freed.
+  void Reset();
+
+  // Total size of the blocks held by the arena.
+  size_t Capacity() const;
+
+  static constexpr size_t kAlignment = 64;
+  static constexpr size_t kMinBlockSize = 1 << 20;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunArena);
+
+  struct Block;
+
+  // Takes size bytes from the end of the used part of block, or returns nullptr if they don't fit.
+  static char* TryAlloc(Block& block, size_t size);
+
+  // Makes a block with room for size bytes current, unless another thread replaced seen already, and returns
+  // the current block.
+  Block* Grow(Block* seen, size_t size);
+
+  void AddBlock(size_t size);
+  void FreeBlocks();
+  size_t CapacityLocked() const;
+
+  const AllocatorPtr backing_allocator_;
+
+  // block that allocations are bumped through
+  std::atomic<Block*> current_{nullptr};
+
+  // guards the list of blocks. only taken to grow the arena and by Reset.
+  mutable OrtMutex mutex_;
+  std::vector<std::unique_ptr<Block>> blocks_;
+  // peak of in_use_ over the runs since the arena was created, decaying on every Reset
+  size_t decayed_peak_ = 0;
+
+  // bytes of the allocations that haven't been freed, and their peak since the last Reset
+  std::atomic<size_t> in_use_{0};
+  std::atomic<size_t> peak_in_use_{0};
+};
+
+/**
+ * Per-session pool of RunArena instances, so that every run, including concurrent ones, has an arena of its
+ * own that keeps its blocks from one run to the next. The pool lock is taken once when a run starts and once
+ * when it ends, never per allocation. At most max_free_arenas arenas are kept; the ones released beyond that,
+ * left over from a burst of concurrent runs, are destroyed with their blocks.
+ */
+class RunArenaPool {
+ public:
+  explicit RunArenaPool(AllocatorPtr backing_allocator, size_t max_free_arenas = kDefaultMaxFreeArenas);
+
+  // Location of the memory handed out by the arenas of this pool.
+  const OrtMemoryInfo& Info() const { return backing_allocator_->Info(); }
+
+  // Takes an arena for a run, creating one if none is free.
+  std::shared_ptr<RunArena> Acquire();
+
+  // Resets the arena and returns it to the pool. The values allocated from it must have been released.
+  void Release(std::shared_ptr<RunArena> arena);
+
+  // Number of arenas waiting in the pool.
+  size_t NumFreeArenas();
+
+  static constexpr size_t kDefaultMaxFreeArenas = 8;
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(RunArenaPool);
+
+  const AllocatorPtr backing_allocator_;
+  const size_t max_free_arenas_;
+
+  OrtMutex mutex_;
+  std::vector<std::shared_ptr<RunArena>> free_arenas_;
+};
+
+}  // namespace onnxruntime
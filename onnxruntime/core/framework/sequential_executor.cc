@@ -11,9 +11,11 @@
 #include "core/common/logging/logging.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/execution_frame.h"
+#include "core/framework/execution_frame_pool.h"
 #include "core/framework/session_state.h"
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/framework/utils.h"
+#include "gsl/gsl"
 
 // Define this symbol to create Concurrency Visualizer markers.
 // See https://docs.microsoft.com/en-us/visualstudio/profiling/concurrency-visualizer-sdk
@@ -46,7 +48,46 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
     tp = session_state.Profiler().StartTime();
   }
 
-  ExecutionFrame frame{feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches, fetch_allocators, session_state};
+  // Take a frame from the pool if this session reuses them and the run has no per-run allocators.
+  ExecutionFramePool* frame_pool = session_state.GetExecutionFramePool();
+  int64_t frame_key = 0;
+  if (frame_pool != nullptr &&
+      !(fetch_allocators.empty() &&
+        ExecutionFramePool::ComputeKey(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, frame_key))) {
+    frame_pool = nullptr;
+  }
+
+  // A pooled run always has an entry, so that its frame can go back to the pool however the run ends.
+  std::unique_ptr<ExecutionFramePool::Entry> pooled_frame;
+  if (frame_pool != nullptr) {
+    pooled_frame = frame_pool->Acquire(frame_key, feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs);
+    if (pooled_frame) {
+      pooled_frame->frame->Reuse(feed_mlvalue_idxs, feeds, fetches);
+    } else {
+      pooled_frame = onnxruntime::make_unique<ExecutionFramePool::Entry>(
+          frame_key, feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs,
+          onnxruntime::make_unique<ExecutionFrame>(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
+                                                   fetch_allocators, session_state));
+    }
+  }
+
+  std::unique_ptr<ExecutionFrame> owned_frame;
+  if (!pooled_frame) {
+    owned_frame = onnxruntime::make_unique<ExecutionFrame>(feed_mlvalue_idxs, feeds, fetch_mlvalue_idxs, fetches,
+                                                           fetch_allocators, session_state);
+  }
+
+  ExecutionFrame& frame = pooled_frame ? *pooled_frame->frame : *owned_frame;
+
+  // Return the frame to the pool on every exit, including errors and termination. A frame that traced
+  // allocations to build a memory pattern is not reused: the next run with these shapes builds a frame
+  // that uses the pattern, and that one goes back to the pool.
+  const auto return_frame = gsl::finally([&frame, &pooled_frame, frame_pool]() {
+    if (pooled_frame && !frame.HasMemoryPatternPlanner()) {
+      frame.ClearValues();
+      frame_pool->Release(std::move(pooled_frame));
+    }
+  });
 
   LOGS(logger, INFO) << "Begin execution";
   const SequentialExecutionPlan& seq_exec_plan = *session_state.GetExecutionPlan();
@@ -244,7 +285,13 @@ Status SequentialExecutor::Execute(const SessionState& session_state, const std:
   }
 
   if (is_profiler_enabled) {
-    session_state.Profiler().EndTimeAndRecordEvent(profiling::SESSION_EVENT, "SequentialExecutor::Execute", tp);
+    const auto mem_pattern_stats = session_state.GetMemoryPatternCacheStats();
+    session_state.Profiler().EndTimeAndRecordEvent(
+        profiling::SESSION_EVENT, "SequentialExecutor::Execute", tp,
+        {{"mem_pattern_cache_hits", std::to_string(mem_pattern_stats.hits)},
+         {"mem_pattern_cache_misses", std::to_string(mem_pattern_stats.misses)},
+         {"mem_pattern_cache_evictions", std::to_string(mem_pattern_stats.evictions)},
+         {"mem_pattern_cache_size", std::to_string(mem_pattern_stats.size)}});
   }
 
   return Status::OK();
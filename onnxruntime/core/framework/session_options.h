@@ -24,6 +24,10 @@ struct SessionOptions {
   bool enable_profiling = false;
 
   // non empty filepath enables serialization of the transformed optimized model to the specified filepath.
+  // The saved model records the optimization level, providers, free dimension overrides and hardware it was
+  // optimized for; sessions with the same configuration that load it skip the graph transformers it has already
+  // been through. Only graph transformations are reused: kernel assignment, execution planning and the weights
+  // that kernels pre-pack are redone when the saved model is loaded.
   std::basic_string<ORTCHAR_T> optimized_model_filepath;
 
   // enable the memory pattern optimization.
@@ -33,6 +37,33 @@ struct SessionOptions {
   // See class 'OrtValuePatternPlanner'.
   bool enable_mem_pattern = true;
 
+  // bucket boundaries, in ascending order, that input dimensions are rounded up to when looking up a cached
+  // memory pattern. Inputs whose dimensions fall in the same buckets share one pattern, which is what makes
+  // the cache useful for inputs with variable dimensions such as a sequence length. Empty = exact shapes.
+  std::vector<int64_t> mem_pattern_dim_buckets;
+
+  // maximum number of memory patterns cached per session. The least recently used one is evicted when full.
+  // 0 = unbounded.
+  size_t mem_pattern_cache_capacity = 32;
+
+  // memory-map the model file when loading a model from a path. The raw data of large initializers is not copied
+  // into the ModelProto; the initializers reference it in the model file instead and, if it's suitably aligned,
+  // use it in place from the mapping. See Model::LoadMapped.
+  bool enable_model_mmap = false;
+
+  // reuse execution frames across runs with the same input shapes instead of building a new one for every run.
+  // Frames are pooled per session and handed out without locking, so concurrent Run calls each get their own.
+  // A pooled frame keeps the memory pattern buffers it allocated, trading memory for less per-run work.
+  // Only used by the sequential executor.
+  bool enable_execution_frame_pool = false;
+
+  // allocate the intermediate values of a run on the CPU from a per-run arena that hands out memory with a pointer
+  // bump and is reset in one step when the run ends, rather than taking each one from the shared CPU allocator.
+  // Outputs of the run still come from the shared allocator. Memory freed during a run is only reused when it was
+  // the last one handed out or its whole block is free, so a run may hold more than the peak of its intermediates
+  // not covered by the memory pattern. Each arena shrinks again once runs need less.
+  bool enable_run_arena = false;
+
   // enable the memory arena on CPU
   // Arena may pre-allocate memory for future usage.
   // set this option to false if you don't want it.
@@ -55,12 +86,37 @@ struct SessionOptions {
   TransformerLevel graph_optimization_level = TransformerLevel::Level1;
 
   // controls the size of the thread pool used to parallelize the execution of tasks within individual nodes (ops)
+  // when use_per_session_threads is false this instead caps how many workers of the global
+  // intra op thread pool this session may occupy at once (0 = no cap).
   int intra_op_num_threads = 0;
 
   // controls the size of the thread pool used to parallelize the execution of nodes (ops)
   // configuring this makes sense only when you're using parallel executor
   int inter_op_num_threads = 0;
 
+  // number of threads owned by the session that execute the runs queued by RunAsync. They wait for their runs, so
+  // they are separate from the intra and inter op pools, including the global ones. 0 = one per physical core.
+  int async_run_num_threads = 0;
+
+  // time every kernel the parallel executor runs so that later runs can order the ready nodes by their measured
+  // critical path rather than by output size estimates. Timing is also done while profiling is enabled.
+  bool enable_node_cost_measurement = false;
+
+  // logical processors the intra op worker threads are pinned to, one worker per processor in round-robin order.
+  // Empty means no pinning. Ignored when use_per_session_threads is false.
+  std::vector<int> intra_op_thread_affinity;
+
+  // NUMA node the session runs on, or -1 to not restrict placement.
+  // Worker threads are restricted to the processors of the node when they are created (unless
+  // intra_op_thread_affinity is set), and the thread calling Initialize() is moved onto the node while it
+  // executes, so that the initializers it first touches are allocated on the node's local memory.
+  // Threads calling Run() are left where they are; place them on the node to keep their allocations local.
+  int numa_node = -1;
+
+  // if false, the session uses the thread pools owned by the Environment it was created with instead of
+  // creating its own. The Environment must have been created with global thread pools.
+  bool use_per_session_threads = true;
+
   // For models with free input dimensions (most commonly batch size), specifies a set of values to override those
   // free dimensions with, keyed by dimension denotation.
   std::vector<FreeDimensionOverride> free_dimension_overrides;
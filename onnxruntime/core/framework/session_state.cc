@@ -77,6 +77,10 @@ Status SessionState::CreateKernels(const KernelRegistryManager& custom_registry_
     }
     session_kernels_.clear();
     session_kernels_.resize(max_nodeid + 1, nullptr);
+    node_costs_.reset(new std::atomic<int64_t>[max_nodeid + 1]);
+    for (size_t i = 0; i <= max_nodeid; ++i) {
+      node_costs_[i].store(0, std::memory_order_relaxed);
+    }
     for (auto& node : graph_viewer_->Nodes()) {
       // construct and save the kernels
       std::unique_ptr<OpKernel> op_kernel;
@@ -94,6 +98,25 @@ Status SessionState::CreateKernels(const KernelRegistryManager& custom_registry_
             status.Category(), status.Code(),
             MakeString("Kernel creation failed for node: ", node.Name(), " with error: ", status.ErrorMessage()));
       }
+
+      // give the kernel a chance to pre-process its constant initializer inputs
+      int input_idx = 0;
+      for (const auto* input_def : node.InputDefs()) {
+        int ort_value_idx;
+        if (input_def->Exists() && ort_value_name_idx_map_.GetIdx(input_def->Name(), ort_value_idx).IsOK()) {
+          auto it = constant_initialized_tensors_.find(ort_value_idx);
+          if (it != constant_initialized_tensors_.end() && it->second.IsTensor()) {
+            bool is_packed = false;
+            ORT_RETURN_IF_ERROR(op_kernel->PrePack(it->second.Get<Tensor>(), input_idx,
+                                                   prepacked_weights_[ort_value_idx], is_packed));
+            if (is_packed) {
+              VLOGS(Logger(), 1) << "Node " << node.Name() << " pre-packed constant input " << input_def->Name();
+            }
+          }
+        }
+        ++input_idx;
+      }
+
       assert(session_kernels_[node.Index()] == nullptr);
       // assumes vector is already resize()'ed to the number of nodes in the graph
       session_kernels_[node.Index()] = op_kernel.release();
@@ -148,41 +171,57 @@ void SessionState::SetProfiler(profiling::Profiler& profiler) { profiler_ = &pro
 
 ::onnxruntime::profiling::Profiler& SessionState::Profiler() const { return *profiler_; }
 
-static int64_t CalculateMemoryPatternsKey(const std::vector<std::reference_wrapper<const TensorShape>>& shapes) {
-  int64_t key = 0;
-  for (auto shape : shapes) {
-    for (auto dim : shape.get().GetDims()) key ^= dim;
-  }
-  return key;
-}
-
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
+std::shared_ptr<const MemoryPatternGroup> SessionState::GetMemoryPatternGroup(
     const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
-
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) return nullptr;
-
-  return it->second.get();
+  return mem_pattern_cache_->Get(input_shapes);
 }
 
 Status SessionState::UpdateMemoryPatternGroupCache(
     const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes,
     std::unique_ptr<MemoryPatternGroup> mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(input_shapes);
+  mem_pattern_cache_->Put(input_shapes, std::move(mem_patterns));
+  return Status::OK();
+}
+
+std::shared_ptr<const MemoryPatternGroup> SessionState::PlanMemoryPatternGroup(
+    const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+    const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const {
+  if (!symbolic_mem_planner_) {
+    return nullptr;
+  }
 
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
-    mem_patterns_[key] = std::move(mem_patterns);
+  auto mem_patterns = std::make_shared<MemoryPatternGroup>();
+  auto status = symbolic_mem_planner_->GeneratePatterns(feed_mlvalue_idxs, feeds, *mem_patterns);
+  if (!status.IsOK()) {
+    // the run traces its allocations instead
+    LOGS(Logger(), VERBOSE) << "Couldn't plan memory patterns from the symbolic shapes: " << status.ErrorMessage();
+    return nullptr;
   }
 
-  return Status::OK();
+  mem_pattern_cache_->Put(input_shapes, mem_patterns);
+  return mem_patterns;
+}
+
+void SessionState::SetSymbolicMemoryPlanner(std::unique_ptr<SymbolicMemoryPlanner> planner) {
+  symbolic_mem_planner_ = std::move(planner);
 }
 
 bool SessionState::GetEnableMemoryPattern() const { return enable_mem_pattern_; }
 
+void SessionState::ConfigureMemoryPatternCache(const std::vector<int64_t>& dim_buckets, size_t capacity) {
+  mem_pattern_cache_ = onnxruntime::make_unique<MemoryPatternCache>(dim_buckets, capacity);
+}
+
+MemoryPatternCacheStats SessionState::GetMemoryPatternCacheStats() const { return mem_pattern_cache_->GetStats(); }
+
+void SessionState::EnableExecutionFramePool(size_t capacity) {
+  execution_frame_pool_ = onnxruntime::make_unique<ExecutionFramePool>(capacity);
+}
+
+void SessionState::EnableRunArena(AllocatorPtr backing_allocator) {
+  run_arena_pool_ = onnxruntime::make_unique<RunArenaPool>(std::move(backing_allocator));
+}
+
 common::Status SessionState::AddInputNameToNodeInfoMapping(const std::string& input_name, const NodeInfo& node_info) {
   // Graph partitioning should ensure an input is only consumed from one device. Copy nodes should have been inserted
   // to handle a scenario where an input is required on different devices by different nodes. Validate that.
@@ -301,6 +340,26 @@ void SessionState::RemoveSubgraphSessionState(onnxruntime::NodeIndex index) {
   subgraph_session_states_.erase(index);
 }
 
+int64_t SessionState::GetNodeCost(NodeIndex node_index) const {
+  if (!node_costs_ || node_index >= session_kernels_.size()) {
+    return 0;
+  }
+  return node_costs_[node_index].load(std::memory_order_relaxed);
+}
+
+void SessionState::UpdateNodeCost(NodeIndex node_index, int64_t cost_us) const {
+  if (!node_costs_ || node_index >= session_kernels_.size()) {
+    return;
+  }
+
+  // keep a running average so a single slow run doesn't reorder the schedule. concurrent runs may race
+  // on the update, which only loses a sample.
+  auto& cost = node_costs_[node_index];
+  const int64_t previous = cost.load(std::memory_order_relaxed);
+  const int64_t average = previous == 0 ? cost_us : (3 * previous + cost_us) / 4;
+  cost.store(std::max<int64_t>(average, 1), std::memory_order_relaxed);
+}
+
 const NodeIndexInfo& SessionState::GetNodeIndexInfo() const {
   ORT_ENFORCE(node_index_info_, "SetGraphAndCreateKernels must be called prior to GetExecutionInfo.");
   return *node_index_info_;
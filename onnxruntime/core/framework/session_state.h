@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
 #include <map>
 #include <unordered_map>
@@ -15,14 +16,19 @@
 #include "core/common/profiler.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/data_transfer_manager.h"
+#include "core/framework/execution_frame_pool.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/feeds_fetches_manager.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
+#include "core/framework/mem_pattern_cache.h"
+#include "core/framework/run_arena.h"
+#include "core/framework/symbolic_mem_planner.h"
 #include "core/framework/ml_value.h"
 #include "core/framework/callback.h"
 #include "core/framework/ort_value_name_idx_map.h"
 #include "core/framework/node_index_info.h"
+#include "core/framework/op_kernel.h"
 #include "core/graph/graph_viewer.h"
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/platform/threadpool.h"
@@ -55,11 +61,14 @@ class SessionState {
                concurrency::ThreadPool* inter_op_thread_pool)
       : execution_providers_(execution_providers),
         enable_mem_pattern_(enable_mem_pattern),
+        mem_pattern_cache_(onnxruntime::make_unique<MemoryPatternCache>(std::vector<int64_t>{}, 0)),
         thread_pool_(thread_pool),
         inter_op_thread_pool_(inter_op_thread_pool) {
   }
 
   ~SessionState() {
+    // pooled frames refer to the kernels and initializers below
+    execution_frame_pool_.reset();
     for (auto* p : session_kernels_) {
       delete p;
     }
@@ -144,7 +153,7 @@ class SessionState {
   /**
   Get cached memory pattern based on input shapes
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  std::shared_ptr<const MemoryPatternGroup> GetMemoryPatternGroup(
       const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const;
 
   /**
@@ -154,11 +163,56 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(const std::vector<std::reference_wrapper<const TensorShape>>& input_shape,
                                        std::unique_ptr<MemoryPatternGroup> mem_patterns) const;
 
+  /**
+  Plan the memory patterns for the given feeds from the symbolic shapes of the graph and cache them.
+  Returns nullptr if the session has no symbolic memory planner or it can't plan for these feeds.
+  */
+  std::shared_ptr<const MemoryPatternGroup> PlanMemoryPatternGroup(
+      const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+      const std::vector<std::reference_wrapper<const TensorShape>>& input_shapes) const;
+
+  /**
+  Set the planner that works out memory patterns from the symbolic shapes of the graph.
+  */
+  void SetSymbolicMemoryPlanner(std::unique_ptr<SymbolicMemoryPlanner> planner);
+  const SymbolicMemoryPlanner* GetSymbolicMemoryPlanner() const { return symbolic_mem_planner_.get(); }
+
   /**
   Get enable memory pattern flag
   */
   bool GetEnableMemoryPattern() const;
 
+  /**
+  Round input dimensions up to the given bucket boundaries when caching memory patterns, and keep at most
+  'capacity' patterns (0 = unbounded). Clears the patterns cached so far.
+  */
+  void ConfigureMemoryPatternCache(const std::vector<int64_t>& dim_buckets, size_t capacity);
+
+  /**
+  Get the hit, miss and eviction counts of the memory pattern cache.
+  */
+  MemoryPatternCacheStats GetMemoryPatternCacheStats() const;
+
+  /**
+  Keep up to 'capacity' execution frames around and reuse them across runs with the same input shapes.
+  */
+  void EnableExecutionFramePool(size_t capacity);
+
+  /**
+  Get the pool of reusable execution frames. nullptr if frames are created for every run.
+  */
+  ExecutionFramePool* GetExecutionFramePool() const { return execution_frame_pool_.get(); }
+
+  /**
+  Allocate the intermediate values of each run in the memory of 'backing_allocator' from a per-run arena.
+  */
+  void EnableRunArena(AllocatorPtr backing_allocator);
+
+  /**
+  Get the pool of per-run arenas. nullptr if intermediate values are allocated one by one.
+  */
+  RunArenaPool* GetRunArenaPool() const { return run_arena_pool_.get(); }
+
   struct NodeInfo {
     /**
      *
@@ -217,12 +271,29 @@ class SessionState {
   std::vector<BufferUniquePtr>& GetMutableWeightsBuffers() { return weights_buffers_; }
   const NodeIndexInfo& GetNodeIndexInfo() const;
 
+  /**
+  Get the kernel run time of a node in microseconds, averaged over the previous runs that measured it.
+  Returns 0 if the node hasn't been measured. The ParallelExecutor uses these to rank ready nodes by
+  their remaining critical path.
+  */
+  int64_t GetNodeCost(NodeIndex node_index) const;
+
+  /** Record a measured kernel run time of a node in microseconds. Safe to call from concurrent runs. */
+  void UpdateNodeCost(NodeIndex node_index, int64_t cost_us) const;
+
+  /** Set whether executors should measure kernel run times when profiling is disabled. */
+  void SetMeasureNodeCosts(bool measure) { measure_node_costs_ = measure; }
+  bool MeasureNodeCosts() const { return measure_node_costs_; }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(SessionState);
 
   // cache of the constructed kernels to avoid spending construction
   // time per executor
   std::vector<OpKernel*> session_kernels_;
+  // measured kernel run times in microseconds, indexed like session_kernels_
+  std::unique_ptr<std::atomic<int64_t>[]> node_costs_;
+  bool measure_node_costs_ = false;
   std::unique_ptr<GraphViewer> graph_viewer_;
 
   std::reference_wrapper<const ExecutionProviders> execution_providers_;  // owned by InferenceSession
@@ -232,6 +303,8 @@ class SessionState {
   std::unordered_map<int, OrtValue> initialized_tensors_;  // key is ort_value_index
   // subset of initialized_tensors_ that are constant and cannot be overridden at runtime
   std::unordered_map<int, OrtValue> constant_initialized_tensors_;
+  // copies of constant_initialized_tensors_ packed by the kernels, shared by the kernels that pack them the same way
+  std::unordered_map<int, PrePackedWeights> prepacked_weights_;  // key is ort_value_index
 
   // This data structure is for uninitializing string tensors and
   // munmap memory region and close file descriptor
@@ -244,10 +317,11 @@ class SessionState {
 
   // switch for enable memory pattern optimization or not.
   const bool enable_mem_pattern_;
-  // lock for the mem_patterns_
-  mutable OrtMutex mem_patterns_lock_;
-  // cache for the generated mem_patterns. key is calculated based on input shapes.
-  mutable std::map<int64_t, std::unique_ptr<MemoryPatternGroup>> mem_patterns_;
+  // cache for the generated mem_patterns, keyed by the bucketed input shapes.
+  // unbounded and without buckets until configured by the inference session.
+  std::unique_ptr<MemoryPatternCache> mem_pattern_cache_;
+  // plans memory patterns for new input shapes without tracing a run. null if the graph can't be planned.
+  std::unique_ptr<SymbolicMemoryPlanner> symbolic_mem_planner_;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -268,6 +342,13 @@ class SessionState {
 
   std::unique_ptr<NodeIndexInfo> node_index_info_;
   std::multimap<int, std::unique_ptr<FeedsFetchesManager>> cached_feeds_fetches_managers_;
+
+  // arenas for the intermediate values of a run. null unless enabled by the inference session.
+  // declared before execution_frame_pool_ as pooled frames return their arena to it when destroyed.
+  std::unique_ptr<RunArenaPool> run_arena_pool_;
+
+  // reusable execution frames. null unless enabled by the inference session.
+  std::unique_ptr<ExecutionFramePool> execution_frame_pool_;
 };
 
 }  // namespace onnxruntime
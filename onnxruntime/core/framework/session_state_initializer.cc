@@ -20,6 +20,7 @@
 #include "core/framework/ort_value_name_idx_map.h"
 #include "core/framework/sequential_execution_plan.h"
 #include "core/framework/session_state.h"
+#include "core/framework/symbolic_mem_planner.h"
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/utils.h"
 #include "core/framework/mem_buffer.h"
@@ -87,6 +88,16 @@ common::Status SessionStateInitializer::CreatePlan(
   const auto* exec_plan_ptr = session_state_.GetExecutionPlan();
   ORT_ENFORCE(exec_plan_ptr, "Execution plan was not found in SessionState. CreatePlan must be called first.");
 
+  // work out the memory patterns ahead of the runs if every buffer can be sized from the graph inputs
+  if (session_state_.GetEnableMemoryPattern()) {
+    session_state_.SetSymbolicMemoryPlanner(
+        SymbolicMemoryPlanner::Create(*graph_viewer, *exec_plan_ptr, ort_value_name_idx_map));
+    if (session_state_.GetSymbolicMemoryPlanner() == nullptr) {
+      LOGS(logger_, INFO) << "Memory patterns will be traced at run time as the graph has buffers whose size "
+                             "can't be worked out from the shapes of its inputs.";
+    }
+  }
+
   std::unique_ptr<ITensorAllocator> tensor_allocator_(ITensorAllocator::Create(
       enable_mem_pattern_, *exec_plan_ptr, execution_providers_, session_state_.GetMutableWeightsBuffers()));
 
@@ -21,7 +21,7 @@ common::Status SimpleTensorAllocator::GetPreallocatedBuffer(int ort_value_index,
   static constexpr int alignment = 256;
   ORT_RETURN_IF_ERROR(utils::GetSizeInBytesFromTensorProto<alignment>(*iter->second, &len));
   const struct OrtMemoryInfo& location = seq_plan_.GetLocation(ort_value_index);
-  if (len == 0) {
+  if (len == 0 || UsesExternalDataInPlace(location, *iter->second)) {
     out = onnxruntime::make_unique<MemBuffer>(nullptr, 0, location);
     return Status::OK();
   }
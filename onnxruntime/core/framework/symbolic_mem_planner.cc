@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/symbolic_mem_planner.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "core/framework/allocator.h"
+#include "core/framework/data_types.h"
+#include "core/framework/ort_value_pattern_planner.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+size_t SymbolicMemoryPlanner::GetOrAddSymbol(const std::string& name) {
+  auto it = symbol_indices_.find(name);
+  if (it != symbol_indices_.end()) {
+    return it->second;
+  }
+  symbols_.push_back(name);
+  symbol_indices_.emplace(name, symbols_.size() - 1);
+  return symbols_.size() - 1;
+}
+
+std::unique_ptr<SymbolicMemoryPlanner> SymbolicMemoryPlanner::Create(const GraphViewer& graph_viewer,
+                                                                     const SequentialExecutionPlan& execution_plan,
+                                                                     const OrtValueNameIdxMap& ort_value_name_idx_map) {
+  std::unique_ptr<SymbolicMemoryPlanner> planner(new SymbolicMemoryPlanner(execution_plan));
+
+  // the free dimensions are the symbolic dimensions of the graph inputs
+  for (const auto* input : graph_viewer.GetInputs()) {
+    int idx;
+    const auto* shape = input->Shape();
+    if (shape == nullptr || !ort_value_name_idx_map.GetIdx(input->Name(), idx).IsOK()) {
+      continue;
+    }
+    std::vector<int> dim_symbols;
+    dim_symbols.reserve(shape->dim_size());
+    for (const auto& dim : shape->dim()) {
+      dim_symbols.push_back(dim.has_dim_param() ? static_cast<int>(planner->GetOrAddSymbol(dim.dim_param())) : -1);
+    }
+    planner->input_symbols_.emplace(idx, std::move(dim_symbols));
+  }
+  const size_t num_input_symbols = planner->symbols_.size();
+
+  // replay the execution plan the way the execution frame traces it: the buffers allocated for the outputs of
+  // a node, then the values freed after it. values that reuse or share a buffer, graph outputs and non-tensors
+  // are not part of the pattern.
+  const auto& alloc_plan = execution_plan.allocation_plan;
+  planner->steps_.reserve(execution_plan.execution_plan.size());
+  for (const auto& node_plan : execution_plan.execution_plan) {
+    Step step;
+    const auto* node = graph_viewer.GetNode(node_plan.node_index);
+    if (node == nullptr) {
+      return nullptr;
+    }
+
+    for (const auto* output : node->OutputDefs()) {
+      int idx;
+      if (!output->Exists() || !ort_value_name_idx_map.GetIdx(output->Name(), idx).IsOK()) {
+        continue;
+      }
+      const auto& value_plan = alloc_plan[idx];
+      if (value_plan.alloc_kind != AllocKind::kAllocate || value_plan.value_type == nullptr ||
+          !value_plan.value_type->IsTensorType()) {
+        continue;
+      }
+      const auto* element_type = static_cast<const TensorTypeBase*>(value_plan.value_type)->GetElementType();
+      if (element_type == DataTypeImpl::GetType<std::string>()) {
+        continue;
+      }
+
+      const auto* shape = output->Shape();
+      if (shape == nullptr) {
+        return nullptr;
+      }
+      Allocation allocation{idx, SymbolicSize{}};
+      allocation.size.element_size = element_type->Size();
+      for (const auto& dim : shape->dim()) {
+        if (dim.has_dim_value() && dim.dim_value() >= 0) {
+          allocation.size.constant *= dim.dim_value();
+        } else if (dim.has_dim_param()) {
+          size_t symbol = planner->GetOrAddSymbol(dim.dim_param());
+          // a symbol the graph inputs don't define can't be bound at run time
+          if (symbol >= num_input_symbols) {
+            return nullptr;
+          }
+          allocation.size.symbols.push_back(symbol);
+        } else {
+          return nullptr;
+        }
+      }
+      step.allocations.push_back(std::move(allocation));
+    }
+
+    for (int i = node_plan.free_from_index; i <= node_plan.free_to_index; ++i) {
+      step.frees.push_back(execution_plan.to_be_freed[i]);
+    }
+    planner->steps_.push_back(std::move(step));
+  }
+
+  return planner;
+}
+
+Status SymbolicMemoryPlanner::GeneratePatterns(const std::vector<int>& feed_mlvalue_idxs,
+                                               const std::vector<OrtValue>& feeds,
+                                               MemoryPatternGroup& out) const {
+  std::vector<int64_t> values(symbols_.size(), -1);
+  for (size_t i = 0, end = std::min(feed_mlvalue_idxs.size(), feeds.size()); i < end; ++i) {
+    auto it = input_symbols_.find(feed_mlvalue_idxs[i]);
+    if (it == input_symbols_.end()) {
+      continue;
+    }
+    if (!feeds[i].IsTensor()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Feed ", i, " is not a tensor.");
+    }
+    const auto& dims = feeds[i].Get<Tensor>().Shape().GetDims();
+    const auto& dim_symbols = it->second;
+    if (dims.size() != dim_symbols.size()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Feed ", i, " has rank ", dims.size(), " but the graph expects ",
+                             dim_symbols.size());
+    }
+    for (size_t d = 0; d < dims.size(); ++d) {
+      if (dim_symbols[d] < 0) {
+        continue;
+      }
+      auto& value = values[dim_symbols[d]];
+      if (value >= 0 && value != dims[d]) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Dimension '", symbols_[dim_symbols[d]], "' is bound to both ",
+                               value, " and ", dims[d]);
+      }
+      value = dims[d];
+    }
+  }
+
+  OrtValuePatternPlanner planner(execution_plan_);
+  for (const auto& step : steps_) {
+    for (const auto& allocation : step.allocations) {
+      int64_t len = allocation.size.constant;
+      for (auto symbol : allocation.size.symbols) {
+        const int64_t value = values[symbol];
+        if (value < 0) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Dimension '", symbols_[symbol], "' is not bound by the feeds.");
+        }
+        if (value != 0 && len > std::numeric_limits<int64_t>::max() / value) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "size overflow");
+        }
+        len *= value;
+      }
+
+      size_t size;
+      if (!IAllocator::CalcMemSizeForArrayWithAlignment<64>(static_cast<size_t>(len), allocation.size.element_size,
+                                                            &size)) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "size overflow");
+      }
+      ORT_RETURN_IF_ERROR(planner.TraceAllocation(allocation.ort_value_idx, size));
+    }
+    for (int idx : step.frees) {
+      ORT_RETURN_IF_ERROR(planner.TraceFree(idx));
+    }
+  }
+
+  return planner.GeneratePatterns(&out);
+}
+
+}  // namespace onnxruntime
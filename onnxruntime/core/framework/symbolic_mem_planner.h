@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/ml_value.h"
+#include "core/framework/ort_value_name_idx_map.h"
+#include "core/framework/sequential_execution_plan.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+/**
+ * Plans memory patterns from the shapes inferred for the graph instead of tracing a run.
+ *
+ * At session initialization the size of every buffer the execution plan allocates is expressed as a constant
+ * times a product of the symbolic (free) dimensions of the graph inputs. Replaying the allocations and frees of
+ * the execution plan with the free dimensions bound to the dimensions of the feeds then gives the same pattern
+ * as tracing a run with those feeds, without running the graph. The first run with new input shapes can use a
+ * pattern right away, so it is as fast as the runs after it.
+ *
+ * Graphs where the size of some buffer can't be worked out from the graph inputs, e.g. because shape inference
+ * leaves a dimension unknown or introduces a dimension for the output of an op like NonZero, are not planned.
+ */
+class SymbolicMemoryPlanner {
+ public:
+  // Returns nullptr if the buffers of the graph can't all be planned from the shapes of its inputs.
+  static std::unique_ptr<SymbolicMemoryPlanner> Create(const GraphViewer& graph_viewer,
+                                                       const SequentialExecutionPlan& execution_plan,
+                                                       const OrtValueNameIdxMap& ort_value_name_idx_map);
+
+  // Generates the memory patterns for a run with the given feeds.
+  // Fails if the feeds don't bind every free dimension, or bind one to different values.
+  Status GeneratePatterns(const std::vector<int>& feed_mlvalue_idxs, const std::vector<OrtValue>& feeds,
+                          MemoryPatternGroup& out) const;
+
+  size_t NumSymbols() const { return symbols_.size(); }
+
+ private:
+  explicit SymbolicMemoryPlanner(const SequentialExecutionPlan& execution_plan) : execution_plan_(execution_plan) {}
+
+  // Size of a buffer: element_size * constant * product of the values of the symbols.
+  struct SymbolicSize {
+    size_t element_size = 0;
+    int64_t constant = 1;
+    std::vector<size_t> symbols;
+  };
+
+  struct Allocation {
+    int ort_value_idx;
+    SymbolicSize size;
+  };
+
+  // allocations made by a step of the execution plan, followed by the values freed after it
+  struct Step {
+    std::vector<Allocation> allocations;
+    std::vector<int> frees;
+  };
+
+  size_t GetOrAddSymbol(const std::string& name);
+
+  const SequentialExecutionPlan& execution_plan_;
+  std::vector<std::string> symbols_;
+  std::unordered_map<std::string, size_t> symbol_indices_;
+  // for each graph input, the symbol of each of its dimensions, or -1 if the dimension is not symbolic
+  std::unordered_map<int, std::vector<int>> input_symbols_;
+  std::vector<Step> steps_;
+};
+
+}  // namespace onnxruntime
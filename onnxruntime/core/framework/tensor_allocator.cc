@@ -3,6 +3,7 @@
 
 #include "tensor_allocator_with_mem_pattern.h"
 #include "simple_tensor_allocator.h"
+#include "tensorprotoutils.h"
 
 namespace onnxruntime {
 
@@ -10,6 +11,13 @@ AllocatorPtr ITensorAllocator::GetAllocator(const OrtMemoryInfo& memory_info) {
   return exec_providers_.GetAllocator(memory_info);
 }
 
+bool ITensorAllocator::UsesExternalDataInPlace(const OrtMemoryInfo& location,
+                                               const ONNX_NAMESPACE::TensorProto& value) {
+  // only initializers deserialized directly to CPU tensors can use the mapped file. see DeserializeTensorProto.
+  return (strcmp(location.name, CPU) == 0 || location.mem_type == OrtMemTypeCPUOutput) &&
+         utils::CanUseExternalDataInPlace(value);
+}
+
 std::unique_ptr<ITensorAllocator> ITensorAllocator::Create(bool enable_mem_pattern,
                                                            const ExecutionPlanBase& execution_plan,
                                                            const ExecutionProviders& exec_providers,
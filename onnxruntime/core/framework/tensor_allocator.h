@@ -41,6 +41,12 @@ class ITensorAllocator {
   explicit ITensorAllocator(const ExecutionProviders& exec_providers) : exec_providers_(exec_providers) {}
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ITensorAllocator);
 
+  /**
+   * Whether the initializer 'value' placed at 'location' doesn't need a preallocated buffer because it will use its
+   * external data in place, from a mapping of the file.
+   */
+  static bool UsesExternalDataInPlace(const OrtMemoryInfo& location, const ONNX_NAMESPACE::TensorProto& value);
+
   static std::unique_ptr<ITensorAllocator> Create(bool enable_mem_pattern, const ExecutionPlanBase& execution_plan,
                                                   const ExecutionProviders& exec_providers,
                                                   std::vector<BufferUniquePtr>& weights_buffers);
@@ -81,6 +81,10 @@ class TensorAllocatorWithMemPattern : public ITensorAllocator {
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Weight buffer for initializer '", name, "' is not found");
     }
 
+    if (block != nullptr && block->size_ == 0) {
+      out = onnxruntime::make_unique<MemBuffer>(nullptr, 0, location);
+      return Status::OK();
+    }
     if (block == nullptr || it->second == nullptr) {
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Get preallocated buffer for initializer '", name, "' failed");
     }
@@ -93,8 +97,10 @@ class TensorAllocatorWithMemPattern : public ITensorAllocator {
       return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Internal error.");
     }
     size_t len = 0;
-    static constexpr int alignment = 256;
-    ORT_RETURN_IF_ERROR(utils::GetSizeInBytesFromTensorProto<alignment>(*value, &len));
+    if (!UsesExternalDataInPlace(seq_plan_.GetLocation(id), *value)) {
+      static constexpr int alignment = 256;
+      ORT_RETURN_IF_ERROR(utils::GetSizeInBytesFromTensorProto<alignment>(*value, &len));
+    }
     ORT_RETURN_IF_ERROR(planner_.TraceAllocation(id, len));
     return Status::OK();
   }
@@ -361,6 +361,60 @@ static void MoveOrtCallback(OrtCallback& from, OrtCallback& to) {
   from.param = nullptr;
 }
 
+// Locations are relative to the directory of the model. The one absolute location accepted is the model file
+// itself, which is what Model::LoadMapped writes for the initializers it leaves in the mapped file.
+static Status GetExternalDataPath(const ORTCHAR_T* tensor_proto_path, const ExternalDataInfo& external_data_info,
+                                  std::basic_string<ORTCHAR_T>& full_path) {
+  const auto& location = external_data_info.GetRelPath();
+  if (tensor_proto_path == nullptr) {
+    full_path = location;
+  } else if (IsAbsolutePath(location)) {
+    std::basic_string<ORTCHAR_T> model_path;
+    ORT_RETURN_IF_ERROR(GetAbsolutePath(tensor_proto_path, model_path));
+    if (location != model_path) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "External data location '", ToMBString(location),
+                             "' is an absolute path. Locations must be relative to the model directory.");
+    }
+    full_path = location;
+  } else {
+    ORT_RETURN_IF_ERROR(GetDirNameFromFilePath(tensor_proto_path, full_path));
+    full_path = ConcatPathComponent<ORTCHAR_T>(full_path, location);
+  }
+  return Status::OK();
+}
+
+Status ReadExternalData(const Env& env, const ORTCHAR_T* tensor_proto_path,
+                        const ONNX_NAMESPACE::TensorProto& tensor_proto, std::string& raw_data) {
+  std::unique_ptr<ExternalDataInfo> external_data_info;
+  ORT_RETURN_IF_ERROR(ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info));
+  std::basic_string<ORTCHAR_T> full_path;
+  ORT_RETURN_IF_ERROR(GetExternalDataPath(tensor_proto_path, *external_data_info, full_path));
+  size_t len = external_data_info->GetLength();
+  void* file_data;
+  AutoDelete deleter_for_file_data;
+  ORT_RETURN_IF_ERROR(env.ReadFileAsString(full_path.c_str(), external_data_info->GetOffset(), file_data, len,
+                                           deleter_for_file_data.d));
+  raw_data.assign(static_cast<const char*>(file_data), len);
+  return Status::OK();
+}
+
+bool CanUseExternalDataInPlace(const ONNX_NAMESPACE::TensorProto& tensor_proto) {
+  if (tensor_proto.data_location() != TensorProto_DataLocation_EXTERNAL || !IsLittleEndianOrder() ||
+      !utils::HasDataType(tensor_proto) || tensor_proto.data_type() == TensorProto_DataType_STRING) {
+    return false;
+  }
+  const auto* tensor_type = DataTypeImpl::TensorTypeFromONNXEnum(tensor_proto.data_type());
+  if (tensor_type == nullptr) {
+    return false;
+  }
+  std::unique_ptr<ExternalDataInfo> external_data_info;
+  if (!ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info).IsOK()) {
+    return false;
+  }
+  // mappings start at a page boundary, so the data is aligned if its offset in the file is
+  return external_data_info->GetOffset() % tensor_type->GetElementType()->Size() == 0;
+}
+
 Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
                             const ONNX_NAMESPACE::TensorProto& tensor_proto, const MemBuffer& m, OrtValue& value,
                             OrtCallback& deleter) {
@@ -381,18 +435,20 @@ Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
       std::unique_ptr<ExternalDataInfo> external_data_info;
       ORT_RETURN_IF_ERROR(ExternalDataInfo::Create(tensor_proto.external_data(), external_data_info));
       std::basic_string<ORTCHAR_T> full_path;
-      if (tensor_proto_path != nullptr) {
-        ORT_RETURN_IF_ERROR(GetDirNameFromFilePath(tensor_proto_path, full_path));
-        full_path = ConcatPathComponent<ORTCHAR_T>(full_path, external_data_info->GetRelPath());
-      } else {
-        full_path = external_data_info->GetRelPath();
-      }
+      ORT_RETURN_IF_ERROR(GetExternalDataPath(tensor_proto_path, *external_data_info, full_path));
       raw_data_len = external_data_info->GetLength();
-      // load the file
+      // map the file. the tensor uses the mapped pages in place if they are suitably aligned, so weights are only
+      // read from disk when they are first used and are shared by all the sessions that load the same file.
       {
         void* file_data;
-        ORT_RETURN_IF_ERROR(env.ReadFileAsString(full_path.c_str(), external_data_info->GetOffset(),
-                                                 file_data, raw_data_len, deleter_for_file_data.d));
+        Status st = env.MapFileIntoMemory(full_path.c_str(), external_data_info->GetOffset(), raw_data_len,
+                                          file_data, deleter_for_file_data.d);
+        if (!st.IsOK()) {
+          LOGS_DEFAULT(WARNING) << "Failed to map the external data of " << tensor_proto.name()
+                                << ", reading it instead: " << st.ErrorMessage();
+          ORT_RETURN_IF_ERROR(env.ReadFileAsString(full_path.c_str(), external_data_info->GetOffset(),
+                                                   file_data, raw_data_len, deleter_for_file_data.d));
+        }
         raw_data = file_data;
       }
     } else if (utils::HasRawData(tensor_proto)) {
@@ -401,7 +457,8 @@ Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
       raw_data = tensor_proto.raw_data().data();
       raw_data_len = tensor_proto.raw_data().size();
     }
-    if (IsLittleEndianOrder() && raw_data != nullptr && deleter_for_file_data.d.f != nullptr) {
+    if (IsLittleEndianOrder() && raw_data != nullptr && deleter_for_file_data.d.f != nullptr &&
+        reinterpret_cast<uintptr_t>(raw_data) % type->Size() == 0) {
       tensor_data = const_cast<void*>(raw_data);
       MoveOrtCallback(deleter_for_file_data.d, deleter);
     } else {
@@ -34,6 +34,17 @@ TensorShape GetTensorShapeFromTensorShapeProto(const ONNX_NAMESPACE::TensorShape
 common::Status TensorProtoToMLValue(const Env& env, const ORTCHAR_T* tensor_proto_path,
                                     const ONNX_NAMESPACE::TensorProto& input, const MemBuffer& m, OrtValue& value,
                                     OrtCallback& deleter);
+/**
+ * Reads the external data of 'tensor_proto' into 'raw_data'.
+ * \param tensor_proto_path Same as for TensorProtoToMLValue. If null, the external data location is used as it is.
+ */
+common::Status ReadExternalData(const Env& env, const ORTCHAR_T* tensor_proto_path,
+                                const ONNX_NAMESPACE::TensorProto& tensor_proto, std::string& raw_data);
+
+// Whether TensorProtoToMLValue will use the external data of 'tensor_proto' in place, from a read-only mapping of
+// the file it's stored in. Such tensors don't need a preallocated buffer.
+bool CanUseExternalDataInPlace(const ONNX_NAMESPACE::TensorProto& tensor_proto);
+
 // This function doesn't support string tensors
 ONNX_NAMESPACE::TensorProto::DataType GetTensorProtoType(const Tensor& tensor);
 
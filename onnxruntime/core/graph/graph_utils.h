@@ -70,6 +70,10 @@ const std::string& GetNodeInputName(const Node& node, int index);
 /** Gets the name of the outgoing NodeArg with the specified index for the given node. */
 const std::string& GetNodeOutputName(const Node& node, int index);
 
+/** Gets the node producing the input with the specified index for the given node.
+@returns nullptr if the input is a graph input or an initializer. */
+const Node* GetInputNode(const Node& node, int index);
+
 /** Returns the attribute of a Node with a given name. */
 const ONNX_NAMESPACE::AttributeProto* GetNodeAttribute(const Node& node, const std::string& attr_name);
 
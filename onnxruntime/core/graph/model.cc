@@ -3,6 +3,9 @@
 
 #include "core/framework/tensorprotoutils.h"
 #include "core/graph/model.h"
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
 #include <memory>
 #include "core/common/logging/logging.h"
 
@@ -19,6 +22,8 @@
 
 #include "gsl/gsl"
 
+#include "core/framework/callback.h"
+#include "core/framework/path_lib.h"
 #include "core/platform/env.h"
 #include "core/graph/schema_registry.h"
 using namespace ONNX_NAMESPACE;
@@ -307,13 +312,74 @@ static Status LoadModel(const T& file_path, std::shared_ptr<Model>& p_model, con
   return Env::Default().FileClose(fd);
 }
 
+// Model::LoadMapped leaves large initializers in the model file, which they reference by absolute path. Only the
+// model file itself may do that, so a saved copy gets their data inline.
+static Status InlineMappedInitializers(const std::basic_string<ORTCHAR_T>& model_path, ModelProto& model_proto) {
+  if (model_path.empty()) {
+    return Status::OK();
+  }
+
+  for (auto& tensor : *model_proto.mutable_graph()->mutable_initializer()) {
+    if (tensor.data_location() != TensorProto_DataLocation_EXTERNAL) {
+      continue;
+    }
+    const auto& entries = tensor.external_data();
+    const auto location = std::find_if(entries.begin(), entries.end(), [](const StringStringEntryProto& entry) {
+      return entry.key() == "location";
+    });
+    if (location == entries.end() || !IsAbsolutePath(ToWideString(location->value()))) {
+      continue;
+    }
+
+    std::string raw_data;
+    ORT_RETURN_IF_ERROR(utils::ReadExternalData(Env::Default(), model_path.c_str(), tensor, raw_data));
+    tensor.clear_external_data();
+    tensor.clear_data_location();
+    tensor.set_raw_data(std::move(raw_data));
+  }
+  return Status::OK();
+}
+
+static Status SaveModelToFd(Model& model, int p_fd, const ModelMetaData* metadata) {
+  if (p_fd < 0) {
+    return Status(ONNXRUNTIME, INVALID_ARGUMENT, "<p_fd> is less than 0.");
+  }
+
+  ORT_RETURN_IF_ERROR(model.MainGraph().Resolve());
+
+  auto model_proto = model.ToProto();
+  ORT_RETURN_IF_ERROR(InlineMappedInitializers(model.MainGraph().ModelPath(), model_proto));
+  if (metadata != nullptr) {
+    for (const auto& entry : *metadata) {
+      StringStringEntryProto* prop = nullptr;
+      for (auto& existing : *model_proto.mutable_metadata_props()) {
+        if (existing.key() == entry.first) {
+          prop = &existing;
+          break;
+        }
+      }
+      if (prop == nullptr) {
+        prop = model_proto.add_metadata_props();
+        prop->set_key(entry.first);
+      }
+      prop->set_value(entry.second);
+    }
+  }
+  google::protobuf::io::FileOutputStream output(p_fd);
+  const bool result = model_proto.SerializeToZeroCopyStream(&output) && output.Flush();
+  if (result) {
+    return Status::OK();
+  }
+  return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Protobuf serialization failed.");
+}
+
 template <typename T>
-static Status SaveModel(Model& model, const T& file_path) {
+static Status SaveModel(Model& model, const T& file_path, const ModelMetaData* metadata = nullptr) {
   int fd;
   Status status = Env::Default().FileOpenWr(file_path, fd);
   ORT_RETURN_IF_ERROR(status);
   try {
-    status = Model::Save(model, fd);
+    status = SaveModelToFd(model, fd, metadata);
   } catch (std::exception& ex) {
     GSL_SUPPRESS(es .84)
     ORT_IGNORE_RETURN_VALUE(Env::Default().FileClose(fd));
@@ -331,7 +397,9 @@ static Status SaveModel(Model& model, const T& file_path) {
 GSL_SUPPRESS(r .30)  // spurious warnings. p_model is potentially reset in the internal call to Load
 GSL_SUPPRESS(r .35)
 Status Model::Load(const std::wstring& file_path, std::shared_ptr<Model>& p_model, const IOnnxRuntimeOpSchemaRegistryList* local_registries) {
-  return LoadModel(file_path, p_model, local_registries);
+  ORT_RETURN_IF_ERROR(LoadModel(file_path, p_model, local_registries));
+  p_model->graph_->model_path_ = file_path;
+  return Status::OK();
 }
 
 Status Model::Save(Model& model, const std::wstring& file_path) {
@@ -343,7 +411,9 @@ Status Model::Save(Model& model, const std::wstring& file_path) {
 GSL_SUPPRESS(r .30)  // spurious warnings. p_model is potentially reset in the internal call to Load
 GSL_SUPPRESS(r .35)
 Status Model::Load(const std::string& file_path, std::shared_ptr<Model>& p_model, const IOnnxRuntimeOpSchemaRegistryList* local_registries) {
-  return LoadModel(file_path, p_model, local_registries);
+  ORT_RETURN_IF_ERROR(LoadModel(file_path, p_model, local_registries));
+  p_model->graph_->model_path_ = ToWideString(file_path);
+  return Status::OK();
 }
 
 Status Model::Save(Model& model, const std::string& file_path) {
@@ -364,6 +434,215 @@ Status Model::LoadFromBytes(int count, void* p_bytes, /*out*/ std::shared_ptr<Mo
   return Status::OK();
 }
 
+namespace {
+
+// Minimal protobuf wire format reader/writer, used to drop the raw data of initializers from a serialized model
+// without parsing the model.
+enum WireType { kVarint = 0, kFixed64 = 1, kLengthDelimited = 2, kFixed32 = 5 };
+
+constexpr uint32_t kModelGraphField = 7;          // ModelProto.graph
+constexpr uint32_t kGraphInitializerField = 5;    // GraphProto.initializer
+constexpr uint32_t kTensorDataTypeField = 2;      // TensorProto.data_type
+constexpr uint32_t kTensorRawDataField = 9;       // TensorProto.raw_data
+constexpr uint32_t kTensorExternalDataField = 13;  // TensorProto.external_data
+constexpr uint32_t kTensorDataLocationField = 14;  // TensorProto.data_location
+constexpr uint32_t kEntryKeyField = 1;            // StringStringEntryProto.key
+constexpr uint32_t kEntryValueField = 2;          // StringStringEntryProto.value
+
+bool ReadVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value) {
+  value = 0;
+  for (int shift = 0; shift < 64 && p < end; shift += 7) {
+    const uint8_t byte = *p++;
+    value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+    if ((byte & 0x80) == 0) return true;
+  }
+  return false;
+}
+
+void WriteVarint(uint64_t value, std::string& out) {
+  while (value >= 0x80) {
+    out.push_back(static_cast<char>((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out.push_back(static_cast<char>(value));
+}
+
+void WriteLengthDelimited(uint32_t field, const std::string& value, std::string& out) {
+  WriteVarint((static_cast<uint64_t>(field) << 3) | kLengthDelimited, out);
+  WriteVarint(value.size(), out);
+  out.append(value);
+}
+
+struct Field {
+  uint32_t number;
+  uint32_t wire_type;
+  const uint8_t* begin;  // start of the tag
+  const uint8_t* value;  // start of the value, after the length of length-delimited fields
+  const uint8_t* end;
+  uint64_t varint;  // value of varint fields
+};
+
+// Reads the field at 'p' and moves 'p' past it. Groups are not supported: ONNX doesn't use them.
+bool ReadField(const uint8_t*& p, const uint8_t* end, Field& field) {
+  field.begin = p;
+  uint64_t tag;
+  if (!ReadVarint(p, end, tag)) return false;
+  field.number = static_cast<uint32_t>(tag >> 3);
+  field.wire_type = static_cast<uint32_t>(tag & 7);
+  field.varint = 0;
+  size_t len;
+  switch (field.wire_type) {
+    case kVarint:
+      field.value = p;
+      if (!ReadVarint(p, end, field.varint)) return false;
+      field.end = p;
+      return true;
+    case kFixed64:
+      len = 8;
+      break;
+    case kFixed32:
+      len = 4;
+      break;
+    case kLengthDelimited: {
+      uint64_t value_len;
+      if (!ReadVarint(p, end, value_len) || value_len > static_cast<uint64_t>(end - p)) return false;
+      len = static_cast<size_t>(value_len);
+      break;
+    }
+    default:
+      return false;
+  }
+  if (len > static_cast<size_t>(end - p)) return false;
+  field.value = p;
+  p += len;
+  field.end = p;
+  return true;
+}
+
+struct ExternalDataRewriter {
+  const uint8_t* file_begin;
+  std::string location;
+  size_t min_external_bytes;
+
+  bool RewriteTensor(const uint8_t* p, const uint8_t* end, std::string& out) const {
+    const uint8_t* raw_data = nullptr;
+    size_t raw_data_len = 0;
+    uint64_t data_type = TensorProto_DataType_UNDEFINED;
+    for (const uint8_t* q = p; q < end;) {
+      Field field;
+      if (!ReadField(q, end, field)) return false;
+      if (field.number == kTensorRawDataField && field.wire_type == kLengthDelimited) {
+        raw_data = field.value;
+        raw_data_len = static_cast<size_t>(field.end - field.value);
+      } else if (field.number == kTensorDataTypeField && field.wire_type == kVarint) {
+        data_type = field.varint;
+      }
+    }
+
+    if (raw_data == nullptr || raw_data_len < min_external_bytes || data_type == TensorProto_DataType_STRING) {
+      out.append(reinterpret_cast<const char*>(p), end - p);
+      return true;
+    }
+
+    for (const uint8_t* q = p; q < end;) {
+      Field field;
+      ReadField(q, end, field);
+      if (field.number != kTensorRawDataField) {
+        out.append(reinterpret_cast<const char*>(field.begin), field.end - field.begin);
+      }
+    }
+    const std::pair<const char*, std::string> entries[] = {
+        {"location", location},
+        {"offset", std::to_string(raw_data - file_begin)},
+        {"length", std::to_string(raw_data_len)}};
+    for (const auto& entry : entries) {
+      std::string entry_bytes;
+      WriteLengthDelimited(kEntryKeyField, entry.first, entry_bytes);
+      WriteLengthDelimited(kEntryValueField, entry.second, entry_bytes);
+      WriteLengthDelimited(kTensorExternalDataField, entry_bytes, out);
+    }
+    // the last occurrence of a scalar field wins, so this overrides any data_location already set
+    WriteVarint((static_cast<uint64_t>(kTensorDataLocationField) << 3) | kVarint, out);
+    WriteVarint(TensorProto_DataLocation_EXTERNAL, out);
+    return true;
+  }
+
+  // Copies the message in [p, end) to 'out', rewriting the length-delimited fields numbered 'field_number' with
+  // 'rewrite'.
+  template <typename TRewrite>
+  bool RewriteFields(const uint8_t* p, const uint8_t* end, uint32_t field_number, TRewrite rewrite,
+                     std::string& out) const {
+    while (p < end) {
+      Field field;
+      if (!ReadField(p, end, field)) return false;
+      if (field.number != field_number || field.wire_type != kLengthDelimited) {
+        out.append(reinterpret_cast<const char*>(field.begin), field.end - field.begin);
+        continue;
+      }
+      std::string value;
+      if (!rewrite(field.value, field.end, value)) return false;
+      WriteLengthDelimited(field_number, value, out);
+    }
+    return true;
+  }
+
+  bool RewriteTensors(const uint8_t* p, const uint8_t* end, std::string& out) const {
+    return RewriteFields(p, end, kGraphInitializerField,
+                         [this](const uint8_t* tensor, const uint8_t* tensor_end, std::string& tensor_out) {
+                           return RewriteTensor(tensor, tensor_end, tensor_out);
+                         },
+                         out);
+  }
+
+  // Only the initializers of the main graph are rewritten. Those of subgraphs stay inline.
+  bool RewriteModel(const uint8_t* p, const uint8_t* end, std::string& out) const {
+    return RewriteFields(p, end, kModelGraphField,
+                         [this](const uint8_t* graph, const uint8_t* graph_end, std::string& graph_out) {
+                           return RewriteTensors(graph, graph_end, graph_out);
+                         },
+                         out);
+  }
+};
+
+}  // namespace
+
+Status Model::LoadMapped(const std::basic_string<ORTCHAR_T>& file_path, std::shared_ptr<Model>& p_model,
+                         const IOnnxRuntimeOpSchemaRegistryList* local_registries, size_t min_external_bytes) {
+  ExternalDataRewriter rewriter;
+  rewriter.min_external_bytes = min_external_bytes;
+  std::basic_string<ORTCHAR_T> absolute_path;
+  ORT_RETURN_IF_ERROR(GetAbsolutePath(file_path, absolute_path));
+  rewriter.location = ToMBString(absolute_path);
+
+  size_t len = 0;
+  void* file_data;
+  OrtCallback unmap;
+  ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(file_path.c_str(), 0, len, file_data, unmap));
+  const auto unmap_file = gsl::finally([&unmap]() {
+    if (unmap.f != nullptr) unmap.f(unmap.param);
+  });
+
+  const auto* begin = static_cast<const uint8_t*>(file_data);
+  rewriter.file_begin = begin;
+  std::string model_bytes;
+  if (!rewriter.RewriteModel(begin, begin + len, model_bytes)) {
+    return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Protobuf parsing failed.");
+  }
+  if (model_bytes.size() > static_cast<size_t>(std::numeric_limits<int>::max())) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_PROTOBUF, "The model is larger than 2GB without its large initializers.");
+  }
+
+  std::unique_ptr<ModelProto> model_proto = onnxruntime::make_unique<ModelProto>();
+  if (!model_proto->ParseFromArray(model_bytes.data(), static_cast<int>(model_bytes.size()))) {
+    return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Protobuf parsing failed.");
+  }
+
+  p_model = std::make_shared<Model>(std::move(model_proto), local_registries);
+  p_model->graph_->model_path_ = file_path;
+  ORT_RETURN_IF_ERROR(p_model->MainGraph().Resolve(true));
+  return Status::OK();
+}
+
 using ::google::protobuf::io::CodedInputStream;
 using ::google::protobuf::io::FileInputStream;
 using ::google::protobuf::io::ZeroCopyInputStream;
@@ -402,18 +681,11 @@ Status Model::Load(int fd, std::shared_ptr<Model>& p_model, const IOnnxRuntimeOp
 }
 
 Status Model::Save(Model& model, int p_fd) {
-  if (p_fd < 0) {
-    return Status(ONNXRUNTIME, INVALID_ARGUMENT, "<p_fd> is less than 0.");
-  }
-
-  ORT_RETURN_IF_ERROR(model.MainGraph().Resolve());
+  return SaveModelToFd(model, p_fd, nullptr);
+}
 
-  auto model_proto = model.ToProto();
-  google::protobuf::io::FileOutputStream output(p_fd);
-  const bool result = model_proto.SerializeToZeroCopyStream(&output) && output.Flush();
-  if (result) {
-    return Status::OK();
-  }
-  return Status(ONNXRUNTIME, INVALID_PROTOBUF, "Protobuf serialization failed.");
+Status Model::SaveWithMetaData(Model& model, const std::basic_string<ORTCHAR_T>& file_path,
+                               const ModelMetaData& metadata) {
+  return SaveModel(model, file_path, &metadata);
 }
 }  // namespace onnxruntime
@@ -8,6 +8,7 @@
 #include <climits>
 #include <string>
 #include "core/graph/graph_viewer.h"
+#include "core/session/onnxruntime_c_api.h"
 
 #include "gsl/gsl"
 
@@ -97,6 +98,11 @@ class Model {
 
   static common::Status Save(Model& model, int fd);
 
+  // Save the model with 'metadata' added to the metadata properties of the saved copy, replacing existing values.
+  // The model itself is not changed.
+  static common::Status SaveWithMetaData(Model& model, const std::basic_string<ORTCHAR_T>& file_path,
+                                         const ModelMetaData& metadata);
+
   static common::Status Load(std::istream& model_istream, ONNX_NAMESPACE::ModelProto* p_model_proto);
 
   static common::Status Load(const std::string& file_path,
@@ -117,6 +123,17 @@ class Model {
                              /*out*/ std::shared_ptr<Model>& p_model,
                              const IOnnxRuntimeOpSchemaRegistryList* local_registries = nullptr);
 
+  /**
+   * Loads a model with its file memory-mapped. The raw data of the initializers of the main graph that are at least
+   * 'min_external_bytes' long is not copied into the ModelProto: the initializers reference it as external data in
+   * the model file, by absolute path, so sessions can map it and use it in place. Absolute external data locations
+   * are only accepted when they name the model file itself.
+   */
+  static common::Status LoadMapped(const std::basic_string<ORTCHAR_T>& file_path,
+                                   /*out*/ std::shared_ptr<Model>& p_model,
+                                   const IOnnxRuntimeOpSchemaRegistryList* local_registries = nullptr,
+                                   size_t min_external_bytes = 4096);
+
  private:
   // Model data.
   std::unique_ptr<ONNX_NAMESPACE::ModelProto> model_proto_;
@@ -128,6 +128,48 @@ MlasGemm(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Packed matrix/matrix multiply routines. Matrix B is packed once by
+// MlasGemmPackB into a buffer of MlasGemmPackBSize bytes aligned to
+// MlasGetPreferredBufferAlignment, and the buffer can then be shared by any
+// number of MlasGemm calls.
+//
+
+size_t
+MLASCALL
+MlasGemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+void
+MLASCALL
+MlasGemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const float* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+void
+MLASCALL
+MlasGemm(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    float beta,
+    float* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 void
 MLASCALL
 MlasGemm(
@@ -181,6 +223,58 @@ MlasGemm(
     MLAS_THREADPOOL* ThreadPool
     );
 
+//
+// Quantized matrix/matrix multiply routines with a requantizing output stage.
+// The int32 accumulators are written to C as above. Each block of C is then
+// offset by the bias of its row, scaled, offset by the zero point and
+// saturated into the uint8 matrix Output as soon as its reduction over K
+// completes, while the block is still in the cache.
+//
+
+struct MLAS_REQUANTIZE_OUTPUT {
+    uint8_t* Output;
+    size_t ldo;
+    const int32_t* Bias;
+    float Scale;
+    uint8_t ZeroPoint;
+};
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const int8_t* B,
+    size_t ldb,
+    int8_t offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_REQUANTIZE_OUTPUT* Requantize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_REQUANTIZE_OUTPUT* Requantize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Convolution routines.
 //
@@ -306,6 +400,51 @@ MlasComputeErf(
     size_t N
     );
 
+void
+MLASCALL
+MlasComputeExp(
+    const float* Input,
+    float* Output,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Transpose routines.
+//
+
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    size_t lda,
+    uint32_t* Output,
+    size_t ldb,
+    size_t M,
+    size_t N
+    );
+
+void
+MLASCALL
+MlasTranspose(
+    const uint8_t* Input,
+    size_t lda,
+    uint8_t* Output,
+    size_t ldb,
+    size_t M,
+    size_t N
+    );
+
 //
 // Half-precision floating-point routines.
 //
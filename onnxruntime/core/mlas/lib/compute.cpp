@@ -0,0 +1,591 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    compute.cpp
+
+Abstract:
+
+    This module implements miscellaneous computation routines.
+
+    The exponential function uses a Cody-Waite range reduction followed by the
+    same minimax polynomial as found in Cephes. The softmax routines are built
+    on top of the exponential function and compute a single pass per row for
+    the maximum and a second pass for the exponentials and their sum.
+
+--*/
+
+#include "mlasi.h"
+
+#include <cmath>
+
+//
+// Bundles the floating point constants of the exponential function.
+//
+
+static const struct {
+    float LowerRange;
+    float UpperRange;
+    float RoundingBias;
+    float Log2Reciprocal;
+    float Log2High;
+    float Log2Low;
+    float poly_0;
+    float poly_1;
+    float poly_2;
+    float poly_3;
+    float poly_4;
+    float poly_5;
+    float poly_6;
+} MlasExpConstants = {
+    -87.3365447505f,
+    88.0f,
+    12582912.0f,
+    1.44269504088896341f,
+    -6.93359375e-1f,
+    2.12194440e-4f,
+    1.9875691500e-4f,
+    1.3981999507e-3f,
+    8.3334519073e-3f,
+    4.1665795894e-2f,
+    1.6666665459e-1f,
+    5.0000001201e-1f,
+    1.0f,
+};
+
+MLAS_FORCEINLINE
+MLAS_FLOAT32X4
+MlasComputeExpVector(
+    MLAS_FLOAT32X4 Vector
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function for four elements.
+
+Arguments:
+
+    Vector - Supplies the input vector.
+
+Return Value:
+
+    Returns the exponential of each element of the input vector.
+
+--*/
+{
+    Vector = MlasMaximumFloat32x4(MlasBroadcastFloat32x4(MlasExpConstants.LowerRange), Vector);
+    Vector = MlasMinimumFloat32x4(MlasBroadcastFloat32x4(MlasExpConstants.UpperRange), Vector);
+
+    //
+    // Range reduce the input to exp(x) = 2^m * exp(r) where m is the input
+    // rounded to the nearest multiple of ln(2).
+    //
+
+    MLAS_FLOAT32X4 RoundingBias = MlasBroadcastFloat32x4(MlasExpConstants.RoundingBias);
+    MLAS_FLOAT32X4 m = MlasMultiplyAddFloat32x4(Vector, MlasBroadcastFloat32x4(MlasExpConstants.Log2Reciprocal), RoundingBias);
+    m = MlasSubtractFloat32x4(m, RoundingBias);
+
+    MLAS_FLOAT32X4 r = MlasMultiplyAddFloat32x4(m, MlasBroadcastFloat32x4(MlasExpConstants.Log2High), Vector);
+    r = MlasMultiplyAddFloat32x4(m, MlasBroadcastFloat32x4(MlasExpConstants.Log2Low), r);
+
+    MLAS_FLOAT32X4 p;
+    p = MlasMultiplyAddFloat32x4(r, MlasBroadcastFloat32x4(MlasExpConstants.poly_0), MlasBroadcastFloat32x4(MlasExpConstants.poly_1));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_2));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_3));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_4));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_5));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_6));
+    p = MlasMultiplyAddFloat32x4(p, r, MlasBroadcastFloat32x4(MlasExpConstants.poly_6));
+
+    return MlasMultiplyFloat32x4(p, MlasPowerOf2Float32x4(m));
+}
+
+MLAS_FORCEINLINE
+float
+MlasComputeExpScalar(
+    float Value
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function for a single element using
+    the same algorithm as the vector form.
+
+Arguments:
+
+    Value - Supplies the input value.
+
+Return Value:
+
+    Returns the exponential of the input value.
+
+--*/
+{
+    Value = (std::min)(MlasExpConstants.UpperRange, (std::max)(MlasExpConstants.LowerRange, Value));
+
+    float m = std::nearbyint(Value * MlasExpConstants.Log2Reciprocal);
+
+    float r = m * MlasExpConstants.Log2High + Value;
+    r = m * MlasExpConstants.Log2Low + r;
+
+    float p;
+    p = r * MlasExpConstants.poly_0 + MlasExpConstants.poly_1;
+    p = p * r + MlasExpConstants.poly_2;
+    p = p * r + MlasExpConstants.poly_3;
+    p = p * r + MlasExpConstants.poly_4;
+    p = p * r + MlasExpConstants.poly_5;
+    p = p * r + MlasExpConstants.poly_6;
+    p = p * r + MlasExpConstants.poly_6;
+
+    return std::ldexp(p, int(m));
+}
+
+void
+MLASCALL
+MlasComputeExp(
+    const float* Input,
+    float* Output,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the exponential function.
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    Output - Supplies the output buffer.
+
+    N - Supplies the number of elements to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (N >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasComputeExpVector(MlasLoadFloat32x4(Input)));
+
+        Input += 4;
+        Output += 4;
+        N -= 4;
+    }
+
+    while (N > 0) {
+
+        *Output++ = MlasComputeExpScalar(*Input++);
+
+        N -= 1;
+    }
+}
+
+float
+MlasComputeMaximumRow(
+    const float* Input,
+    size_t D
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the maximum value of a row.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    D - Supplies the number of elements in the row.
+
+Return Value:
+
+    Returns the maximum value of the row.
+
+--*/
+{
+    float Maximum = std::numeric_limits<float>::lowest();
+
+    if (D >= 4) {
+
+        MLAS_FLOAT32X4 MaximumVector0 = MlasBroadcastFloat32x4(Maximum);
+
+        if (D >= 16) {
+
+            MLAS_FLOAT32X4 MaximumVector1 = MaximumVector0;
+            MLAS_FLOAT32X4 MaximumVector2 = MaximumVector0;
+            MLAS_FLOAT32X4 MaximumVector3 = MaximumVector0;
+
+            while (D >= 16) {
+
+                MaximumVector0 = MlasMaximumFloat32x4(MaximumVector0, MlasLoadFloat32x4(Input));
+                MaximumVector1 = MlasMaximumFloat32x4(MaximumVector1, MlasLoadFloat32x4(Input + 4));
+                MaximumVector2 = MlasMaximumFloat32x4(MaximumVector2, MlasLoadFloat32x4(Input + 8));
+                MaximumVector3 = MlasMaximumFloat32x4(MaximumVector3, MlasLoadFloat32x4(Input + 12));
+
+                Input += 16;
+                D -= 16;
+            }
+
+            MaximumVector0 = MlasMaximumFloat32x4(MaximumVector0, MaximumVector1);
+            MaximumVector2 = MlasMaximumFloat32x4(MaximumVector2, MaximumVector3);
+            MaximumVector0 = MlasMaximumFloat32x4(MaximumVector0, MaximumVector2);
+        }
+
+        while (D >= 4) {
+
+            MaximumVector0 = MlasMaximumFloat32x4(MaximumVector0, MlasLoadFloat32x4(Input));
+
+            Input += 4;
+            D -= 4;
+        }
+
+        Maximum = MlasReduceMaximumFloat32x4(MaximumVector0);
+    }
+
+    while (D > 0) {
+
+        Maximum = (std::max)(Maximum, *Input);
+
+        Input += 1;
+        D -= 1;
+    }
+
+    return Maximum;
+}
+
+float
+MlasComputeSumExpRow(
+    const float* Input,
+    float* Output,
+    size_t D,
+    float NegativeMaximum
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the sum of the exponentials of a row after shifting
+    each element by the negated row maximum.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    Output - Optionally supplies the output row to store the exponentials.
+
+    D - Supplies the number of elements in the row.
+
+    NegativeMaximum - Supplies the negated maximum value of the row.
+
+Return Value:
+
+    Returns the sum of the exponentials.
+
+--*/
+{
+    MLAS_FLOAT32X4 NegativeMaximumVector = MlasBroadcastFloat32x4(NegativeMaximum);
+    MLAS_FLOAT32X4 AccumulatorVector = MlasZeroFloat32x4();
+
+    while (D >= 4) {
+
+        MLAS_FLOAT32X4 Vector = MlasComputeExpVector(MlasAddFloat32x4(MlasLoadFloat32x4(Input), NegativeMaximumVector));
+
+        AccumulatorVector = MlasAddFloat32x4(AccumulatorVector, Vector);
+
+        if (Output != nullptr) {
+            MlasStoreFloat32x4(Output, Vector);
+            Output += 4;
+        }
+
+        Input += 4;
+        D -= 4;
+    }
+
+    float Accumulator = MlasReduceAddFloat32x4(AccumulatorVector);
+
+    while (D > 0) {
+
+        float Value = MlasComputeExpScalar(*Input + NegativeMaximum);
+
+        Accumulator += Value;
+
+        if (Output != nullptr) {
+            *Output++ = Value;
+        }
+
+        Input += 1;
+        D -= 1;
+    }
+
+    return Accumulator;
+}
+
+void
+MlasComputeSoftmaxOutputRow(
+    float* Output,
+    size_t D,
+    float Scale
+    )
+/*++
+
+Routine Description:
+
+    This routine scales the exponentials of a row by the reciprocal of their
+    sum to produce the softmax output.
+
+Arguments:
+
+    Output - Supplies the output row holding the exponentials.
+
+    D - Supplies the number of elements in the row.
+
+    Scale - Supplies the reciprocal of the sum of the exponentials.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 ScaleVector = MlasBroadcastFloat32x4(Scale);
+
+    while (D >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasMultiplyFloat32x4(MlasLoadFloat32x4(Output), ScaleVector));
+
+        Output += 4;
+        D -= 4;
+    }
+
+    while (D > 0) {
+
+        *Output++ *= Scale;
+
+        D -= 1;
+    }
+}
+
+void
+MlasComputeLogSoftmaxOutputRow(
+    const float* Input,
+    float* Output,
+    size_t D,
+    float Bias
+    )
+/*++
+
+Routine Description:
+
+    This routine shifts the elements of a row by the negated maximum and the
+    logarithm of the sum of the exponentials to produce the log softmax
+    output.
+
+Arguments:
+
+    Input - Supplies the input row.
+
+    Output - Supplies the output row.
+
+    D - Supplies the number of elements in the row.
+
+    Bias - Supplies the negated sum of the row maximum and the logarithm of
+        the sum of the exponentials.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MLAS_FLOAT32X4 BiasVector = MlasBroadcastFloat32x4(Bias);
+
+    while (D >= 4) {
+
+        MlasStoreFloat32x4(Output, MlasAddFloat32x4(MlasLoadFloat32x4(Input), BiasVector));
+
+        Input += 4;
+        Output += 4;
+        D -= 4;
+    }
+
+    while (D > 0) {
+
+        *Output++ = *Input++ + Bias;
+
+        D -= 1;
+    }
+}
+
+struct MLAS_SOFTMAX_WORK_BLOCK {
+    int32_t ThreadCountN;
+    bool LogSoftmax;
+    const float* Input;
+    float* Output;
+    size_t N;
+    size_t D;
+};
+
+void
+MlasComputeSoftmaxThreaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    softmax or log softmax operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_SOFTMAX_WORK_BLOCK*)Context;
+
+    //
+    // Partition the operation along the N dimension.
+    //
+
+    const size_t N = WorkBlock->N;
+    const size_t D = WorkBlock->D;
+
+    const size_t WorkPerThread = N / WorkBlock->ThreadCountN;
+    const size_t WorkPerThreadExtra = N % WorkBlock->ThreadCountN;
+
+    size_t n;
+    size_t CountN;
+
+    if (uint32_t(Index) < WorkPerThreadExtra) {
+        n = (WorkPerThread + 1) * Index;
+        CountN = WorkPerThread + 1;
+    } else {
+        n = WorkPerThread * Index + WorkPerThreadExtra;
+        CountN = WorkPerThread;
+    }
+
+    //
+    // Compute the softmax or log softmax function.
+    //
+
+    const float* Input = WorkBlock->Input + n * D;
+    float* Output = WorkBlock->Output + n * D;
+
+    while (CountN > 0) {
+
+        const float Maximum = MlasComputeMaximumRow(Input, D);
+
+        if (WorkBlock->LogSoftmax) {
+
+            const float Accumulation = MlasComputeSumExpRow(Input, nullptr, D, -Maximum);
+
+            MlasComputeLogSoftmaxOutputRow(Input, Output, D, -Maximum - std::log(Accumulation));
+
+        } else {
+
+            const float Accumulation = MlasComputeSumExpRow(Input, Output, D, -Maximum);
+
+            MlasComputeSoftmaxOutputRow(Output, D, 1.0f / Accumulation);
+        }
+
+        Input += D;
+        Output += D;
+        CountN--;
+    }
+}
+
+void
+MLASCALL
+MlasComputeSoftmax(
+    const float* Input,
+    float* Output,
+    size_t N,
+    size_t D,
+    bool LogSoftmax,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the softmax or log softmax function along the
+    innermost dimension of a two dimensional input.
+
+Arguments:
+
+    Input - Supplies the input buffer of N rows with D elements per row.
+
+    Output - Supplies the output buffer. The buffer may be the same as the
+        input buffer.
+
+    N - Supplies the number of rows to process.
+
+    D - Supplies the number of elements per row.
+
+    LogSoftmax - Supplies true if the log softmax function should be computed
+        instead of the softmax function.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (N == 0 || D == 0) {
+        return;
+    }
+
+    MLAS_SOFTMAX_WORK_BLOCK WorkBlock;
+
+    WorkBlock.LogSoftmax = LogSoftmax;
+    WorkBlock.Input = Input;
+    WorkBlock.Output = Output;
+    WorkBlock.N = N;
+    WorkBlock.D = D;
+
+    //
+    // Compute the number of target threads given the complexity of the
+    // operation. Limit the number of threads to the number of rows.
+    //
+
+    const double Complexity = double(N) * double(D);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_SOFTMAX_THREAD_COMPLEXITY) * double(N)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_SOFTMAX_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = int32_t((std::min)(N, size_t(std::numeric_limits<int32_t>::max())));
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    WorkBlock.ThreadCountN = TargetThreadCount;
+
+    MlasExecuteThreaded(MlasComputeSoftmaxThreaded, &WorkBlock, TargetThreadCount, ThreadPool);
+}
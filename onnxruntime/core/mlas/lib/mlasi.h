@@ -120,6 +120,15 @@ Abstract:
 #define MLAS_DGEMM_STRIDEN                          64
 #define MLAS_DGEMM_STRIDEK                          128
 
+//
+// Define the strides to step through slices of a packed matrix B. The packed
+// buffer is used in place by the kernels, so these are not limited by the
+// size of a local panel buffer.
+//
+
+#define MLAS_SGEMM_PACKED_STRIDEN                   128
+#define MLAS_SGEMM_PACKED_STRIDEK                   256
+
 //
 // Define the alignment for segmenting a GEMM operation across multiple
 // threads.
@@ -131,6 +140,7 @@ Abstract:
 
 #define MLAS_SGEMM_STRIDEN_THREAD_ALIGN             16
 #define MLAS_DGEMM_STRIDEN_THREAD_ALIGN             8
+#define MLAS_QGEMM_STRIDEN_THREAD_ALIGN             16
 
 //
 // Define the prototypes of the platform optimized routines.
@@ -571,6 +581,20 @@ extern "C" {
 
 #define MLAS_DGEMM_THREAD_COMPLEXITY                (64 * 1024)
 
+//
+// The integer kernels retire several times more multiplies per cycle than
+// the SGEMM kernels, so each thread is given proportionally more work.
+//
+
+#define MLAS_QGEMM_THREAD_COMPLEXITY                (4 * MLAS_SGEMM_THREAD_COMPLEXITY)
+
+//
+// Define the target number of per-thread elements for the row oriented
+// softmax routines before using another thread to perform additional work.
+//
+
+#define MLAS_SOFTMAX_THREAD_COMPLEXITY              (16 * 1024)
+
 //
 // Single-threaded single precision matrix/matrix multiply operation.
 //
@@ -997,6 +1021,42 @@ MlasPowerOf2Float32x4(MLAS_FLOAT32X4 Vector)
 #endif
 }
 
+inline
+float
+MlasReduceAddFloat32x4(MLAS_FLOAT32X4 Vector)
+{
+#if defined(MLAS_NEON64_INTRINSICS)
+    Vector = vpaddq_f32(Vector, Vector);
+    Vector = vpaddq_f32(Vector, Vector);
+    return vgetq_lane_f32(Vector, 0);
+#elif defined(MLAS_NEON32_INTRINSICS)
+    float32x2_t VectorLow = vpadd_f32(vget_low_f32(Vector), vget_high_f32(Vector));
+    VectorLow = vpadd_f32(VectorLow, VectorLow);
+    return vget_lane_f32(VectorLow, 0);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    Vector = _mm_add_ps(Vector, _mm_movehl_ps(Vector, Vector));
+    Vector = _mm_add_ss(Vector, _mm_shuffle_ps(Vector, Vector, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(Vector);
+#endif
+}
+
+inline
+float
+MlasReduceMaximumFloat32x4(MLAS_FLOAT32X4 Vector)
+{
+#if defined(MLAS_NEON64_INTRINSICS)
+    return vmaxvq_f32(Vector);
+#elif defined(MLAS_NEON32_INTRINSICS)
+    float32x2_t VectorLow = vpmax_f32(vget_low_f32(Vector), vget_high_f32(Vector));
+    VectorLow = vpmax_f32(VectorLow, VectorLow);
+    return vget_lane_f32(VectorLow, 0);
+#elif defined(MLAS_SSE2_INTRINSICS)
+    Vector = _mm_max_ps(Vector, _mm_movehl_ps(Vector, Vector));
+    Vector = _mm_max_ss(Vector, _mm_shuffle_ps(Vector, Vector, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_cvtss_f32(Vector);
+#endif
+}
+
 //
 // Cross-platform wrappers for 64-bit vector intrinsics.
 //
@@ -1100,22 +1100,214 @@ Return Value:
     return 1;
 }
 
+//
+// Define the parameters to execute a quantized GEMM operation across threads.
+//
+
+template<typename BType>
+struct MLAS_GEMM_U8X8_WORK_BLOCK {
+    int32_t ThreadCountM;
+    int32_t ThreadCountN;
+    size_t M;
+    size_t N;
+    size_t K;
+    const uint8_t* A;
+    size_t lda;
+    const BType* B;
+    size_t ldb;
+    int32_t* C;
+    size_t ldc;
+    uint8_t offa;
+    BType offb;
+    const MLAS_REQUANTIZE_OUTPUT* Requantize;
+};
+
 void
-MLASCALL
-MlasGemm(
-    size_t M,
-    size_t N,
-    size_t K,
-    const uint8_t* A,
-    size_t lda,
-    uint8_t offa,
-    const int8_t* B,
-    size_t ldb,
-    int8_t offb,
-    int32_t* C,
-    size_t ldc,
-    MLAS_THREADPOOL* ThreadPool
+MlasRequantizeOutput(
+    const int32_t* Input,
+    size_t ldi,
+    uint8_t* Output,
+    size_t ldo,
+    const int32_t* Bias,
+    size_t CountM,
+    size_t CountN,
+    float Scale,
+    uint8_t ZeroPoint
+    )
+/*++
+
+Routine Description:
+
+    This routine requantizes a block of the int32 output of a QGEMM operation
+    to uint8 values: each element is offset by the bias of its row, scaled,
+    rounded to nearest even, offset by the zero point and saturated.
+
+    The scaled values are clamped to the output range in floating point, as
+    values beyond the int32 range would otherwise convert to INT_MIN and
+    saturate to zero.
+
+Arguments:
+
+    Input - Supplies the address of the int32 block.
+
+    ldi - Supplies the first dimension of the int32 block.
+
+    Output - Supplies the address of the uint8 block.
+
+    ldo - Supplies the first dimension of the uint8 block.
+
+    Bias - Optionally supplies the address of a vector of CountM bias values,
+        one per row of the block.
+
+    CountM - Supplies the number of rows of the block.
+
+    CountN - Supplies the number of columns of the block.
+
+    Scale - Supplies the scale to apply to the biased values.
+
+    ZeroPoint - Supplies the zero point of the uint8 output.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const __m128 ScaleVector = _mm_set1_ps(Scale);
+    const __m128 MinimumValueVector = _mm_set1_ps(float(0 - ZeroPoint));
+    const __m128 MaximumValueVector = _mm_set1_ps(float(255 - ZeroPoint));
+    const __m128i ZeroPointVector = _mm_set1_epi32(ZeroPoint);
+
+    auto Requantize = [&](__m128i Vector, __m128i BiasVector) {
+        Vector = _mm_add_epi32(Vector, BiasVector);
+        __m128 FloatVector = _mm_mul_ps(_mm_cvtepi32_ps(Vector), ScaleVector);
+        FloatVector = _mm_max_ps(FloatVector, MinimumValueVector);
+        FloatVector = _mm_min_ps(FloatVector, MaximumValueVector);
+        Vector = _mm_cvtps_epi32(FloatVector);
+        return _mm_add_epi32(Vector, ZeroPointVector);
+    };
+
+    for (size_t m = 0; m < CountM; m++) {
+
+        const __m128i BiasVector = _mm_set1_epi32((Bias != nullptr) ? Bias[m] : 0);
+
+        const int32_t* input = Input + m * ldi;
+        uint8_t* output = Output + m * ldo;
+        size_t n = CountN;
+
+        while (n >= 16) {
+
+            __m128i Vector0 = Requantize(_mm_loadu_si128((const __m128i*)&input[0]), BiasVector);
+            __m128i Vector1 = Requantize(_mm_loadu_si128((const __m128i*)&input[4]), BiasVector);
+            __m128i Vector2 = Requantize(_mm_loadu_si128((const __m128i*)&input[8]), BiasVector);
+            __m128i Vector3 = Requantize(_mm_loadu_si128((const __m128i*)&input[12]), BiasVector);
+
+            //
+            // Saturate to int16 and then to uint8, which clamps the values
+            // to the range of the output type.
+            //
+
+            Vector0 = _mm_packs_epi32(Vector0, Vector1);
+            Vector2 = _mm_packs_epi32(Vector2, Vector3);
+
+            _mm_storeu_si128((__m128i*)output, _mm_packus_epi16(Vector0, Vector2));
+
+            input += 16;
+            output += 16;
+            n -= 16;
+        }
+
+        while (n > 0) {
+
+            __m128i Vector = Requantize(_mm_cvtsi32_si128(*input), BiasVector);
+
+            Vector = _mm_packs_epi32(Vector, Vector);
+            Vector = _mm_packus_epi16(Vector, Vector);
+
+            *output = uint8_t(_mm_cvtsi128_si32(Vector));
+
+            input += 1;
+            output += 1;
+            n -= 1;
+        }
+    }
+}
+
+template<typename BType>
+MLAS_FORCEINLINE
+void
+MlasGemmU8X8RequantizeBlock(
+    const MLAS_GEMM_U8X8_WORK_BLOCK<BType>* WorkBlock,
+    size_t StartM,
+    size_t StartN,
+    size_t CountM,
+    size_t CountN
+    )
+/*++
+
+Routine Description:
+
+    This routine requantizes a block of matrix C once its reduction over the
+    K dimension has completed.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the GEMM parameters.
+
+    StartM - Supplies the starting row of the block.
+
+    StartN - Supplies the starting column of the block.
+
+    CountM - Supplies the number of rows of the block.
+
+    CountN - Supplies the number of columns of the block.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const MLAS_REQUANTIZE_OUTPUT* Requantize = WorkBlock->Requantize;
+
+    MlasRequantizeOutput(WorkBlock->C + StartN + StartM * WorkBlock->ldc, WorkBlock->ldc,
+        Requantize->Output + StartN + StartM * Requantize->ldo, Requantize->ldo,
+        (Requantize->Bias != nullptr) ? Requantize->Bias + StartM : nullptr,
+        CountM, CountN, Requantize->Scale, Requantize->ZeroPoint);
+}
+
+void
+MlasGemmU8X8Operation(
+    const MLAS_GEMM_U8X8_WORK_BLOCK<int8_t>* WorkBlock,
+    size_t RangeStartM,
+    size_t RangeCountM,
+    size_t RangeStartN,
+    size_t RangeCountN
     )
+/*++
+
+Routine Description:
+
+    This routine implements the U8S8 QGEMM operation for a range of rows and
+    columns of matrix C.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the GEMM parameters.
+
+    RangeStartM - Supplies the starting row of the range.
+
+    RangeCountM - Supplies the number of rows of the range.
+
+    RangeStartN - Supplies the starting column of the range.
+
+    RangeCountN - Supplies the number of columns of the range.
+
+Return Value:
+
+    None.
+
+--*/
 {
     MLAS_DECLSPEC_ALIGN(uint8_t PanelA[MLAS_GEMM_U8S8_STRIDEM * MLAS_GEMM_U8S8_STRIDEK], 64);
     MLAS_DECLSPEC_ALIGN(int8_t PanelB[MLAS_GEMM_U8S8_STRIDEN * MLAS_GEMM_U8S8_STRIDEK], 64);
@@ -1127,14 +1319,31 @@ MlasGemm(
     size_t StrideN = MLAS_GEMM_U8S8_STRIDEN;
     size_t StrideK = MLAS_GEMM_U8S8_STRIDEK;
 
-    MLAS_UNREFERENCED_PARAMETER(ThreadPool);
+    const size_t M = RangeCountM;
+    const size_t N = RangeCountN;
+    const size_t K = WorkBlock->K;
+    const size_t lda = WorkBlock->lda;
+    const size_t ldb = WorkBlock->ldb;
+    const size_t ldc = WorkBlock->ldc;
+    const uint8_t offa = WorkBlock->offa;
+    const int8_t offb = WorkBlock->offb;
+
+    const uint8_t* A = WorkBlock->A + RangeStartM * lda;
+    const int8_t* B = WorkBlock->B + RangeStartN;
+    int32_t* C = WorkBlock->C + RangeStartM * ldc + RangeStartN;
 
 #if defined(MLAS_TARGET_AMD64)
 
     if (M == 1 && offa == 0 && offb == 0) {
 
         if (MlasPlatform.GemvU8S8Kernel != nullptr) {
+
             MlasPlatform.GemvU8S8Kernel(A, B, C, K, N, ldb);
+
+            if (WorkBlock->Requantize != nullptr) {
+                MlasGemmU8X8RequantizeBlock(WorkBlock, RangeStartM, RangeStartN, M, N);
+            }
+
             return;
         }
     }
@@ -1194,27 +1403,52 @@ MlasGemm(
                     pa += 4 * QuadCountK * RowsHandled;
                     RowSums += RowsHandled;
                 }
+
+                //
+                // Requantize the block while it is still in the cache if this
+                // was the last slice along the K dimension.
+                //
+
+                if (WorkBlock->Requantize != nullptr && k + CountK == K) {
+                    MlasGemmU8X8RequantizeBlock(WorkBlock, RangeStartM + m, RangeStartN + n, CountM, CountN);
+                }
             }
         }
     }
 }
 
 void
-MLASCALL
-MlasGemm(
-    size_t M,
-    size_t N,
-    size_t K,
-    const uint8_t* A,
-    size_t lda,
-    uint8_t offa,
-    const uint8_t* B,
-    size_t ldb,
-    uint8_t offb,
-    int32_t* C,
-    size_t ldc,
-    MLAS_THREADPOOL* ThreadPool
+MlasGemmU8X8Operation(
+    const MLAS_GEMM_U8X8_WORK_BLOCK<uint8_t>* WorkBlock,
+    size_t RangeStartM,
+    size_t RangeCountM,
+    size_t RangeStartN,
+    size_t RangeCountN
     )
+/*++
+
+Routine Description:
+
+    This routine implements the U8U8 QGEMM operation for a range of rows and
+    columns of matrix C.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the GEMM parameters.
+
+    RangeStartM - Supplies the starting row of the range.
+
+    RangeCountM - Supplies the number of rows of the range.
+
+    RangeStartN - Supplies the starting column of the range.
+
+    RangeCountN - Supplies the number of columns of the range.
+
+Return Value:
+
+    None.
+
+--*/
 {
     MLAS_DECLSPEC_ALIGN(int16_t PanelA[MLAS_GEMM_U8U8_STRIDEM * MLAS_GEMM_U8U8_STRIDEK], 64);
     MLAS_DECLSPEC_ALIGN(uint8_t PanelB[MLAS_GEMM_U8U8_STRIDEN * MLAS_GEMM_U8U8_STRIDEK], 64);
@@ -1226,7 +1460,18 @@ MlasGemm(
     size_t StrideN = MLAS_GEMM_U8U8_STRIDEN;
     size_t StrideK = MLAS_GEMM_U8U8_STRIDEK;
 
-    MLAS_UNREFERENCED_PARAMETER(ThreadPool);
+    const size_t M = RangeCountM;
+    const size_t N = RangeCountN;
+    const size_t K = WorkBlock->K;
+    const size_t lda = WorkBlock->lda;
+    const size_t ldb = WorkBlock->ldb;
+    const size_t ldc = WorkBlock->ldc;
+    const uint8_t offa = WorkBlock->offa;
+    const uint8_t offb = WorkBlock->offb;
+
+    const uint8_t* A = WorkBlock->A + RangeStartM * lda;
+    const uint8_t* B = WorkBlock->B + RangeStartN;
+    int32_t* C = WorkBlock->C + RangeStartM * ldc + RangeStartN;
 
     size_t CountK;
 
@@ -1281,9 +1526,301 @@ MlasGemm(
                     pa += 2 * PairCountK * RowsHandled;
                     RowSums += RowsHandled;
                 }
+
+                //
+                // Requantize the block while it is still in the cache if this
+                // was the last slice along the K dimension.
+                //
+
+                if (WorkBlock->Requantize != nullptr && k + CountK == K) {
+                    MlasGemmU8X8RequantizeBlock(WorkBlock, RangeStartM + m, RangeStartN + n, CountM, CountN);
+                }
             }
         }
     }
 }
 
+MLAS_FORCEINLINE
+void
+MlasPartitionWork(
+    int32_t Index,
+    int32_t ThreadCount,
+    size_t TotalWork,
+    size_t* WorkIndex,
+    size_t* WorkRemaining
+    )
+{
+    const size_t WorkPerThread = TotalWork / ThreadCount;
+    const size_t WorkPerThreadExtra = TotalWork % ThreadCount;
+
+    if (uint32_t(Index) < WorkPerThreadExtra) {
+        *WorkIndex = (WorkPerThread + 1) * Index;
+        *WorkRemaining = WorkPerThread + 1;
+    } else {
+        *WorkIndex = WorkPerThread * Index + WorkPerThreadExtra;
+        *WorkRemaining = WorkPerThread;
+    }
+}
+
+template<typename BType>
+void
+MlasGemmU8X8Threaded(
+    void* Context,
+    int32_t Index
+    )
+/*++
+
+Routine Description:
+
+    This routine is invoked from a worker thread to execute a segment of a
+    QGEMM operation.
+
+Arguments:
+
+    Context - Supplies the pointer to the context for the threaded operation.
+
+    Index - Supplies the current index of the threaded operation.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const auto* WorkBlock = (MLAS_GEMM_U8X8_WORK_BLOCK<BType>*)Context;
+
+    //
+    // Partition the operation along the M dimension or along the N dimension
+    // in units of the column alignment.
+    //
+
+    size_t RangeStartM = 0;
+    size_t RangeCountM = WorkBlock->M;
+    size_t RangeStartN = 0;
+    size_t RangeCountN = WorkBlock->N;
+
+    if (WorkBlock->ThreadCountM > 1) {
+
+        MlasPartitionWork(Index, WorkBlock->ThreadCountM, WorkBlock->M, &RangeStartM, &RangeCountM);
+
+    } else if (WorkBlock->ThreadCountN > 1) {
+
+        const size_t BlockedN = (WorkBlock->N + MLAS_QGEMM_STRIDEN_THREAD_ALIGN - 1) /
+            MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
+
+        MlasPartitionWork(Index, WorkBlock->ThreadCountN, BlockedN, &RangeStartN, &RangeCountN);
+
+        RangeStartN *= MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
+        RangeCountN *= MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
+
+        RangeCountN = (std::min)(WorkBlock->N - RangeStartN, RangeCountN);
+    }
+
+    MlasGemmU8X8Operation(WorkBlock, RangeStartM, RangeCountM, RangeStartN, RangeCountN);
+}
+
+template<typename BType>
+void
+MlasGemmU8X8Schedule(
+    MLAS_GEMM_U8X8_WORK_BLOCK<BType>* WorkBlock,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine schedules the quantized GEMM operation across one or more
+    threads.
+
+Arguments:
+
+    WorkBlock - Supplies the structure containing the GEMM parameters.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t M = WorkBlock->M;
+    const size_t N = WorkBlock->N;
+    const size_t K = WorkBlock->K;
+
+    //
+    // Compute the number of target threads given the complexity of the QGEMM
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K);
+
+    int32_t TargetThreadCount;
+
+    if (Complexity < double(MLAS_QGEMM_THREAD_COMPLEXITY * MLAS_MAXIMUM_THREAD_COUNT)) {
+        TargetThreadCount = int32_t(Complexity / double(MLAS_QGEMM_THREAD_COMPLEXITY)) + 1;
+    } else {
+        TargetThreadCount = MLAS_MAXIMUM_THREAD_COUNT;
+    }
+
+    int32_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    //
+    // Segment the operation along the larger of the M and N dimensions, but
+    // not into more pieces than that dimension holds.
+    //
+
+    WorkBlock->ThreadCountM = 1;
+    WorkBlock->ThreadCountN = 1;
+
+    if (N > M) {
+
+        const size_t BlockedN = (N + MLAS_QGEMM_STRIDEN_THREAD_ALIGN - 1) /
+            MLAS_QGEMM_STRIDEN_THREAD_ALIGN;
+
+        if (size_t(TargetThreadCount) > BlockedN) {
+            TargetThreadCount = int32_t(BlockedN);
+        }
+
+        WorkBlock->ThreadCountN = TargetThreadCount;
+
+    } else {
+
+        if (size_t(TargetThreadCount) > M) {
+            TargetThreadCount = int32_t(M);
+        }
+
+        WorkBlock->ThreadCountM = TargetThreadCount;
+    }
+
+    MlasExecuteThreaded(MlasGemmU8X8Threaded<BType>, WorkBlock, TargetThreadCount, ThreadPool);
+}
+
+template<typename BType>
+void
+MlasGemmU8X8(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const BType* B,
+    size_t ldb,
+    BType offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_REQUANTIZE_OUTPUT* Requantize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    if (M == 0 || N == 0 || K == 0) {
+        return;
+    }
+
+    MLAS_GEMM_U8X8_WORK_BLOCK<BType> WorkBlock;
+
+    WorkBlock.M = M;
+    WorkBlock.N = N;
+    WorkBlock.K = K;
+    WorkBlock.A = A;
+    WorkBlock.lda = lda;
+    WorkBlock.B = B;
+    WorkBlock.ldb = ldb;
+    WorkBlock.C = C;
+    WorkBlock.ldc = ldc;
+    WorkBlock.offa = offa;
+    WorkBlock.offb = offb;
+    WorkBlock.Requantize = Requantize;
+
+    MlasGemmU8X8Schedule(&WorkBlock, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const int8_t* B,
+    size_t ldb,
+    int8_t offb,
+    int32_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    MlasGemmU8X8(M, N, K, A, lda, offa, B, ldb, offb, C, ldc, nullptr, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    int32_t* C,
+    size_t ldc,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    MlasGemmU8X8(M, N, K, A, lda, offa, B, ldb, offb, C, ldc, nullptr, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const int8_t* B,
+    size_t ldb,
+    int8_t offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_REQUANTIZE_OUTPUT* Requantize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    MlasGemmU8X8(M, N, K, A, lda, offa, B, ldb, offb, C, ldc, Requantize, ThreadPool);
+}
+
+void
+MLASCALL
+MlasGemm(
+    size_t M,
+    size_t N,
+    size_t K,
+    const uint8_t* A,
+    size_t lda,
+    uint8_t offa,
+    const uint8_t* B,
+    size_t ldb,
+    uint8_t offb,
+    int32_t* C,
+    size_t ldc,
+    const MLAS_REQUANTIZE_OUTPUT* Requantize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    MlasGemmU8X8(M, N, K, A, lda, offa, B, ldb, offb, C, ldc, Requantize, ThreadPool);
+}
+
 #endif
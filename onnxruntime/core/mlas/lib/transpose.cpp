@@ -0,0 +1,293 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    transpose.cpp
+
+Abstract:
+
+    This module implements the matrix transpose routines.
+
+    The matrix is walked in strips of rows. Each strip is transposed with a
+    4x4 (32-bit elements) or 8x8 (8-bit elements) register micro-kernel and
+    the leftover rows and columns are transposed one element at a time.
+
+--*/
+
+#include "mlasi.h"
+
+MLAS_FORCEINLINE
+void
+MlasTranspose4x4Block(
+    const uint32_t* Input,
+    size_t lda,
+    uint32_t* Output,
+    size_t ldb
+    )
+{
+#if defined(MLAS_SSE2_INTRINSICS)
+    __m128i a0 = _mm_loadu_si128((const __m128i*)&Input[lda * 0]);
+    __m128i a1 = _mm_loadu_si128((const __m128i*)&Input[lda * 1]);
+    __m128i a2 = _mm_loadu_si128((const __m128i*)&Input[lda * 2]);
+    __m128i a3 = _mm_loadu_si128((const __m128i*)&Input[lda * 3]);
+
+    __m128i b0 = _mm_unpacklo_epi32(a0, a1);
+    __m128i b1 = _mm_unpackhi_epi32(a0, a1);
+    __m128i b2 = _mm_unpacklo_epi32(a2, a3);
+    __m128i b3 = _mm_unpackhi_epi32(a2, a3);
+
+    _mm_storeu_si128((__m128i*)&Output[ldb * 0], _mm_unpacklo_epi64(b0, b2));
+    _mm_storeu_si128((__m128i*)&Output[ldb * 1], _mm_unpackhi_epi64(b0, b2));
+    _mm_storeu_si128((__m128i*)&Output[ldb * 2], _mm_unpacklo_epi64(b1, b3));
+    _mm_storeu_si128((__m128i*)&Output[ldb * 3], _mm_unpackhi_epi64(b1, b3));
+#elif defined(MLAS_NEON_INTRINSICS)
+    uint32x4_t a0 = vld1q_u32(&Input[lda * 0]);
+    uint32x4_t a1 = vld1q_u32(&Input[lda * 1]);
+    uint32x4_t a2 = vld1q_u32(&Input[lda * 2]);
+    uint32x4_t a3 = vld1q_u32(&Input[lda * 3]);
+
+    uint32x4x2_t b01 = vtrnq_u32(a0, a1);
+    uint32x4x2_t b23 = vtrnq_u32(a2, a3);
+
+    vst1q_u32(&Output[ldb * 0], vcombine_u32(vget_low_u32(b01.val[0]), vget_low_u32(b23.val[0])));
+    vst1q_u32(&Output[ldb * 1], vcombine_u32(vget_low_u32(b01.val[1]), vget_low_u32(b23.val[1])));
+    vst1q_u32(&Output[ldb * 2], vcombine_u32(vget_high_u32(b01.val[0]), vget_high_u32(b23.val[0])));
+    vst1q_u32(&Output[ldb * 3], vcombine_u32(vget_high_u32(b01.val[1]), vget_high_u32(b23.val[1])));
+#endif
+}
+
+MLAS_FORCEINLINE
+void
+MlasTranspose8x8Block(
+    const uint8_t* Input,
+    size_t lda,
+    uint8_t* Output,
+    size_t ldb
+    )
+{
+#if defined(MLAS_SSE2_INTRINSICS)
+    __m128i a0 = _mm_loadl_epi64((const __m128i*)&Input[lda * 0]);
+    __m128i a1 = _mm_loadl_epi64((const __m128i*)&Input[lda * 1]);
+    __m128i a2 = _mm_loadl_epi64((const __m128i*)&Input[lda * 2]);
+    __m128i a3 = _mm_loadl_epi64((const __m128i*)&Input[lda * 3]);
+    __m128i a4 = _mm_loadl_epi64((const __m128i*)&Input[lda * 4]);
+    __m128i a5 = _mm_loadl_epi64((const __m128i*)&Input[lda * 5]);
+    __m128i a6 = _mm_loadl_epi64((const __m128i*)&Input[lda * 6]);
+    __m128i a7 = _mm_loadl_epi64((const __m128i*)&Input[lda * 7]);
+
+    __m128i b0 = _mm_unpacklo_epi8(a0, a1);
+    __m128i b1 = _mm_unpacklo_epi8(a2, a3);
+    __m128i b2 = _mm_unpacklo_epi8(a4, a5);
+    __m128i b3 = _mm_unpacklo_epi8(a6, a7);
+
+    __m128i c0 = _mm_unpacklo_epi16(b0, b1);
+    __m128i c1 = _mm_unpackhi_epi16(b0, b1);
+    __m128i c2 = _mm_unpacklo_epi16(b2, b3);
+    __m128i c3 = _mm_unpackhi_epi16(b2, b3);
+
+    __m128i d0 = _mm_unpacklo_epi32(c0, c2);
+    __m128i d1 = _mm_unpackhi_epi32(c0, c2);
+    __m128i d2 = _mm_unpacklo_epi32(c1, c3);
+    __m128i d3 = _mm_unpackhi_epi32(c1, c3);
+
+    _mm_storel_epi64((__m128i*)&Output[ldb * 0], d0);
+    _mm_storel_epi64((__m128i*)&Output[ldb * 1], _mm_unpackhi_epi64(d0, d0));
+    _mm_storel_epi64((__m128i*)&Output[ldb * 2], d1);
+    _mm_storel_epi64((__m128i*)&Output[ldb * 3], _mm_unpackhi_epi64(d1, d1));
+    _mm_storel_epi64((__m128i*)&Output[ldb * 4], d2);
+    _mm_storel_epi64((__m128i*)&Output[ldb * 5], _mm_unpackhi_epi64(d2, d2));
+    _mm_storel_epi64((__m128i*)&Output[ldb * 6], d3);
+    _mm_storel_epi64((__m128i*)&Output[ldb * 7], _mm_unpackhi_epi64(d3, d3));
+#elif defined(MLAS_NEON_INTRINSICS)
+    uint8x8x2_t b01 = vtrn_u8(vld1_u8(&Input[lda * 0]), vld1_u8(&Input[lda * 1]));
+    uint8x8x2_t b23 = vtrn_u8(vld1_u8(&Input[lda * 2]), vld1_u8(&Input[lda * 3]));
+    uint8x8x2_t b45 = vtrn_u8(vld1_u8(&Input[lda * 4]), vld1_u8(&Input[lda * 5]));
+    uint8x8x2_t b67 = vtrn_u8(vld1_u8(&Input[lda * 6]), vld1_u8(&Input[lda * 7]));
+
+    uint16x4x2_t c0 = vtrn_u16(vreinterpret_u16_u8(b01.val[0]), vreinterpret_u16_u8(b23.val[0]));
+    uint16x4x2_t c1 = vtrn_u16(vreinterpret_u16_u8(b01.val[1]), vreinterpret_u16_u8(b23.val[1]));
+    uint16x4x2_t c2 = vtrn_u16(vreinterpret_u16_u8(b45.val[0]), vreinterpret_u16_u8(b67.val[0]));
+    uint16x4x2_t c3 = vtrn_u16(vreinterpret_u16_u8(b45.val[1]), vreinterpret_u16_u8(b67.val[1]));
+
+    uint32x2x2_t d0 = vtrn_u32(vreinterpret_u32_u16(c0.val[0]), vreinterpret_u32_u16(c2.val[0]));
+    uint32x2x2_t d1 = vtrn_u32(vreinterpret_u32_u16(c1.val[0]), vreinterpret_u32_u16(c3.val[0]));
+    uint32x2x2_t d2 = vtrn_u32(vreinterpret_u32_u16(c0.val[1]), vreinterpret_u32_u16(c2.val[1]));
+    uint32x2x2_t d3 = vtrn_u32(vreinterpret_u32_u16(c1.val[1]), vreinterpret_u32_u16(c3.val[1]));
+
+    vst1_u8(&Output[ldb * 0], vreinterpret_u8_u32(d0.val[0]));
+    vst1_u8(&Output[ldb * 1], vreinterpret_u8_u32(d1.val[0]));
+    vst1_u8(&Output[ldb * 2], vreinterpret_u8_u32(d2.val[0]));
+    vst1_u8(&Output[ldb * 3], vreinterpret_u8_u32(d3.val[0]));
+    vst1_u8(&Output[ldb * 4], vreinterpret_u8_u32(d0.val[1]));
+    vst1_u8(&Output[ldb * 5], vreinterpret_u8_u32(d1.val[1]));
+    vst1_u8(&Output[ldb * 6], vreinterpret_u8_u32(d2.val[1]));
+    vst1_u8(&Output[ldb * 7], vreinterpret_u8_u32(d3.val[1]));
+#endif
+}
+
+template<typename ElementType, size_t StripSize, void (*BlockRoutine)(const ElementType*, size_t, ElementType*, size_t)>
+void
+MlasTransposeStrips(
+    const ElementType* Input,
+    size_t lda,
+    ElementType* Output,
+    size_t ldb,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a matrix by walking strips of StripSize rows and
+    transposing StripSize x StripSize blocks of each strip with the supplied
+    block routine.
+
+Arguments:
+
+    Input - Supplies the input matrix.
+
+    lda - Supplies the first dimension of the input matrix.
+
+    Output - Supplies the output matrix.
+
+    ldb - Supplies the first dimension of the output matrix.
+
+    M - Supplies the number of rows of the input matrix.
+
+    N - Supplies the number of columns of the input matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    while (M >= StripSize) {
+
+        const ElementType* s = Input;
+        ElementType* d = Output;
+        size_t n = N;
+
+        while (n >= StripSize) {
+
+            BlockRoutine(s, lda, d, ldb);
+
+            s += StripSize;
+            d += StripSize * ldb;
+            n -= StripSize;
+        }
+
+        while (n > 0) {
+
+            for (size_t k = 0; k < StripSize; k++) {
+                d[k] = s[k * lda];
+            }
+
+            s += 1;
+            d += ldb;
+            n -= 1;
+        }
+
+        Input += StripSize * lda;
+        Output += StripSize;
+        M -= StripSize;
+    }
+
+    while (M > 0) {
+
+        const ElementType* s = Input;
+        ElementType* d = Output;
+
+        for (size_t n = 0; n < N; n++) {
+            *d = *s++;
+            d += ldb;
+        }
+
+        Input += lda;
+        Output += 1;
+        M -= 1;
+    }
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint32_t* Input,
+    size_t lda,
+    uint32_t* Output,
+    size_t ldb,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a matrix of 32-bit elements.
+
+Arguments:
+
+    Input - Supplies the input matrix of M rows and N columns.
+
+    lda - Supplies the first dimension of the input matrix.
+
+    Output - Supplies the output matrix of N rows and M columns.
+
+    ldb - Supplies the first dimension of the output matrix.
+
+    M - Supplies the number of rows of the input matrix.
+
+    N - Supplies the number of columns of the input matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasTransposeStrips<uint32_t, 4, MlasTranspose4x4Block>(Input, lda, Output, ldb, M, N);
+}
+
+void
+MLASCALL
+MlasTranspose(
+    const uint8_t* Input,
+    size_t lda,
+    uint8_t* Output,
+    size_t ldb,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a matrix of 8-bit elements.
+
+Arguments:
+
+    Input - Supplies the input matrix of M rows and N columns.
+
+    lda - Supplies the first dimension of the input matrix.
+
+    Output - Supplies the output matrix of N rows and M columns.
+
+    ldb - Supplies the first dimension of the output matrix.
+
+    M - Supplies the number of rows of the input matrix.
+
+    N - Supplies the number of columns of the input matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    MlasTransposeStrips<uint8_t, 8, MlasTranspose8x8Block>(Input, lda, Output, ldb, M, N);
+}
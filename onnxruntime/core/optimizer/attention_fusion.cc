@@ -0,0 +1,419 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/attention_fusion.h"
+#include "core/graph/graph_utils.h"
+#include "core/framework/tensorprotoutils.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+namespace onnxruntime {
+
+// Checks the type and provider of a node inside the subgraph, and that none of its outputs are graph outputs.
+static bool IsMatchingNode(const Graph& graph, const Node* node, const std::string& op_type,
+                           const std::initializer_list<OperatorSetVersion>& versions, const std::string& provider) {
+  return node != nullptr &&
+         graph_utils::IsSupportedOptypeVersionAndDomain(*node, op_type, versions) &&
+         node->GetExecutionProviderType() == provider &&
+         graph.GetNodeOutputsInGraphOutputs(*node).empty();
+}
+
+// Same as IsMatchingNode, and the node only feeds the next node of the subgraph so it can be removed with it.
+static bool IsFusableNode(const Graph& graph, const Node* node, const std::string& op_type,
+                          const std::initializer_list<OperatorSetVersion>& versions, const std::string& provider) {
+  return IsMatchingNode(graph, node, op_type, versions, provider) && node->GetOutputEdgesCount() == 1;
+}
+
+static bool IsFusableTranspose(const Graph& graph, const Node* node, const std::string& provider,
+                               const std::vector<int64_t>& expected_perm) {
+  std::vector<int64_t> perm;
+  return IsFusableNode(graph, node, "Transpose", {1}, provider) &&
+         graph_utils::GetRepeatedNodeAttributeValues(*node, "perm", perm) &&
+         perm == expected_perm;
+}
+
+static bool GetConstantShape(const Graph& graph, const NodeArg& input_arg, std::vector<int64_t>& shape) {
+  const TensorProto* tensor_proto = graph_utils::GetConstantInitializer(graph, input_arg.Name());
+  if (tensor_proto == nullptr ||
+      tensor_proto->data_type() != TensorProto_DataType_INT64 ||
+      tensor_proto->dims_size() != 1) {
+    return false;
+  }
+
+  shape.resize(static_cast<size_t>(tensor_proto->dims(0)));
+  const bool has_raw_data = utils::HasRawData(*tensor_proto);
+  return utils::UnpackTensor<int64_t>(*tensor_proto,
+                                      has_raw_data ? tensor_proto->raw_data().data() : nullptr,
+                                      has_raw_data ? tensor_proto->raw_data().size() : 0,
+                                      shape.data(), static_cast<int64_t>(shape.size()))
+      .IsOK();
+}
+
+static bool GetConstantScalar(const Graph& graph, const NodeArg& input_arg, float& value) {
+  const TensorProto* tensor_proto = graph_utils::GetConstantInitializer(graph, input_arg.Name());
+  if (tensor_proto == nullptr || tensor_proto->data_type() != TensorProto_DataType_FLOAT) {
+    return false;
+  }
+
+  Initializer init_const{*tensor_proto, graph.ModelPath()};
+  if (init_const.size() != 1) {
+    return false;
+  }
+  value = init_const.data<float>()[0];
+  return true;
+}
+
+// One of the Q, K and V projections: MatMul(input, weight) + bias, reshaped to
+// (batch_size, sequence_length, num_heads, head_size) and transposed with the given permutation.
+struct ProjectionMatch {
+  const Node* matmul;
+  const Node* add;
+  const Node* reshape;
+  const Node* transpose;
+  const NodeArg* input;
+  const TensorProto* weight;
+  const TensorProto* bias;
+  int64_t num_heads;
+  int64_t head_size;
+};
+
+static bool MatchProjection(const Graph& graph, const Node* transpose, const std::string& provider,
+                            const std::vector<int64_t>& perm, ProjectionMatch& match) {
+  if (!IsFusableTranspose(graph, transpose, provider, perm)) {
+    return false;
+  }
+
+  const Node* reshape = graph_utils::GetInputNode(*transpose, 0);
+  std::vector<int64_t> shape;
+  if (!IsFusableNode(graph, reshape, "Reshape", {5}, provider) ||
+      !GetConstantShape(graph, *reshape->InputDefs()[1], shape) ||
+      shape.size() != 4 || shape[2] <= 0 || shape[3] <= 0) {
+    return false;
+  }
+
+  const Node* add = graph_utils::GetInputNode(*reshape, 0);
+  if (!IsFusableNode(graph, add, "Add", {7}, provider)) {
+    return false;
+  }
+
+  int bias_index = 1;
+  const Node* matmul = graph_utils::GetInputNode(*add, 0);
+  if (matmul == nullptr) {
+    bias_index = 0;
+    matmul = graph_utils::GetInputNode(*add, 1);
+  }
+  if (!IsFusableNode(graph, matmul, "MatMul", {1, 9}, provider)) {
+    return false;
+  }
+
+  const int64_t hidden_size = shape[2] * shape[3];
+  const TensorProto* weight = graph_utils::GetConstantInitializer(graph, matmul->InputDefs()[1]->Name());
+  const TensorProto* bias = graph_utils::GetConstantInitializer(graph, add->InputDefs()[bias_index]->Name());
+  if (weight == nullptr || weight->data_type() != TensorProto_DataType_FLOAT ||
+      weight->dims_size() != 2 || weight->dims(0) != hidden_size || weight->dims(1) != hidden_size ||
+      bias == nullptr || bias->data_type() != TensorProto_DataType_FLOAT ||
+      bias->dims_size() != 1 || bias->dims(0) != hidden_size) {
+    return false;
+  }
+
+  match = {matmul, add, reshape, transpose, matmul->InputDefs()[0], weight, bias, shape[2], shape[3]};
+  return true;
+}
+
+// Matches the conversion of a (batch_size, sequence_length) 0/1 attention mask into the additive mask
+// of the scores: Mul(Sub(1, Cast(Unsqueeze(Unsqueeze(mask)))), -10000). The nodes may be shared by all
+// the layers, so they are returned separately and only removed once nothing else consumes them.
+static bool MatchMask(const Graph& graph, const Node* mul, const std::string& provider,
+                      std::vector<const Node*>& mask_nodes, const NodeArg*& mask_input) {
+  if (!IsMatchingNode(graph, mul, "Mul", {7}, provider)) {
+    return false;
+  }
+
+  // Attention adds -10000 to the masked scores, as BERT does.
+  float mask_value = 0.0f;
+  const Node* sub = graph_utils::GetInputNode(*mul, 0);
+  if (sub == nullptr ||
+      !GetConstantScalar(graph, *mul->InputDefs()[1], mask_value)) {
+    sub = graph_utils::GetInputNode(*mul, 1);
+    if (!GetConstantScalar(graph, *mul->InputDefs()[0], mask_value)) {
+      return false;
+    }
+  }
+  if (mask_value != -10000.0f) {
+    return false;
+  }
+
+  float one = 0.0f;
+  if (!IsMatchingNode(graph, sub, "Sub", {7}, provider) ||
+      !GetConstantScalar(graph, *sub->InputDefs()[0], one) || one != 1.0f) {
+    return false;
+  }
+  mask_nodes = {mul, sub};
+
+  const Node* node = graph_utils::GetInputNode(*sub, 1);
+  if (node != nullptr && node->OpType() == "Cast") {
+    if (!IsMatchingNode(graph, node, "Cast", {6, 9}, provider)) {
+      return false;
+    }
+    mask_nodes.push_back(node);
+    node = graph_utils::GetInputNode(*node, 0);
+  }
+
+  while (node != nullptr && node->OpType() == "Unsqueeze") {
+    if (!IsMatchingNode(graph, node, "Unsqueeze", {1, 11}, provider)) {
+      return false;
+    }
+    mask_nodes.push_back(node);
+    mask_input = node->InputDefs()[0];
+    node = graph_utils::GetInputNode(*node, 0);
+  }
+  if (mask_nodes.back()->OpType() != "Unsqueeze") {
+    return false;
+  }
+
+  // Attention takes the mask as int32, so only integer masks are converted without changing their values.
+  const auto* mask_shape = mask_input->Shape();
+  const auto* mask_type = mask_input->TypeAsProto();
+  if (mask_shape == nullptr || mask_shape->dim_size() != 2 || mask_type == nullptr ||
+      (mask_type->tensor_type().elem_type() != TensorProto_DataType_INT32 &&
+       mask_type->tensor_type().elem_type() != TensorProto_DataType_INT64)) {
+    return false;
+  }
+
+  // The unsqueezed mask has to be (batch_size, 1, 1, sequence_length) to broadcast over the heads and queries.
+  std::vector<int64_t> dims{0, 1};
+  for (auto it = mask_nodes.rbegin(); it != mask_nodes.rend() && (*it)->OpType() == "Unsqueeze"; ++it) {
+    std::vector<int64_t> axes;
+    if (!graph_utils::GetRepeatedNodeAttributeValues(**it, "axes", axes)) {
+      return false;
+    }
+    std::sort(axes.begin(), axes.end());
+    for (int64_t axis : axes) {
+      if (axis < 0 || axis > static_cast<int64_t>(dims.size())) {
+        return false;
+      }
+      dims.insert(dims.begin() + axis, -1);
+    }
+  }
+  return dims == std::vector<int64_t>{0, -1, -1, 1};
+}
+
+// Returns the 0/1 mask as the int32 (batch_size, sequence_length) mask_index input of Attention, adding a Cast
+// if needed. The result is shared by all layers using the mask.
+static NodeArg* GetOrCreateMaskIndex(Graph& graph, const NodeArg& mask_input, const std::string& provider,
+                                     std::unordered_map<std::string, NodeArg*>& mask_index_map) {
+  auto it = mask_index_map.find(mask_input.Name());
+  if (it != mask_index_map.end()) {
+    return it->second;
+  }
+
+  NodeArg* mask_index = const_cast<NodeArg*>(&mask_input);
+  if (mask_input.TypeAsProto()->tensor_type().elem_type() != TensorProto_DataType_INT32) {
+    TypeProto int32_type;
+    int32_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT32);
+    mask_index = &graph.GetOrCreateNodeArg(graph.GenerateNodeArgName("mask_int32"), &int32_type);
+    Node& cast_node = graph.AddNode(graph.GenerateNodeName("MaskCast"),
+                                    "Cast",
+                                    "cast attention mask to int32",
+                                    {const_cast<NodeArg*>(&mask_input)},
+                                    {mask_index});
+    cast_node.AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_INT32));
+    cast_node.SetExecutionProviderType(provider);
+  }
+
+  mask_index_map[mask_input.Name()] = mask_index;
+  return mask_index;
+}
+
+Status AttentionFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+
+  // Fused nodes are removed once all subgraphs are matched, consumers before producers.
+  std::vector<NodeIndex> removed_nodes;
+  std::vector<NodeIndex> mask_nodes;
+  std::unordered_map<std::string, NodeArg*> mask_index_map;
+
+  for (auto node_index : node_topology_list) {
+    auto& softmax = *graph.GetNode(node_index);
+    ORT_RETURN_IF_ERROR(Recurse(softmax, modified, graph_level));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(softmax, "Softmax", {1, 11}) ||
+        !graph_utils::IsSupportedProvider(softmax, GetCompatibleExecutionProviders()) ||
+        softmax.GetOutputEdgesCount() != 1 ||
+        !graph.GetNodeOutputsInGraphOutputs(softmax).empty()) {
+      continue;
+    }
+    const std::string& provider = softmax.GetExecutionProviderType();
+
+    // Softmax has to run over the last axis of the (batch_size, num_heads, sequence_length, sequence_length) scores.
+    const auto* axis_attr = graph_utils::GetNodeAttribute(softmax, "axis");
+    if (axis_attr == nullptr || (axis_attr->i() != 3 && axis_attr->i() != -1)) {
+      continue;
+    }
+
+    const Node* add_mask = graph_utils::GetInputNode(softmax, 0);
+    if (!IsFusableNode(graph, add_mask, "Add", {7}, provider)) {
+      continue;
+    }
+
+    // One input of the Add is the scaled Q x K', the other the additive mask.
+    const Node* scale = nullptr;
+    int mask_index_input = 0;
+    for (int i = 0; i < 2; i++) {
+      const Node* input_node = graph_utils::GetInputNode(*add_mask, i);
+      if (input_node != nullptr && (input_node->OpType() == "Div" || input_node->OpType() == "Mul")) {
+        const Node* qk_node = graph_utils::GetInputNode(*input_node, 0);
+        if (qk_node != nullptr && qk_node->OpType() == "MatMul") {
+          scale = input_node;
+          mask_index_input = 1 - i;
+          break;
+        }
+      }
+    }
+    float scale_value = 0.0f;
+    if (scale == nullptr ||
+        !IsFusableNode(graph, scale, scale->OpType(), {7}, provider) ||
+        !GetConstantScalar(graph, *scale->InputDefs()[1], scale_value)) {
+      continue;
+    }
+
+    const Node* qk = graph_utils::GetInputNode(*scale, 0);
+    ProjectionMatch q{}, k{}, v{};
+    if (!IsFusableNode(graph, qk, "MatMul", {1, 9}, provider) ||
+        !MatchProjection(graph, graph_utils::GetInputNode(*qk, 0), provider, {0, 2, 1, 3}, q) ||
+        !MatchProjection(graph, graph_utils::GetInputNode(*qk, 1), provider, {0, 2, 3, 1}, k)) {
+      continue;
+    }
+
+    const Node* context = &*softmax.OutputNodesBegin();
+    if (!IsFusableNode(graph, context, "MatMul", {1, 9}, provider) ||
+        context->InputDefs()[0] != softmax.OutputDefs()[0] ||
+        !MatchProjection(graph, graph_utils::GetInputNode(*context, 1), provider, {0, 2, 1, 3}, v)) {
+      continue;
+    }
+
+    const Node* transpose_out = &*context->OutputNodesBegin();
+    if (!IsFusableTranspose(graph, transpose_out, provider, {0, 2, 1, 3})) {
+      continue;
+    }
+
+    // The output Reshape back to (batch_size, sequence_length, hidden_size) ends the subgraph, so its
+    // output may have any number of consumers.
+    const Node* reshape_out = &*transpose_out->OutputNodesBegin();
+    const int64_t num_heads = q.num_heads;
+    const int64_t head_size = q.head_size;
+    const int64_t hidden_size = num_heads * head_size;
+    std::vector<int64_t> output_shape;
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(*reshape_out, "Reshape", {5}) ||
+        reshape_out->GetExecutionProviderType() != provider ||
+        !GetConstantShape(graph, *reshape_out->InputDefs()[1], output_shape) ||
+        output_shape.size() != 3 || output_shape[2] != hidden_size) {
+      continue;
+    }
+
+    // All projections read the same (batch_size, sequence_length, hidden_size) input with the same heads.
+    const auto* input_shape = q.input->Shape();
+    if (k.input != q.input || v.input != q.input ||
+        k.num_heads != num_heads || k.head_size != head_size ||
+        v.num_heads != num_heads || v.head_size != head_size ||
+        input_shape == nullptr || input_shape->dim_size() != 3) {
+      continue;
+    }
+
+    // Attention scales the scores by 1/sqrt(head_size).
+    const float expected_scale = std::sqrt(static_cast<float>(head_size));
+    if (scale->OpType() == "Mul") {
+      scale_value = 1.0f / scale_value;
+    }
+    if (std::abs(scale_value - expected_scale) > 1e-4f * expected_scale) {
+      continue;
+    }
+
+    std::vector<const Node*> matched_mask_nodes;
+    const NodeArg* mask_input = nullptr;
+    const Node* mask_mul = graph_utils::GetInputNode(*add_mask, mask_index_input);
+    if (!MatchMask(graph, mask_mul, provider, matched_mask_nodes, mask_input)) {
+      continue;
+    }
+
+    // Merge the Q, K and V weights into a (hidden_size, 3 * hidden_size) initializer, and their biases
+    // into a (3 * hidden_size) one.
+    const auto& model_path = graph.ModelPath();
+    Initializer q_weight{*q.weight, model_path}, k_weight{*k.weight, model_path}, v_weight{*v.weight, model_path};
+    Initializer q_bias{*q.bias, model_path}, k_bias{*k.bias, model_path}, v_bias{*v.bias, model_path};
+
+    Initializer qkv_weight(TensorProto_DataType_FLOAT, graph.GenerateNodeArgName("qkv_weight"),
+                           {hidden_size, 3 * hidden_size});
+    Initializer qkv_bias(TensorProto_DataType_FLOAT, graph.GenerateNodeArgName("qkv_bias"), {3 * hidden_size});
+
+    float* weight_data = qkv_weight.data<float>();
+    for (int64_t row = 0; row < hidden_size; row++) {
+      std::copy_n(q_weight.data<float>() + row * hidden_size, hidden_size, weight_data);
+      std::copy_n(k_weight.data<float>() + row * hidden_size, hidden_size, weight_data + hidden_size);
+      std::copy_n(v_weight.data<float>() + row * hidden_size, hidden_size, weight_data + 2 * hidden_size);
+      weight_data += 3 * hidden_size;
+    }
+    float* bias_data = qkv_bias.data<float>();
+    std::copy_n(q_bias.data<float>(), hidden_size, bias_data);
+    std::copy_n(k_bias.data<float>(), hidden_size, bias_data + hidden_size);
+    std::copy_n(v_bias.data<float>(), hidden_size, bias_data + 2 * hidden_size);
+
+    TensorProto weight_proto, bias_proto;
+    qkv_weight.ToProto(weight_proto);
+    qkv_bias.ToProto(bias_proto);
+    NodeArg& weight_arg = graph_utils::AddInitializer(graph, weight_proto);
+    NodeArg& bias_arg = graph_utils::AddInitializer(graph, bias_proto);
+
+    NodeArg* mask_index = GetOrCreateMaskIndex(graph, *mask_input, provider, mask_index_map);
+
+    const std::vector<NodeArg*> attention_input_defs{const_cast<NodeArg*>(q.input), &weight_arg, &bias_arg, mask_index};
+    const std::vector<NodeArg*> attention_output_defs{const_cast<NodeArg*>(reshape_out->OutputDefs()[0])};
+    Node& attention_node = graph.AddNode(graph.GenerateNodeName("Attention"),
+                                         "Attention",
+                                         "fused Attention subgraphs",
+                                         attention_input_defs,
+                                         attention_output_defs, nullptr, kMSDomain);
+    attention_node.AddAttribute("num_heads", num_heads);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    attention_node.SetExecutionProviderType(provider);
+
+    for (NodeIndex index : {reshape_out->Index(), transpose_out->Index(), context->Index(), softmax.Index(),
+                            add_mask->Index(), scale->Index(), qk->Index()}) {
+      removed_nodes.push_back(index);
+    }
+    for (const ProjectionMatch* projection : {&q, &k, &v}) {
+      for (const Node* node : {projection->transpose, projection->reshape, projection->add, projection->matmul}) {
+        removed_nodes.push_back(node->Index());
+      }
+    }
+    for (const Node* node : matched_mask_nodes) {
+      mask_nodes.push_back(node->Index());
+    }
+  }
+
+  for (NodeIndex removed_node : removed_nodes) {
+    Node* node = graph.GetNode(removed_node);
+    graph_utils::RemoveNodeOutputEdges(graph, *node);
+    graph.RemoveNode(removed_node);
+  }
+
+  // The mask nodes are removed in order from the Mul to the first Unsqueeze once they are no longer used.
+  for (NodeIndex mask_node : mask_nodes) {
+    Node* node = graph.GetNode(mask_node);
+    if (node != nullptr && node->GetOutputEdgesCount() == 0 && graph.GetNodeOutputsInGraphOutputs(*node).empty()) {
+      graph.RemoveNode(mask_node);
+    }
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
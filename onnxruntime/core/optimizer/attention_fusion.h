@@ -0,0 +1,30 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+@Class AttentionFusion
+
+Rewrite graph fusing the multi-head self attention subgraph of BERT to a single Attention node.
+
+The Q, K and V projections (MatMul + Add + Reshape + Transpose) of a shared input, the scaled dot product
+(MatMul + Div), the attention mask (Add), Softmax, the context MatMul and the final Transpose + Reshape are
+replaced. The Q, K and V weights and biases are merged into new initializers, and the (batch_size, sequence_length)
+0/1 attention mask, usually a graph input, is passed to Attention as its 2D mask_index input. Attention applies it
+like the subgraph does, so the mask filter value has to be -10000.
+
+*/
+class AttentionFusion : public GraphTransformer {
+ public:
+  AttentionFusion(const std::unordered_set<std::string>& compatible_execution_providers = {}) noexcept
+      : GraphTransformer("AttentionFusion", compatible_execution_providers) {}
+
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level) const override;
+};
+
+}  // namespace onnxruntime
@@ -61,11 +61,11 @@ Status ConvBNFusion::Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_eff
     return Status::OK();
   }
 
-  auto bn_scale = onnxruntime::make_unique<Initializer>(*bn_scale_tensor_proto);
-  auto bn_B = onnxruntime::make_unique<Initializer>(*bn_B_tensor_proto);
-  auto bn_mean = onnxruntime::make_unique<Initializer>(*bn_mean_tensor_proto);
-  auto bn_var = onnxruntime::make_unique<Initializer>(*bn_var_tensor_proto);
-  auto conv_W = onnxruntime::make_unique<Initializer>(*conv_W_tensor_proto);
+  auto bn_scale = onnxruntime::make_unique<Initializer>(*bn_scale_tensor_proto, graph.ModelPath());
+  auto bn_B = onnxruntime::make_unique<Initializer>(*bn_B_tensor_proto, graph.ModelPath());
+  auto bn_mean = onnxruntime::make_unique<Initializer>(*bn_mean_tensor_proto, graph.ModelPath());
+  auto bn_var = onnxruntime::make_unique<Initializer>(*bn_var_tensor_proto, graph.ModelPath());
+  auto conv_W = onnxruntime::make_unique<Initializer>(*conv_W_tensor_proto, graph.ModelPath());
 
   std::unique_ptr<Initializer> conv_B = nullptr;
   const ONNX_NAMESPACE::TensorProto* conv_B_tensor_proto = nullptr;
@@ -79,7 +79,7 @@ Status ConvBNFusion::Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_eff
         conv_B_tensor_proto->data_type() != bn_B_tensor_proto->data_type()) {
       return Status::OK();
     }
-    conv_B = onnxruntime::make_unique<Initializer>(*conv_B_tensor_proto);
+    conv_B = onnxruntime::make_unique<Initializer>(*conv_B_tensor_proto, graph.ModelPath());
   }
 
   // Calculate new value of initializers of conv node
@@ -53,8 +53,8 @@ Status ConvMulFusion::Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_ef
     }
   }
 
-  auto conv_W = onnxruntime::make_unique<Initializer>(*conv_W_tensor_proto);
-  auto mul_B = onnxruntime::make_unique<Initializer>(*mul_B_tensor_proto);
+  auto conv_W = onnxruntime::make_unique<Initializer>(*conv_W_tensor_proto, graph.ModelPath());
+  auto mul_B = onnxruntime::make_unique<Initializer>(*mul_B_tensor_proto, graph.ModelPath());
 
   const ONNX_NAMESPACE::TensorProto* conv_B_tensor_proto = nullptr;
   std::unique_ptr<Initializer> conv_B = nullptr;
@@ -70,7 +70,7 @@ Status ConvMulFusion::Apply(Graph& graph, Node& node, RewriteRuleEffect& rule_ef
       return Status::OK();
     }
 
-    conv_B = onnxruntime::make_unique<Initializer>(*conv_B_tensor_proto);
+    conv_B = onnxruntime::make_unique<Initializer>(*conv_B_tensor_proto, graph.ModelPath());
   }
 
   // Calculate new value of initializers of conv node
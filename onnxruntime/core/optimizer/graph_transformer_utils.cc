@@ -19,6 +19,8 @@
 #include "core/optimizer/nchwc_transformer.h"
 #include "core/optimizer/free_dim_override_transformer.h"
 #include "core/optimizer/gelu_fusion.h"
+#include "core/optimizer/layer_norm_fusion.h"
+#include "core/optimizer/attention_fusion.h"
 #include "core/mlas/inc/mlas.h"
 #include "core/session/inference_session.h"
 
@@ -117,6 +119,9 @@ std::vector<std::unique_ptr<GraphTransformer>> GenerateTransformers(TransformerL
       transformers.emplace_back(onnxruntime::make_unique<GemmActivationFusion>(l2_execution_providers));
       transformers.emplace_back(onnxruntime::make_unique<ConvActivationFusion>(l2_execution_providers));
       transformers.emplace_back(onnxruntime::make_unique<GeluFusion>(l2_execution_providers));
+      transformers.emplace_back(onnxruntime::make_unique<LayerNormFusion>(l2_execution_providers));
+      transformers.emplace_back(onnxruntime::make_unique<SkipLayerNormFusion>(l2_execution_providers));
+      transformers.emplace_back(onnxruntime::make_unique<AttentionFusion>(l2_execution_providers));
 #endif
     } break;
 
@@ -9,6 +9,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/tensorprotoutils.h"
+#include "core/platform/env.h"
 #include "core/graph/onnx_protobuf.h"
 #include "core/util/math.h"
 
@@ -43,7 +44,10 @@ class Initializer final {
     }
   }
 
-  Initializer(const ONNX_NAMESPACE::TensorProto& tensor_proto) : size_(0) {
+  // model_path is the file the model was loaded from, see Graph::ModelPath. External data locations are relative
+  // to its directory.
+  Initializer(const ONNX_NAMESPACE::TensorProto& tensor_proto, const std::basic_string<ORTCHAR_T>& model_path)
+      : size_(0) {
     data_type_ = tensor_proto.data_type();
     if (utils::HasName(tensor_proto)) {
       name_ = tensor_proto.name();
@@ -55,7 +59,10 @@ class Initializer final {
 
     size_ = std::accumulate(dims_.begin(), dims_.end(), static_cast<int64_t>(1), std::multiplies<int64_t>{});
 
-    if (utils::HasRawData(tensor_proto)) {
+    if (tensor_proto.data_location() == ONNX_NAMESPACE::TensorProto_DataLocation_EXTERNAL) {
+      ORT_THROW_IF_ERROR(utils::ReadExternalData(Env::Default(), model_path.empty() ? nullptr : model_path.c_str(),
+                                                 tensor_proto, raw_data_));
+    } else if (utils::HasRawData(tensor_proto)) {
       raw_data_ = tensor_proto.raw_data();
     } else {
       switch (data_type_) {
@@ -0,0 +1,301 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/initializer.h"
+#include "core/optimizer/layer_norm_fusion.h"
+#include "core/graph/graph_utils.h"
+#include "core/framework/tensorprotoutils.h"
+#include <deque>
+
+using namespace ONNX_NAMESPACE;
+using namespace onnxruntime::common;
+namespace onnxruntime {
+
+// Checks the type and provider of a node, that it has the given number of consumers and
+// that none of its outputs are graph outputs, so it can be removed by the fusion.
+static bool IsFusableNode(const Graph& graph, const Node& node, const std::string& op_type,
+                          const std::initializer_list<OperatorSetVersion>& versions,
+                          const std::string& provider, size_t output_edges = 1) {
+  return graph_utils::IsSupportedOptypeVersionAndDomain(node, op_type, versions) &&
+         node.GetExecutionProviderType() == provider &&
+         node.GetOutputEdgesCount() == output_edges &&
+         graph.GetNodeOutputsInGraphOutputs(node).empty();
+}
+
+// LayerNormalization is implemented for these types on CPU.
+static bool IsSupportedDataType(const NodeArg& input_arg) {
+  const auto* type = input_arg.TypeAsProto();
+  return type != nullptr && type->has_tensor_type() &&
+         (type->tensor_type().elem_type() == TensorProto_DataType_FLOAT ||
+          type->tensor_type().elem_type() == TensorProto_DataType_DOUBLE);
+}
+
+static bool GetConstantScalar(const Graph& graph, const NodeArg& input_arg, float& value) {
+  const TensorProto* tensor_proto = graph_utils::GetConstantInitializer(graph, input_arg.Name());
+  if (tensor_proto == nullptr ||
+      (tensor_proto->data_type() != TensorProto_DataType_FLOAT &&
+       tensor_proto->data_type() != TensorProto_DataType_DOUBLE)) {
+    return false;
+  }
+
+  Initializer init_const{*tensor_proto, graph.ModelPath()};
+  if (init_const.size() != 1) {
+    return false;
+  }
+  value = tensor_proto->data_type() == TensorProto_DataType_FLOAT
+              ? init_const.data<float>()[0]
+              : static_cast<float>(init_const.data<double>()[0]);
+  return true;
+}
+
+// Returns the rank of a NodeArg, or -1 if its shape is unknown.
+static int GetRank(const NodeArg& input_arg) {
+  const auto* shape = input_arg.Shape();
+  return shape != nullptr ? shape->dim_size() : -1;
+}
+
+// Checks that ReduceMean averages over the last axis of its input only, keeping the reduced axis.
+static bool IsReduceMeanOverLastAxis(const Node& node) {
+  std::vector<int64_t> axes;
+  if (!graph_utils::GetRepeatedNodeAttributeValues(node, "axes", axes) || axes.size() != 1) {
+    return false;
+  }
+
+  const auto* keepdims = graph_utils::GetNodeAttribute(node, "keepdims");
+  if (keepdims != nullptr && keepdims->i() == 0) {
+    return false;
+  }
+
+  const int rank = GetRank(*node.InputDefs()[0]);
+  return axes[0] == -1 || (rank > 0 && axes[0] == rank - 1);
+}
+
+// Checks that a scale or bias input is a vector with one value per element of the last axis of x.
+static bool IsVectorOverLastAxis(const NodeArg& input_arg, const NodeArg& x) {
+  const auto* shape = input_arg.Shape();
+  const auto* x_shape = x.Shape();
+  if (shape == nullptr || x_shape == nullptr || shape->dim_size() != 1 || x_shape->dim_size() < 1) {
+    return false;
+  }
+
+  const auto& dim = shape->dim(0);
+  const auto& x_dim = x_shape->dim(x_shape->dim_size() - 1);
+  return utils::HasDimValue(dim) && utils::HasDimValue(x_dim) && dim.dim_value() == x_dim.dim_value();
+}
+
+Status LayerNormFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+
+  for (auto node_index : node_topology_list) {
+    auto& reduce_mean = *graph.GetNode(node_index);
+    ORT_RETURN_IF_ERROR(Recurse(reduce_mean, modified, graph_level));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(reduce_mean, "ReduceMean", {1, 11}) ||
+        !graph_utils::IsSupportedProvider(reduce_mean, GetCompatibleExecutionProviders()) ||
+        reduce_mean.GetOutputEdgesCount() != 1 ||
+        !graph.GetNodeOutputsInGraphOutputs(reduce_mean).empty() ||
+        !IsSupportedDataType(*reduce_mean.InputDefs()[0]) ||
+        !IsReduceMeanOverLastAxis(reduce_mean)) {
+      continue;
+    }
+    const std::string& provider = reduce_mean.GetExecutionProviderType();
+    const NodeArg* x = reduce_mean.InputDefs()[0];
+
+    // x - mean(x) is consumed by both the Pow of the variance and the final Div.
+    const Node& sub = *(reduce_mean.OutputNodesBegin());
+    if (!IsFusableNode(graph, sub, "Sub", {7}, provider, 2) ||
+        sub.InputDefs()[0] != x) {
+      continue;
+    }
+
+    const Node* pow = nullptr;
+    const Node* div = nullptr;
+    for (auto iter = sub.OutputNodesBegin(); iter != sub.OutputNodesEnd(); ++iter) {
+      if ((*iter).OpType().compare("Pow") == 0) {
+        pow = &(*iter);
+      } else if ((*iter).OpType().compare("Div") == 0) {
+        div = &(*iter);
+      }
+    }
+    if (pow == nullptr || div == nullptr) {
+      continue;
+    }
+
+    float exponent;
+    if (!IsFusableNode(graph, *pow, "Pow", {7}, provider) ||
+        pow->InputDefs()[0] != sub.OutputDefs()[0] ||
+        !GetConstantScalar(graph, *pow->InputDefs()[1], exponent) || exponent != 2.0f) {
+      continue;
+    }
+
+    const Node& reduce_mean2 = *(pow->OutputNodesBegin());
+    if (!IsFusableNode(graph, reduce_mean2, "ReduceMean", {1, 11}, provider) ||
+        !IsReduceMeanOverLastAxis(reduce_mean2)) {
+      continue;
+    }
+
+    // The other input of the Add is epsilon.
+    const Node& add_epsilon = *(reduce_mean2.OutputNodesBegin());
+    float epsilon;
+    if (!IsFusableNode(graph, add_epsilon, "Add", {7}, provider) ||
+        !GetConstantScalar(graph, *add_epsilon.InputDefs()[add_epsilon.InputDefs()[0] == reduce_mean2.OutputDefs()[0] ? 1 : 0],
+                           epsilon)) {
+      continue;
+    }
+
+    const Node& sqrt = *(add_epsilon.OutputNodesBegin());
+    if (!IsFusableNode(graph, sqrt, "Sqrt", {6}, provider) ||
+        !IsFusableNode(graph, *div, "Div", {7}, provider) ||
+        div->InputDefs()[0] != sub.OutputDefs()[0] ||
+        div->InputDefs()[1] != sqrt.OutputDefs()[0]) {
+      continue;
+    }
+
+    const Node& mul = *(div->OutputNodesBegin());
+    if (!IsFusableNode(graph, mul, "Mul", {7}, provider)) {
+      continue;
+    }
+    const NodeArg* scale = mul.InputDefs()[mul.InputDefs()[0] == div->OutputDefs()[0] ? 1 : 0];
+
+    // The output of the last Add is the output of the subgraph, so it may have any number of consumers.
+    const Node& add_bias = *(mul.OutputNodesBegin());
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(add_bias, "Add", {7}) ||
+        add_bias.GetExecutionProviderType() != provider) {
+      continue;
+    }
+    const NodeArg* bias = add_bias.InputDefs()[add_bias.InputDefs()[0] == mul.OutputDefs()[0] ? 1 : 0];
+
+    if (!IsVectorOverLastAxis(*scale, *x) || !IsVectorOverLastAxis(*bias, *x)) {
+      continue;
+    }
+
+    const std::vector<NodeArg*> layer_norm_input_defs{const_cast<NodeArg*>(x),
+                                                      const_cast<NodeArg*>(scale),
+                                                      const_cast<NodeArg*>(bias)};
+    const std::vector<NodeArg*> layer_norm_output_defs{const_cast<NodeArg*>(add_bias.OutputDefs()[0])};
+    Node& layer_norm_node = graph.AddNode(graph.GenerateNodeName("LayerNormalization"),
+                                          "LayerNormalization",
+                                          "fused LayerNorm subgraphs ",
+                                          layer_norm_input_defs,
+                                          layer_norm_output_defs, {}, kOnnxDomain);
+    layer_norm_node.AddAttribute("axis", static_cast<int64_t>(-1));
+    layer_norm_node.AddAttribute("epsilon", epsilon);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    layer_norm_node.SetExecutionProviderType(provider);
+
+    removed_nodes.push_front(reduce_mean.Index());
+    removed_nodes.push_front(sub.Index());
+    removed_nodes.push_front(pow->Index());
+    removed_nodes.push_front(reduce_mean2.Index());
+    removed_nodes.push_front(add_epsilon.Index());
+    removed_nodes.push_front(sqrt.Index());
+    removed_nodes.push_front(div->Index());
+    removed_nodes.push_front(mul.Index());
+    removed_nodes.push_front(add_bias.Index());
+  }
+
+  // Remove consumers before producers; the outputs of the last Add are taken over by the fused node.
+  for (onnxruntime::NodeIndex removed_node : removed_nodes) {
+    graph_utils::RemoveNodeOutputEdges(graph, *graph.GetNode(removed_node));
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+// Checks that both inputs of the residual Add are 3D with the same shape, as SkipLayerNormalization
+// does not broadcast.
+static bool HaveSameShape(const NodeArg& input, const NodeArg& skip) {
+  const auto* input_shape = input.Shape();
+  const auto* skip_shape = skip.Shape();
+  if (input_shape == nullptr || skip_shape == nullptr ||
+      input_shape->dim_size() != 3 || skip_shape->dim_size() != 3) {
+    return false;
+  }
+
+  for (int i = 0; i < 3; i++) {
+    const auto& input_dim = input_shape->dim(i);
+    const auto& skip_dim = skip_shape->dim(i);
+    if (utils::HasDimValue(input_dim) && utils::HasDimValue(skip_dim)) {
+      if (input_dim.dim_value() != skip_dim.dim_value()) {
+        return false;
+      }
+    } else if (!utils::HasDimParam(input_dim) || !utils::HasDimParam(skip_dim) ||
+               input_dim.dim_param() != skip_dim.dim_param()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+Status SkipLayerNormFusion::ApplyImpl(Graph& graph, bool& modified, int graph_level) const {
+  GraphViewer graph_viewer(graph);
+  const auto& node_topology_list = graph_viewer.GetNodesInTopologicalOrder();
+  std::deque<onnxruntime::NodeIndex> removed_nodes;
+
+  for (auto node_index : node_topology_list) {
+    auto& layer_norm = *graph.GetNode(node_index);
+    ORT_RETURN_IF_ERROR(Recurse(layer_norm, modified, graph_level));
+
+    if (!graph_utils::IsSupportedOptypeVersionAndDomain(layer_norm, "LayerNormalization", {1}) ||
+        !graph_utils::IsSupportedProvider(layer_norm, GetCompatibleExecutionProviders()) ||
+        layer_norm.OutputDefs().size() != 1 ||
+        GetRank(*layer_norm.InputDefs()[1]) != 1 ||
+        GetRank(*layer_norm.InputDefs()[2]) != 1) {
+      continue;
+    }
+
+    // SkipLayerNormalization normalizes over the last axis of 3D float tensors.
+    const auto* axis = graph_utils::GetNodeAttribute(layer_norm, "axis");
+    if (axis != nullptr && axis->i() != -1 && axis->i() != 2) {
+      continue;
+    }
+
+    const std::string& provider = layer_norm.GetExecutionProviderType();
+    const Node* add = graph_utils::GetInputNode(layer_norm, 0);
+    if (add == nullptr ||
+        !IsFusableNode(graph, *add, "Add", {7}, provider) ||
+        !HaveSameShape(*add->InputDefs()[0], *add->InputDefs()[1]) ||
+        add->InputDefs()[0]->TypeAsProto()->tensor_type().elem_type() != TensorProto_DataType_FLOAT) {
+      continue;
+    }
+
+    const auto* epsilon = graph_utils::GetNodeAttribute(layer_norm, "epsilon");
+
+    const std::vector<NodeArg*> skip_layer_norm_input_defs{const_cast<NodeArg*>(add->InputDefs()[0]),
+                                                           const_cast<NodeArg*>(add->InputDefs()[1]),
+                                                           layer_norm.MutableInputDefs()[1],
+                                                           layer_norm.MutableInputDefs()[2]};
+    Node& skip_layer_norm_node = graph.AddNode(graph.GenerateNodeName("SkipLayerNormalization"),
+                                               "SkipLayerNormalization",
+                                               "fused SkipLayerNorm subgraphs ",
+                                               skip_layer_norm_input_defs,
+                                               layer_norm.MutableOutputDefs(), {}, kMSDomain);
+    skip_layer_norm_node.AddAttribute("epsilon", epsilon != nullptr ? epsilon->f() : 1e-5f);
+
+    // Assign provider to this new node. Provider should be same as the provider for old node.
+    skip_layer_norm_node.SetExecutionProviderType(provider);
+
+    removed_nodes.push_front(add->Index());
+    removed_nodes.push_front(layer_norm.Index());
+  }
+
+  for (onnxruntime::NodeIndex removed_node : removed_nodes) {
+    graph_utils::RemoveNodeOutputEdges(graph, *graph.GetNode(removed_node));
+    graph.RemoveNode(removed_node);
+  }
+
+  if (!removed_nodes.empty()) {
+    modified = true;
+  }
+
+  return Status::OK();
+}
+}  // namespace onnxruntime
@@ -364,7 +364,7 @@ void NchwcTransformerImpl::TransformConv(Node& node) {
     // Reuse the existing NodeArg.
     nchwc_conv_W_arg = filters_it->second;
   } else {
-    auto conv_W = onnxruntime::make_unique<Initializer>(*conv_W_tensor_proto);
+    auto conv_W = onnxruntime::make_unique<Initializer>(*conv_W_tensor_proto, graph_.ModelPath());
 
     std::vector<float> reordered_filter(conv_W->size() / output_channels * nchwc_output_channels);
 
@@ -400,7 +400,7 @@ void NchwcTransformerImpl::TransformConv(Node& node) {
       // Reuse the existing NodeArg.
       nchwc_conv_B_arg = biases_it->second;
     } else {
-      auto conv_B = onnxruntime::make_unique<Initializer>(*conv_B_tensor_proto);
+      auto conv_B = onnxruntime::make_unique<Initializer>(*conv_B_tensor_proto, graph_.ModelPath());
 
       std::vector<float> aligned_bias(nchwc_output_channels);
       std::copy_n(conv_B->data<float>(), output_channels, aligned_bias.data());
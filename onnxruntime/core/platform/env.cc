@@ -15,12 +15,57 @@ limitations under the License.
 // Portions Copyright (c) Microsoft Corporation
 
 #include "core/platform/env.h"
+
+#include <cerrno>
+#include <cstdlib>
+
 #include "gsl/gsl"
 
 namespace onnxruntime {
 
 Env::Env() = default;
 
+common::Status Env::ParseProcessorList(const std::string& processor_list, int max_processor_id,
+                                       std::vector<int>& processor_ids) {
+  processor_ids.clear();
+  const auto invalid = [&processor_list]() {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid processor list '", processor_list, "'");
+  };
+
+  // Parses a non-negative id at p and advances p past it.
+  const auto parse_id = [max_processor_id](const char*& p, long& id) {
+    if (*p < '0' || *p > '9')
+      return false;
+    char* end = nullptr;
+    errno = 0;
+    id = std::strtol(p, &end, 10);
+    p = end;
+    return errno == 0 && id <= max_processor_id;
+  };
+
+  const char* p = processor_list.c_str();
+  for (;;) {
+    long first = 0;
+    if (!parse_id(p, first))
+      return invalid();
+    long last = first;
+    if (*p == '-') {
+      ++p;
+      if (!parse_id(p, last) || last < first)
+        return invalid();
+    }
+    for (long id = first; id <= last; ++id) {
+      processor_ids.push_back(static_cast<int>(id));
+    }
+
+    if (*p == 0)
+      break;
+    if (*p++ != ',')
+      return invalid();
+  }
+  return common::Status::OK();
+}
+
 }  // namespace onnxruntime
 
 // This definition is provided to handle GSL failures in CUDA as
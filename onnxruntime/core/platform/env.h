@@ -89,6 +89,23 @@ class Env {
                                           OrtCallback& deleter) const = 0;
 #endif
 
+  /**
+   * Maps a range of a file into memory, read-only. The pages are backed by the file: they are read on first
+   * access and shared with every other process that maps the same file.
+   * \param file_path file_path must point to a regular file
+   * \param offset offset of the range in the file. It doesn't need to be aligned.
+   * \param[in, out] len length of the range. If len==0, map the rest of the file and return its length.
+   * \param[out] p start of the range, or nullptr if it's empty
+   * \param[out] deleter unmaps the range
+   */
+#ifndef _WIN32
+  virtual common::Status MapFileIntoMemory(const char* file_path, off_t offset, size_t& len, void*& p,
+                                           OrtCallback& deleter) const = 0;
+#else
+  virtual common::Status MapFileIntoMemory(const wchar_t* file_path, int64_t offset, size_t& len, void*& p,
+                                           OrtCallback& deleter) const = 0;
+#endif
+
 #ifdef _WIN32
   //Mainly for use with protobuf library
   virtual common::Status FileOpenRd(const std::wstring& path, /*out*/ int& fd) const = 0;
@@ -104,6 +121,20 @@ class Env {
   //This functions is always successful. It can't fail.
   virtual PIDType GetSelfPid() const = 0;
 
+  /// \brief Returns the ids of the logical processors that belong to the given NUMA node.
+  virtual common::Status GetNumaNodeProcessors(int numa_node, std::vector<int>& processor_ids) const = 0;
+
+  /// \brief Returns the ids of the logical processors the calling thread may run on.
+  virtual common::Status GetThreadAffinity(std::vector<int>& processor_ids) const = 0;
+
+  /// \brief Restricts the calling thread to the given logical processors.
+  virtual common::Status SetThreadAffinity(const std::vector<int>& processor_ids) const = 0;
+
+  /// \brief Parses a list of logical processor ids such as "0-3,8,10-11", the format of Linux cpu lists.
+  /// Fails if the list is empty or malformed, a range is descending, or an id is above max_processor_id.
+  static common::Status ParseProcessorList(const std::string& processor_list, int max_processor_id,
+                                           std::vector<int>& processor_ids);
+
   // \brief Load a dynamic library.
   //
   // Pass "library_filename" to a platform-specific mechanism for dynamically
@@ -27,6 +27,11 @@ limitations under the License.
 #include <thread>
 #include <vector>
 #include <assert.h>
+#include <fstream>
+#include <sstream>
+#ifdef __linux__
+#include <sched.h>
+#endif
 #include "core/platform/env.h"
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
@@ -57,7 +62,9 @@ static void UnmapFile(void* param) noexcept {
     int err = errno;
     LOGS_DEFAULT(INFO) << "munmap failed. error code:" << err;
   }
-  (void)close(p->fd);
+  if (p->fd >= 0) {
+    (void)close(p->fd);
+  }
   delete p;
 }
 
@@ -99,6 +106,68 @@ class PosixEnv : public Env {
     return getpid();
   }
 
+  common::Status GetNumaNodeProcessors(int numa_node, std::vector<int>& processor_ids) const override {
+    processor_ids.clear();
+#ifdef __linux__
+    std::ostringstream path;
+    path << "/sys/devices/system/node/node" << numa_node << "/cpulist";
+    std::ifstream cpu_list_file(path.str());
+    std::string cpu_list;
+    if (numa_node < 0 || !cpu_list_file || !std::getline(cpu_list_file, cpu_list)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "NUMA node ", numa_node, " does not exist");
+    }
+    auto status = ParseProcessorList(cpu_list, CPU_SETSIZE - 1, processor_ids);
+    if (!status.IsOK()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Unable to parse the processors of NUMA node ", numa_node, ". ",
+                             status.ErrorMessage());
+    }
+    return Status::OK();
+#else
+    ORT_UNUSED_PARAMETER(numa_node);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "NUMA topology is not available on this platform");
+#endif
+  }
+
+  common::Status GetThreadAffinity(std::vector<int>& processor_ids) const override {
+    processor_ids.clear();
+#ifdef __linux__
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    if (sched_getaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "sched_getaffinity failed. error code:", errno);
+    }
+    for (int id = 0; id < CPU_SETSIZE; ++id) {
+      if (CPU_ISSET(id, &cpu_set)) {
+        processor_ids.push_back(id);
+      }
+    }
+    return Status::OK();
+#else
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Thread affinity is not supported on this platform");
+#endif
+  }
+
+  common::Status SetThreadAffinity(const std::vector<int>& processor_ids) const override {
+#ifdef __linux__
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int id : processor_ids) {
+      if (id < 0 || id >= CPU_SETSIZE) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid processor id ", id);
+      }
+      CPU_SET(id, &cpu_set);
+    }
+    // pid 0 means the calling thread
+    if (sched_setaffinity(0, sizeof(cpu_set), &cpu_set) != 0) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "sched_setaffinity failed. error code:", errno);
+    }
+    return Status::OK();
+#else
+    ORT_UNUSED_PARAMETER(processor_ids);
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Thread affinity is not supported on this platform");
+#endif
+  }
+
   static common::Status ReadBinaryFile(int fd, off_t offset, const char* fname, void*& p, size_t len,
                                        OrtCallback& deleter) {
     std::unique_ptr<char[]> buffer(reinterpret_cast<char*>(malloc(len)));
@@ -175,6 +244,62 @@ class PosixEnv : public Env {
     return common::Status::OK();
   }
 
+  common::Status MapFileIntoMemory(const char* fname, off_t offset, size_t& len, void*& p,
+                                   OrtCallback& deleter) const override {
+    if (!fname) {
+      return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "MapFileIntoMemory: 'fname' cannot be NULL");
+    }
+    if (offset < 0) {
+      return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                            "MapFileIntoMemory: offset must be non-negative");
+    }
+    deleter.f = nullptr;
+    deleter.param = nullptr;
+    p = nullptr;
+
+    int fd = open(fname, O_RDONLY);
+    if (fd < 0) {
+      return ReportSystemError("open", fname);
+    }
+    // the mapping stays valid after the file is closed
+    std::unique_ptr<int, void (*)(int*)> fd_holder(&fd, [](int* f) { (void)close(*f); });
+
+    struct stat stbuf;
+    if (fstat(fd, &stbuf) != 0) {
+      return ReportSystemError("fstat", fname);
+    }
+    if (!S_ISREG(stbuf.st_mode)) {
+      return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                            "MapFileIntoMemory: input is not a regular file");
+    }
+    if (offset > stbuf.st_size) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "MapFileIntoMemory: offset ", offset,
+                             " is past the end of file '", fname, "'");
+    }
+    if (len == 0) {
+      len = static_cast<size_t>(stbuf.st_size - offset);
+    } else if (static_cast<uint64_t>(stbuf.st_size - offset) < len) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "MapFileIntoMemory: file '", fname,
+                             "' is too short for the requested range");
+    }
+    if (len == 0) {
+      return Status::OK();
+    }
+
+    // mmap needs a page-aligned offset
+    const off_t page_size = static_cast<off_t>(sysconf(_SC_PAGESIZE));
+    const off_t offset_to_page = offset % page_size;
+    void* addr = mmap(nullptr, len + offset_to_page, PROT_READ, MAP_SHARED, fd, offset - offset_to_page);
+    if (addr == MAP_FAILED) {
+      return ReportSystemError("mmap", fname);
+    }
+
+    deleter.f = UnmapFile;
+    deleter.param = new UnmapFileParam{addr, len + offset_to_page, -1};
+    p = reinterpret_cast<char*>(addr) + offset_to_page;
+    return Status::OK();
+  }
+
   static common::Status ReportSystemError(const char* operation_name, const std::string& path) {
     auto e = errno;
     char buf[1024];
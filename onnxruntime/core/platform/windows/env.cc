@@ -17,6 +17,7 @@ limitations under the License.
 #include <Shlwapi.h>
 #include <Windows.h>
 
+#include <climits>
 #include <string>
 #include <thread>
 #include <fcntl.h>
@@ -32,6 +33,12 @@ namespace {
 
 static void DeleteBuffer(void* param) noexcept { ::free(param); }
 
+static void UnmapFile(void* param) noexcept {
+  if (!UnmapViewOfFile(param)) {
+    LOGS_DEFAULT(INFO) << "UnmapViewOfFile failed. error code:" << GetLastError();
+  }
+}
+
 class WindowsEnv : public Env {
  public:
   void SleepForMicroseconds(int64_t micros) const override { Sleep(static_cast<DWORD>(micros) / 1000); }
@@ -69,6 +76,61 @@ class WindowsEnv : public Env {
     return GetCurrentProcessId();
   }
 
+  common::Status GetNumaNodeProcessors(int numa_node, std::vector<int>& processor_ids) const override {
+    processor_ids.clear();
+    GROUP_AFFINITY affinity;
+    if (numa_node < 0 || numa_node > USHRT_MAX ||
+        !GetNumaNodeProcessorMaskEx(static_cast<USHORT>(numa_node), &affinity)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "NUMA node ", numa_node, " does not exist");
+    }
+    AppendProcessors(affinity, processor_ids);
+    if (processor_ids.empty()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "NUMA node ", numa_node, " has no processors");
+    }
+    return Status::OK();
+  }
+
+  common::Status GetThreadAffinity(std::vector<int>& processor_ids) const override {
+    processor_ids.clear();
+    GROUP_AFFINITY affinity;
+    if (!GetThreadGroupAffinity(GetCurrentThread(), &affinity)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "GetThreadGroupAffinity failed. error code:", GetLastError());
+    }
+    AppendProcessors(affinity, processor_ids);
+    return Status::OK();
+  }
+
+  // A thread can only have affinity within a single processor group,
+  // so all ids must belong to the same group of 64 processors.
+  common::Status SetThreadAffinity(const std::vector<int>& processor_ids) const override {
+    if (processor_ids.empty()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "No processors given");
+    }
+    GROUP_AFFINITY affinity = {};
+    affinity.Group = static_cast<WORD>(processor_ids.front() / kProcessorsPerGroup);
+    for (int id : processor_ids) {
+      if (id < 0 || id / kProcessorsPerGroup != affinity.Group) {
+        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                               "Processor ids must be non-negative and belong to the same processor group");
+      }
+      affinity.Mask |= KAFFINITY(1) << (id % kProcessorsPerGroup);
+    }
+    if (!SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr)) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "SetThreadGroupAffinity failed. error code:", GetLastError());
+    }
+    return Status::OK();
+  }
+
+  static constexpr int kProcessorsPerGroup = sizeof(KAFFINITY) * 8;
+
+  static void AppendProcessors(const GROUP_AFFINITY& affinity, std::vector<int>& processor_ids) {
+    for (int bit = 0; bit < kProcessorsPerGroup; ++bit) {
+      if (affinity.Mask & (KAFFINITY(1) << bit)) {
+        processor_ids.push_back(affinity.Group * kProcessorsPerGroup + bit);
+      }
+    }
+  }
+
   static common::Status GetFileSizeIfUnknown(const wchar_t* fname, HANDLE hFile, size_t& length) {
     if (length > 0) return Status::OK();
     LARGE_INTEGER filesize;
@@ -145,6 +207,76 @@ class WindowsEnv : public Env {
     return common::Status::OK();
   }
 
+  common::Status MapFileIntoMemory(const wchar_t* fname, int64_t offset, size_t& len, void*& p,
+                                   OrtCallback& deleter) const override {
+    if (!fname) {
+      return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "MapFileIntoMemory: 'fname' cannot be NULL");
+    }
+    if (offset < 0) {
+      return common::Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT,
+                            "MapFileIntoMemory: offset must be non-negative");
+    }
+    deleter.f = nullptr;
+    deleter.param = nullptr;
+    p = nullptr;
+
+    HANDLE hFile = CreateFileW(fname, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (hFile == INVALID_HANDLE_VALUE) {
+      int err = GetLastError();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "open file ", ToMBString(fname), " fail, errcode =", err);
+    }
+    // the view stays valid after the file and mapping handles are closed
+    std::unique_ptr<void, decltype(&CloseHandle)> file_holder(hFile, CloseHandle);
+
+    LARGE_INTEGER filesize;
+    if (!GetFileSizeEx(hFile, &filesize)) {
+      int err = GetLastError();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "GetFileSizeEx ", ToMBString(fname), " fail, errcode =", err);
+    }
+    if (offset > filesize.QuadPart) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "MapFileIntoMemory: offset ", offset,
+                             " is past the end of file ", ToMBString(fname));
+    }
+    const ULONGLONG remaining = static_cast<ULONGLONG>(filesize.QuadPart - offset);
+    if (len == 0) {
+      if (remaining > std::numeric_limits<size_t>::max()) {
+        return common::Status(common::ONNXRUNTIME, common::FAIL, "MapFileIntoMemory: File is too large");
+      }
+      len = static_cast<size_t>(remaining);
+    } else if (remaining < len) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "MapFileIntoMemory: file ", ToMBString(fname),
+                             " is too short for the requested range");
+    }
+    if (len == 0) {
+      return Status::OK();
+    }
+
+    HANDLE hMapping = CreateFileMappingW(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (hMapping == NULL) {
+      int err = GetLastError();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "CreateFileMapping ", ToMBString(fname), " fail, errcode =", err);
+    }
+    std::unique_ptr<void, decltype(&CloseHandle)> mapping_holder(hMapping, CloseHandle);
+
+    // views must start at a multiple of the allocation granularity
+    SYSTEM_INFO sysInfo;
+    GetSystemInfo(&sysInfo);
+    const int64_t offset_to_granularity = offset % static_cast<int64_t>(sysInfo.dwAllocationGranularity);
+    const ULONGLONG view_offset = static_cast<ULONGLONG>(offset - offset_to_granularity);
+    void* view = MapViewOfFile(hMapping, FILE_MAP_READ, static_cast<DWORD>(view_offset >> 32),
+                               static_cast<DWORD>(view_offset & 0xFFFFFFFF),
+                               len + static_cast<size_t>(offset_to_granularity));
+    if (view == nullptr) {
+      int err = GetLastError();
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "MapViewOfFile ", ToMBString(fname), " fail, errcode =", err);
+    }
+
+    deleter.f = UnmapFile;
+    deleter.param = view;
+    p = reinterpret_cast<char*>(view) + offset_to_granularity;
+    return Status::OK();
+  }
+
   common::Status FileOpenRd(const std::wstring& path, /*out*/ int& fd) const override {
     _wsopen_s(&fd, path.c_str(), _O_RDONLY | _O_SEQUENTIAL | _O_BINARY, _SH_DENYWR, _S_IREAD | _S_IWRITE);
     if (0 > fd) {
@@ -5,6 +5,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 
 namespace onnxruntime {
@@ -330,6 +331,22 @@ struct BroadcastIterator {
     return index;
   }
 
+  // Positions the iterator at the given element of the output, as if AdvanceBy had been
+  // called for a total of offset elements. Counter k has been incremented once for every
+  // wrap of counter k-1, which is the offset divided by the counts below it.
+  void Seek(size_t offset) {
+    ptrdiff_t index = deltas_[0] * static_cast<ptrdiff_t>(offset);
+    auto remaining = static_cast<int64_t>(offset);
+    counters_[0] = remaining % counts_[0];
+    remaining /= counts_[0];
+    for (size_t counterIndex = 1; counterIndex < counters_.size(); counterIndex++) {
+      index += deltas_[counterIndex] * static_cast<ptrdiff_t>(remaining);
+      counters_[counterIndex] = remaining % counts_[counterIndex];
+      remaining /= counts_[counterIndex];
+    }
+    index_ = static_cast<size_t>(index);
+  }
+
   void Reserve(int64_t max_dims) {
     deltas_.reserve(static_cast<size_t>(max_dims));
     counts_.reserve(static_cast<size_t>(max_dims));
@@ -480,6 +497,12 @@ struct TBroadcaster {
   TensorShape GetOutputShape() const { return TensorShape(broadcaster_.output_shape_); }
   size_t GetSpanSize() const { return span_size_; }
 
+  // Positions both inputs at the given element of the output. Must be the start of a span.
+  void Seek(size_t offset) {
+    broadcaster_.iterator1_.Seek(offset);
+    broadcaster_.iterator2_.Seek(offset);
+  }
+
   bool IsInput0Scalar() const { return broadcaster_.iterator1_.deltas_.front() == 0; }
   bool IsInput1Scalar() const { return broadcaster_.iterator2_.deltas_.front() == 0; }
 
@@ -513,6 +536,13 @@ struct TBroadcastOutput {
     output_end_ = output_ + tensor.Shape().Size();
   }
 
+  // Limits the output to elements [first, last), which must be whole spans.
+  TBroadcastOutput(size_t span_size, Tensor& tensor, size_t first, size_t last)
+      : span_size_(span_size) {
+    output_ = tensor.template MutableData<T>() + first;
+    output_end_ = tensor.template MutableData<T>() + last;
+  }
+
   operator bool() const {
     return output_ != output_end_;
   }
@@ -593,11 +623,79 @@ void BroadcastLoopSpan(TBroadcaster& bc, Output& output, Input0Scalar input0scal
   }
 }
 
+// Runs BroadcastLoop split across the thread pool. The function forms are the same as BroadcastLoop.
+// The broadcaster has already merged adjacent axes that broadcast the same way, so the output is
+// a sequence of spans that each read a scalar or a contiguous run of every input. With many spans,
+// each task walks a copy of the broadcaster positioned at its first span. With only a few large
+// spans (e.g. same shape inputs, or a scalar and a tensor), the spans are walked in order and each
+// is split across the pool instead.
+// unit_cost is the estimated number of cycles to produce one output element.
+template <typename TOutput, typename T0, typename T1, typename Input0Scalar, typename Input1Scalar, typename General>
+void ParallelBroadcastLoop(TBroadcaster<T0, T1>& bc, Tensor& output_tensor, concurrency::ThreadPool* tp, double unit_cost,
+                           Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
+  const auto output_size = static_cast<std::ptrdiff_t>(output_tensor.Shape().Size());
+  if (output_size == 0) {
+    return;
+  }
+
+  const auto span_size = static_cast<std::ptrdiff_t>(bc.GetSpanSize());
+  const std::ptrdiff_t num_spans = output_size / span_size;
+
+  if (tp == nullptr || num_spans >= 4 * (static_cast<std::ptrdiff_t>(tp->NumThreads()) + 1)) {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, num_spans, static_cast<double>(span_size) * unit_cost,
+        [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+          TBroadcaster<T0, T1> span_bc(bc);
+          span_bc.Seek(static_cast<size_t>(first * span_size));
+          TBroadcastOutput<TOutput> output(static_cast<size_t>(span_size), output_tensor,
+                                           static_cast<size_t>(first * span_size),
+                                           static_cast<size_t>(last * span_size));
+          BroadcastLoop(span_bc, output, input0scalar, input1scalar, general);
+        });
+    return;
+  }
+
+  TBroadcastOutput<TOutput> output(static_cast<size_t>(span_size), output_tensor);
+  while (output) {
+    auto output_span = output.NextEigenOutput();
+    TOutput* output_data = output_span.data();
+    if (bc.IsInput0Scalar()) {
+      const auto& input0 = bc.NextScalar0();
+      const auto* input1 = bc.NextEigen1().data();
+      concurrency::ThreadPool::TryParallelFor(
+          tp, span_size, unit_cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            input0scalar(EigenVectorMap<TOutput>(output_data + first, last - first), input0,
+                         ConstEigenVectorMap<T1>(input1 + first, last - first));
+          });
+    } else if (bc.IsInput1Scalar()) {
+      const auto* input0 = bc.NextEigen0().data();
+      const auto& input1 = bc.NextScalar1();
+      concurrency::ThreadPool::TryParallelFor(
+          tp, span_size, unit_cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            input1scalar(EigenVectorMap<TOutput>(output_data + first, last - first),
+                         ConstEigenVectorMap<T0>(input0 + first, last - first),
+                         input1);
+          });
+    } else {
+      const auto* input0 = bc.NextEigen0().data();
+      const auto* input1 = bc.NextEigen1().data();
+      concurrency::ThreadPool::TryParallelFor(
+          tp, span_size, unit_cost, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            general(EigenVectorMap<TOutput>(output_data + first, last - first),
+                    ConstEigenVectorMap<T0>(input0 + first, last - first),
+                    ConstEigenVectorMap<T1>(input1 + first, last - first));
+          });
+    }
+  }
+}
+
 template <typename TInput, typename TOutput, typename Input0Scalar, typename Input1Scalar, typename General>
-Status BroadcastTwo(OpKernelContext& context, Input0Scalar input0scalar, Input1Scalar input1scalar, General general) {
+Status BroadcastTwo(OpKernelContext& context, Input0Scalar input0scalar, Input1Scalar input1scalar, General general,
+                    double unit_cost = 1.0) {
   TBroadcaster<TInput, TInput> bc(*context.Input<Tensor>(0), *context.Input<Tensor>(1));
-  TBroadcastOutput<TOutput> output(bc.GetSpanSize(), *context.Output(0, bc.GetOutputShape()));
-  BroadcastLoop(bc, output, input0scalar, input1scalar, general);
+  Tensor& output = *context.Output(0, bc.GetOutputShape());
+  ParallelBroadcastLoop<TOutput>(bc, output, context.GetOperatorThreadPool(), unit_cost,
+                                 input0scalar, input1scalar, general);
 
   return Status::OK();
 }
@@ -634,9 +732,8 @@ Status BroadcastVariadic(const Node& node, OpKernelContext& context, Input0Scala
       p_output = tempOutput.get();
     }
 
-    TBroadcastOutput<TOutput> output(bc.GetSpanSize(), *p_output);
-
-    BroadcastLoop(bc, output, input0scalar, input1scalar, general);
+    ParallelBroadcastLoop<TOutput>(bc, *p_output, context.GetOperatorThreadPool(), 1.0,
+                                   input0scalar, input1scalar, general);
 
     tempInput = std::move(tempOutput);
   }
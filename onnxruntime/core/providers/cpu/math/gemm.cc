@@ -2,9 +2,87 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/math/gemm.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 
+bool GemmPackBFp32(const OpKernelInfo& info, const Tensor& tensor_b, bool trans_b,
+                   PrePackedWeights& prepacked_weights, const void*& packed_b) {
+#if defined(USE_MKLML_FOR_BLAS)
+  // math::Gemm is implemented by MKL in this build, so keep using the original weights
+  ORT_UNUSED_PARAMETER(info);
+  ORT_UNUSED_PARAMETER(tensor_b);
+  ORT_UNUSED_PARAMETER(trans_b);
+  ORT_UNUSED_PARAMETER(prepacked_weights);
+  ORT_UNUSED_PARAMETER(packed_b);
+  return false;
+#else
+  // Only handle the common case of a 2D weight matrix
+  const auto& b_shape = tensor_b.Shape();
+  if (b_shape.NumDimensions() != 2) {
+    return false;
+  }
+
+  const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
+
+  auto pack = [&](BufferUniquePtr& buffer) {
+    const size_t packed_b_size = MlasGemmPackBSize(N, K);
+    if (packed_b_size == 0) {
+      return false;
+    }
+
+    auto alloc = info.GetAllocator(0, OrtMemTypeDefault);
+    buffer = BufferUniquePtr(alloc->Alloc(packed_b_size), BufferDeleter(alloc));
+
+    MlasGemmPackB(trans_b ? CblasTrans : CblasNoTrans,
+                  N,
+                  K,
+                  tensor_b.Data<float>(),
+                  trans_b ? K : N,
+                  buffer.get());
+    return true;
+  };
+
+  packed_b = prepacked_weights.GetOrPack(trans_b ? "MlasGemmPackB:T" : "MlasGemmPackB:N", pack);
+  return packed_b != nullptr;
+#endif
+}
+
+template <>
+Status Gemm<float>::PrePack(const Tensor& tensor, int input_idx, PrePackedWeights& prepacked_weights,
+                            bool& is_packed) {
+  is_packed = false;
+
+  // only pack matrix B
+  if (input_idx == 1) {
+    is_packed = GemmPackBFp32(Info(), tensor, trans_B_ != CblasNoTrans, prepacked_weights, packed_b_);
+  }
+  return Status::OK();
+}
+
+template <>
+void Gemm<float>::ComputeGemm(int64_t M, int64_t N, int64_t K, const float* x_data, const float* w_data, float beta,
+                              float* y_data, concurrency::ThreadPool* tp) const {
+  if (packed_b_) {
+    MlasGemm(trans_A_,
+             static_cast<size_t>(M),
+             static_cast<size_t>(N),
+             static_cast<size_t>(K),
+             alpha_,
+             x_data,
+             static_cast<size_t>(trans_A_ == CblasNoTrans ? K : M),
+             packed_b_,
+             beta,
+             y_data,
+             static_cast<size_t>(N),
+             tp);
+    return;
+  }
+
+  math::Gemm<float>(trans_A_, trans_B_, M, N, K, alpha_, x_data, w_data, beta, y_data, tp);
+}
+
 ONNX_CPU_OPERATOR_VERSIONED_KERNEL(
     Gemm,
     7,
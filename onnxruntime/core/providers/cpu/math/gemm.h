@@ -12,6 +12,11 @@
 
 namespace onnxruntime {
 
+// Packs a constant 2D matrix B of a float GEMM into the layout used by the packed MlasGemm, or finds the copy
+// another kernel packed the same way. Returns false and leaves packed_b unset if the tensor can not be packed.
+bool GemmPackBFp32(const OpKernelInfo& info, const Tensor& tensor_b, bool trans_b,
+                   PrePackedWeights& prepacked_weights, const void*& packed_b);
+
 template <typename T>
 class Gemm : public OpKernel {
  public:
@@ -27,6 +32,9 @@ class Gemm : public OpKernel {
     ORT_ENFORCE(info.GetAttr<float>("beta", &beta_).IsOK());
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, PrePackedWeights& prepacked_weights,
+                 bool& is_packed) override;
+
   Status Compute(OpKernelContext* context) const override {
     concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
 
@@ -69,13 +77,10 @@ class Gemm : public OpKernel {
     }
 
     // W * x
-    math::Gemm<T>(
-        trans_A_,
-        trans_B_,
+    ComputeGemm(
         M,
         N,
         helper.K(),
-        alpha_,
         X->template Data<T>(),
         W->template Data<T>(),
         // ideally we need to set the output buffer contents to 0 if bias is missing,
@@ -90,15 +95,38 @@ class Gemm : public OpKernel {
   }
 
  private:
+  void ComputeGemm(int64_t M, int64_t N, int64_t K, const T* x_data, const T* w_data, float beta, T* y_data,
+                   concurrency::ThreadPool* tp) const {
+    math::Gemm<T>(trans_A_, trans_B_, M, N, K, alpha_, x_data, w_data, beta, y_data, tp);
+  }
+
   CBLAS_TRANSPOSE trans_A_;
   CBLAS_TRANSPOSE trans_B_;
   float alpha_;
   float beta_;
 
+  // W pre-packed by PrePack when it is a constant initializer. Owned by the session.
+  const void* packed_b_ = nullptr;
+
  protected:
   // For fused gemm + activation
   std::string activation_;
   float leaky_relu_alpha_;
 };
 
+template <typename T>
+Status Gemm<T>::PrePack(const Tensor& /*tensor*/, int /*input_idx*/, PrePackedWeights& /*prepacked_weights*/,
+                        bool& is_packed) {
+  is_packed = false;
+  return Status::OK();
+}
+
+template <>
+Status Gemm<float>::PrePack(const Tensor& tensor, int input_idx, PrePackedWeights& prepacked_weights,
+                            bool& is_packed);
+
+template <>
+void Gemm<float>::ComputeGemm(int64_t M, int64_t N, int64_t K, const float* x_data, const float* w_data, float beta,
+                              float* y_data, concurrency::ThreadPool* tp) const;
+
 }  // namespace onnxruntime
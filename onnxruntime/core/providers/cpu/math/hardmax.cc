@@ -3,8 +3,9 @@
 
 #include "core/providers/cpu/math/hardmax.h"
 #include "core/providers/common.h"
-#include "core/util/math_cpuonly.h"
-#include "core/util/math.h"
+#include "core/platform/threadpool.h"
+
+#include <algorithm>
 
 namespace onnxruntime {
 
@@ -18,34 +19,25 @@ Status Hardmax<float>::Compute(OpKernelContext* ctx) const {
   size_t tmpN = input_shape.SizeToDimension(axis);
   size_t tmpD = input_shape.SizeFromDimension(axis);
 
-  // Math::RowwiseMax expects int N and D.
-  if (tmpN * tmpD > INT32_MAX || tmpN > INT32_MAX || tmpD > INT32_MAX) {
-    std::ostringstream ss;
-    ss << "Hardmax inputs N, D and N * D must be < " << INT32_MAX << ". N=" << tmpN << ", D=" << tmpD;
-    std::string msg = ss.str();
-
-    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, msg);
-  }
-
-  const int N = gsl::narrow_cast<int>(tmpN);
-  const int D = gsl::narrow_cast<int>(tmpD);
-
-  std::vector<float> rowmax_(N);
-  float* rowmax_data = rowmax_.data();
-  math::RowwiseMax<float, CPUMathUtil>(N, D, Xdata, rowmax_data, nullptr);
+  const std::ptrdiff_t N = gsl::narrow<std::ptrdiff_t>(tmpN);
+  const std::ptrdiff_t D = gsl::narrow<std::ptrdiff_t>(tmpD);
 
   Tensor* Y = ctx->Output(0, input_shape);
   auto* Ydata = Y->template MutableData<float>();
-  math::Set<float, CPUMathUtil>(input_shape.Size(), 0.f, Ydata, &CPUMathUtil::Instance());
 
-  for (int i = 0; i < N; ++i) {
-    for (int j = 0; j < D; ++j) {
-      if (Xdata[i * D + j] == rowmax_data[i]) {
-        Ydata[i * D + j] = 1;
-        break;
-      }
-    }
-  }
+  // rows are independent: each one is zeroed and gets a single 1 at the first maximum
+  concurrency::ThreadPool::TryParallelFor(
+      ctx->GetOperatorThreadPool(), N, static_cast<double>(D) * 2.0,
+      [Xdata, Ydata, D](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          const float* x_row = Xdata + i * D;
+          float* y_row = Ydata + i * D;
+          std::fill_n(y_row, D, 0.f);
+          if (D > 0) {
+            y_row[std::max_element(x_row, x_row + D) - x_row] = 1.f;
+          }
+        }
+      });
 
   return Status::OK();
 }
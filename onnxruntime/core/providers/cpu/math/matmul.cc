@@ -2,6 +2,8 @@
 // Licensed under the MIT License.
 #include "core/framework/op_kernel_context_internal.h"
 #include "core/providers/cpu/math/matmul.h"
+#include "core/providers/cpu/math/gemm.h"
+#include "core/mlas/inc/mlas.h"
 
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
@@ -92,4 +94,60 @@ Status MatMul<T>::Compute(OpKernelContext* ctx) const {
   return Status::OK();
 }
 
+template <>
+Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, PrePackedWeights& prepacked_weights,
+                              bool& is_packed) {
+  is_packed = false;
+
+  // only pack matrix B
+  if (input_idx == 1) {
+    is_packed = GemmPackBFp32(Info(), tensor, false, prepacked_weights, packed_b_);
+  }
+  return Status::OK();
+}
+
+template <>
+Status MatMul<float>::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const auto* left_X = ctx->Input<Tensor>(0);
+  const auto* right_X = ctx->Input<Tensor>(1);
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(left_X->Shape(), right_X->Shape()));
+
+  Tensor* Y = ctx->Output(0, helper.OutputShape());
+
+  // Bail out early if the output is going to be empty
+  if (Y->Shape().Size() == 0)
+    return Status::OK();
+
+  const float* a_data = left_X->Data<float>();
+  const float* b_data = right_X->Data<float>();
+  float* y_data = Y->MutableData<float>();
+
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+
+  size_t max_len = helper.OutputOffsets().size();
+  for (size_t i = 0; i < max_len; i++) {
+    if (packed_b_) {
+      // B is 2D, so every matrix of a stacked A is multiplied by the same packed B
+      MlasGemm(CblasNoTrans, M, N, K, 1.0f, a_data + helper.LeftOffsets()[i], K,
+               packed_b_, 0.0f, y_data + helper.OutputOffsets()[i], N, thread_pool);
+    } else {
+      math::MatMul<float>(
+          static_cast<int>(M),
+          static_cast<int>(N),
+          static_cast<int>(K),
+          a_data + helper.LeftOffsets()[i],
+          b_data + helper.RightOffsets()[i],
+          y_data + helper.OutputOffsets()[i], thread_pool);
+    }
+  }
+
+  return Status::OK();
+}
+
 }  // namespace onnxruntime
@@ -15,7 +15,28 @@ class MatMul final : public OpKernel {
       : OpKernel(info) {
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, PrePackedWeights& prepacked_weights,
+                 bool& is_packed) override;
+
   Status Compute(OpKernelContext* context) const override;
+
+ private:
+  // B pre-packed by PrePack when it is a constant 2D initializer. Owned by the session.
+  const void* packed_b_ = nullptr;
 };
 
+template <typename T>
+Status MatMul<T>::PrePack(const Tensor& /*tensor*/, int /*input_idx*/, PrePackedWeights& /*prepacked_weights*/,
+                          bool& is_packed) {
+  is_packed = false;
+  return Status::OK();
+}
+
+template <>
+Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, PrePackedWeights& prepacked_weights,
+                              bool& is_packed);
+
+template <>
+Status MatMul<float>::Compute(OpKernelContext* ctx) const;
+
 }  // namespace onnxruntime
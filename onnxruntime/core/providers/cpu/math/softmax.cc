@@ -3,10 +3,7 @@
 #include "core/providers/cpu/math/softmax.h"
 
 #include "core/framework/op_kernel.h"
-#include "core/framework/op_kernel_context_internal.h"
 #include "core/providers/common.h"
-#include "core/util/math.h"
-#include "core/util/eigen_common_wrapper.h"
 
 namespace onnxruntime {
 
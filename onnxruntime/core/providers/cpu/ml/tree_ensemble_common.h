@@ -0,0 +1,375 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/platform/threadpool.h"
+#include "ml_common.h"
+
+namespace onnxruntime {
+namespace ml {
+namespace detail {
+
+// Accumulated score of one class (or target) for one row.
+// has_score tells an untouched class apart from one whose votes sum to 0.
+struct ScoreValue {
+  float score;
+  unsigned char has_score;
+};
+
+// Node of a flattened tree. Children and leaf weights are referenced by index so the nodes of all the trees
+// live in one contiguous array.
+struct TreeNodeElement {
+  int64_t feature_id;
+  float value;
+  NODE_MODE mode;
+  bool missing_tracks_true;
+  int32_t truenode_index;
+  int32_t falsenode_index;
+  // range of the leaf weights of this node in TreeEnsembleCommon::weights_
+  int32_t weights_start;
+  int32_t weights_count;
+};
+
+struct TreeLeafWeight {
+  int64_t class_id;
+  float value;
+};
+
+/**
+Flattened evaluator shared by TreeEnsembleClassifier and TreeEnsembleRegressor.
+
+The node attributes are converted once, at kernel construction, into an array of TreeNodeElement where every
+child is resolved to its position in the array and every node knows the range of its leaf weights. Compute
+accumulates the leaf weights of every tree into a dense N x NumScores() array of ScoreValue.
+Rows are processed in blocks, one tree at a time for the whole block, so the nodes of a tree stay in cache
+while they are reused. Blocks of rows run in parallel on the intra-op thread pool. When there are fewer rows
+than threads the trees are split across the threads instead and the partial scores are merged at the end.
+*/
+class TreeEnsembleCommon {
+ public:
+  TreeEnsembleCommon(const std::vector<int64_t>& nodes_treeids,
+                     const std::vector<int64_t>& nodes_nodeids,
+                     const std::vector<int64_t>& nodes_featureids,
+                     const std::vector<float>& nodes_values,
+                     const std::vector<NODE_MODE>& nodes_modes,
+                     const std::vector<int64_t>& nodes_truenodeids,
+                     const std::vector<int64_t>& nodes_falsenodeids,
+                     const std::vector<int64_t>& missing_tracks_true,
+                     const std::vector<int64_t>& leaf_treeids,
+                     const std::vector<int64_t>& leaf_nodeids,
+                     const std::vector<int64_t>& leaf_ids,
+                     const std::vector<float>& leaf_weights,
+                     AGGREGATE_FUNCTION aggregate_function,
+                     int64_t min_num_scores);
+
+  size_t NumTrees() const { return roots_.size(); }
+
+  // Width of a row of scores, large enough for every class id found in the leaves.
+  int64_t NumScores() const { return num_scores_; }
+
+  // Largest feature id read by a branch node, -1 if there is none. Rows must have more features than that.
+  int64_t MaxFeatureId() const { return max_feature_id_; }
+
+  // Computes the scores of N rows of stride features each. scores must hold N * NumScores() values.
+  // The first base_values.size() scores of every row start from base_values with has_score set,
+  // the others start empty.
+  template <typename T>
+  void ComputeScores(const T* x_data, int64_t N, int64_t stride, const std::vector<float>& base_values,
+                     ScoreValue* scores, concurrency::ThreadPool* tp) const;
+
+ private:
+  template <typename T>
+  const TreeNodeElement* ProcessTreeNodeLeave(const TreeNodeElement* root, const T* x_data) const;
+
+  void ProcessLeaf(const TreeNodeElement& leaf, ScoreValue* row_scores) const;
+
+  void MergeScores(ScoreValue& dst, const ScoreValue& src) const;
+
+  template <typename T>
+  void ComputeBlock(const T* x_data, int64_t stride, int64_t row_begin, int64_t row_end,
+                    size_t tree_begin, size_t tree_end, ScoreValue* scores) const;
+
+  std::vector<TreeNodeElement> nodes_;
+  std::vector<TreeLeafWeight> weights_;
+  std::vector<int32_t> roots_;
+  AGGREGATE_FUNCTION aggregate_function_;
+  int64_t num_scores_;
+  int64_t max_feature_id_ = -1;
+
+  // guards against cycles in malformed models
+  static constexpr int64_t kMaxTreeDepth = 1000;
+  // number of rows that go through one tree before moving to the next
+  static constexpr int64_t kRowBlockSize = 128;
+};
+
+inline TreeEnsembleCommon::TreeEnsembleCommon(const std::vector<int64_t>& nodes_treeids,
+                                              const std::vector<int64_t>& nodes_nodeids,
+                                              const std::vector<int64_t>& nodes_featureids,
+                                              const std::vector<float>& nodes_values,
+                                              const std::vector<NODE_MODE>& nodes_modes,
+                                              const std::vector<int64_t>& nodes_truenodeids,
+                                              const std::vector<int64_t>& nodes_falsenodeids,
+                                              const std::vector<int64_t>& missing_tracks_true,
+                                              const std::vector<int64_t>& leaf_treeids,
+                                              const std::vector<int64_t>& leaf_nodeids,
+                                              const std::vector<int64_t>& leaf_ids,
+                                              const std::vector<float>& leaf_weights,
+                                              AGGREGATE_FUNCTION aggregate_function,
+                                              int64_t min_num_scores)
+    : aggregate_function_(aggregate_function), num_scores_(std::max<int64_t>(min_num_scores, 0)) {
+  const size_t n_nodes = nodes_treeids.size();
+  ORT_ENFORCE(n_nodes < static_cast<size_t>(std::numeric_limits<int32_t>::max()));
+  ORT_ENFORCE(leaf_weights.size() < static_cast<size_t>(std::numeric_limits<int32_t>::max()));
+  // missing_tracks_true is optional and ignored unless there is one value per node
+  const bool has_missing_tracks = missing_tracks_true.size() == n_nodes;
+
+  // (tree id, node id) -> position of the node
+  struct TreeNodeKey {
+    int64_t tree_id;
+    int64_t node_id;
+    bool operator==(const TreeNodeKey& other) const {
+      return tree_id == other.tree_id && node_id == other.node_id;
+    }
+  };
+  struct TreeNodeKeyHash {
+    size_t operator()(const TreeNodeKey& key) const {
+      return std::hash<int64_t>()(key.tree_id) ^ (std::hash<int64_t>()(key.node_id) * 0x9E3779B97F4A7C15ULL);
+    }
+  };
+  std::unordered_map<TreeNodeKey, int32_t, TreeNodeKeyHash> indices;
+  indices.reserve(n_nodes);
+
+  nodes_.resize(n_nodes);
+  for (size_t i = 0; i < n_nodes; ++i) {
+    TreeNodeElement& node = nodes_[i];
+    node.feature_id = nodes_featureids[i];
+    node.value = nodes_values[i];
+    node.mode = nodes_modes[i];
+    node.missing_tracks_true = has_missing_tracks && missing_tracks_true[i] != 0;
+    node.truenode_index = -1;
+    node.falsenode_index = -1;
+    node.weights_start = 0;
+    node.weights_count = 0;
+    if (node.mode != NODE_MODE::LEAF) {
+      ORT_ENFORCE(node.feature_id >= 0, "Invalid feature id ", node.feature_id,
+                  " for node ", nodes_nodeids[i], " of tree ", nodes_treeids[i]);
+      max_feature_id_ = std::max(max_feature_id_, node.feature_id);
+    }
+    ORT_ENFORCE(indices.insert({{nodes_treeids[i], nodes_nodeids[i]}, static_cast<int32_t>(i)}).second,
+                "Node ", nodes_nodeids[i], " of tree ", nodes_treeids[i], " is defined more than once.");
+  }
+
+  // resolve the children, the nodes nobody points at are the roots
+  std::vector<bool> has_parent(n_nodes, false);
+  for (size_t i = 0; i < n_nodes; ++i) {
+    TreeNodeElement& node = nodes_[i];
+    if (node.mode == NODE_MODE::LEAF) continue;
+    // children must be in the same tree
+    auto it = indices.find({nodes_treeids[i], nodes_truenodeids[i]});
+    ORT_ENFORCE(it != indices.end(), "Node ", nodes_truenodeids[i], " of tree ", nodes_treeids[i], " is missing.");
+    node.truenode_index = it->second;
+    has_parent[it->second] = true;
+    it = indices.find({nodes_treeids[i], nodes_falsenodeids[i]});
+    ORT_ENFORCE(it != indices.end(), "Node ", nodes_falsenodeids[i], " of tree ", nodes_treeids[i], " is missing.");
+    node.falsenode_index = it->second;
+    has_parent[it->second] = true;
+  }
+  for (size_t i = 0; i < n_nodes; ++i) {
+    if (!has_parent[i]) {
+      roots_.push_back(static_cast<int32_t>(i));
+    }
+  }
+
+  // group the leaf weights by node, keeping the order in which they are listed
+  std::vector<int32_t> weight_counts(n_nodes, 0);
+  std::vector<int32_t> weight_nodes(leaf_weights.size(), -1);
+  for (size_t i = 0, end = leaf_weights.size(); i < end; ++i) {
+    auto it = indices.find({leaf_treeids[i], leaf_nodeids[i]});
+    if (it == indices.end()) continue;  // votes of a node that does not exist are never reached
+    ORT_ENFORCE(leaf_ids[i] >= 0, "Invalid class id ", leaf_ids[i], " for node ", leaf_nodeids[i],
+                " of tree ", leaf_treeids[i]);
+    weight_nodes[i] = it->second;
+    ++weight_counts[it->second];
+    num_scores_ = std::max(num_scores_, leaf_ids[i] + 1);
+  }
+  int32_t weights_start = 0;
+  for (size_t i = 0; i < n_nodes; ++i) {
+    nodes_[i].weights_start = weights_start;
+    weights_start += weight_counts[i];
+  }
+  weights_.resize(weights_start);
+  for (size_t i = 0, end = leaf_weights.size(); i < end; ++i) {
+    if (weight_nodes[i] < 0) continue;
+    TreeNodeElement& node = nodes_[weight_nodes[i]];
+    weights_[node.weights_start + node.weights_count++] = {leaf_ids[i], leaf_weights[i]};
+  }
+}
+
+template <typename T>
+inline const TreeNodeElement* TreeEnsembleCommon::ProcessTreeNodeLeave(const TreeNodeElement* root,
+                                                                       const T* x_data) const {
+  const TreeNodeElement* node = root;
+  const TreeNodeElement* nodes = nodes_.data();
+  int64_t loopcount = 0;
+  while (node->mode != NODE_MODE::LEAF) {
+    const T val = x_data[node->feature_id];
+    const float threshold = node->value;
+    bool cond;
+    switch (node->mode) {
+      case NODE_MODE::BRANCH_LEQ:
+        cond = val <= threshold;
+        break;
+      case NODE_MODE::BRANCH_LT:
+        cond = val < threshold;
+        break;
+      case NODE_MODE::BRANCH_GTE:
+        cond = val >= threshold;
+        break;
+      case NODE_MODE::BRANCH_GT:
+        cond = val > threshold;
+        break;
+      case NODE_MODE::BRANCH_EQ:
+        cond = val == threshold;
+        break;
+      default:
+        // MakeTreeNodeMode maps anything else to BRANCH_NEQ
+        cond = val != threshold;
+        break;
+    }
+    if (!cond && node->missing_tracks_true) {
+      cond = std::isnan(static_cast<float>(val));
+    }
+    node = nodes + (cond ? node->truenode_index : node->falsenode_index);
+    if (++loopcount > kMaxTreeDepth) break;
+  }
+  return node;
+}
+
+inline void TreeEnsembleCommon::ProcessLeaf(const TreeNodeElement& leaf, ScoreValue* row_scores) const {
+  const TreeLeafWeight* weight = weights_.data() + leaf.weights_start;
+  const TreeLeafWeight* weight_end = weight + leaf.weights_count;
+  switch (aggregate_function_) {
+    case AGGREGATE_FUNCTION::MIN:
+      for (; weight != weight_end; ++weight) {
+        ScoreValue& s = row_scores[weight->class_id];
+        s.score = (s.has_score && s.score < weight->value) ? s.score : weight->value;
+        s.has_score = 1;
+      }
+      break;
+    case AGGREGATE_FUNCTION::MAX:
+      for (; weight != weight_end; ++weight) {
+        ScoreValue& s = row_scores[weight->class_id];
+        s.score = (s.has_score && s.score > weight->value) ? s.score : weight->value;
+        s.has_score = 1;
+      }
+      break;
+    default:
+      // SUM and AVERAGE, the average is taken by the caller
+      for (; weight != weight_end; ++weight) {
+        ScoreValue& s = row_scores[weight->class_id];
+        s.score += weight->value;
+        s.has_score = 1;
+      }
+      break;
+  }
+}
+
+inline void TreeEnsembleCommon::MergeScores(ScoreValue& dst, const ScoreValue& src) const {
+  if (!src.has_score) return;
+  if (!dst.has_score) {
+    dst = src;
+    return;
+  }
+  switch (aggregate_function_) {
+    case AGGREGATE_FUNCTION::MIN:
+      dst.score = std::min(dst.score, src.score);
+      break;
+    case AGGREGATE_FUNCTION::MAX:
+      dst.score = std::max(dst.score, src.score);
+      break;
+    default:
+      dst.score += src.score;
+      break;
+  }
+}
+
+template <typename T>
+void TreeEnsembleCommon::ComputeBlock(const T* x_data, int64_t stride, int64_t row_begin, int64_t row_end,
+                                      size_t tree_begin, size_t tree_end, ScoreValue* scores) const {
+  for (int64_t block_begin = row_begin; block_begin < row_end; block_begin += kRowBlockSize) {
+    const int64_t block_end = std::min(block_begin + kRowBlockSize, row_end);
+    for (size_t j = tree_begin; j < tree_end; ++j) {
+      const TreeNodeElement* root = nodes_.data() + roots_[j];
+      for (int64_t i = block_begin; i < block_end; ++i) {
+        const TreeNodeElement* leaf = ProcessTreeNodeLeave(root, x_data + i * stride);
+        ProcessLeaf(*leaf, scores + i * num_scores_);
+      }
+    }
+  }
+}
+
+template <typename T>
+void TreeEnsembleCommon::ComputeScores(const T* x_data, int64_t N, int64_t stride,
+                                       const std::vector<float>& base_values, ScoreValue* scores,
+                                       concurrency::ThreadPool* tp) const {
+  const int64_t n_scores = num_scores_;
+  const int64_t n_base_values = std::min(static_cast<int64_t>(base_values.size()), n_scores);
+  auto init_scores = [&](ScoreValue* row_scores, bool with_base_values) {
+    for (int64_t k = 0; k < n_scores; ++k) {
+      row_scores[k] = {0.f, 0};
+    }
+    if (with_base_values) {
+      for (int64_t k = 0; k < n_base_values; ++k) {
+        row_scores[k] = {base_values[k], 1};
+      }
+    }
+  };
+
+  const size_t n_trees = roots_.size();
+  const int num_threads = tp != nullptr ? tp->NumThreads() + 1 : 1;
+
+  if (num_threads > 1 && N < num_threads && n_trees >= static_cast<size_t>(2 * num_threads)) {
+    // Too few rows to keep the threads busy: split the trees instead. Every batch of trees accumulates
+    // into its own scores, the first one in place, and the partial scores are merged in batch order.
+    const int32_t n_batches = num_threads;
+    std::vector<ScoreValue> partial_scores(static_cast<size_t>((n_batches - 1) * N * n_scores));
+    tp->ParallelFor(n_batches, [&](int32_t batch) {
+      ScoreValue* batch_scores = batch == 0 ? scores : partial_scores.data() + (batch - 1) * N * n_scores;
+      for (int64_t i = 0; i < N; ++i) {
+        init_scores(batch_scores + i * n_scores, batch == 0);
+      }
+      const size_t tree_begin = n_trees * batch / n_batches;
+      const size_t tree_end = n_trees * (batch + 1) / n_batches;
+      ComputeBlock(x_data, stride, 0, N, tree_begin, tree_end, batch_scores);
+    });
+    for (int32_t batch = 1; batch < n_batches; ++batch) {
+      const ScoreValue* batch_scores = partial_scores.data() + (batch - 1) * N * n_scores;
+      for (int64_t k = 0, end = N * n_scores; k < end; ++k) {
+        MergeScores(scores[k], batch_scores[k]);
+      }
+    }
+    return;
+  }
+
+  // Split the rows. Each row is visited by every tree, roughly a few cycles per level.
+  const double cost_per_row = static_cast<double>(n_trees) * 16.0;
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(N), cost_per_row,
+      [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          init_scores(scores + i * n_scores, true);
+        }
+        ComputeBlock(x_data, stride, first, last, 0, n_trees, scores);
+      });
+}
+
+}  // namespace detail
+}  // namespace ml
+}  // namespace onnxruntime
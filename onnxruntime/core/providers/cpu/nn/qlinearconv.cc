@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/nn/qlinearconv.h"
+
+#include <algorithm>
+
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 #include "core/providers/common.h"
@@ -50,9 +53,6 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   auto result_scale_data = *(result_scale->template Data<float>());
 
   const float real_multiplier = (input_scale_data * filter_scale_data) / result_scale_data;
-  int32_t integer_multiplier;
-  int right_shift;
-  QuantizeMultiplier(real_multiplier, &integer_multiplier, &right_shift);
 
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const Tensor* bias = nullptr;
@@ -104,45 +104,75 @@ Status QLinearConv::Compute(OpKernelContext* context) const {
   const int64_t col_buffer_size = kernel_dim * output_image_size;
   const int bias_offset = static_cast<int>(M / conv_attrs_.group);
 
-  auto col_data = alloc->Alloc(sizeof(uint8_t) * col_buffer_size);
-  BufferUniquePtr col_buffer(col_data, BufferDeleter(alloc));
-  auto* col_buffer_data = static_cast<uint8_t*>(col_buffer.get());
+  // A pointwise convolution reads the input image directly as the GEMM operand, so the
+  // image to column expansion can be skipped.
+  const bool is_pointwise =
+      std::all_of(kernel_shape.begin(), kernel_shape.end(), [](int64_t dim) { return dim == 1; }) &&
+      std::all_of(strides.begin(), strides.end(), [](int64_t dim) { return dim == 1; }) &&
+      std::all_of(pads.begin(), pads.end(), [](int64_t dim) { return dim == 0; });
+
+  BufferUniquePtr col_buffer;
+  uint8_t* col_buffer_data = nullptr;
+  if (!is_pointwise) {
+    auto col_data = alloc->Alloc(sizeof(uint8_t) * col_buffer_size);
+    col_buffer = BufferUniquePtr(col_data, BufferDeleter(alloc));
+    col_buffer_data = static_cast<uint8_t*>(col_buffer.get());
+  }
+
+  // int32 accumulators of one group, which the GEMM requantizes into the output
+  auto gemm_output_data = alloc->Alloc(sizeof(int32_t) * static_cast<size_t>(M / conv_attrs_.group) *
+                                       static_cast<size_t>(output_image_size));
+  BufferUniquePtr gemm_output_buffer(gemm_output_data, BufferDeleter(alloc));
+  auto* gemm_output = static_cast<int32_t*>(gemm_output_buffer.get());
 
   TensorShape image_shape = X->Shape().Slice(1);
   std::vector<int64_t> col_buffer_shape{kernel_dim};
   col_buffer_shape.insert(col_buffer_shape.end(), output_shape.GetDims().begin(),
                           output_shape.GetDims().end());
 
+  const uint8_t input_zero_point = *input_offset->template Data<uint8_t>();
+  const uint8_t filter_zero_point = *filter_offset->template Data<uint8_t>();
+  const uint8_t result_zero_point = *result_offset->template Data<uint8_t>();
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
   for (int image_id = 0; image_id < N; ++image_id) {
     for (int group_id = 0; group_id < conv_attrs_.group; ++group_id) {
-      math::Im2colNd<uint8_t, CPUMathUtil, StorageOrder::NCHW>()(
-          Xdata + group_id * X_offset,
-          image_shape.GetDims().data(),
-          col_buffer_shape.data(),
-          C * input_image_size,
-          col_buffer_size,
-          kernel_shape.data(),
-          strides.data(),
-          dilations.data(),
-          pads.data(),
-          static_cast<int>(kernel_shape.size()),
-          col_buffer_data,
-          &CPUMathUtil::Instance(),
-          false,
-          *input_offset->template Data<uint8_t>());
-
-      GemmlowpMultiplyu8u8_u8(W->template Data<uint8_t>() + group_id * W_offset,
-                              col_buffer_data,
-                              Ydata + group_id * Y_offset,
-                              *filter_offset->template Data<uint8_t>(),
-                              *input_offset->template Data<uint8_t>(),
-                              *result_offset->template Data<uint8_t>(),
-                              static_cast<int>(M / conv_attrs_.group),
-                              static_cast<int>(output_image_size),
-                              static_cast<int>(kernel_dim),
-                              integer_multiplier,
-                              right_shift,
-                              bias == nullptr ? nullptr : bias->template Data<int32_t>() + group_id * bias_offset);
+      const uint8_t* gemm_input = Xdata + group_id * X_offset;
+      if (!is_pointwise) {
+        math::Im2colNd<uint8_t, CPUMathUtil, StorageOrder::NCHW>()(
+            Xdata + group_id * X_offset,
+            image_shape.GetDims().data(),
+            col_buffer_shape.data(),
+            C * input_image_size,
+            col_buffer_size,
+            kernel_shape.data(),
+            strides.data(),
+            dilations.data(),
+            pads.data(),
+            static_cast<int>(kernel_shape.size()),
+            col_buffer_data,
+            &CPUMathUtil::Instance(),
+            false,
+            input_zero_point);
+        gemm_input = col_buffer_data;
+      }
+
+      QGemmu8u8_u8(static_cast<int>(M / conv_attrs_.group),
+                   static_cast<int>(output_image_size),
+                   static_cast<int>(kernel_dim),
+                   W->template Data<uint8_t>() + group_id * W_offset,
+                   static_cast<int>(kernel_dim),
+                   filter_zero_point,
+                   gemm_input,
+                   static_cast<int>(output_image_size),
+                   input_zero_point,
+                   gemm_output,
+                   Ydata + group_id * Y_offset,
+                   static_cast<int>(output_image_size),
+                   real_multiplier,
+                   result_zero_point,
+                   bias == nullptr ? nullptr : bias->template Data<int32_t>() + group_id * bias_offset,
+                   thread_pool);
     }
 
     Xdata += X_offset * conv_attrs_.group;
@@ -5,7 +5,7 @@
 
 #include "core/framework/op_kernel.h"
 #include "core/providers/cpu/nn/conv_attributes.h"
-#include "core/util/gemmlowp_common.h"
+#include "core/util/qmath.h"
 
 namespace onnxruntime {
 class QLinearConv : public OpKernel {
@@ -6,9 +6,253 @@
 
 #include "core/common/common.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/threadpool.h"
+#include "core/util/math_cpuonly.h"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
 
 namespace onnxruntime {
 
+// A reduction viewed as [outer, reduced, inner]: the kept dimensions before the reduced axes,
+// the reduced axes and the kept dimensions after them. The output is [outer, inner].
+struct FastReduceShape {
+  int64_t outer;
+  int64_t reduced;
+  int64_t inner;
+};
+
+// Returns false if the reduced axes are not adjacent once dimensions of size 1 are ignored,
+// in which case the input has to be transposed before reducing. axes must be sorted and
+// non-negative; an empty list reduces over all dimensions.
+bool GetFastReduceShape(const std::vector<int64_t>& input_dims, const std::vector<int64_t>& axes,
+                        FastReduceShape& shape);
+
+// Aggregators define how NoTransposeReduce reduces the input:
+//   ReduceContiguous(data, n) reduces n contiguous values to one output.
+//   ReduceColumns(data, reduced, stride, count, out) reduces `reduced` rows that are `stride`
+//   elements apart into `count` adjacent outputs, one per column.
+// Aggregators that accumulate elementwise derive ReduceAggregator and only provide
+// Init/ReduceRow/UpdateColumns/Finalize.
+template <typename T, typename Derived>
+struct ReduceAggregator {
+  using output_type = T;
+
+  static T ReduceContiguous(const T* data, int64_t n) {
+    return Derived::Finalize(Derived::ReduceRow(data, n), n);
+  }
+
+  static void ReduceColumns(const T* data, int64_t reduced, int64_t stride, int64_t count, T* out) {
+    std::fill_n(out, count, Derived::Init());
+    for (int64_t r = 0; r < reduced; ++r) {
+      Derived::UpdateColumns(out, data + r * stride, count);
+    }
+    for (int64_t k = 0; k < count; ++k) {
+      out[k] = Derived::Finalize(out[k], reduced);
+    }
+  }
+};
+
+template <typename T>
+struct ReduceAggregatorSum : public ReduceAggregator<T, ReduceAggregatorSum<T>> {
+  static T Init() { return 0; }
+  static T ReduceRow(const T* data, int64_t n) { return ConstEigenVectorArrayMap<T>(data, n).sum(); }
+  static void UpdateColumns(T* acc, const T* data, int64_t n) {
+    EigenVectorArrayMap<T>(acc, n) += ConstEigenVectorArrayMap<T>(data, n);
+  }
+  static T Finalize(T acc, int64_t) { return acc; }
+};
+
+template <typename T>
+struct ReduceAggregatorMean : public ReduceAggregator<T, ReduceAggregatorMean<T>> {
+  static T Init() { return 0; }
+  static T ReduceRow(const T* data, int64_t n) { return ConstEigenVectorArrayMap<T>(data, n).sum(); }
+  static void UpdateColumns(T* acc, const T* data, int64_t n) {
+    EigenVectorArrayMap<T>(acc, n) += ConstEigenVectorArrayMap<T>(data, n);
+  }
+  static T Finalize(T acc, int64_t count) { return acc / static_cast<T>(count); }
+};
+
+template <typename T>
+struct ReduceAggregatorLogSum : public ReduceAggregator<T, ReduceAggregatorLogSum<T>> {
+  static T Init() { return 0; }
+  static T ReduceRow(const T* data, int64_t n) { return ConstEigenVectorArrayMap<T>(data, n).sum(); }
+  static void UpdateColumns(T* acc, const T* data, int64_t n) {
+    EigenVectorArrayMap<T>(acc, n) += ConstEigenVectorArrayMap<T>(data, n);
+  }
+  static T Finalize(T acc, int64_t) { return static_cast<T>(std::log(acc)); }
+};
+
+template <typename T>
+struct ReduceAggregatorSumSquare : public ReduceAggregator<T, ReduceAggregatorSumSquare<T>> {
+  static T Init() { return 0; }
+  static T ReduceRow(const T* data, int64_t n) { return ConstEigenVectorArrayMap<T>(data, n).square().sum(); }
+  static void UpdateColumns(T* acc, const T* data, int64_t n) {
+    EigenVectorArrayMap<T>(acc, n) += ConstEigenVectorArrayMap<T>(data, n).square();
+  }
+  static T Finalize(T acc, int64_t) { return acc; }
+};
+
+template <typename T>
+struct ReduceAggregatorL1 : public ReduceAggregator<T, ReduceAggregatorL1<T>> {
+  static T Init() { return 0; }
+  static T ReduceRow(const T* data, int64_t n) { return ConstEigenVectorArrayMap<T>(data, n).abs().sum(); }
+  static void UpdateColumns(T* acc, const T* data, int64_t n) {
+    EigenVectorArrayMap<T>(acc, n) += ConstEigenVectorArrayMap<T>(data, n).abs();
+  }
+  static T Finalize(T acc, int64_t) { return acc; }
+};
+
+template <typename T>
+struct ReduceAggregatorL2 : public ReduceAggregator<T, ReduceAggregatorL2<T>> {
+  static T Init() { return 0; }
+  static T ReduceRow(const T* data, int64_t n) { return ConstEigenVectorArrayMap<T>(data, n).square().sum(); }
+  static void UpdateColumns(T* acc, const T* data, int64_t n) {
+    EigenVectorArrayMap<T>(acc, n) += ConstEigenVectorArrayMap<T>(data, n).square();
+  }
+  static T Finalize(T acc, int64_t) { return static_cast<T>(std::sqrt(acc)); }
+};
+
+template <typename T>
+struct ReduceAggregatorProd : public ReduceAggregator<T, ReduceAggregatorProd<T>> {
+  static T Init() { return 1; }
+  static T ReduceRow(const T* data, int64_t n) { return ConstEigenVectorArrayMap<T>(data, n).prod(); }
+  static void UpdateColumns(T* acc, const T* data, int64_t n) {
+    EigenVectorArrayMap<T>(acc, n) *= ConstEigenVectorArrayMap<T>(data, n);
+  }
+  static T Finalize(T acc, int64_t) { return acc; }
+};
+
+template <typename T>
+struct ReduceAggregatorMax : public ReduceAggregator<T, ReduceAggregatorMax<T>> {
+  static T Init() { return std::numeric_limits<T>::lowest(); }
+  static T ReduceRow(const T* data, int64_t n) { return ConstEigenVectorArrayMap<T>(data, n).maxCoeff(); }
+  static void UpdateColumns(T* acc, const T* data, int64_t n) {
+    EigenVectorArrayMap<T> acc_vec(acc, n);
+    acc_vec = acc_vec.max(ConstEigenVectorArrayMap<T>(data, n));
+  }
+  static T Finalize(T acc, int64_t) { return acc; }
+};
+
+template <typename T>
+struct ReduceAggregatorMin : public ReduceAggregator<T, ReduceAggregatorMin<T>> {
+  static T Init() { return std::numeric_limits<T>::max(); }
+  static T ReduceRow(const T* data, int64_t n) { return ConstEigenVectorArrayMap<T>(data, n).minCoeff(); }
+  static void UpdateColumns(T* acc, const T* data, int64_t n) {
+    EigenVectorArrayMap<T> acc_vec(acc, n);
+    acc_vec = acc_vec.min(ConstEigenVectorArrayMap<T>(data, n));
+  }
+  static T Finalize(T acc, int64_t) { return acc; }
+};
+
+// log(sum(exp(x))) computed as max + log(sum(exp(x - max))), so it needs a pass for the maximum first.
+template <typename T>
+struct ReduceAggregatorLogSumExp {
+  using output_type = T;
+
+  static T ReduceContiguous(const T* data, int64_t n) {
+    const T max_value = ReduceAggregatorMax<T>::ReduceRow(data, n);
+    T scaled_exp_sum = 0;
+    for (int64_t i = 0; i < n; ++i) {
+      scaled_exp_sum += static_cast<T>(std::exp(data[i] - max_value));
+    }
+    return static_cast<T>(std::log(scaled_exp_sum) + max_value);
+  }
+
+  static void ReduceColumns(const T* data, int64_t reduced, int64_t stride, int64_t count, T* out) {
+    ReduceAggregatorMax<T>::ReduceColumns(data, reduced, stride, count, out);
+    std::vector<T> scaled_exp_sum(count, 0);
+    for (int64_t r = 0; r < reduced; ++r) {
+      const T* row = data + r * stride;
+      for (int64_t k = 0; k < count; ++k) {
+        scaled_exp_sum[k] += static_cast<T>(std::exp(row[k] - out[k]));
+      }
+    }
+    for (int64_t k = 0; k < count; ++k) {
+      out[k] = static_cast<T>(std::log(scaled_exp_sum[k]) + out[k]);
+    }
+  }
+};
+
+// Index of the first element that wins Compare against every other one.
+template <typename T, typename Compare>
+struct ReduceAggregatorArgSelect {
+  using output_type = int64_t;
+
+  static int64_t ReduceContiguous(const T* data, int64_t n) {
+    Compare compare;
+    int64_t index = 0;
+    for (int64_t i = 1; i < n; ++i) {
+      if (compare(data[i], data[index])) {
+        index = i;
+      }
+    }
+    return index;
+  }
+
+  static void ReduceColumns(const T* data, int64_t reduced, int64_t stride, int64_t count, int64_t* out) {
+    Compare compare;
+    std::vector<T> best(data, data + count);
+    std::fill_n(out, count, 0);
+    for (int64_t r = 1; r < reduced; ++r) {
+      const T* row = data + r * stride;
+      for (int64_t k = 0; k < count; ++k) {
+        if (compare(row[k], best[k])) {
+          best[k] = row[k];
+          out[k] = r;
+        }
+      }
+    }
+  }
+};
+
+template <typename T>
+using ReduceAggregatorArgMax = ReduceAggregatorArgSelect<T, std::greater<T>>;
+
+template <typename T>
+using ReduceAggregatorArgMin = ReduceAggregatorArgSelect<T, std::less<T>>;
+
+// Number of adjacent output columns a task accumulates at once when the reduced axes are not
+// innermost. The accumulators for a block stay in L1 while the reduced rows stream through.
+constexpr int64_t kReduceColumnBlock = 256;
+
+// Reduces the input in place, without transposing it, split across the thread pool.
+// Innermost reductions give every output its own contiguous run of input. Otherwise each
+// task owns a block of columns of one outer slice and accumulates the reduced rows into it.
+template <typename T, typename AGG>
+void NoTransposeReduce(const T* input, const FastReduceShape& shape, typename AGG::output_type* output,
+                       concurrency::ThreadPool* tp) {
+  const int64_t outer = shape.outer;
+  const int64_t reduced = shape.reduced;
+  const int64_t inner = shape.inner;
+
+  if (inner == 1) {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, static_cast<std::ptrdiff_t>(outer), static_cast<double>(reduced),
+        [input, output, reduced](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t i = first; i < last; ++i) {
+            output[i] = AGG::ReduceContiguous(input + i * reduced, reduced);
+          }
+        });
+    return;
+  }
+
+  const int64_t column_blocks = (inner + kReduceColumnBlock - 1) / kReduceColumnBlock;
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(outer * column_blocks),
+      static_cast<double>(reduced * std::min(inner, kReduceColumnBlock)),
+      [input, output, reduced, inner, column_blocks](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t task = first; task < last; ++task) {
+          const int64_t o = task / column_blocks;
+          const int64_t column = (task % column_blocks) * kReduceColumnBlock;
+          const int64_t count = std::min(kReduceColumnBlock, inner - column);
+          AGG::ReduceColumns(input + o * reduced * inner + column, reduced, inner, count,
+                             output + o * inner + column);
+        }
+      });
+}
+
 template <bool allow_multi_axes>
 class ReduceKernelBase {
  protected:
@@ -173,8 +173,8 @@ class UniDirectionalGru {
                     onnxruntime::concurrency::ThreadPool* ttp);
 
   void Compute(const gsl::span<const T>& inputs, const gsl::span<const int>& sequence_lengths, int num_directions,
-               const gsl::span<const T>& input_weights, const gsl::span<const T>& recurrent_weights,
-               gsl::span<T>& outputs, gsl::span<T>& final_hidden_state);
+               const GemmWeights<T>& input_weights, const GemmWeights<T>& recurrent_weightsZR,
+               const GemmWeights<T>& recurrent_weightsH, gsl::span<T>& outputs, gsl::span<T>& final_hidden_state);
 
   ~UniDirectionalGru() = default;
 
@@ -248,6 +248,29 @@ class UniDirectionalGru {
 #define DumpMatrix(...) ((void)0)
 #endif
 
+Status DeepCpuGruOp::PrePack(const Tensor& tensor, int input_idx, PrePackedWeights& prepacked_weights,
+                             bool& is_packed) {
+  is_packed = false;
+
+  // pack W and R. the shapes are fully validated against X in Compute, so anything unexpected is left as is.
+  if (input_idx == 1 || input_idx == 2) {
+    const auto& shape = tensor.Shape();
+    if (shape.NumDimensions() == 3 && shape[0] == num_directions_ && shape[1] == 3 * hidden_size_) {
+      auto alloc = Info().GetAllocator(0, OrtMemTypeDefault);
+      if (input_idx == 1) {
+        is_packed = rnn::detail::PackRnnWeights(alloc, tensor, 0, 3 * hidden_size_, prepacked_weights, packed_W_);
+      } else {
+        is_packed = rnn::detail::PackRnnWeights(alloc, tensor, 0, 2 * hidden_size_, prepacked_weights,
+                                                packed_R_zr_) &&
+                    rnn::detail::PackRnnWeights(alloc, tensor, 2 * hidden_size_, hidden_size_, prepacked_weights,
+                                                packed_R_h_);
+      }
+    }
+  }
+
+  return Status::OK();
+}
+
 Status DeepCpuGruOp::Compute(OpKernelContext* context) const {
   const Tensor& X = *context->Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
 
@@ -317,8 +340,14 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
   const size_t recurrent_weights_size_per_direction = 3 * hidden_size_ * hidden_size_;
   const size_t bias_size_per_direction = 6 * hidden_size_;
 
-  gsl::span<const T> input_weights_1 = input_weights.subspan(0, input_weights_size_per_direction);
-  gsl::span<const T> recurrent_weights_1 = recurrent_weights.subspan(0, recurrent_weights_size_per_direction);
+  const size_t recurrent_weights_zr_size = 2 * hidden_size_ * hidden_size_;
+  const size_t recurrent_weights_h_size = hidden_size_ * hidden_size_;
+
+  GemmWeights<T> input_weights_1(0, input_weights, input_weights_size_per_direction, packed_W_);
+  GemmWeights<T> recurrent_weights_zr_1(0, recurrent_weights, recurrent_weights_size_per_direction,
+                                        0, recurrent_weights_zr_size, packed_R_zr_);
+  GemmWeights<T> recurrent_weights_h_1(0, recurrent_weights, recurrent_weights_size_per_direction,
+                                       recurrent_weights_zr_size, recurrent_weights_h_size, packed_R_h_);
   gsl::span<const T> bias_1 = bias.empty() ? bias : bias.subspan(0, bias_size_per_direction);
 
   gsl::span<const T> input = X.DataAsSpan<T>();
@@ -353,10 +382,11 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
 
   if (direction_ == Direction::kBidirectional) {
     // spans for second direction
-    gsl::span<const T> input_weights_2 = input_weights.subspan(input_weights_size_per_direction,
-                                                               input_weights_size_per_direction);
-    gsl::span<const T> recurrent_weights_2 = recurrent_weights.subspan(recurrent_weights_size_per_direction,
-                                                                       recurrent_weights_size_per_direction);
+    GemmWeights<T> input_weights_2(1, input_weights, input_weights_size_per_direction, packed_W_);
+    GemmWeights<T> recurrent_weights_zr_2(1, recurrent_weights, recurrent_weights_size_per_direction,
+                                          0, recurrent_weights_zr_size, packed_R_zr_);
+    GemmWeights<T> recurrent_weights_h_2(1, recurrent_weights, recurrent_weights_size_per_direction,
+                                         recurrent_weights_zr_size, recurrent_weights_h_size, packed_R_h_);
     gsl::span<const T> bias_2 = bias.empty() ? bias : bias.subspan(bias_size_per_direction, bias_size_per_direction);
 
     gsl::span<const T> initial_hidden_2 = initial_hidden.empty()
@@ -375,24 +405,24 @@ Status DeepCpuGruOp::ComputeImpl(OpKernelContext& context) const {
                                     activation_funcs_.Entries()[0],
                                     activation_funcs_.Entries()[1],
                                     clip_, thread_pool);
-    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
-               output_1, hidden_output_1);
+    fw.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_zr_1,
+               recurrent_weights_h_1, output_1, hidden_output_1);
 
     detail::UniDirectionalGru<T> bw(alloc, seq_length, batch_size, input_size, hidden_size_,
                                     linear_before_reset_, Direction::kReverse, bias_2, initial_hidden_2,
                                     activation_funcs_.Entries()[2],
                                     activation_funcs_.Entries()[3],
                                     clip_, thread_pool);
-    bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_2,
-               output_2, hidden_output_2);
+    bw.Compute(input, sequence_lens_span, num_directions_, input_weights_2, recurrent_weights_zr_2,
+               recurrent_weights_h_2, output_2, hidden_output_2);
   } else {
     detail::UniDirectionalGru<T> gru_p(alloc, seq_length, batch_size, input_size, hidden_size_,
                                        linear_before_reset_, direction_, bias_1, initial_hidden_1,
                                        activation_funcs_.Entries()[0],
                                        activation_funcs_.Entries()[1],
                                        clip_, thread_pool);
-    gru_p.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_1,
-                  output_1, hidden_output_1);
+    gru_p.Compute(input, sequence_lens_span, num_directions_, input_weights_1, recurrent_weights_zr_1,
+                  recurrent_weights_h_1, output_1, hidden_output_1);
   }
 
   if (!output.empty())
@@ -491,8 +521,9 @@ template <typename T>
 void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
                                    const gsl::span<const int>& sequence_lengths_arg,
                                    const int num_directions,
-                                   const gsl::span<const T>& input_weights,
-                                   const gsl::span<const T>& recurrent_weights,
+                                   const GemmWeights<T>& input_weights,
+                                   const GemmWeights<T>& recurrent_weightsZR,
+                                   const GemmWeights<T>& recurrent_weightsH,
                                    gsl::span<T>& outputs,
                                    gsl::span<T>& final_hidden_state) {
   using span_T_const_iter = typename gsl::span<T>::const_iterator;
@@ -509,11 +540,12 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
   }
 
   DumpMatrix("Inputs", inputs.data(), seq_length_ * batch_size_, input_size_);
-  DumpMatrix("input_weights", input_weights.data(), 3 * hidden_size_, input_size_);
-  DumpMatrix("recurrent_weights", recurrent_weights.data(), 3 * hidden_size_, hidden_size_);
-
-  gsl::span<const T> recurrent_weightsZR = recurrent_weights.subspan(0, 2 * hidden_size_ * hidden_size_);
-  gsl::span<const T> recurrent_weightsH = recurrent_weights.subspan(2 * hidden_size_ * hidden_size_, hidden_size_ * hidden_size_);
+  if (!input_weights.IsPrepacked())
+    DumpMatrix("input_weights", input_weights.weights_.data(), 3 * hidden_size_, input_size_);
+  if (!recurrent_weightsZR.IsPrepacked() && !recurrent_weightsH.IsPrepacked()) {
+    DumpMatrix("recurrent_weights[zr]", recurrent_weightsZR.weights_.data(), 2 * hidden_size_, hidden_size_);
+    DumpMatrix("recurrent_weights[h]", recurrent_weightsH.weights_.data(), hidden_size_, hidden_size_);
+  }
 
   gsl::span<T> original_outputs = outputs;
   const bool output_sequence = !outputs.empty();
@@ -545,8 +577,8 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
   ComputeGemm(total_rows, hidden_size_x3, input_size_, alpha,
               inputs.cbegin(), inputs.cend(),
               input_size_,
-              input_weights.cbegin(), input_weights.cend(),
-              input_size_, beta,
+              input_weights,
+              beta,
               outputZRH_.begin(), outputZRH_.end(),
               hidden_size_x3, ttp_);
 
@@ -611,8 +643,8 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
     ComputeGemm(batch_size_, hidden_size_x2, hidden_size_, alpha,
                 prev_Ht, prev_Ht_end,
                 hidden_size_,
-                recurrent_weightsZR.cbegin(), recurrent_weightsZR.cend(),
-                hidden_size_, beta,
+                recurrent_weightsZR,
+                beta,
                 outputZRH_.begin() + out_added_offset, outputZRH_.end(),
                 hidden_size_x3, ttp_);
 
@@ -627,8 +659,8 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
       ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
                   prev_Ht, prev_Ht_end,  // Ht-1
                   hidden_size_,
-                  recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
-                  hidden_size_, beta,
+                  recurrent_weightsH,  // Rh^T
+                  beta,
                   linear_output_.begin(), linear_output_.end(),  // pre: Rbh, post:output
                   hidden_size_, ttp_);
 
@@ -698,8 +730,8 @@ void UniDirectionalGru<T>::Compute(const gsl::span<const T>& inputs_arg,
       ComputeGemm(batch_size_, hidden_size_, hidden_size_, alpha,
                   cur_h_local, cur_h_local_end,  // rt (.) Ht-1
                   hidden_size_,
-                  recurrent_weightsH.cbegin(), recurrent_weightsH.cend(),  // Rh^T
-                  hidden_size_, beta,
+                  recurrent_weightsH,  // Rh^T
+                  beta,
                   out_H, outputZRH_.end(),
                   hidden_size_x3, ttp_);
     }
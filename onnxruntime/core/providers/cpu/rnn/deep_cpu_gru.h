@@ -52,6 +52,9 @@ class DeepCpuGruOp final : public OpKernel {
                                                      activation_func_betas);
   }
 
+  Status PrePack(const Tensor& tensor, int input_idx, PrePackedWeights& prepacked_weights,
+                 bool& is_packed) override;
+
   Status Compute(OpKernelContext* context) const override;
 
   ~DeepCpuGruOp() override = default;
@@ -66,6 +69,12 @@ class DeepCpuGruOp final : public OpKernel {
 
   rnn::detail::ActivationFuncs activation_funcs_;
 
+  // W, R[zr] and R[h] pre-packed by PrePack when W and R are constant initializers.
+  // R[zr] and R[h] are used in separate GEMMs so they are packed separately.
+  rnn::detail::PackedWeights packed_W_;
+  rnn::detail::PackedWeights packed_R_zr_;
+  rnn::detail::PackedWeights packed_R_h_;
+
   template <typename T>
   Status ComputeImpl(OpKernelContext& context) const;
 };
@@ -200,7 +200,7 @@ class UniDirectionalLstm {
                      concurrency::ThreadPool* mlas_tp_);
 
   void Compute(const gsl::span<const T>& inputs, const gsl::span<const int>& sequence_lengths, int num_directions,
-               const gsl::span<const T>& input_weights, const gsl::span<const T>& recurrent_weights,
+               const GemmWeights<T>& input_weights, const GemmWeights<T>& recurrent_weights,
                gsl::span<T>& outputs, gsl::span<T>& final_hidden_state, gsl::span<T>& final_cell_state);
 
   ~UniDirectionalLstm() = default;
@@ -242,6 +242,10 @@ class UniDirectionalLstm {
   bool use_bias_;
   bool use_peepholes_;
 
+  // use deepcpu::lstm_gates_sigmoid_tanh, which computes all the gates of a block of a row in one pass, for the
+  // default activations
+  bool use_fused_gates_;
+
   int hidden_num_threads_ = -1;
 
   IAllocatorUniquePtr<T> output_iofc_ptr_;
@@ -285,6 +289,23 @@ class UniDirectionalLstm {
 
 }  // namespace detail
 
+Status DeepCpuLstmOp::PrePack(const Tensor& tensor, int input_idx, PrePackedWeights& prepacked_weights,
+                              bool& is_packed) {
+  is_packed = false;
+
+  // pack W and R. the shapes are fully validated against X in Compute, so anything unexpected is left as is.
+  if (input_idx == 1 || input_idx == 2) {
+    const auto& shape = tensor.Shape();
+    if (shape.NumDimensions() == 3 && shape[0] == num_directions_ && shape[1] == 4 * hidden_size_) {
+      is_packed = rnn::detail::PackRnnWeights(Info().GetAllocator(0, OrtMemTypeDefault), tensor,
+                                              0, 4 * hidden_size_, prepacked_weights,
+                                              input_idx == 1 ? packed_W_ : packed_R_);
+    }
+  }
+
+  return Status::OK();
+}
+
 Status
 DeepCpuLstmOp::Compute(OpKernelContext* context) const {
   const Tensor& X = *context->Input<Tensor>(0);  // inputs. [seq_length, batch_size, input_size]
@@ -374,8 +395,8 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
   const size_t bias_size_per_direction = 8 * hidden_size_;
   const size_t peephole_weights_size_per_direction = 3 * hidden_size_;
 
-  gsl::span<const T> input_weights_1 = input_weights.subspan(0, input_weights_size_per_direction);
-  gsl::span<const T> recurrent_weights_1 = recurrent_weights.subspan(0, hidden_weights_size_per_direction);
+  GemmWeights<T> input_weights_1(0, input_weights, input_weights_size_per_direction, packed_W_);
+  GemmWeights<T> recurrent_weights_1(0, recurrent_weights, hidden_weights_size_per_direction, packed_R_);
   gsl::span<const T> bias_1 = bias.empty() ? bias : bias.subspan(0, bias_size_per_direction);
   gsl::span<const T> peephole_weights_1 =
       peephole_weights.empty() ? peephole_weights
@@ -427,10 +448,8 @@ Status DeepCpuLstmOp::ComputeImpl(OpKernelContext& context) const {
 
   if (direction_ == Direction::kBidirectional) {
     // spans for second direction
-    gsl::span<const T> input_weights_2 = input_weights.subspan(input_weights_size_per_direction,
-                                                               input_weights_size_per_direction);
-    gsl::span<const T> hidden_weights_2 = recurrent_weights.subspan(hidden_weights_size_per_direction,
-                                                                    hidden_weights_size_per_direction);
+    GemmWeights<T> input_weights_2(1, input_weights, input_weights_size_per_direction, packed_W_);
+    GemmWeights<T> hidden_weights_2(1, recurrent_weights, hidden_weights_size_per_direction, packed_R_);
     gsl::span<const T> bias_2 = bias.empty() ? bias : bias.subspan(bias_size_per_direction, bias_size_per_direction);
     gsl::span<const T> peephole_weights_2 =
         peephole_weights.empty() ? peephole_weights
@@ -582,6 +601,10 @@ UniDirectionalLstm<T>::UniDirectionalLstm(AllocatorPtr allocator,
 
   clip_with_bias_ptr_ = use_bias_ ? deepcpu::clip_add_bias : deepcpu::clip_ignore_bias;
 
+  use_fused_gates_ = activation_func_f.name == "sigmoid" &&
+                     activation_func_g.name == "tanh" &&
+                     activation_func_h.name == "tanh";
+
   SetNumThreads();
   AllocateBuffers();
   InitializeBuffers(initial_hidden_state, initial_cell_state);
@@ -719,8 +742,8 @@ template <typename T>
 void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
                                     const gsl::span<const int>& sequence_lengths_arg,
                                     const int num_directions,
-                                    const gsl::span<const T>& input_weights,
-                                    const gsl::span<const T>& recurrent_weights,
+                                    const GemmWeights<T>& input_weights,
+                                    const GemmWeights<T>& recurrent_weights,
                                     gsl::span<T>& outputs,
                                     gsl::span<T>& final_hidden_state,
                                     gsl::span<T>& final_cell_state) {
@@ -780,8 +803,8 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
   ComputeGemm(total_rows, hidden_size_x4, input_size_, alpha,
               inputs.cbegin(), inputs.cend(),
               input_size_,
-              input_weights.cbegin(), input_weights.cend(),  // W[iofc]
-              input_size_, beta,
+              input_weights,  // W[iofc]
+              beta,
               output_iofc_.begin(), output_iofc_.end(),
               hidden_size_x4, mlas_tp_);
 
@@ -830,8 +853,8 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
         ComputeGemm(local_fused_hidden_rows, hidden_size_x4, hidden_size_, alpha,
                     previous_state, previous_state_end,  // Ht-1
                     hidden_size_,
-                    recurrent_weights.cbegin(), recurrent_weights.cend(),  // R[iofc]
-                    hidden_size_, beta,
+                    recurrent_weights,  // R[iofc]
+                    beta,
                     step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
                     hidden_size_x4, mlas_tp_);
 
@@ -910,8 +933,8 @@ void UniDirectionalLstm<T>::Compute(const gsl::span<const T>& inputs_arg,
       ComputeGemm(batch_size_, hidden_size_x4, hidden_size_, alpha,
                   previous_state, previous_state_end,  // Ht-1
                   hidden_size_,
-                  recurrent_weights.cbegin(), recurrent_weights.cend(),  // R[iofc]
-                  hidden_size_, beta,
+                  recurrent_weights,  // R[iofc]
+                  beta,
                   step_out_IOFC, output_iofc_.end(),  // input contains Xt*(W[iofc]^T)
                   hidden_size_x4, mlas_tp_);
 
@@ -1033,6 +1056,22 @@ void UniDirectionalLstm<T>::GateComputations(span_T_iter& out, span_T_iter& out_
     float* pCprev_hidden_size = SafeRawPointer<T>(C_prev + b * hidden_size_, C_prev_end, hidden_size_);
 #endif
 
+    if (use_fused_gates_) {
+      float* pH = SafeRawPointer<T>(batched_output + row * hidden_size_ + b * hidden_size_,
+                                    batched_output_end, hidden_size_);
+
+      deepcpu::lstm_gates_sigmoid_tanh(pi, po, pf, pc,
+                                       use_bias_ ? bias_WRi_.data() : nullptr,
+                                       use_bias_ ? bias_WRo_.data() : nullptr,
+                                       use_bias_ ? bias_WRf_.data() : nullptr,
+                                       use_bias_ ? bias_WRc_.data() : nullptr,
+                                       use_peepholes_ ? peephole_i_.data() : nullptr,
+                                       use_peepholes_ ? peephole_o_.data() : nullptr,
+                                       use_peepholes_ ? peephole_f_.data() : nullptr,
+                                       clip_, input_forget_, pCprev_hidden_size, pH, hidden_size_);
+      continue;
+    }
+
     // DumpMatrix("C_prev" + row_str, pCprev_hidden_size, 1, hidden_size_);
 
     // Input Gate
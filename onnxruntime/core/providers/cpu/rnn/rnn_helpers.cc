@@ -101,6 +101,54 @@ Status ValidateCommonRnnInputs(const Tensor& X,
   return Status::OK();
 }  // namespace detail
 
+bool PackRnnWeights(const AllocatorPtr& alloc, const Tensor& weights, size_t first_row, size_t rows,
+                    PrePackedWeights& prepacked_weights, PackedWeights& packed_weights) {
+#if defined(USE_MKLML_FOR_BLAS)
+  // ComputeGemm is implemented by MKL in this build, so keep using the original weights
+  ORT_UNUSED_PARAMETER(alloc);
+  ORT_UNUSED_PARAMETER(weights);
+  ORT_UNUSED_PARAMETER(first_row);
+  ORT_UNUSED_PARAMETER(rows);
+  ORT_UNUSED_PARAMETER(prepacked_weights);
+  ORT_UNUSED_PARAMETER(packed_weights);
+  return false;
+#else
+  const auto& shape = weights.Shape();
+  if (weights.DataType() != DataTypeImpl::GetType<float>() || shape.NumDimensions() != 3 ||
+      first_row + rows > static_cast<size_t>(shape[1])) {
+    return false;
+  }
+
+  const size_t num_directions = static_cast<size_t>(shape[0]);
+  const size_t N = static_cast<size_t>(shape[1]);
+  const size_t K = static_cast<size_t>(shape[2]);
+
+  // keep each direction at the alignment MlasGemm expects for a packed buffer
+  const size_t alignment = MlasGetPreferredBufferAlignment();
+  const size_t packed_size = MlasGemmPackBSize(rows, K);
+  if (packed_size == 0) {
+    return false;
+  }
+  const size_t weights_size = (packed_size + alignment - 1) / alignment * alignment;
+
+  auto pack = [&](BufferUniquePtr& buffer) {
+    buffer = BufferUniquePtr(alloc->Alloc(weights_size * num_directions), BufferDeleter(alloc));
+
+    const float* weights_data = weights.Data<float>();
+    for (size_t direction = 0; direction < num_directions; ++direction) {
+      MlasGemmPackB(CblasTrans, rows, K, weights_data + (direction * N + first_row) * K, K,
+                    static_cast<uint8_t*>(buffer.get()) + direction * weights_size);
+    }
+    return true;
+  };
+
+  packed_weights.buffer_ = prepacked_weights.GetOrPack(
+      "RnnWeights:" + std::to_string(first_row) + ":" + std::to_string(rows), pack);
+  packed_weights.weights_size_ = weights_size;
+  return packed_weights.buffer_ != nullptr;
+#endif
+}
+
 // map of arg name and whether the alpha and/or beta arguments are required
 static std::unordered_map<std::string, std::pair<bool, bool>>
     NameToArgUsageMap{{"affine", {1, 1}},
@@ -481,6 +529,77 @@ void merge_lstm_gates_to_memory(const float* pprev, const float* pi, const float
   }
 }
 
+// adds the optional bias and peephole (pp * pC) terms to a gate and clips it. the branches are taken once
+// per gate block rather than once per element.
+static void add_bias_peephole_clip(const float* pb, const float* pp, const float* pC, float clip, float* pd, int c) {
+  if (pb != nullptr && pp != nullptr) {
+    for (int i = 0; i < c; i++) {
+      pd[i] = std::min(std::max(pd[i] + (pb[i] + pC[i] * pp[i]), -clip), clip);
+    }
+  } else if (pb != nullptr) {
+    for (int i = 0; i < c; i++) {
+      pd[i] = std::min(std::max(pd[i] + pb[i], -clip), clip);
+    }
+  } else if (pp != nullptr) {
+    for (int i = 0; i < c; i++) {
+      pd[i] = std::min(std::max(pd[i] + pC[i] * pp[i], -clip), clip);
+    }
+  } else {
+    for (int i = 0; i < c; i++) {
+      pd[i] = std::min(std::max(pd[i], -clip), clip);
+    }
+  }
+}
+
+void lstm_gates_sigmoid_tanh(float* pi, float* po, float* pf, float* pc,
+                             const float* pbi, const float* pbo, const float* pbf, const float* pbc,
+                             const float* ppi, const float* ppo, const float* ppf,
+                             const float clip, const bool input_forget, float* pC, float* pH, int c) {
+  // The row is processed in blocks small enough for all the gates, Ct and Ht of a block to stay in L1, so each
+  // block is read from memory once although the bias, peephole, clip and activation steps are separate loops
+  // that let MLAS vectorize the activations.
+  constexpr int block_size = 64;
+
+  for (int first = 0; first < c; first += block_size) {
+    const int n = std::min(block_size, c - first);
+    const size_t count = static_cast<size_t>(n);
+    float* bi = pi + first;
+    float* bo = po + first;
+    float* bf = pf + first;
+    float* bc = pc + first;
+    float* bC = pC + first;
+    float* bH = pH + first;
+
+    add_bias_peephole_clip(pbi ? pbi + first : nullptr, ppi ? ppi + first : nullptr, bC, clip, bi, n);
+    MlasComputeLogistic(bi, bi, count);
+
+    if (input_forget) {
+      for (int j = 0; j < n; j++) {
+        bf[j] = 1.0f - bi[j];
+      }
+    } else {
+      add_bias_peephole_clip(pbf ? pbf + first : nullptr, ppf ? ppf + first : nullptr, bC, clip, bf, n);
+      MlasComputeLogistic(bf, bf, count);
+    }
+
+    add_bias_peephole_clip(pbc ? pbc + first : nullptr, nullptr, bC, clip, bc, n);
+    MlasComputeTanh(bc, bc, count);
+
+    for (int j = 0; j < n; j++) {
+      bC[j] = bC[j] * bf[j] + bi[j] * bc[j];
+    }
+
+    // the output gate peephole uses Ct
+    add_bias_peephole_clip(pbo ? pbo + first : nullptr, ppo ? ppo + first : nullptr, bC, clip, bo, n);
+    MlasComputeLogistic(bo, bo, count);
+
+    MlasComputeTanh(bC, bH, count);
+    for (int j = 0; j < n; j++) {
+      bH[j] *= bo[j];
+    }
+  }
+}
+
 void gru_reset_gate_tanh(const float* ps1, float* ps2, float* pd, int c, float alpha, float beta) {
   ORT_UNUSED_PARAMETER(alpha);
   ORT_UNUSED_PARAMETER(beta);
@@ -18,6 +18,7 @@
 #include "core/common/common.h"
 #include "core/common/logging/logging.h"
 #include "core/framework/allocator.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math.h"
 #include "core/util/math_cpuonly.h"
 
@@ -26,6 +27,7 @@
 namespace onnxruntime {
 class Tensor;
 class OpKernelContext;
+class PrePackedWeights;
 
 namespace rnn {
 namespace detail {
@@ -74,6 +76,47 @@ gsl::span<TAlloc> Allocate(std::shared_ptr<IAllocator> allocator,
   return span;
 }
 
+// W or R weights of an LSTM or GRU operator that were packed by MlasGemmPackB in PrePack.
+// The buffer is owned by the session and holds one packed matrix per direction, each weights_size_ bytes long.
+struct PackedWeights {
+  const void* buffer_ = nullptr;
+  size_t weights_size_ = 0;
+};
+
+// Pack rows [first_row, first_row + rows) of each direction of a W or R tensor with shape
+// [num_directions, N, K] so the GEMMs can skip packing the weights on every call. Kernels that pack the same
+// rows of the same initializer share the copy in prepacked_weights.
+// Returns false, leaving packed_weights empty, if the weights should be used as is.
+bool PackRnnWeights(const AllocatorPtr& alloc, const Tensor& weights, size_t first_row, size_t rows,
+                    PrePackedWeights& prepacked_weights, PackedWeights& packed_weights);
+
+// The weights of one direction, used as the transposed B of ComputeGemm.
+// Refers to the packed copy from PrePack if there is one, otherwise to the original input.
+template <typename T>
+struct GemmWeights {
+  GemmWeights() = default;
+
+  GemmWeights(int direction, gsl::span<const T> weights, size_t weights_size_per_direction,
+              const PackedWeights& packed_weights)
+      : GemmWeights(direction, weights, weights_size_per_direction, 0, weights_size_per_direction, packed_weights) {}
+
+  // weights for a block of rows within a direction, starting at element offset and covering size elements.
+  // packed_weights must have been packed from the same block of rows.
+  GemmWeights(int direction, gsl::span<const T> weights, size_t weights_size_per_direction,
+              size_t offset, size_t size, const PackedWeights& packed_weights) {
+    if (packed_weights.buffer_) {
+      buffer_ = static_cast<const uint8_t*>(packed_weights.buffer_) + direction * packed_weights.weights_size_;
+    } else {
+      weights_ = weights.subspan(direction * weights_size_per_direction + offset, size);
+    }
+  }
+
+  bool IsPrepacked() const { return buffer_ != nullptr; }
+
+  gsl::span<const T> weights_;
+  const void* buffer_ = nullptr;
+};
+
 // validate the common inputs to RNN, LSTM and GRU operators
 Status ValidateCommonRnnInputs(const Tensor& X,
                                const Tensor& W,
@@ -174,6 +217,36 @@ void ComputeGemm(const int M,
       &*C, ldc, tp);
 }
 
+// As above, with B given as GemmWeights of size N x K. Pre-packed weights go straight to MlasGemm.
+template <typename T, typename TSpanAIter, typename TSpanCIter>
+void ComputeGemm(const int M,
+                 const int N,
+                 const int K,
+                 const float alpha,
+                 TSpanAIter A,
+                 TSpanAIter A_end,
+                 const int lda,
+                 const GemmWeights<T>& B,
+                 const float beta,
+                 TSpanCIter C,
+                 TSpanCIter C_end,
+                 const int ldc, concurrency::ThreadPool* tp) {
+  if (!B.IsPrepacked()) {
+    ComputeGemm(M, N, K, alpha, A, A_end, lda, B.weights_.cbegin(), B.weights_.cend(), K, beta, C, C_end, ldc, tp);
+    return;
+  }
+
+  ORT_ENFORCE(lda >= K && ldc >= N);
+  ORT_ENFORCE(A + (M * lda - (lda - K)) <= A_end);
+  ORT_ENFORCE(C + (M * ldc - (ldc - N)) <= C_end);
+
+  MlasGemm(CblasNoTrans,
+           static_cast<size_t>(M), static_cast<size_t>(N), static_cast<size_t>(K), alpha,
+           &*A, static_cast<size_t>(lda),
+           B.buffer_, beta,
+           &*C, static_cast<size_t>(ldc), tp);
+}
+
 // helper to convert a span to a raw pointer
 // after validating the memory covered by the span supports the size required
 template <typename T>
@@ -347,6 +420,15 @@ void sigmoid_exact(float* pd, int c, float alpha, float beta);
 void tanh_exact(float* pd, int c, float alpha, float beta);
 void merge_lstm_gates_to_memory(const float* pprev, const float* pi, const float* pf, const float* pg, float* pcurr,
                                 int c);
+// All the LSTM gates for one row with the default activations f = sigmoid, g = tanh and h = tanh, using the
+// MLAS logistic and tanh kernels. The row is processed in cache sized blocks, each going through all the gates
+// before the next one is read. pi, po, pf and pc hold Xt*(W^T) + Ht-1*(R^T) for each gate and are
+// overwritten with the activated gates. The biases and peepholes are optional (nullptr).
+// pC holds Ct-1 on input and is updated in place to Ct. Ht is written to pH.
+void lstm_gates_sigmoid_tanh(float* pi, float* po, float* pf, float* pc,
+                             const float* pbi, const float* pbo, const float* pbf, const float* pbc,
+                             const float* ppi, const float* ppo, const float* ppf,
+                             float clip, bool input_forget, float* pC, float* pH, int c);
 void gru_reset_gate_tanh(const float* ps1, float* ps2, float* pd, int c, float alpha, float beta);
 void gru_reset_gate_sigmoid(const float* ps1, float* ps2, float* pd, int c, float alpha, float beta);
 void gru_reset_gate_relu(const float* ps1, const float* ps2, float* pd, int c, float alpha, float beta);
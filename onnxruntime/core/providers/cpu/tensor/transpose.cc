@@ -3,6 +3,11 @@
 
 #include "core/providers/cpu/tensor/transpose.h"
 #include "core/framework/utils.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/platform/threadpool.h"
+
+#include <algorithm>
+#include <numeric>
 
 namespace onnxruntime {
 
@@ -23,6 +28,16 @@ static inline size_t ComputeOffset(const std::vector<int64_t>& index, const std:
   return offset;
 }
 
+// ComputeIndex: inverse of a lexicographic walk. Sets index to the position reached after
+// incrementing a zero index offset times.
+static inline void ComputeIndex(size_t offset, const std::vector<int64_t>& upper_bound, int64_t num_axes,
+                                std::vector<int64_t>& index) {
+  for (int64_t k = num_axes - 1; k >= 0; --k) {
+    index[k] = static_cast<int64_t>(offset % upper_bound[k]);
+    offset /= upper_bound[k];
+  }
+}
+
 // IncrementIndex: Increment an index into a tensor (in lexicographic ordering), wrapping
 // around the specified upper_bound.
 static inline void IncrementIndex(std::vector<int64_t>& index, const std::vector<int64_t>& upper_bound, int64_t num_axes) {
@@ -47,15 +62,18 @@ static inline void DoTransposeSingleBlock(size_t num_elts_in_block, const std::s
   std::copy(source, end, target);
 }
 
-// DoTranspose: copies source tensor to target, transposing elements.
+// DoTranspose: copies blocks [first_block, last_block) of the source tensor to target, transposing elements.
 // The stride vector indicates the transposition.
 static void DoTransposeImpl(int64_t num_axes, const std::vector<int64_t>& target_dims,
-                            size_t num_blocks, size_t num_elts_in_block, const std::vector<size_t>& stride,
-                            const uint8_t* source, uint8_t* target, size_t element_size) {
+                            size_t first_block, size_t last_block, size_t num_elts_in_block,
+                            const std::vector<size_t>& stride, const uint8_t* source, uint8_t* target,
+                            size_t element_size) {
   size_t blocksize = num_elts_in_block * element_size;
   // index used to iterate over target iteration-space
   std::vector<int64_t> target_index(num_axes, 0);
-  for (size_t i = 0; i < num_blocks; ++i) {
+  ComputeIndex(first_block, target_dims, num_axes, target_index);
+  target += first_block * blocksize;
+  for (size_t i = first_block; i < last_block; ++i) {
     // convert target_index into an offset in source data
     size_t source_offset = ComputeOffset(target_index, stride, num_axes);
 
@@ -86,110 +104,259 @@ static void DoTransposeImpl(int64_t num_axes, const std::vector<int64_t>& target
   }
 }
 
-template <class T>
-inline void CopyPrim(uint8_t* target, const uint8_t* source) {
-  *reinterpret_cast<T*>(target) = *reinterpret_cast<const T*>(source);
-}
-
 // DoTransposeEltWise: specialization of DoTranspose for the num_elts_in_block=1 case.
-// copies source tensor to target, transposing elements.
+// copies elements [first, last) of the source tensor to target, transposing elements.
 // The stride vector indicates the transposition.
-static void DoTransposeEltWise(int64_t num_axes, const std::vector<int64_t>& target_dims, size_t num_blocks,
-                               const std::vector<size_t>& stride, const uint8_t* source, uint8_t* target,
-                               size_t element_size) {
+template <typename T>
+static void DoTransposeEltWise(int64_t num_axes, const std::vector<int64_t>& target_dims, size_t first, size_t last,
+                               const std::vector<size_t>& stride, const T* source, T* target) {
   // index used to iterate over target iteration-space
   std::vector<int64_t> target_index(num_axes, 0);
+  ComputeIndex(first, target_dims, num_axes, target_index);
+  for (size_t i = first; i < last; ++i) {
+    // convert target_index into an offset in source data
+    size_t source_offset = ComputeOffset(target_index, stride, num_axes);
 
-  switch (element_size) {
-    case sizeof(uint64_t):
-      for (size_t i = 0; i < num_blocks; ++i) {
-        // convert target_index into an offset in source data
-        size_t source_offset = ComputeOffset(target_index, stride, num_axes);
+    // copy
+    target[i] = source[source_offset];
 
-        // copy
-        CopyPrim<uint64_t>(target, source + (source_offset * element_size));
+    // increment target_index:
+    IncrementIndex(target_index, target_dims, num_axes);
+  }
+}
 
-        // increment target_index:
-        IncrementIndex(target_index, target_dims, num_axes);
-        target += element_size;
-      }
+static void DoTransposeEltWise(int64_t num_axes, const std::vector<int64_t>& target_dims, size_t first, size_t last,
+                               const std::vector<size_t>& stride, const uint8_t* source, uint8_t* target,
+                               size_t element_size) {
+  switch (element_size) {
+    case sizeof(uint64_t):
+      DoTransposeEltWise(num_axes, target_dims, first, last, stride,
+                         reinterpret_cast<const uint64_t*>(source), reinterpret_cast<uint64_t*>(target));
       break;
     case sizeof(uint32_t):
-      for (size_t i = 0; i < num_blocks; ++i) {
-        // convert target_index into an offset in source data
-        size_t source_offset = ComputeOffset(target_index, stride, num_axes);
-
-        // copy
-        CopyPrim<uint32_t>(target, source + (source_offset * element_size));
-
-        // increment target_index:
-        IncrementIndex(target_index, target_dims, num_axes);
-        target += element_size;
-      }
+      DoTransposeEltWise(num_axes, target_dims, first, last, stride,
+                         reinterpret_cast<const uint32_t*>(source), reinterpret_cast<uint32_t*>(target));
       break;
     case sizeof(uint16_t):
-      for (size_t i = 0; i < num_blocks; ++i) {
-        // convert target_index into an offset in source data
-        size_t source_offset = ComputeOffset(target_index, stride, num_axes);
-
-        // copy
-        CopyPrim<uint16_t>(target, source + (source_offset * element_size));
-
-        // increment target_index:
-        IncrementIndex(target_index, target_dims, num_axes);
-        target += element_size;
-      }
+      DoTransposeEltWise(num_axes, target_dims, first, last, stride,
+                         reinterpret_cast<const uint16_t*>(source), reinterpret_cast<uint16_t*>(target));
       break;
     case sizeof(uint8_t):
-      for (size_t i = 0; i < num_blocks; ++i) {
-        // convert target_index into an offset in source data
-        size_t source_offset = ComputeOffset(target_index, stride, num_axes);
-
-        // copy
-        *target = *(source + (source_offset * element_size));
-
-        // increment target_index:
-        IncrementIndex(target_index, target_dims, num_axes);
-        target += element_size;
-      }
+      DoTransposeEltWise(num_axes, target_dims, first, last, stride, source, target);
       break;
     default:
       assert(false);
   }
 }
 
-static void DoTransposeEltWise(int64_t num_axes, const std::vector<int64_t>& target_dims, size_t num_blocks,
-                               const std::vector<size_t>& stride, const std::string* source, std::string* target) {
-  // index used to iterate over target iteration-space
-  std::vector<int64_t> target_index(num_axes, 0);
-  for (size_t i = 0; i < num_blocks; ++i) {
-    // convert target_index into an offset in source data
-    size_t source_offset = ComputeOffset(target_index, stride, num_axes);
+// CanonicalizeTranspose: reduces a transpose to the smallest equivalent one. Axes of size 1 are
+// dropped and runs of input axes that stay adjacent and in order in the output are merged, so
+// that e.g. NCHW->NHWC becomes [N, C, H*W] with permutation (0, 2, 1).
+static void CanonicalizeTranspose(const std::vector<int64_t>& input_dims, const std::vector<size_t>& permutations,
+                                  std::vector<int64_t>& dims, std::vector<size_t>& perm) {
+  const size_t rank = input_dims.size();
+
+  // renumber the input axes that are kept
+  std::vector<size_t> kept_axis(rank);
+  size_t num_kept = 0;
+  for (size_t i = 0; i < rank; ++i) {
+    kept_axis[i] = num_kept;
+    if (input_dims[i] != 1) ++num_kept;
+  }
 
-    // copy
-    *target = *(source + source_offset);
+  // walk the kept axes in output order and split them into runs of consecutive input axes
+  std::vector<size_t> run_start;
+  std::vector<int64_t> run_dim;
+  size_t previous = 0;
+  for (size_t i = 0; i < rank; ++i) {
+    size_t input_axis = permutations[i];
+    if (input_dims[input_axis] == 1) continue;
+    size_t axis = kept_axis[input_axis];
+    if (!run_start.empty() && axis == previous + 1) {
+      run_dim.back() *= input_dims[input_axis];
+    } else {
+      run_start.push_back(axis);
+      run_dim.push_back(input_dims[input_axis]);
+    }
+    previous = axis;
+  }
 
-    // increment target_index:
-    IncrementIndex(target_index, target_dims, num_axes);
-    target++;
+  // each run becomes one axis; the merged input axes are ordered by where their runs start
+  const size_t num_runs = run_start.size();
+  std::vector<size_t> input_order(num_runs);
+  std::iota(input_order.begin(), input_order.end(), size_t{0});
+  std::sort(input_order.begin(), input_order.end(),
+            [&run_start](size_t a, size_t b) { return run_start[a] < run_start[b]; });
+
+  dims.resize(num_runs);
+  perm.resize(num_runs);
+  for (size_t axis = 0; axis < num_runs; ++axis) {
+    dims[axis] = run_dim[input_order[axis]];
+    perm[input_order[axis]] = axis;
+  }
+}
+
+// A transpose that swaps two adjacent axes: [batch, rows, cols, inner] -> [batch, cols, rows, inner].
+// This covers 2-D transposes, batched 2-D transposes such as NCHW<->NHWC once H and W are merged,
+// and the [B, S, H, D] -> [B, H, S, D] head split of attention.
+struct BatchedTransposeShape {
+  int64_t batch;
+  int64_t rows;
+  int64_t cols;
+  int64_t inner;
+};
+
+static bool IsBatchedTranspose(const std::vector<int64_t>& dims, const std::vector<size_t>& perm,
+                               BatchedTransposeShape& shape) {
+  if (perm == std::vector<size_t>{1, 0}) {
+    shape = {1, dims[0], dims[1], 1};
+  } else if (perm == std::vector<size_t>{0, 2, 1}) {
+    shape = {dims[0], dims[1], dims[2], 1};
+  } else if (perm == std::vector<size_t>{1, 0, 2}) {
+    shape = {1, dims[0], dims[1], dims[2]};
+  } else if (perm == std::vector<size_t>{0, 2, 1, 3}) {
+    shape = {dims[0], dims[1], dims[2], dims[3]};
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// TransposeTile: transposes an m x n tile with row stride lda into an n x m tile with row stride ldb.
+template <typename T>
+static void TransposeTile(const T* input, size_t lda, T* output, size_t ldb, size_t m, size_t n) {
+  for (size_t j = 0; j < n; ++j) {
+    for (size_t i = 0; i < m; ++i) {
+      output[j * ldb + i] = input[i * lda + j];
+    }
+  }
+}
+
+static void TransposeTile(const uint32_t* input, size_t lda, uint32_t* output, size_t ldb, size_t m, size_t n) {
+  MlasTranspose(input, lda, output, ldb, m, n);
+}
+
+static void TransposeTile(const uint8_t* input, size_t lda, uint8_t* output, size_t ldb, size_t m, size_t n) {
+  MlasTranspose(input, lda, output, ldb, m, n);
+}
+
+// TransposeBatched2D: transposes each [rows, cols] matrix of the batch in square tiles that stay in
+// cache, with the tiles of all matrices split across the thread pool.
+template <typename T>
+static void TransposeBatched2D(const T* input, T* output, const BatchedTransposeShape& shape,
+                               concurrency::ThreadPool* tp) {
+  const int64_t tile = sizeof(T) >= sizeof(uint32_t) ? 32 : 64;
+  const int64_t rows = shape.rows;
+  const int64_t cols = shape.cols;
+  const int64_t row_tiles = (rows + tile - 1) / tile;
+  const int64_t col_tiles = (cols + tile - 1) / tile;
+  const int64_t tiles_per_matrix = row_tiles * col_tiles;
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(shape.batch * tiles_per_matrix), static_cast<double>(tile * tile),
+      [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t t = first; t < last; ++t) {
+          const int64_t b = t / tiles_per_matrix;
+          const int64_t row = ((t % tiles_per_matrix) / col_tiles) * tile;
+          const int64_t col = (t % col_tiles) * tile;
+          const T* source = input + b * rows * cols + row * cols + col;
+          T* target = output + b * rows * cols + col * rows + row;
+          TransposeTile(source, static_cast<size_t>(cols), target, static_cast<size_t>(rows),
+                        static_cast<size_t>(std::min(tile, rows - row)),
+                        static_cast<size_t>(std::min(tile, cols - col)));
+        }
+      });
+}
+
+// TransposeBatchedBlocks: the inner > 1 case of a batched transpose, where every element being
+// moved is a contiguous block of inner elements.
+static void TransposeBatchedBlocks(const uint8_t* input, uint8_t* output, const BatchedTransposeShape& shape,
+                                   size_t element_size, concurrency::ThreadPool* tp) {
+  const size_t block_bytes = static_cast<size_t>(shape.inner) * element_size;
+  const int64_t rows = shape.rows;
+  const int64_t cols = shape.cols;
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, static_cast<std::ptrdiff_t>(shape.batch * cols * rows), static_cast<double>(block_bytes),
+      [=](std::ptrdiff_t first, std::ptrdiff_t last) {
+        // output blocks are walked in [batch, cols, rows] order
+        int64_t row = first % rows;
+        int64_t col = (first / rows) % cols;
+        int64_t b = first / (rows * cols);
+        uint8_t* target = output + first * block_bytes;
+        for (std::ptrdiff_t i = first; i < last; ++i) {
+          memcpy(target, input + ((b * rows + row) * cols + col) * block_bytes, block_bytes);
+          target += block_bytes;
+          if (++row == rows) {
+            row = 0;
+            if (++col == cols) {
+              col = 0;
+              ++b;
+            }
+          }
+        }
+      });
+}
+
+static bool DoBatchedTranspose(const BatchedTransposeShape& shape, const uint8_t* input, uint8_t* output,
+                               size_t element_size, concurrency::ThreadPool* tp) {
+  if (shape.inner > 1) {
+    TransposeBatchedBlocks(input, output, shape, element_size, tp);
+    return true;
+  }
+
+  switch (element_size) {
+    case sizeof(uint64_t):
+      TransposeBatched2D(reinterpret_cast<const uint64_t*>(input), reinterpret_cast<uint64_t*>(output), shape, tp);
+      return true;
+    case sizeof(uint32_t):
+      TransposeBatched2D(reinterpret_cast<const uint32_t*>(input), reinterpret_cast<uint32_t*>(output), shape, tp);
+      return true;
+    case sizeof(uint16_t):
+      TransposeBatched2D(reinterpret_cast<const uint16_t*>(input), reinterpret_cast<uint16_t*>(output), shape, tp);
+      return true;
+    case sizeof(uint8_t):
+      TransposeBatched2D(input, output, shape, tp);
+      return true;
+    default:
+      return false;
   }
 }
 
-static Status DoUntypedTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output) {
+static Status DoUntypedTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output,
+                                 concurrency::ThreadPool* tp) {
   const auto& input_shape = input.Shape();
-  const auto& input_dims = input_shape.GetDims();
-  auto rank = input_shape.NumDimensions();
+  if (input_shape.Size() == 0) {
+    return Status::OK();
+  }
 
   const auto element_size = input.DataType()->Size();
   const bool is_string_type = input.DataType() == DataTypeImpl::GetType<std::string>();
 
+  // work on the canonical form of the transpose; it has the fewest axes and exposes the batched cases
+  std::vector<int64_t> input_dims;
+  std::vector<size_t> perm;
+  CanonicalizeTranspose(input_shape.GetDims(), permutations, input_dims, perm);
+  const auto rank = static_cast<int64_t>(input_dims.size());
+
+  if (!is_string_type) {
+    BatchedTransposeShape batched_shape;
+    if (IsBatchedTranspose(input_dims, perm, batched_shape) &&
+        DoBatchedTranspose(batched_shape, reinterpret_cast<const uint8_t*>(input.DataRaw()),
+                           reinterpret_cast<uint8_t*>(output.MutableDataRaw()), element_size, tp)) {
+      return Status::OK();
+    }
+  }
+
   std::vector<size_t> stride(rank);
-  for (size_t i = 0; i < rank; i++) {
-    size_t inpdim = permutations[i];
-    if (inpdim + 1 < rank)
-      stride[i] = input_shape.SizeFromDimension(inpdim + 1);
-    else
-      stride[i] = 1;
+  std::vector<int64_t> target_dims(rank);
+  for (int64_t i = 0; i < rank; i++) {
+    size_t inpdim = perm[i];
+    stride[i] = 1;
+    for (int64_t j = inpdim + 1; j < rank; ++j) {
+      stride[i] *= input_dims[j];
+    }
+    target_dims[i] = input_dims[inpdim];
   }
 
   // Partition the permutation into a prefix and the largest suffix such that
@@ -200,7 +367,7 @@ static Status DoUntypedTranspose(const std::vector<size_t>& permutations, const
   bool is_suffix = true;
 
   for (int64_t i = rank - 1; i >= 0; --i) {
-    int64_t input_axis = permutations[i];
+    int64_t input_axis = perm[i];
     if (is_suffix && (input_axis == i)) {
       suffix_blocksize *= input_dims[input_axis];
     } else {
@@ -216,10 +383,9 @@ static Status DoUntypedTranspose(const std::vector<size_t>& permutations, const
     if (1 == prefix_blocksize) {
       DoTransposeSingleBlock(suffix_blocksize, input_data, output_data);
     } else if (1 == suffix_blocksize) {
-      DoTransposeEltWise(num_axes_in_prefix, output.Shape().GetDims(), prefix_blocksize, stride,
-                         input_data, output_data);
+      DoTransposeEltWise(num_axes_in_prefix, target_dims, 0, prefix_blocksize, stride, input_data, output_data);
     } else {
-      DoTransposeImpl(num_axes_in_prefix, output.Shape().GetDims(), prefix_blocksize, suffix_blocksize, stride,
+      DoTransposeImpl(num_axes_in_prefix, target_dims, prefix_blocksize, suffix_blocksize, stride,
                       input_data, output_data);
     }
   } else {
@@ -228,18 +394,29 @@ static Status DoUntypedTranspose(const std::vector<size_t>& permutations, const
     if (1 == prefix_blocksize) {
       DoTransposeSingleBlock(suffix_blocksize, input_data, output_data, element_size);
     } else if (1 == suffix_blocksize) {
-      DoTransposeEltWise(num_axes_in_prefix, output.Shape().GetDims(), prefix_blocksize, stride,
-                         input_data, output_data, element_size);
+      concurrency::ThreadPool::TryParallelFor(
+          tp, static_cast<std::ptrdiff_t>(prefix_blocksize), static_cast<double>(2 * num_axes_in_prefix),
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            DoTransposeEltWise(num_axes_in_prefix, target_dims, static_cast<size_t>(first),
+                               static_cast<size_t>(last), stride, input_data, output_data, element_size);
+          });
     } else {
-      DoTransposeImpl(num_axes_in_prefix, output.Shape().GetDims(), prefix_blocksize, suffix_blocksize, stride,
-                      input_data, output_data, element_size);
+      concurrency::ThreadPool::TryParallelFor(
+          tp, static_cast<std::ptrdiff_t>(prefix_blocksize),
+          static_cast<double>(2 * num_axes_in_prefix + suffix_blocksize * element_size),
+          [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+            DoTransposeImpl(num_axes_in_prefix, target_dims, static_cast<size_t>(first),
+                            static_cast<size_t>(last), suffix_blocksize, stride, input_data, output_data,
+                            element_size);
+          });
     }
   }
 
   return Status::OK();
 }
 
-Status TransposeBase::DoTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output) {
+Status TransposeBase::DoTranspose(const std::vector<size_t>& permutations, const Tensor& input, Tensor& output,
+                                  concurrency::ThreadPool* tp) {
   Status status = Status::OK();
 
   auto input_type = input.DataType();
@@ -249,7 +426,7 @@ Status TransposeBase::DoTranspose(const std::vector<size_t>& permutations, const
     status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Mismatched data types between input and output Tensors. ",
                              input_type, " != ", output_type);
   } else {
-    status = DoUntypedTranspose(permutations, input, output);
+    status = DoUntypedTranspose(permutations, input, output, tp);
   }
 
   return status;
@@ -274,9 +451,7 @@ Status Transpose::Compute(OpKernelContext* ctx) const {
   TensorShape output_shape{output_dims};
   Tensor& Y = *ctx->Output(0, output_shape);
 
-  DoUntypedTranspose(*p_perm, X, Y);
-
-  return Status::OK();
+  return DoUntypedTranspose(*p_perm, X, Y, ctx->GetOperatorThreadPool());
 }
 
 ONNX_CPU_OPERATOR_KERNEL(
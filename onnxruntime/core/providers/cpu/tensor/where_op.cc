@@ -50,11 +50,10 @@ using EnableIfEigenNotScalar = typename std::enable_if<!std::is_arithmetic<T>::v
 
 template <typename T>
 EnableIfEigenScalar<T, void>
-SelectBroadcastLoop(bool target,
-                    TBroadcaster<bool, T>* select_broadcaster,
-                    TBroadcastOutput<T>* select_broadcast_output) {
-  BroadcastLoop(
-      *select_broadcaster, *select_broadcast_output,
+SelectBroadcastLoop(bool target, TBroadcaster<bool, T>& select_broadcaster, Tensor& select_tensor,
+                    concurrency::ThreadPool* tp) {
+  ParallelBroadcastLoop<T>(
+      select_broadcaster, select_tensor, tp, 1.0,
       [target](EigenVectorMap<T> output, bool condition, ConstEigenVectorMap<T> value) {
         if (condition == target) {
           output = value;
@@ -74,10 +73,11 @@ SelectBroadcastLoop(bool target,
 
 template <typename T>
 EnableIfEigenNotScalar<T, void>
-SelectBroadcastLoop(bool target, TBroadcaster<bool, T>* select_broadcaster,
-                    TBroadcastOutput<T>* select_broadcast_output) {
+SelectBroadcastLoop(bool target, TBroadcaster<bool, T>& select_broadcaster, Tensor& select_tensor,
+                    concurrency::ThreadPool*) {
+  TBroadcastOutput<T> select_broadcast_output{select_broadcaster.GetSpanSize(), select_tensor};
   BroadcastLoopSpan(
-      *select_broadcaster, *select_broadcast_output,
+      select_broadcaster, select_broadcast_output,
       [target](gsl::span<T> output, bool condition, gsl::span<const T> value) {
         if (condition == target) {
           std::copy(value.cbegin(), value.cend(), output.begin());
@@ -101,21 +101,19 @@ SelectBroadcastLoop(bool target, TBroadcaster<bool, T>* select_broadcaster,
 
 template <typename T>
 std::unique_ptr<Tensor> Select(bool target, const Tensor& condition_tensor, const Tensor& value_tensor,
-                               TensorAllocator<T>& tensor_allocator) {
+                               TensorAllocator<T>& tensor_allocator, concurrency::ThreadPool* tp) {
   TBroadcaster<bool, T> select_broadcaster{condition_tensor, value_tensor};
   std::unique_ptr<Tensor> select_tensor{
       tensor_allocator.Allocate(select_broadcaster.GetOutputShape())};
-  TBroadcastOutput<T> select_broadcast_output{
-      select_broadcaster.GetSpanSize(), *select_tensor};
 
-  SelectBroadcastLoop(target, &select_broadcaster, &select_broadcast_output);
+  SelectBroadcastLoop(target, select_broadcaster, *select_tensor, tp);
 
   return select_tensor;
 }
 
 template <typename T>
 EnableIfEigenScalar<T, void>
-MergeBroadcastLoop(TBroadcaster<T, T>* merge_broadcaster, TBroadcastOutput<T>* merge_broadcast_output) {
+MergeBroadcastLoop(TBroadcaster<T, T>& merge_broadcaster, Tensor& output, concurrency::ThreadPool* tp) {
   const auto merge_scalar_and_vector = [](EigenVectorMap<T> output,
                                           const T& scalar_value, ConstEigenVectorMap<T> vector_value) {
     if (scalar_value != T{}) {
@@ -125,8 +123,8 @@ MergeBroadcastLoop(TBroadcaster<T, T>* merge_broadcaster, TBroadcastOutput<T>* m
     }
   };
 
-  BroadcastLoop(
-      *merge_broadcaster, *merge_broadcast_output,
+  ParallelBroadcastLoop<T>(
+      merge_broadcaster, output, tp, 1.0,
       [merge_scalar_and_vector](EigenVectorMap<T> output, const T& X_selection, ConstEigenVectorMap<T> Y_selection) {
         merge_scalar_and_vector(output, X_selection, Y_selection);
       },
@@ -142,7 +140,7 @@ MergeBroadcastLoop(TBroadcaster<T, T>* merge_broadcaster, TBroadcastOutput<T>* m
 
 template <typename T>
 EnableIfEigenNotScalar<T, void>
-MergeBroadcastLoop(TBroadcaster<T, T>* merge_broadcaster, TBroadcastOutput<T>* merge_broadcast_output) {
+MergeBroadcastLoop(TBroadcaster<T, T>& merge_broadcaster, Tensor& output, concurrency::ThreadPool*) {
   const auto merge_scalar_and_vector = [](gsl::span<T> output, const T& scalar_value, gsl::span<const T> vector_value) {
     if (!scalar_value.empty()) {
       std::fill(output.begin(), output.end(), scalar_value);
@@ -151,8 +149,9 @@ MergeBroadcastLoop(TBroadcaster<T, T>* merge_broadcaster, TBroadcastOutput<T>* m
     }
   };
 
+  TBroadcastOutput<T> merge_broadcast_output{merge_broadcaster.GetSpanSize(), output};
   BroadcastLoopSpan(
-      *merge_broadcaster, *merge_broadcast_output,
+      merge_broadcaster, merge_broadcast_output,
       [merge_scalar_and_vector](gsl::span<T> output, const T& X_selection, gsl::span<const T> Y_selection) {
         merge_scalar_and_vector(output, X_selection, Y_selection);
       },
@@ -181,16 +180,15 @@ Status Where<T>::Compute(OpKernelContext* context) const {
   // Finally, we broadcast over and merge X_selection and Y_selection:
   //   output = (X_selection != default value) ? X_selection : Y_selection
   TensorAllocator<T> tensor_allocator{*context};
-  auto X_selection_tensor = Select<T>(true, *condition, *X, tensor_allocator);
-  auto Y_selection_tensor = Select<T>(false, *condition, *Y, tensor_allocator);
+  concurrency::ThreadPool* tp = context->GetOperatorThreadPool();
+  auto X_selection_tensor = Select<T>(true, *condition, *X, tensor_allocator, tp);
+  auto Y_selection_tensor = Select<T>(false, *condition, *Y, tensor_allocator, tp);
 
   TBroadcaster<T, T> merge_broadcaster{*X_selection_tensor, *Y_selection_tensor};
   Tensor* const output = context->Output(0, merge_broadcaster.GetOutputShape());
   ORT_ENFORCE(output, "failed to get first output!");
-  TBroadcastOutput<T> merge_broadcast_output{
-      merge_broadcaster.GetSpanSize(), *output};
 
-  MergeBroadcastLoop(&merge_broadcaster, &merge_broadcast_output);
+  MergeBroadcastLoop(merge_broadcaster, *output, tp);
 
   return Status::OK();
 }
@@ -85,12 +85,24 @@ common::Status IOBinding::BindOutput(const std::string& name, const OrtValue& ml
   return Status::OK();
 }
 
+void IOBinding::ClearInputs() {
+  feed_names_.clear();
+  feeds_.clear();
+}
+
+void IOBinding::ClearOutputs() {
+  output_names_.clear();
+  outputs_.clear();
+}
+
 const std::vector<std::string>& IOBinding::GetOutputNames() const {
   return output_names_;
 }
 
 std::vector<OrtValue>& IOBinding::GetOutputs() { return outputs_; }
 
+const std::vector<OrtValue>& IOBinding::GetOutputs() const { return outputs_; }
+
 const std::vector<std::string>& IOBinding::GetInputNames() const {
   return feed_names_;
 }
@@ -149,6 +149,82 @@ ORT_API_STATUS_IMPL(OrtApis::SetInterOpNumThreads, _In_ OrtSessionOptions* optio
   return nullptr;
 }
 
+ORT_API_STATUS_IMPL(OrtApis::DisablePerSessionThreads, _Inout_ OrtSessionOptions* options) {
+  options->value.use_per_session_threads = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetIntraOpThreadAffinity, _Inout_ OrtSessionOptions* options,
+                    _In_ const int* processor_ids, size_t processor_ids_len) {
+  API_IMPL_BEGIN
+  for (size_t i = 0; i < processor_ids_len; ++i) {
+    if (processor_ids[i] < 0) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "processor ids must not be negative");
+    }
+  }
+  options->value.intra_op_thread_affinity.assign(processor_ids, processor_ids + processor_ids_len);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetSessionNumaNode, _Inout_ OrtSessionOptions* options, int numa_node) {
+  if (numa_node < -1) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "numa_node must be -1 or a valid NUMA node index");
+  }
+  options->value.numa_node = numa_node;
+  return nullptr;
+}
+
+// reuse execution frames across runs with the same input shapes
+ORT_API_STATUS_IMPL(OrtApis::EnableExecutionFramePool, _Inout_ OrtSessionOptions* options) {
+  options->value.enable_execution_frame_pool = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::DisableExecutionFramePool, _Inout_ OrtSessionOptions* options) {
+  options->value.enable_execution_frame_pool = false;
+  return nullptr;
+}
+
+// allocate the intermediate values of each run from a per-run arena
+ORT_API_STATUS_IMPL(OrtApis::EnableRunArena, _Inout_ OrtSessionOptions* options) {
+  options->value.enable_run_arena = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::DisableRunArena, _Inout_ OrtSessionOptions* options) {
+  options->value.enable_run_arena = false;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetMemPatternDimBuckets, _Inout_ OrtSessionOptions* options,
+                    _In_ const int64_t* dim_buckets, size_t dim_buckets_len) {
+  API_IMPL_BEGIN
+  for (size_t i = 0; i < dim_buckets_len; ++i) {
+    if (dim_buckets[i] <= 0 || (i > 0 && dim_buckets[i] <= dim_buckets[i - 1])) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "dim buckets must be positive and in ascending order");
+    }
+  }
+  options->value.mem_pattern_dim_buckets.assign(dim_buckets, dim_buckets + dim_buckets_len);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetMemPatternCacheCapacity, _Inout_ OrtSessionOptions* options, size_t capacity) {
+  options->value.mem_pattern_cache_capacity = capacity;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::EnableModelMmap, _Inout_ OrtSessionOptions* options) {
+  options->value.enable_model_mmap = true;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::DisableModelMmap, _Inout_ OrtSessionOptions* options) {
+  options->value.enable_model_mmap = false;
+  return nullptr;
+}
+
 ORT_API_STATUS_IMPL(OrtApis::AddFreeDimensionOverride, _Inout_ OrtSessionOptions* options,
                     _In_ const char* symbolic_dim, _In_ int64_t dim_override) {
   options->value.free_dimension_overrides.push_back(onnxruntime::FreeDimensionOverride{symbolic_dim, dim_override});
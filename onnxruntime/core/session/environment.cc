@@ -5,6 +5,8 @@
 #include "core/framework/allocatormgr.h"
 #include "core/graph/constants.h"
 #include "core/graph/op.h"
+#include "core/platform/threadpool.h"
+#include "core/util/thread_utils.h"
 #include "onnx/defs/operator_sets.h"
 #include "onnx/defs/operator_sets-ml.h"
 #ifndef DISABLE_CONTRIB_OPS
@@ -25,16 +27,35 @@ std::once_flag schemaRegistrationOnceFlag;
 
 std::atomic<bool> Environment::is_initialized_{false};
 
-Status Environment::Create(std::unique_ptr<Environment>& environment) {
+Environment::Environment() = default;
+
+Status Environment::Create(std::unique_ptr<Environment>& environment, const ThreadingOptions* tp_options) {
   environment = std::unique_ptr<Environment>(new Environment());
-  auto status = environment->Initialize();
+  auto status = environment->Initialize(tp_options);
   return status;
 }
 
-Status Environment::Initialize() {
+Status Environment::Initialize(const ThreadingOptions* tp_options) {
   auto status = Status::OK();
 
   try {
+    if (tp_options != nullptr) {
+      ORT_RETURN_IF_NOT(tp_options->intra_op_num_threads >= 0 && tp_options->inter_op_num_threads >= 0,
+                        "Global thread pool sizes must not be negative.");
+      // Sessions calling Run() contribute their own threads, so unlike a per session pool a
+      // global pool of size 1 still gets a worker thread.
+      int intra_op_num_threads = tp_options->intra_op_num_threads;
+      if (intra_op_num_threads == 0) {
+        intra_op_num_threads = concurrency::DefaultThreadPoolSize();
+      }
+      intra_op_thread_pool_ = onnxruntime::make_unique<concurrency::ThreadPool>("global_intra_op_thread_pool",
+                                                                                intra_op_num_threads);
+      if (tp_options->inter_op_num_threads > 0) {
+        inter_op_thread_pool_ = onnxruntime::make_unique<concurrency::ThreadPool>("global_inter_op_thread_pool",
+                                                                                  tp_options->inter_op_num_threads);
+      }
+    }
+
     // Register Microsoft domain with min/max op_set version as 1/1.
     std::call_once(schemaRegistrationOnceFlag, []() {
       ONNX_NAMESPACE::OpSchemaRegistry::DomainToVersionRange::Instance().AddDomainToVersion(onnxruntime::kMSDomain, 1, 1);
@@ -7,6 +7,8 @@
 
 #include "core/session/inference_session.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <memory>
 #include <sstream>
 #include <unordered_set>
@@ -15,6 +17,7 @@
 #include <thread>
 
 #include "core/common/logging/logging.h"
+#include "core/platform/env.h"
 #include "core/platform/notification.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
@@ -55,6 +58,8 @@
 #include "core/optimizer/rule_based_graph_transformer.h"
 #include "core/optimizer/graph_transformer_utils.h"
 #include "core/util/thread_utils.h"
+#include "core/mlas/inc/mlas.h"
+#include "onnxruntime_config.h"
 
 using namespace ONNX_NAMESPACE;
 
@@ -93,19 +98,81 @@ inline std::basic_string<T> GetCurrentTimeString() {
   return std::basic_string<T>(time_str);
 }
 
+std::vector<int> GetNumaNodeProcessors(const SessionOptions& session_options) {
+  std::vector<int> processor_ids;
+  if (session_options.numa_node >= 0) {
+    ORT_THROW_IF_ERROR(Env::Default().GetNumaNodeProcessors(session_options.numa_node, processor_ids));
+  }
+  return processor_ids;
+}
+
+concurrency::ThreadAffinity GetThreadAffinity(const SessionOptions& session_options, bool intra_op) {
+  concurrency::ThreadAffinity affinity;
+  if (intra_op && !session_options.intra_op_thread_affinity.empty()) {
+    const int num_processors = static_cast<int>(std::thread::hardware_concurrency());
+    for (int id : session_options.intra_op_thread_affinity) {
+      ORT_ENFORCE(id >= 0 && (num_processors == 0 || id < num_processors), "Invalid processor id ", id,
+                  " in intra_op_thread_affinity.");
+    }
+    affinity.processor_ids = session_options.intra_op_thread_affinity;
+    affinity.one_processor_per_thread = true;
+  } else {
+    affinity.processor_ids = GetNumaNodeProcessors(session_options);
+  }
+  return affinity;
+}
+
+std::unique_ptr<concurrency::ThreadPool> CreateIntraOpThreadPool(const SessionOptions& session_options,
+                                                                 const Environment* session_env) {
+  if (session_options.use_per_session_threads) {
+    return concurrency::CreateThreadPool("intra_op_thread_pool", session_options.intra_op_num_threads,
+                                         GetThreadAffinity(session_options, true));
+  }
+
+  ORT_ENFORCE(session_env != nullptr && session_env->EnvCreatedWithGlobalThreadPools(),
+              "use_per_session_threads is false but the environment was not created with global thread pools.");
+  return onnxruntime::make_unique<concurrency::ThreadPool>(*session_env->GetIntraOpThreadPool(),
+                                                           session_options.intra_op_num_threads);
+}
+
+std::unique_ptr<concurrency::ThreadPool> CreateInterOpThreadPool(const SessionOptions& session_options,
+                                                                 const Environment* session_env) {
+  if (session_options.execution_mode != ExecutionMode::ORT_PARALLEL) {
+    return nullptr;
+  }
+
+  if (session_options.use_per_session_threads) {
+    return concurrency::CreateThreadPool("inter_op_thread_pool", session_options.inter_op_num_threads,
+                                         GetThreadAffinity(session_options, false));
+  }
+
+  ORT_ENFORCE(session_env != nullptr && session_env->EnvCreatedWithGlobalThreadPools(),
+              "use_per_session_threads is false but the environment was not created with global thread pools.");
+  return onnxruntime::make_unique<concurrency::ThreadPool>(*session_env->GetInterOpThreadPool(),
+                                                           session_options.inter_op_num_threads);
+}
+
 }  // namespace
 
 InferenceSession::InferenceSession(const SessionOptions& session_options,
                                    logging::LoggingManager* logging_manager)
+    : InferenceSession(session_options, logging_manager, static_cast<const Environment*>(nullptr)) {
+}
+
+InferenceSession::InferenceSession(const SessionOptions& session_options,
+                                   logging::LoggingManager* logging_manager,
+                                   const Environment& session_env)
+    : InferenceSession(session_options, logging_manager, &session_env) {
+}
+
+InferenceSession::InferenceSession(const SessionOptions& session_options,
+                                   logging::LoggingManager* logging_manager,
+                                   const Environment* session_env)
     : session_options_(session_options),
       graph_transformation_mgr_(session_options.max_num_graph_transformation_steps),
       logging_manager_(logging_manager),
-      thread_pool_(concurrency::CreateThreadPool("intra_op_thread_pool",
-                                                 session_options.intra_op_num_threads)),
-      inter_op_thread_pool_(session_options.execution_mode == ExecutionMode::ORT_PARALLEL
-                                ? concurrency::CreateThreadPool("inter_op_thread_pool",
-                                                                session_options.inter_op_num_threads)
-                                : nullptr),
+      thread_pool_(CreateIntraOpThreadPool(session_options, session_env)),
+      inter_op_thread_pool_(CreateInterOpThreadPool(session_options, session_env)),
       session_state_(execution_providers_,
                      session_options.enable_mem_pattern && session_options.execution_mode == ExecutionMode::ORT_SEQUENTIAL,
                      thread_pool_.get(),
@@ -116,15 +183,24 @@ InferenceSession::InferenceSession(const SessionOptions& session_options,
 
   InitLogger(logging_manager);
 
+  numa_node_processors_ = GetNumaNodeProcessors(session_options);
+
   session_state_.SetDataTransferMgr(&data_transfer_mgr_);
   session_profiler_.Initialize(session_logger_);
   session_state_.SetProfiler(session_profiler_);
+  session_state_.SetMeasureNodeCosts(session_options.enable_node_cost_measurement);
   if (session_options.enable_profiling) {
     StartProfiling(session_options.profile_file_prefix);
   }
 }
 
 InferenceSession::~InferenceSession() {
+  // runs queued by RunAsync use the session until their callback returns
+  {
+    std::unique_lock<OrtMutex> lock(async_run_mutex_);
+    async_run_cv_.wait(lock, [this] { return num_pending_async_runs_ == 0; });
+  }
+
   if (session_options_.enable_profiling) {
     try {
       EndProfiling();
@@ -254,6 +330,10 @@ common::Status InferenceSession::Load(const std::basic_string<T>& model_uri) {
       AddCustomOpDomains({domain.get()});
     }
 #endif
+    if (session_options_.enable_model_mmap) {
+      return onnxruntime::Model::LoadMapped(model_location_, model,
+                                            HasLocalSchema() ? &custom_schema_registries_ : nullptr);
+    }
     return onnxruntime::Model::Load(model_location_, model, HasLocalSchema() ? &custom_schema_registries_ : nullptr);
   };
 
@@ -435,7 +515,10 @@ common::Status InferenceSession::CreateSubgraphSessionState(Graph& graph, Sessio
                                                                            session_state.GetEnableMemoryPattern(),
                                                                            session_state.GetThreadPool(),
                                                                            session_state.GetInterOpThreadPool());
+      subgraph_session_state->ConfigureMemoryPatternCache(session_options_.mem_pattern_dim_buckets,
+                                                           session_options_.mem_pattern_cache_capacity);
       subgraph_session_state->SetProfiler(session_profiler_);
+      subgraph_session_state->SetMeasureNodeCosts(session_state.MeasureNodeCosts());
       subgraph_session_state->SetLogger(*session_logger_);
       // Pass data transfer manager to subgraph.
       subgraph_session_state->SetDataTransferMgr(&session_state.GetDataTransferMgr());
@@ -506,6 +589,10 @@ common::Status InferenceSession::Initialize() {
   try {
     LOGS(*session_logger_, INFO) << "Initializing session.";
     std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+
+    // initializers are copied into session owned buffers below; do it from the session's NUMA node so
+    // the pages are first touched, and therefore allocated, there.
+    concurrency::ScopedThreadAffinity numa_affinity(numa_node_processors_);
     if (!is_model_loaded_) {
       LOGS(*session_logger_, ERROR) << "Model was not loaded";
       return common::Status(common::ONNXRUNTIME, common::FAIL, "Model was not loaded.");
@@ -533,8 +620,17 @@ common::Status InferenceSession::Initialize() {
                             "for the registered CUDA Execution Provider.");
     }
 
+    // a model saved through optimized_model_filepath by a session configured like this one has been through the
+    // predefined transformers already, which includes any weights they pre-packed such as the NCHWc reorders.
+    const TransformerLevel preoptimized_level = GetPreoptimizedLevel(*model_);
+    if (preoptimized_level > TransformerLevel::Default) {
+      LOGS(*session_logger_, INFO) << "Model was optimized up to level " << static_cast<int>(preoptimized_level)
+                                   << " when it was saved. Skipping those graph transformers.";
+    }
+
     // add predefined transformers
-    AddPredefinedTransformers(graph_transformation_mgr_, session_options_.graph_optimization_level, transformers_to_enable_);
+    AddPredefinedTransformers(graph_transformation_mgr_, session_options_.graph_optimization_level,
+                              preoptimized_level, transformers_to_enable_);
 
     onnxruntime::Graph& graph = model_->MainGraph();
 
@@ -564,17 +660,29 @@ common::Status InferenceSession::Initialize() {
     ORT_RETURN_IF_ERROR(graph.Resolve());
 
     if (!session_options_.optimized_model_filepath.empty()) {
-      if (session_options_.graph_optimization_level < TransformerLevel::Level3) {
-        // Serialize optimized ONNX model.
-        ORT_RETURN_IF_ERROR(Model::Save(*model_, session_options_.optimized_model_filepath));
-      } else {
-        LOGS(*session_logger_, WARNING) << "Serializing Optimized ONNX model with Graph Optimization"
-                                           " level greater than 2 is not supported.";
-      }
+      // Serialize optimized ONNX model. Level 3 models depend on the providers and the hardware they were optimized
+      // for, which the metadata records so that other configurations optimize the original model again.
+      ORT_RETURN_IF_ERROR(Model::SaveWithMetaData(*model_, session_options_.optimized_model_filepath,
+                                                  GetOptimizationMetadata(*model_)));
     }
 
     ORT_RETURN_IF_ERROR(session_initializer.CreatePlan(nullptr, nullptr, session_options_.execution_mode));
 
+    session_state_.ConfigureMemoryPatternCache(session_options_.mem_pattern_dim_buckets,
+                                               session_options_.mem_pattern_cache_capacity);
+
+    if (session_options_.enable_execution_frame_pool &&
+        session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL) {
+      // enough frames for every thread that may call Run concurrently plus some headroom
+      size_t pool_capacity = std::max<size_t>(4, 2 * static_cast<size_t>(std::thread::hardware_concurrency()));
+      session_state_.EnableExecutionFramePool(pool_capacity);
+    }
+
+    if (session_options_.enable_run_arena) {
+      session_state_.EnableRunArena(
+          execution_providers_.Get(onnxruntime::kCpuExecutionProvider)->GetAllocator(0, OrtMemTypeDefault));
+    }
+
     // handle any subgraphs
     ORT_RETURN_IF_ERROR(InitializeSubgraphSessions(graph, session_state_));
     is_inited_ = true;
@@ -818,6 +926,79 @@ common::Status InferenceSession::Run(const RunOptions& run_options, const NameML
   return Run(run_options, feed_names, feeds, output_names, p_fetches);
 }
 
+common::Status InferenceSession::RunAsync(const RunOptions* run_options, std::vector<std::string> feed_names,
+                                          std::vector<OrtValue> feeds, std::vector<std::string> output_names,
+                                          std::vector<OrtValue> fetches, RunAsyncCallback callback) {
+  if (!callback) {
+    return Status(common::ONNXRUNTIME, common::INVALID_ARGUMENT, "RunAsync requires a callback.");
+  }
+
+  if (!is_inited_) {
+    LOGS(*session_logger_, ERROR) << "Session was not initialized";
+    return Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+  }
+
+  struct AsyncRun {
+    const RunOptions* run_options;
+    std::unique_ptr<RunOptions> default_run_options;
+    std::vector<std::string> feed_names;
+    std::vector<OrtValue> feeds;
+    std::vector<std::string> output_names;
+    std::vector<OrtValue> fetches;
+    RunAsyncCallback callback;
+  };
+
+  // std::function needs a copyable task, so the run state is shared with it rather than moved into it
+  auto run = std::make_shared<AsyncRun>();
+  if (run_options == nullptr) {
+    run->default_run_options = onnxruntime::make_unique<RunOptions>();
+    run_options = run->default_run_options.get();
+  }
+  run->run_options = run_options;
+  run->feed_names = std::move(feed_names);
+  run->feeds = std::move(feeds);
+  run->output_names = std::move(output_names);
+  run->fetches = std::move(fetches);
+  run->callback = std::move(callback);
+
+  concurrency::ThreadPool* pool = nullptr;
+  {
+    std::lock_guard<OrtMutex> lock(async_run_mutex_);
+    if (async_run_thread_pool_ == nullptr) {
+      // The runs block their thread until they complete, so they get threads of their own rather than workers of
+      // the compute pools, which a parallel run waits on. Unlike CreateThreadPool, a size of 1 still gets a thread.
+      const int num_threads = session_options_.async_run_num_threads > 0 ? session_options_.async_run_num_threads
+                                                                         : concurrency::DefaultThreadPoolSize();
+      async_run_thread_pool_ = onnxruntime::make_unique<concurrency::ThreadPool>(
+          "async_run_thread_pool", num_threads, GetThreadAffinity(session_options_, false));
+    }
+    pool = async_run_thread_pool_.get();
+    ++num_pending_async_runs_;
+  }
+
+  pool->Schedule([this, run]() mutable {
+    Status status = Run(*run->run_options, run->feed_names, run->feeds, run->output_names, &run->fetches);
+
+    try {
+      run->callback(status, run->fetches);
+    } catch (const std::exception& ex) {
+      LOGS(*session_logger_, ERROR) << "Exception in RunAsync callback: " << ex.what();
+    } catch (...) {
+      LOGS(*session_logger_, ERROR) << "Unknown exception in RunAsync callback";
+    }
+
+    // release the inputs and outputs before the session may be destroyed
+    run.reset();
+
+    std::lock_guard<OrtMutex> lock(async_run_mutex_);
+    if (--num_pending_async_runs_ == 0) {
+      async_run_cv_.notify_all();
+    }
+  });
+
+  return Status::OK();
+}
+
 std::pair<common::Status, const ModelMetadata*> InferenceSession::GetModelMetadata() const {
   {
     std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
@@ -1065,8 +1246,12 @@ void InferenceSession::InitLogger(logging::LoggingManager* logging_manager) {
 // Registers all the predefined transformers with transformer manager
 void InferenceSession::AddPredefinedTransformers(GraphTransformerManager& transformer_manager,
                                                  TransformerLevel graph_optimization_level,
+                                                 TransformerLevel preoptimized_level,
                                                  const std::vector<std::string>& custom_list) {
   auto add_transformers = [&](TransformerLevel level) {
+    if (level <= preoptimized_level) {
+      return;
+    }
     // Generate and register transformers for level
     auto transformers_to_register = optimizer_utils::GenerateTransformers(level, session_options_.free_dimension_overrides, custom_list);
     for (auto& entry : transformers_to_register) {
@@ -1091,6 +1276,89 @@ void InferenceSession::AddPredefinedTransformers(GraphTransformerManager& transf
   }
 }
 
+// metadata a session adds to the models it saves through optimized_model_filepath
+static constexpr const char* kOptimizationLevelKey = "onnxruntime.optimization_level";
+static constexpr const char* kOptimizationProvidersKey = "onnxruntime.optimization_providers";
+static constexpr const char* kOptimizationNchwcBlockSizeKey = "onnxruntime.optimization_nchwc_block_size";
+static constexpr const char* kOptimizationVersionKey = "onnxruntime.optimization_version";
+static constexpr const char* kOptimizationFreeDimensionOverridesKey =
+    "onnxruntime.optimization_free_dimension_overrides";
+
+static std::string GetOptimizationProviders(const ExecutionProviders& providers) {
+  std::string ids;
+  for (const auto& id : providers.GetIds()) {
+    if (!ids.empty()) ids += ',';
+    ids += id;
+  }
+  return ids;
+}
+
+// the Level1 FreeDimensionOverrideTransformer bakes these into the saved model
+static std::string GetOptimizationFreeDimensionOverrides(const std::vector<FreeDimensionOverride>& overrides) {
+  std::string value;
+  for (const auto& entry : overrides) {
+    if (!value.empty()) value += ',';
+    value += entry.dimension_denotation + '=' + std::to_string(entry.dimension_override);
+  }
+  return value;
+}
+
+static std::string GetOptimizationVersion() {
+#ifdef ORT_VERSION
+  return ORT_VERSION;
+#else
+  return "";
+#endif
+}
+
+ModelMetaData InferenceSession::GetOptimizationMetadata(const Model& model) const {
+  // transformers enabled by name can't be told apart from the predefined ones, so the result can't be reused
+  const auto level = transformers_to_enable_.empty()
+                         ? std::max(session_options_.graph_optimization_level, GetPreoptimizedLevel(model))
+                         : TransformerLevel::Default;
+  return {{kOptimizationLevelKey, std::to_string(static_cast<int>(level))},
+          {kOptimizationProvidersKey, GetOptimizationProviders(execution_providers_)},
+          {kOptimizationNchwcBlockSizeKey, std::to_string(MlasNchwcGetBlockSize())},
+          {kOptimizationVersionKey, GetOptimizationVersion()},
+          {kOptimizationFreeDimensionOverridesKey,
+           GetOptimizationFreeDimensionOverrides(session_options_.free_dimension_overrides)}};
+}
+
+TransformerLevel InferenceSession::GetPreoptimizedLevel(const Model& model) const {
+  const auto& metadata = model.MetaData();
+  auto get = [&metadata](const char* key) -> const std::string* {
+    auto it = metadata.find(key);
+    return it == metadata.end() ? nullptr : &it->second;
+  };
+
+  const std::string* level = get(kOptimizationLevelKey);
+  if (level == nullptr || !transformers_to_enable_.empty()) {
+    return TransformerLevel::Default;
+  }
+
+  const std::string* providers = get(kOptimizationProvidersKey);
+  const std::string* nchwc_block_size = get(kOptimizationNchwcBlockSizeKey);
+  const std::string* version = get(kOptimizationVersionKey);
+  const std::string* free_dimension_overrides = get(kOptimizationFreeDimensionOverridesKey);
+  if (providers == nullptr || *providers != GetOptimizationProviders(execution_providers_) ||
+      nchwc_block_size == nullptr || *nchwc_block_size != std::to_string(MlasNchwcGetBlockSize()) ||
+      version == nullptr || *version != GetOptimizationVersion() ||
+      free_dimension_overrides == nullptr ||
+      *free_dimension_overrides != GetOptimizationFreeDimensionOverrides(session_options_.free_dimension_overrides)) {
+    LOGS(*session_logger_, INFO) << "Model was optimized by a session with different providers, hardware, "
+                                    "free dimension overrides or version. Optimizing it again.";
+    return TransformerLevel::Default;
+  }
+
+  char* end;
+  const long value = std::strtol(level->c_str(), &end, 10);
+  if (end == level->c_str() || *end != '\0' || value <= static_cast<long>(TransformerLevel::Default) ||
+      value >= static_cast<long>(TransformerLevel::MaxTransformerLevel)) {
+    return TransformerLevel::Default;
+  }
+  return static_cast<TransformerLevel>(value);
+}
+
 common::Status InferenceSession::WaitForNotification(Notification* p_executor_done, int64_t timeout_in_ms) {
   if (timeout_in_ms > 0) {
     ORT_NOT_IMPLEMENTED(__FUNCTION__, "timeout_in_ms >0 is not supported");  // TODO
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 
@@ -40,6 +41,7 @@ struct OrtCustomOpDomain {
 
 namespace onnxruntime {
 class IExecutionProvider;  // forward decl
+class Environment;
 class IOBinding;
 class CustomRegistry;
 class Notification;
@@ -96,6 +98,17 @@ class InferenceSession {
   explicit InferenceSession(const SessionOptions& session_options,
                             logging::LoggingManager* logging_manager = nullptr);
 
+  /**
+    Create a new InferenceSession in the given environment.
+    If session_options.use_per_session_threads is false the session runs on the global thread pools
+    owned by session_env rather than creating its own, which keeps the number of worker threads in the
+    process independent of the number of sessions.
+    @param session_env Environment that must outlive the session.
+    */
+  InferenceSession(const SessionOptions& session_options,
+                   logging::LoggingManager* logging_manager,
+                   const Environment& session_env);
+
   virtual ~InferenceSession();
 
   /**
@@ -200,6 +213,23 @@ class InferenceSession {
   common::Status Run(const RunOptions& run_options, const NameMLValMap& feeds,
                      const std::vector<std::string>& output_names, std::vector<OrtValue>* p_fetches);
 
+  using RunAsyncCallback = std::function<void(const common::Status& status, std::vector<OrtValue>& fetches)>;
+
+  /**
+    * Queue a Run and return without waiting for it to complete.
+    * The run executes on a pool of SessionOptions::async_run_num_threads threads owned by the session, created on
+    * the first call, and never on the intra or inter op pools. callback is called on that pool's thread with the
+    * status and fetches of the run once it completes, including when it fails.
+    * @param run_options options for the run, or nullptr for the defaults. Must stay valid until callback is called,
+    *        so that setting RunOptions::terminate still stops the run.
+    * @param fetches preallocated outputs, or empty values to have the run allocate them. See Run.
+    * @return OK if the run was queued. callback isn't called otherwise.
+    * The destructor waits for the queued runs, so the session must not be destroyed from within callback.
+    */
+  common::Status RunAsync(const RunOptions* run_options, std::vector<std::string> feed_names,
+                          std::vector<OrtValue> feeds, std::vector<std::string> output_names,
+                          std::vector<OrtValue> fetches, RunAsyncCallback callback);
+
   /**
   * Creates a new binding object for binding inputs and outputs.
   * @param provider_type specifies the location where the inputs need to be potentially copied.
@@ -341,10 +371,21 @@ class InferenceSession {
 
   common::Status InitializeSubgraphSessions(Graph& graph, SessionState& session_state);
 
+  // Transformers of the levels up to 'preoptimized_level' are not added.
   void AddPredefinedTransformers(GraphTransformerManager& transformer_manager,
                                  TransformerLevel graph_optimization_level,
+                                 TransformerLevel preoptimized_level,
                                  const std::vector<std::string>& custom_list);
 
+  // Returns the metadata that records how this session optimized 'model'. It is added to the copy saved through
+  // optimized_model_filepath so that sessions configured the same way can skip the predefined transformers when
+  // they load it.
+  std::unordered_map<std::string, std::string> GetOptimizationMetadata(const Model& model) const;
+
+  // Returns the level up to which the predefined transformers have already been applied to 'model' by a session
+  // configured like this one, or TransformerLevel::Default if it has to be optimized.
+  TransformerLevel GetPreoptimizedLevel(const Model& model) const;
+
   void InitLogger(logging::LoggingManager* logging_manager);
 
   common::Status CheckShapes(const std::string& input_name,
@@ -385,10 +426,21 @@ class InferenceSession {
   ExecutionProviders execution_providers_;
 
  private:
-  // Threadpool for this session
+  InferenceSession(const SessionOptions& session_options,
+                   logging::LoggingManager* logging_manager,
+                   const Environment* session_env);
+
+  // Threadpool for this session. A restricted view onto the Environment's pool if the session
+  // doesn't use per session threads.
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> thread_pool_;
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
 
+  // Threadpool for the runs queued by RunAsync, created on the first RunAsync call.
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> async_run_thread_pool_;
+  onnxruntime::OrtMutex async_run_mutex_;
+  onnxruntime::OrtCondVar async_run_cv_;
+  int num_pending_async_runs_ = 0;  // GUARDED_BY(async_run_mutex_)
+
  protected:
   // Immutable state for each op in the model. Shared by all executors.
   // It has a dependency on execution_providers_.
@@ -421,6 +473,9 @@ class InferenceSession {
   // Number of concurrently running executors
   std::atomic<int> current_num_runs_;
 
+  // Processors of SessionOptions::numa_node. The thread calling Initialize() is restricted to these.
+  std::vector<int> numa_node_processors_;
+
   mutable onnxruntime::OrtMutex session_mutex_;  // to ensure only one thread can invoke Load/Initialize
   bool is_model_loaded_ = false;                 // GUARDED_BY(session_mutex_)
   bool is_inited_ = false;                       // GUARDED_BY(session_mutex_)
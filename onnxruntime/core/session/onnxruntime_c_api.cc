@@ -21,6 +21,7 @@
 #include "core/framework/tensorprotoutils.h"
 #include "core/framework/onnxruntime_typeinfo.h"
 #include "core/session/inference_session.h"
+#include "core/session/IOBinding.h"
 #include "core/session/ort_apis.h"
 #include "core/framework/data_types.h"
 #include "abi_session_options_impl.h"
@@ -63,6 +64,10 @@ struct OrtEnv {
   ORT_DISALLOW_COPY_AND_ASSIGNMENT(OrtEnv);
 };
 
+struct OrtThreadingOptions {
+  onnxruntime::ThreadingOptions value;
+};
+
 #define TENSOR_READ_API_BEGIN                          \
   API_IMPL_BEGIN                                       \
   auto v = reinterpret_cast<const ::OrtValue*>(value); \
@@ -128,6 +133,54 @@ ORT_API_STATUS_IMPL(OrtApis::CreateEnv, OrtLoggingLevel default_warning_level,
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::CreateEnvWithGlobalThreadPools, OrtLoggingLevel default_warning_level,
+                    _In_ const char* logid, _In_ const OrtThreadingOptions* tp_options, _Outptr_ OrtEnv** out) {
+  API_IMPL_BEGIN
+  std::string name = logid;
+  auto default_logging_manager = onnxruntime::make_unique<LoggingManager>(std::unique_ptr<ISink>{new CLogSink{}},
+                                                                          static_cast<Severity>(default_warning_level), false,
+                                                                          LoggingManager::InstanceType::Default,
+                                                                          &name);
+  std::unique_ptr<Environment> env;
+  Status status = Environment::Create(env, &tp_options->value);
+  if (status.IsOK()) {
+    *out = new OrtEnv(env.release(), default_logging_manager.release());
+    return nullptr;
+  }
+  *out = nullptr;
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::CreateThreadingOptions, _Outptr_ OrtThreadingOptions** out) {
+  API_IMPL_BEGIN
+  *out = new OrtThreadingOptions();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API(void, OrtApis::ReleaseThreadingOptions, OrtThreadingOptions* ptr) {
+  delete ptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetGlobalIntraOpNumThreads, _Inout_ OrtThreadingOptions* tp_options,
+                    int intra_op_num_threads) {
+  if (intra_op_num_threads < 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "intra_op_num_threads must not be negative");
+  }
+  tp_options->value.intra_op_num_threads = intra_op_num_threads;
+  return nullptr;
+}
+
+ORT_API_STATUS_IMPL(OrtApis::SetGlobalInterOpNumThreads, _Inout_ OrtThreadingOptions* tp_options,
+                    int inter_op_num_threads) {
+  if (inter_op_num_threads < 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "inter_op_num_threads must not be negative");
+  }
+  tp_options->value.inter_op_num_threads = inter_op_num_threads;
+  return nullptr;
+}
+
 template <typename T>
 OrtStatus* CreateTensorImpl(const int64_t* shape, size_t shape_len, OrtAllocator* allocator,
                             std::unique_ptr<Tensor>* out) {
@@ -386,8 +439,13 @@ OrtStatus* CreateSessionImpl(_In_ const OrtEnv* env, _In_ const OrtSessionOption
       provider_list.push_back(std::move(provider));
     }
   }
-  auto sess = onnxruntime::make_unique<::onnxruntime::InferenceSession>(
-      options == nullptr ? onnxruntime::SessionOptions() : options->value, env->loggingManager);
+  if (!session_options.use_per_session_threads && !env->value->EnvCreatedWithGlobalThreadPools()) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT,
+                                 "Per session threads are disabled but the environment has no global thread pools. "
+                                 "Create it with CreateEnvWithGlobalThreadPools.");
+  }
+  auto sess = onnxruntime::make_unique<::onnxruntime::InferenceSession>(session_options, env->loggingManager,
+                                                                        *env->value);
   Status status;
   if (options != nullptr) {
     if (!options->custom_op_domains_.empty()) {
@@ -435,16 +493,16 @@ ORT_API_STATUS_IMPL(OrtApis::CreateSessionFromArray, _In_ const OrtEnv* env, _In
   API_IMPL_END
 }
 
-ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess,
-                    _In_opt_ const OrtRunOptions* run_options,
-                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
-                    _In_ const char* const* output_names1, size_t output_names_len, _Outptr_ OrtValue** output) {
-  API_IMPL_BEGIN
-  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+namespace {
+// Converts the inputs and outputs of Run and RunAsync to the arguments of InferenceSession::Run.
+OrtStatus* ToRunArguments(_In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                          _In_ const char* const* output_names1, size_t output_names_len, _In_ OrtValue** output,
+                          std::vector<std::string>& feed_names, std::vector<OrtValue>& feeds,
+                          std::vector<std::string>& output_names, std::vector<OrtValue>& fetches) {
   const int queue_id = 0;
 
-  std::vector<std::string> feed_names(input_len);
-  std::vector<OrtValue> feeds(input_len);
+  feed_names.resize(input_len);
+  feeds.resize(input_len);
 
   for (size_t i = 0; i != input_len; ++i) {
     if (input_names[i] == nullptr || input_names[i][0] == '\0') {
@@ -458,7 +516,7 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess,
   }
 
   // Create output feed
-  std::vector<std::string> output_names(output_names_len);
+  output_names.resize(output_names_len);
   for (size_t i = 0; i != output_names_len; ++i) {
     if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
       return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
@@ -466,7 +524,7 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess,
     output_names[i] = output_names1[i];
   }
 
-  std::vector<OrtValue> fetches(output_names_len);
+  fetches.resize(output_names_len);
   for (size_t i = 0; i != output_names_len; ++i) {
     if (output[i] != nullptr) {
       ::OrtValue& value = *(output[i]);
@@ -475,6 +533,41 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess,
       fetches[i] = value;
     }
   }
+
+  return nullptr;
+}
+
+// Hands the fetches of a successful run back to the caller, allocating the outputs it didn't provide.
+void FromRunFetches(std::vector<OrtValue>& fetches, _Inout_ OrtValue** output) {
+  const int queue_id = 0;
+
+  for (size_t i = 0, end = fetches.size(); i != end; ++i) {
+    ::OrtValue& value = fetches[i];
+    if (value.Fence())
+      value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
+    if (output[i] == nullptr) {
+      output[i] = new OrtValue(value);
+    }
+  }
+}
+}  // namespace
+
+ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess,
+                    _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len, _Outptr_ OrtValue** output) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  std::vector<std::string> feed_names;
+  std::vector<OrtValue> feeds;
+  std::vector<std::string> output_names;
+  std::vector<OrtValue> fetches;
+  if (auto* status = ToRunArguments(input_names, input, input_len, output_names1, output_names_len, output,
+                                    feed_names, feeds, output_names, fetches)) {
+    return status;
+  }
+
   Status status;
   if (run_options == nullptr) {
     OrtRunOptions op;
@@ -485,14 +578,144 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess,
 
   if (!status.IsOK())
     return ToOrtStatus(status);
-  for (size_t i = 0; i != output_names_len; ++i) {
-    ::OrtValue& value = fetches[i];
-    if (value.Fence())
-      value.Fence()->BeforeUsingAsInput(onnxruntime::kCpuExecutionProvider, queue_id);
-    if (output[i] == nullptr) {
-      output[i] = new OrtValue(value);
+
+  FromRunFetches(fetches, output);
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names1, size_t output_names_len, _Inout_ OrtValue** output,
+                    _In_ RunAsyncCallbackFn callback, _In_opt_ void* user_data) {
+  API_IMPL_BEGIN
+  if (callback == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "callback cannot be null");
+  }
+
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  std::vector<std::string> feed_names;
+  std::vector<OrtValue> feeds;
+  std::vector<std::string> output_names;
+  std::vector<OrtValue> fetches;
+  if (auto* status = ToRunArguments(input_names, input, input_len, output_names1, output_names_len, output,
+                                    feed_names, feeds, output_names, fetches)) {
+    return status;
+  }
+
+  auto on_completed = [output, output_names_len, callback, user_data](const Status& run_status,
+                                                                      std::vector<OrtValue>& run_fetches) {
+    OrtStatus* status = nullptr;
+    if (run_status.IsOK()) {
+      try {
+        FromRunFetches(run_fetches, output);
+      } catch (const std::exception& ex) {
+        status = OrtApis::CreateStatus(ORT_RUNTIME_EXCEPTION, ex.what());
+      }
+    } else {
+      status = ToOrtStatus(run_status);
     }
+
+    callback(user_data, output, output_names_len, status);
+    OrtApis::ReleaseStatus(status);
+  };
+
+  return ToOrtStatus(session->RunAsync(run_options, std::move(feed_names), std::move(feeds), std::move(output_names),
+                                       std::move(fetches), on_completed));
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::CreateIoBinding, _Inout_ OrtSession* sess, _Outptr_ OrtIoBinding** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  std::unique_ptr<::onnxruntime::IOBinding> binding;
+  auto status = session->NewIOBinding(&binding);
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+  *out = reinterpret_cast<OrtIoBinding*>(binding.release());
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::BindInput, _Inout_ OrtIoBinding* binding, _In_ const char* name,
+                    _In_ const OrtValue* val) {
+  API_IMPL_BEGIN
+  if (name == nullptr || name[0] == '\0') {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+  }
+  auto& io_binding = *reinterpret_cast<::onnxruntime::IOBinding*>(binding);
+  return ToOrtStatus(io_binding.BindInput(name, *val));
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::BindOutput, _Inout_ OrtIoBinding* binding, _In_ const char* name,
+                    _In_opt_ const OrtValue* val) {
+  API_IMPL_BEGIN
+  if (name == nullptr || name[0] == '\0') {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+  }
+  auto& io_binding = *reinterpret_cast<::onnxruntime::IOBinding*>(binding);
+  return ToOrtStatus(io_binding.BindOutput(name, val != nullptr ? *val : OrtValue()));
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::ClearBoundInputs, _Inout_ OrtIoBinding* binding) {
+  API_IMPL_BEGIN
+  reinterpret_cast<::onnxruntime::IOBinding*>(binding)->ClearInputs();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::ClearBoundOutputs, _Inout_ OrtIoBinding* binding) {
+  API_IMPL_BEGIN
+  reinterpret_cast<::onnxruntime::IOBinding*>(binding)->ClearOutputs();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunWithBinding, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtIoBinding* binding) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+  auto& io_binding = *reinterpret_cast<::onnxruntime::IOBinding*>(binding);
+
+  // callers of the C API have no other way to wait for inputs copied to, or outputs written on, another device
+  auto status = io_binding.SynchronizeInputs();
+  if (status.IsOK()) {
+    if (run_options == nullptr) {
+      OrtRunOptions op;
+      status = session->Run(op, io_binding);
+    } else {
+      status = session->Run(*run_options, io_binding);
+    }
+  }
+  if (status.IsOK()) {
+    status = io_binding.SynchronizeOutputs();
+  }
+
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::GetBoundOutputCount, _In_ const OrtIoBinding* binding, _Out_ size_t* out) {
+  API_IMPL_BEGIN
+  *out = reinterpret_cast<const ::onnxruntime::IOBinding*>(binding)->GetOutputNames().size();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::GetBoundOutputValue, _In_ const OrtIoBinding* binding, size_t index,
+                    _Outptr_ OrtValue** out) {
+  API_IMPL_BEGIN
+  const auto& outputs = reinterpret_cast<const ::onnxruntime::IOBinding*>(binding)->GetOutputs();
+  if (index >= outputs.size()) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output index is out of range");
+  }
+  if (!outputs[index].IsAllocated()) {
+    return OrtApis::CreateStatus(ORT_FAIL, "output has not been produced by a run yet");
   }
+  *out = new OrtValue(outputs[index]);
   return nullptr;
   API_IMPL_END
 }
@@ -1257,7 +1480,7 @@ static constexpr OrtApiBase ort_api_base = {
     &OrtApis::GetVersionString,
 };
 
-static constexpr OrtApi ort_api_1 = {
+static constexpr OrtApi ort_api = {
     ort_api_base,
 
     &OrtApis::CreateStatus,
@@ -1371,13 +1594,42 @@ static constexpr OrtApi ort_api_1 = {
     &OrtApis::ReleaseTensorTypeAndShapeInfo,
     &OrtApis::ReleaseSessionOptions,
     &OrtApis::ReleaseCustomOpDomain,
+    // End of version 1
+
+    &OrtApis::CreateThreadingOptions,
+    &OrtApis::SetGlobalIntraOpNumThreads,
+    &OrtApis::SetGlobalInterOpNumThreads,
+    &OrtApis::CreateEnvWithGlobalThreadPools,
+    &OrtApis::DisablePerSessionThreads,
+    &OrtApis::ReleaseThreadingOptions,
+    &OrtApis::SetIntraOpThreadAffinity,
+    &OrtApis::SetSessionNumaNode,
+    &OrtApis::EnableExecutionFramePool,
+    &OrtApis::DisableExecutionFramePool,
+    &OrtApis::SetMemPatternDimBuckets,
+    &OrtApis::SetMemPatternCacheCapacity,
+    &OrtApis::EnableModelMmap,
+    &OrtApis::DisableModelMmap,
+    &OrtApis::RunAsync,
+    &OrtApis::CreateIoBinding,
+    &OrtApis::ReleaseIoBinding,
+    &OrtApis::BindInput,
+    &OrtApis::BindOutput,
+    &OrtApis::ClearBoundInputs,
+    &OrtApis::ClearBoundOutputs,
+    &OrtApis::RunWithBinding,
+    &OrtApis::GetBoundOutputCount,
+    &OrtApis::GetBoundOutputValue,
+    &OrtApis::EnableRunArena,
+    &OrtApis::DisableRunArena,
 };
 
 ORT_API(const OrtApi*, OrtApis::GetApi, uint32_t version) {
-  if (version > 1)
+  // later versions only append entries, so the same table serves every supported version
+  if (version < 1 || version > ORT_API_VERSION)
     return nullptr;
 
-  return &ort_api_1;
+  return &ort_api;
 }
 
 ORT_API(const char*, OrtApis::GetVersionString) {
@@ -1392,3 +1644,4 @@ DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Env, OrtEnv)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Value, OrtValue)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(RunOptions, OrtRunOptions)
 DEFINE_RELEASE_ORT_OBJECT_FUNCTION(Session, ::onnxruntime::InferenceSession)
+DEFINE_RELEASE_ORT_OBJECT_FUNCTION(IoBinding, ::onnxruntime::IOBinding)
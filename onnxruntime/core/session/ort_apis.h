@@ -16,6 +16,8 @@ ORT_API(void, ReleaseTypeInfo, OrtTypeInfo*);
 ORT_API(void, ReleaseTensorTypeAndShapeInfo, OrtTensorTypeAndShapeInfo*);
 ORT_API(void, ReleaseSessionOptions, OrtSessionOptions*);
 ORT_API(void, ReleaseCustomOpDomain, OrtCustomOpDomain*);
+ORT_API(void, ReleaseThreadingOptions, OrtThreadingOptions*);
+ORT_API(void, ReleaseIoBinding, OrtIoBinding*);
 
 ORT_API_STATUS_IMPL(CreateStatus, OrtErrorCode code, _In_ const char* msg);
 OrtErrorCode ORT_API_CALL GetErrorCode(_In_ const OrtStatus* status) NO_EXCEPTION ORT_ALL_ARGS_NONNULL;
@@ -142,4 +144,37 @@ ORT_API_STATUS_IMPL(KernelContext_GetOutputCount, _In_ const OrtKernelContext* c
 ORT_API_STATUS_IMPL(KernelContext_GetInput, _In_ const OrtKernelContext* context, _In_ size_t index, _Out_ const OrtValue** out);
 ORT_API_STATUS_IMPL(KernelContext_GetOutput, _Inout_ OrtKernelContext* context, _In_ size_t index, _In_ const int64_t* dim_values, size_t dim_count, _Out_ OrtValue** out);
 
+ORT_API_STATUS_IMPL(CreateThreadingOptions, _Outptr_ OrtThreadingOptions** out);
+ORT_API_STATUS_IMPL(SetGlobalIntraOpNumThreads, _Inout_ OrtThreadingOptions* tp_options, int intra_op_num_threads);
+ORT_API_STATUS_IMPL(SetGlobalInterOpNumThreads, _Inout_ OrtThreadingOptions* tp_options, int inter_op_num_threads);
+ORT_API_STATUS_IMPL(CreateEnvWithGlobalThreadPools, OrtLoggingLevel default_logging_level, _In_ const char* logid,
+                    _In_ const OrtThreadingOptions* tp_options, _Outptr_ OrtEnv** out)
+ORT_ALL_ARGS_NONNULL;
+ORT_API_STATUS_IMPL(DisablePerSessionThreads, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(SetIntraOpThreadAffinity, _Inout_ OrtSessionOptions* options,
+                    _In_ const int* processor_ids, size_t processor_ids_len);
+ORT_API_STATUS_IMPL(SetSessionNumaNode, _Inout_ OrtSessionOptions* options, int numa_node);
+ORT_API_STATUS_IMPL(EnableExecutionFramePool, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(DisableExecutionFramePool, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(SetMemPatternDimBuckets, _Inout_ OrtSessionOptions* options, _In_ const int64_t* dim_buckets,
+                    size_t dim_buckets_len);
+ORT_API_STATUS_IMPL(SetMemPatternCacheCapacity, _Inout_ OrtSessionOptions* options, size_t capacity);
+ORT_API_STATUS_IMPL(EnableModelMmap, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(DisableModelMmap, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_ const char* const* input_names, _In_ const OrtValue* const* input, size_t input_len,
+                    _In_ const char* const* output_names, size_t output_names_len, _Inout_ OrtValue** output,
+                    _In_ RunAsyncCallbackFn callback, _In_opt_ void* user_data);
+ORT_API_STATUS_IMPL(CreateIoBinding, _Inout_ OrtSession* session, _Outptr_ OrtIoBinding** out);
+ORT_API_STATUS_IMPL(BindInput, _Inout_ OrtIoBinding* binding, _In_ const char* name, _In_ const OrtValue* val);
+ORT_API_STATUS_IMPL(BindOutput, _Inout_ OrtIoBinding* binding, _In_ const char* name, _In_opt_ const OrtValue* val);
+ORT_API_STATUS_IMPL(ClearBoundInputs, _Inout_ OrtIoBinding* binding);
+ORT_API_STATUS_IMPL(ClearBoundOutputs, _Inout_ OrtIoBinding* binding);
+ORT_API_STATUS_IMPL(RunWithBinding, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtIoBinding* binding);
+ORT_API_STATUS_IMPL(GetBoundOutputCount, _In_ const OrtIoBinding* binding, _Out_ size_t* out);
+ORT_API_STATUS_IMPL(GetBoundOutputValue, _In_ const OrtIoBinding* binding, size_t index, _Outptr_ OrtValue** out);
+ORT_API_STATUS_IMPL(EnableRunArena, _Inout_ OrtSessionOptions* options);
+ORT_API_STATUS_IMPL(DisableRunArena, _Inout_ OrtSessionOptions* options);
+
 }  // namespace OrtApis
@@ -69,6 +69,49 @@ void QGemmu8u8_s32(
 #else
   MlasGemm(M, N, K, lhs_data, lda, lhs_offset, rhs_data, ldb, rhs_offset, result_data, ldc, thread_pool);
 
+#endif
+}
+
+void QGemmu8u8_u8(
+    int M,
+    int N,
+    int K,
+    const uint8_t* lhs_data,
+    int lda,
+    const uint8_t lhs_offset,
+    const uint8_t* rhs_data,
+    int ldb,
+    const uint8_t rhs_offset,
+    int32_t* accumulator_data,
+    uint8_t* result_data,
+    int ldc,
+    float result_scale,
+    const uint8_t result_offset,
+    const int32_t* bias,
+    concurrency::ThreadPool* thread_pool) {
+#ifdef USE_GEMMLOWP
+
+  ORT_UNUSED_PARAMETER(accumulator_data);
+  ORT_UNUSED_PARAMETER(thread_pool);
+  ORT_ENFORCE(lda == K && ldb == N && ldc == N, "For gemmlowp only RowMajor*RowMajor=RowMajor format is supported");
+
+  int32_t integer_multiplier;
+  int right_shift;
+  QuantizeMultiplier(result_scale, &integer_multiplier, &right_shift);
+  GemmlowpMultiplyu8u8_u8(lhs_data, rhs_data, result_data, lhs_offset, rhs_offset, result_offset,
+                          M, N, K, integer_multiplier, right_shift, bias);
+
+#else
+  MLAS_REQUANTIZE_OUTPUT requantize;
+  requantize.Output = result_data;
+  requantize.ldo = ldc;
+  requantize.Bias = bias;
+  requantize.Scale = result_scale;
+  requantize.ZeroPoint = result_offset;
+
+  MlasGemm(M, N, K, lhs_data, lda, lhs_offset, rhs_data, ldb, rhs_offset, accumulator_data, ldc,
+           &requantize, thread_pool);
+
 #endif
 }
 }  // namespace onnxruntime
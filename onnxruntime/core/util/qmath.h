@@ -35,4 +35,25 @@ void QGemmu8u8_s32(
     int ldc,
     concurrency::ThreadPool* thread_pool);
 
+// Computes a quantized GEMM whose output is requantized to uint8 with
+// result_scale and result_offset after the optional per row bias is added.
+// accumulator_data is int32 scratch space with the same layout as result_data.
+void QGemmu8u8_u8(
+    int M,
+    int N,
+    int K,
+    const uint8_t* lhs_data,
+    int lda,
+    const uint8_t lhs_offset,
+    const uint8_t* rhs_data,
+    int ldb,
+    const uint8_t rhs_offset,
+    int32_t* accumulator_data,
+    uint8_t* result_data,
+    int ldc,
+    float result_scale,
+    const uint8_t result_offset,
+    const int32_t* bias,
+    concurrency::ThreadPool* thread_pool);
+
 }  // namespace onnxruntime
@@ -2,18 +2,59 @@
 #include <algorithm>
 
 #include <core/common/make_unique.h>
+#include "core/platform/env.h"
 
 namespace onnxruntime {
 namespace concurrency {
 
+int DefaultThreadPoolSize() {
+  return std::max<int>(1, std::thread::hardware_concurrency() / 2);
+}
+
 std::unique_ptr<ThreadPool> CreateThreadPool(const std::string& name, int thread_pool_size) {
+  return CreateThreadPool(name, thread_pool_size, ThreadAffinity());
+}
+
+std::unique_ptr<ThreadPool> CreateThreadPool(const std::string& name, int thread_pool_size,
+                                             const ThreadAffinity& affinity) {
   if (thread_pool_size <= 0) {  // default
-    thread_pool_size = std::max<int>(1, std::thread::hardware_concurrency() / 2);
+    const int num_processors = static_cast<int>(affinity.processor_ids.size());
+    if (num_processors == 0) {
+      thread_pool_size = DefaultThreadPoolSize();
+    } else {
+      // at least two threads when there are processors for them, so the pool has workers to place
+      thread_pool_size = affinity.one_processor_per_thread
+                             ? num_processors
+                             : std::max(std::min(2, num_processors), num_processors / 2);
+    }
   }
 
+  // a pool of size 1 has no worker threads, so there would be nothing to apply the affinity to
+  ORT_ENFORCE(thread_pool_size != 1 || affinity.processor_ids.empty(), "Thread affinity was requested for ", name,
+              ", but its size is 1, so work runs on the calling thread. Use at least 2 threads, "
+              "or restrict the affinity of the calling thread instead.");
+
   // since we use the main thread for execution we don't have to create any threads on the thread pool when
   // the requested size is 1. For other cases, we will have thread_pool_size + 1 threads for execution
-  return thread_pool_size == 1 ? nullptr : onnxruntime::make_unique<concurrency::ThreadPool>(name, thread_pool_size);
+  return thread_pool_size == 1
+             ? nullptr
+             : onnxruntime::make_unique<concurrency::ThreadPool>(name, thread_pool_size, affinity);
+}
+
+ScopedThreadAffinity::ScopedThreadAffinity(const std::vector<int>& processor_ids) {
+  if (processor_ids.empty())
+    return;
+
+  const Env& env = Env::Default();
+  restore_ = env.GetThreadAffinity(previous_processor_ids_).IsOK() &&
+             env.SetThreadAffinity(processor_ids).IsOK();
+}
+
+ScopedThreadAffinity::~ScopedThreadAffinity() {
+  if (restore_) {
+    auto status = Env::Default().SetThreadAffinity(previous_processor_ids_);
+    ORT_UNUSED_PARAMETER(status);
+  }
 }
 }  // namespace concurrency
-}  // namespace onnxruntime
\ No newline at end of file
+}  // namespace onnxruntime
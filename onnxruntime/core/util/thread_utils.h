@@ -1,10 +1,39 @@
+#pragma once
+
+#include "core/common/common.h"
 #include "core/platform/threadpool.h"
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace onnxruntime {
 namespace concurrency {
 
+// Number of threads used when a pool size of 0 (default) is requested.
+// Approximates the number of physical cores.
+int DefaultThreadPoolSize();
+
 std::unique_ptr<ThreadPool> CreateThreadPool(const std::string& name, int thread_pool_size);
+
+// Creates a pool whose workers are restricted to affinity.processor_ids when they are created.
+// A size of 0 picks one worker per processor when pinning one processor per thread, and an
+// estimate of the number of physical cores among the processors otherwise.
+// Throws if an affinity is given but the size resolves to 1, as such a pool has no workers to restrict.
+std::unique_ptr<ThreadPool> CreateThreadPool(const std::string& name, int thread_pool_size,
+                                             const ThreadAffinity& affinity);
+
+// Restricts the calling thread to the given processors for the lifetime of the object
+// and restores its previous affinity afterwards. Does nothing if processor_ids is empty.
+class ScopedThreadAffinity {
+ public:
+  explicit ScopedThreadAffinity(const std::vector<int>& processor_ids);
+  ~ScopedThreadAffinity();
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ScopedThreadAffinity);
+
+  std::vector<int> previous_processor_ids_;
+  bool restore_ = false;
+};
 }  // namespace concurrency
-}  // namespace onnxruntime
\ No newline at end of file
+}  // namespace onnxruntime
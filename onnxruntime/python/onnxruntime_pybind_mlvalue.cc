@@ -98,7 +98,44 @@ bool PyObjectCheck_Array(PyObject* o) {
   return PyObject_HasAttrString(o, "__array_finalize__");
 }
 
+static TensorShape GetArrayShape(PyArrayObject* pyObject) {
+  // numpy requires long int as its dims.
+  int ndim = PyArray_NDIM(pyObject);
+  npy_intp* npy_dims = PyArray_DIMS(pyObject);
+  std::vector<int64_t> dims(ndim);
+  for (int i = 0; i < ndim; ++i) {
+    dims[i] = npy_dims[i];
+  }
+  return TensorShape(dims);
+}
+
+// Numeric arrays already laid out the way a Tensor expects are used in place instead of being copied.
+// The tensor doesn't own the buffer, so the array must outlive it. That holds for feeds, which are only
+// used during the run while the caller keeps the Python objects alive, and ORT never writes into graph inputs.
+static std::unique_ptr<Tensor> CreateTensorAliasingArray(AllocatorPtr alloc, PyArrayObject* pyObject) {
+  const int npy_type = PyArray_TYPE(pyObject);
+  if (npy_type == NPY_UNICODE || npy_type == NPY_STRING || npy_type == NPY_VOID || npy_type == NPY_OBJECT) {
+    return nullptr;
+  }
+  if (!PyArray_IS_C_CONTIGUOUS(pyObject) || !PyArray_ISALIGNED(pyObject) || !PyArray_ISNOTSWAPPED(pyObject)) {
+    return nullptr;
+  }
+
+  auto element_type = NumpyToOnnxRuntimeTensorType(npy_type);
+  if (element_type->Size() != static_cast<size_t>(PyArray_ITEMSIZE(pyObject))) {
+    return nullptr;
+  }
+
+  return onnxruntime::make_unique<Tensor>(element_type, GetArrayShape(pyObject), PyArray_DATA(pyObject),
+                                          alloc->Info());
+}
+
 std::unique_ptr<Tensor> CreateTensor(AllocatorPtr alloc, const std::string& name_input, PyArrayObject* pyObject) {
+  auto p_aliasing_tensor = CreateTensorAliasingArray(alloc, pyObject);
+  if (p_aliasing_tensor) {
+    return p_aliasing_tensor;
+  }
+
   PyArrayObject* darray = PyArray_GETCONTIGUOUS(pyObject);
   if (darray == NULL) {
     throw std::runtime_error(std::string("The object must be a contiguous array for input '") + name_input + std::string("'."));
@@ -107,15 +144,7 @@ std::unique_ptr<Tensor> CreateTensor(AllocatorPtr alloc, const std::string& name
   std::unique_ptr<Tensor> p_tensor;
   try {
     const int npy_type = PyArray_TYPE(darray);
-    // numpy requires long int as its dims.
-    int ndim = PyArray_NDIM(darray);
-    npy_intp* npy_dims = PyArray_DIMS(darray);
-    std::vector<int64_t> dims(ndim);
-    for (int i = 0; i < ndim; ++i) {
-      dims[i] = npy_dims[i];
-    }
-
-    TensorShape shape(dims);
+    TensorShape shape = GetArrayShape(darray);
     auto element_type = NumpyToOnnxRuntimeTensorType(npy_type);
     p_tensor = onnxruntime::make_unique<Tensor>(element_type, shape, alloc);
     if (npy_type == NPY_UNICODE) {
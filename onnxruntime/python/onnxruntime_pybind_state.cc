@@ -221,10 +221,45 @@ void AddNonTensorAsPyObj(OrtValue& val, std::vector<py::object>& pyobjs) {
   }
 }
 
-void AddTensorAsPyObj(OrtValue& val, std::vector<py::object>& pyobjs) {
+// Wraps the tensor of an output in a numpy array that shares its buffer instead of copying it.
+// A capsule holding the OrtValue is the base of the array, so the buffer is released with the array.
+// Only tensors owning a CPU buffer qualify: other buffers belong to the session or to a feed and
+// don't outlive the run.
+static bool GetPyObjSharingTensorBuffer(const OrtValue& val, py::object& obj) {
   const Tensor& rtensor = val.Get<Tensor>();
+  MLDataType dtype = rtensor.DataType();
+  if (!rtensor.OwnsBuffer() || rtensor.Location().device.Type() != OrtDevice::CPU ||
+      dtype == DataTypeImpl::GetType<std::string>()) {
+    return false;
+  }
+
+  std::vector<npy_intp> npy_dims;
+  const TensorShape& shape = rtensor.Shape();
+
+  for (size_t n = 0; n < shape.NumDimensions(); ++n) {
+    npy_dims.push_back(shape[n]);
+  }
+
+  const int numpy_type = OnnxRuntimeTensorToNumpyType(dtype);
+  py::capsule base(new OrtValue(val), [](void* p) { delete static_cast<OrtValue*>(p); });
+  obj = py::reinterpret_steal<py::object>(PyArray_SimpleNewFromData(
+      shape.NumDimensions(), npy_dims.data(), numpy_type, const_cast<void*>(rtensor.DataRaw(dtype))));
+  if (!obj) {
+    throw py::error_already_set();
+  }
+
+  // the array steals the reference to its base
+  if (PyArray_SetBaseObject(reinterpret_cast<PyArrayObject*>(obj.ptr()), base.release().ptr()) != 0) {
+    throw py::error_already_set();
+  }
+  return true;
+}
+
+void AddTensorAsPyObj(OrtValue& val, std::vector<py::object>& pyobjs) {
   py::object obj;
-  GetPyObjFromTensor(rtensor, obj);
+  if (!GetPyObjSharingTensorBuffer(val, obj)) {
+    GetPyObjFromTensor(val.Get<Tensor>(), obj);
+  }
   pyobjs.push_back(obj);
 }
 
@@ -576,6 +611,12 @@ Applies to session load, initialization, etc. Default is 0.)pbdoc")
                      R"pbdoc(Sets the number of threads used to parallelize the execution of the graph (across nodes). Default is 0 to let onnxruntime choose.)pbdoc")
       .def_readwrite("execution_mode", &SessionOptions::execution_mode,
                      R"pbdoc(Sets the execution mode. Default is sequential.)pbdoc")
+      .def_readwrite("enable_node_cost_measurement", &SessionOptions::enable_node_cost_measurement,
+                     R"pbdoc(Time the nodes run by the parallel executor to order later runs by their critical path.
+Default is false.)pbdoc")
+      .def_readwrite("enable_run_arena", &SessionOptions::enable_run_arena,
+                     R"pbdoc(Allocate the intermediate values of a run from a per-run arena that is reset when the run ends.
+May use more memory. Default is false.)pbdoc")
       .def_property(
           "graph_optimization_level",
           [](const SessionOptions* options) -> GraphOptimizationLevel {
@@ -718,12 +759,12 @@ including arg name, arg type (contains both type and shape).)pbdoc")
            R"pbdoc(Load a model serialized in ONNX format.)pbdoc")
       .def("run", [](InferenceSession* sess, std::vector<std::string> output_names, std::map<std::string, py::object> pyfeeds, RunOptions* run_options = nullptr) -> std::vector<py::object> {
         NameMLValMap feeds;
-        for (auto _ : pyfeeds) {
+        auto px = sess->GetModelInputs();
+        if (!px.first.IsOK() || !px.second) {
+          throw std::runtime_error("Either failed to get model inputs from the session object or the input def list was null");
+        }
+        for (auto& _ : pyfeeds) {
           OrtValue ml_value;
-          auto px = sess->GetModelInputs();
-          if (!px.first.IsOK() || !px.second) {
-            throw std::runtime_error("Either failed to get model inputs from the session object or the input def list was null");
-          }
           CreateGenericMLValue(px.second, GetAllocator(), _.first, _.second, &ml_value);
           if (PyErr_Occurred()) {
             PyObject *ptype, *pvalue, *ptraceback;
@@ -756,7 +797,7 @@ including arg name, arg type (contains both type and shape).)pbdoc")
 
         std::vector<py::object> rfetch;
         rfetch.reserve(fetches.size());
-        for (auto _ : fetches) {
+        for (auto& _ : fetches) {
           if (_.IsTensor()) {
             AddTensorAsPyObj(_, rfetch);
           } else {
@@ -0,0 +1,388 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cstring>
+#include <future>
+
+#include "batcher.h"
+
+namespace onnxruntime {
+namespace server {
+
+namespace {
+
+// Size in bytes of one element, or 0 for types that can't be copied with memcpy.
+size_t ElementSize(ONNXTensorElementDataType type) {
+  switch (type) {
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BOOL:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT8:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT8:
+      return 1;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT16:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_BFLOAT16:
+      return 2;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT32:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT32:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_FLOAT:
+      return 4;
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_INT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_UINT64:
+    case ONNX_TENSOR_ELEMENT_DATA_TYPE_DOUBLE:
+      return 8;
+    default:
+      return 0;
+  }
+}
+
+// Returns the number of rows of a tensor that can be split or concatenated along dimension 0,
+// or 0 if the value can't be batched.
+size_t BatchRows(const Ort::Value& value) {
+  if (!value.IsTensor()) {
+    return 0;
+  }
+  auto info = value.GetTensorTypeAndShapeInfo();
+  if (ElementSize(info.GetElementType()) == 0) {
+    return 0;
+  }
+  auto shape = info.GetShape();
+  if (shape.empty() || shape[0] <= 0) {
+    return 0;
+  }
+  return static_cast<size_t>(shape[0]);
+}
+
+uint8_t* TensorBytes(Ort::Value& value) {
+  return value.GetTensorMutableData<uint8_t>();
+}
+
+}  // namespace
+
+struct RequestBatcher::PendingRequest {
+  PendingRequest(const Ort::RunOptions& run_options_in,
+                 const std::vector<std::string>& input_names_in,
+                 std::vector<Ort::Value>& input_values_in,
+                 const std::vector<std::string>& output_names_in)
+      : run_options(run_options_in),
+        log_verbosity_level(run_options_in.GetRunLogVerbosityLevel()),
+        input_names(input_names_in),
+        input_values(input_values_in),
+        output_names(output_names_in),
+        enqueue_time(std::chrono::steady_clock::now()) {
+    for (const auto& value : input_values) {
+      auto info = value.GetTensorTypeAndShapeInfo();
+      types.push_back(info.GetElementType());
+      shapes.push_back(info.GetShape());
+    }
+    rows = static_cast<size_t>(shapes.front()[0]);
+  }
+
+  // Whether the two requests can be concatenated along dimension 0.
+  bool CompatibleWith(const PendingRequest& other) const {
+    if (log_verbosity_level != other.log_verbosity_level || input_names != other.input_names ||
+        output_names != other.output_names || types != other.types) {
+      return false;
+    }
+    for (size_t i = 0; i < shapes.size(); ++i) {
+      const auto& a = shapes[i];
+      const auto& b = other.shapes[i];
+      if (a.size() != b.size() || !std::equal(a.begin() + 1, a.end(), b.begin() + 1)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  const Ort::RunOptions& run_options;
+  const int log_verbosity_level;
+  const std::vector<std::string>& input_names;
+  std::vector<Ort::Value>& input_values;
+  const std::vector<std::string>& output_names;
+  std::vector<ONNXTensorElementDataType> types;
+  std::vector<std::vector<int64_t>> shapes;
+  size_t rows;
+  std::chrono::steady_clock::time_point enqueue_time;
+  std::promise<std::vector<Ort::Value>> result;
+};
+
+RequestBatcher::RequestBatcher(Runner runner, const BatchingOptions& options)
+    : RequestBatcher(std::move(runner), options, nullptr, std::chrono::milliseconds::zero()) {}
+
+RequestBatcher::RequestBatcher(Runner runner, const BatchingOptions& options, MetricsReporter reporter,
+                               std::chrono::milliseconds metrics_interval)
+    : runner_(std::move(runner)),
+      options_(options),
+      reporter_(std::move(reporter)),
+      metrics_interval_(metrics_interval),
+      last_report_(std::chrono::steady_clock::now()) {
+  const size_t num_workers = std::max<size_t>(1, options_.max_concurrent_batches);
+  for (size_t i = 0; i < num_workers; ++i) {
+    workers_.emplace_back([this]() { WorkerLoop(); });
+  }
+  dispatcher_ = std::thread([this]() { DispatchLoop(); });
+}
+
+RequestBatcher::~RequestBatcher() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  // The dispatcher hands out the remaining requests before it exits, and the workers run them.
+  dispatcher_.join();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_workers_ = true;
+  }
+  batches_cv_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+bool RequestBatcher::CanBatch(const std::vector<Ort::Value>& input_values) {
+  if (input_values.empty()) {
+    return false;
+  }
+  size_t rows = BatchRows(input_values.front());
+  return rows != 0 && std::all_of(input_values.begin(), input_values.end(),
+                                  [rows](const Ort::Value& value) { return BatchRows(value) == rows; });
+}
+
+std::vector<Ort::Value> RequestBatcher::Run(const Ort::RunOptions& run_options,
+                                            const std::vector<std::string>& input_names,
+                                            std::vector<Ort::Value>& input_values,
+                                            const std::vector<std::string>& output_names) {
+  if (!CanBatch(input_values)) {
+    return runner_(run_options, input_names, input_values, output_names);
+  }
+
+  auto request = std::make_shared<PendingRequest>(run_options, input_names, input_values, output_names);
+  auto result = request->result.get_future();
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (shutdown_) {
+      throw Ort::Exception("Request batcher is shutting down.", ORT_FAIL);
+    }
+    queue_.push_back(std::move(request));
+  }
+  cv_.notify_all();
+
+  // The workers read the run options and inputs in place, so they must outlive the run.
+  return result.get();
+}
+
+BatchingMetrics RequestBatcher::GetMetrics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  BatchingMetrics metrics = metrics_;
+  metrics.queue_depth = queue_.size();
+  return metrics;
+}
+
+size_t RequestBatcher::CompatibleRows(const PendingRequest& head) const {
+  size_t rows = 0;
+  for (const auto& request : queue_) {
+    if (request->CompatibleWith(head)) {
+      rows += request->rows;
+    }
+  }
+  return rows;
+}
+
+RequestBatcher::Batch RequestBatcher::TakeBatch() {
+  Batch batch;
+  batch.push_back(queue_.front());
+  queue_.pop_front();
+
+  const PendingRequest& head = *batch.front();
+  size_t rows = head.rows;
+  for (auto it = queue_.begin(); it != queue_.end() && rows < options_.max_batch_size;) {
+    if ((*it)->CompatibleWith(head) && rows + (*it)->rows <= options_.max_batch_size) {
+      rows += (*it)->rows;
+      batch.push_back(std::move(*it));
+      it = queue_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  ++metrics_.num_batches;
+  metrics_.num_requests += batch.size();
+  metrics_.num_rows += rows;
+  metrics_.max_batch_rows = std::max<uint64_t>(metrics_.max_batch_rows, rows);
+  return batch;
+}
+
+void RequestBatcher::DispatchLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    cv_.wait(lock, [this]() { return shutdown_ || !queue_.empty(); });
+    if (queue_.empty()) {
+      return;
+    }
+
+    // Hold the oldest request until enough compatible rows arrive to fill a batch or its deadline passes.
+    const auto deadline = queue_.front()->enqueue_time + options_.max_queue_delay;
+    while (!shutdown_ && CompatibleRows(*queue_.front()) < options_.max_batch_size) {
+      if (cv_.wait_until(lock, deadline) == std::cv_status::timeout) {
+        break;
+      }
+    }
+
+    // Requests keep joining the queue while every worker is busy, so the next batch fills up meanwhile.
+    cv_.wait(lock, [this]() { return busy_workers_ < workers_.size(); });
+
+    batches_.push_back(TakeBatch());
+    ++busy_workers_;
+    batches_cv_.notify_one();
+
+    if (reporter_ && std::chrono::steady_clock::now() - last_report_ >= metrics_interval_) {
+      last_report_ = std::chrono::steady_clock::now();
+      BatchingMetrics metrics = metrics_;
+      metrics.queue_depth = queue_.size();
+      lock.unlock();
+      try {
+        reporter_(metrics);
+      } catch (...) {
+        // metrics are best effort and must not stop the dispatcher
+      }
+      lock.lock();
+    }
+  }
+}
+
+void RequestBatcher::WorkerLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    batches_cv_.wait(lock, [this]() { return stop_workers_ || !batches_.empty(); });
+    if (batches_.empty()) {
+      return;
+    }
+
+    Batch batch = std::move(batches_.front());
+    batches_.pop_front();
+    lock.unlock();
+    RunBatch(batch);
+    lock.lock();
+
+    --busy_workers_;
+    cv_.notify_all();
+  }
+}
+
+void RequestBatcher::RunBatch(const Batch& batch) {
+  if (batch.size() == 1 || !merge_outputs_) {
+    RunOneByOne(batch);
+    return;
+  }
+
+  size_t total_rows = 0;
+  for (const auto& request : batch) {
+    total_rows += request->rows;
+  }
+
+  // Nothing escapes to the worker thread: a failure that doesn't belong to a single request,
+  // such as std::bad_alloc while merging or splitting tensors, fails every request in the batch.
+  std::vector<std::vector<Ort::Value>> results;
+  try {
+    results.resize(batch.size());
+    std::vector<Ort::Value> outputs;
+    try {
+      outputs = RunMerged(batch, total_rows);
+    } catch (const Ort::Exception&) {
+      // Let each request report its own error.
+      RunOneByOne(batch);
+      return;
+    }
+
+    // Outputs must carry the batch dimension to be split back. If the model folds it away,
+    // stop merging requests for it altogether.
+    for (const auto& output : outputs) {
+      if (BatchRows(output) != total_rows) {
+        merge_outputs_ = false;
+        RunOneByOne(batch);
+        return;
+      }
+    }
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    std::vector<size_t> offsets(outputs.size(), 0);
+    for (size_t i = 0; i < batch.size(); ++i) {
+      for (size_t j = 0; j < outputs.size(); ++j) {
+        auto info = outputs[j].GetTensorTypeAndShapeInfo();
+        auto shape = info.GetShape();
+        const size_t row_bytes = info.GetElementCount() / total_rows * ElementSize(info.GetElementType());
+        shape[0] = static_cast<int64_t>(batch[i]->rows);
+
+        auto slice = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), info.GetElementType());
+        const size_t bytes = row_bytes * batch[i]->rows;
+        memcpy(TensorBytes(slice), TensorBytes(outputs[j]) + offsets[j], bytes);
+        offsets[j] += bytes;
+        results[i].push_back(std::move(slice));
+      }
+    }
+  } catch (...) {
+    for (const auto& request : batch) {
+      request->result.set_exception(std::current_exception());
+    }
+    return;
+  }
+
+  for (size_t i = 0; i < batch.size(); ++i) {
+    batch[i]->result.set_value(std::move(results[i]));
+  }
+}
+
+std::vector<Ort::Value> RequestBatcher::RunMerged(const Batch& batch, size_t total_rows) {
+  const PendingRequest& head = *batch.front();
+  Ort::AllocatorWithDefaultOptions allocator;
+
+  // The requests share their log verbosity. Tag the run with all of their tags so its log lines
+  // can be traced back to each request.
+  std::string run_tag;
+  for (const auto& request : batch) {
+    if (!run_tag.empty()) {
+      run_tag += ',';
+    }
+    run_tag += request->run_options.GetRunTag();
+  }
+  Ort::RunOptions run_options;
+  run_options.SetRunLogVerbosityLevel(head.log_verbosity_level);
+  run_options.SetRunTag(run_tag.c_str());
+
+  std::vector<Ort::Value> merged_inputs;
+  merged_inputs.reserve(head.input_values.size());
+  for (size_t i = 0; i < head.input_values.size(); ++i) {
+    auto shape = head.shapes[i];
+    shape[0] = static_cast<int64_t>(total_rows);
+    auto merged = Ort::Value::CreateTensor(allocator, shape.data(), shape.size(), head.types[i]);
+
+    uint8_t* dst = TensorBytes(merged);
+    for (const auto& request : batch) {
+      auto& input = request->input_values[i];
+      const size_t bytes = input.GetTensorTypeAndShapeInfo().GetElementCount() * ElementSize(head.types[i]);
+      memcpy(dst, TensorBytes(input), bytes);
+      dst += bytes;
+    }
+    merged_inputs.push_back(std::move(merged));
+  }
+
+  return runner_(run_options, head.input_names, merged_inputs, head.output_names);
+}
+
+void RequestBatcher::RunOneByOne(const Batch& batch) {
+  for (const auto& request : batch) {
+    try {
+      request->result.set_value(
+          runner_(request->run_options, request->input_names, request->input_values, request->output_names));
+    } catch (...) {
+      request->result.set_exception(std::current_exception());
+    }
+  }
+}
+
+}  // namespace server
+}  // namespace onnxruntime
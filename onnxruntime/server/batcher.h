@@ -0,0 +1,127 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/session/onnxruntime_cxx_api.h"
+
+namespace onnxruntime {
+namespace server {
+
+struct BatchingOptions {
+  // Maximum number of rows (sum of the first dimension of the inputs) run in a single batch.
+  // Batching is disabled when this is 0 or 1.
+  size_t max_batch_size = 0;
+
+  // Maximum time the oldest queued request waits for other requests to join its batch.
+  std::chrono::microseconds max_queue_delay{1000};
+
+  // Maximum number of batches run at the same time. Requests keep joining the queued batches
+  // while all of them are busy.
+  size_t max_concurrent_batches = 4;
+
+  bool Enabled() const { return max_batch_size > 1; }
+};
+
+struct BatchingMetrics {
+  size_t queue_depth = 0;       // requests waiting to be dispatched
+  uint64_t num_batches = 0;     // Run calls issued by the batcher
+  uint64_t num_requests = 0;    // requests served by those runs
+  uint64_t num_rows = 0;        // rows served by those runs
+  uint64_t max_batch_rows = 0;  // largest batch seen so far
+
+  double AverageBatchSize() const {
+    return num_batches == 0 ? 0.0 : static_cast<double>(num_requests) / static_cast<double>(num_batches);
+  }
+};
+
+/**
+ * Merges concurrent requests for the same model along the free batch dimension (dimension 0)
+ * of their inputs, runs the merged request once and scatters the outputs back to the callers.
+ *
+ * Requests are only merged when they have the same input names, output names, element types,
+ * shape past dimension 0 and run log verbosity. A merged run is tagged with the run tags of all
+ * of its requests, joined by commas. A request waits at most max_queue_delay for others to join.
+ * If a merged run fails, or the outputs can't be split along dimension 0, the requests are run one
+ * by one with their own run options so that each caller gets its own result or error.
+ *
+ * A dispatcher thread collects the batches and hands them to max_concurrent_batches workers.
+ */
+class RequestBatcher {
+ public:
+  using Runner = std::function<std::vector<Ort::Value>(const Ort::RunOptions& run_options,
+                                                       const std::vector<std::string>& input_names,
+                                                       std::vector<Ort::Value>& input_values,
+                                                       const std::vector<std::string>& output_names)>;
+
+  // Called from the dispatcher at most once per metrics_interval, after a batch was taken.
+  using MetricsReporter = std::function<void(const BatchingMetrics& metrics)>;
+
+  RequestBatcher(Runner runner, const BatchingOptions& options);
+  RequestBatcher(Runner runner, const BatchingOptions& options, MetricsReporter reporter,
+                 std::chrono::milliseconds metrics_interval);
+  ~RequestBatcher();
+  RequestBatcher(const RequestBatcher&) = delete;
+  RequestBatcher& operator=(const RequestBatcher&) = delete;
+
+  // Queues the request and blocks until the batch holding it has run.
+  // Rethrows the exception of a failed run, usually an Ort::Exception.
+  std::vector<Ort::Value> Run(const Ort::RunOptions& run_options,
+                              const std::vector<std::string>& input_names,
+                              std::vector<Ort::Value>& input_values,
+                              const std::vector<std::string>& output_names);
+
+  // Returns true if the inputs are dense tensors with a batch dimension that can be concatenated.
+  static bool CanBatch(const std::vector<Ort::Value>& input_values);
+
+  BatchingMetrics GetMetrics() const;
+
+ private:
+  struct PendingRequest;
+  using Batch = std::vector<std::shared_ptr<PendingRequest>>;
+
+  void DispatchLoop();
+  void WorkerLoop();
+  size_t CompatibleRows(const PendingRequest& head) const;
+  Batch TakeBatch();
+  void RunBatch(const Batch& batch);
+  void RunOneByOne(const Batch& batch);
+  std::vector<Ort::Value> RunMerged(const Batch& batch, size_t total_rows);
+
+  const Runner runner_;
+  const BatchingOptions options_;
+  const MetricsReporter reporter_;
+  const std::chrono::milliseconds metrics_interval_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;  // requests queued, a worker became free, or shutdown
+  std::deque<std::shared_ptr<PendingRequest>> queue_;
+  bool shutdown_ = false;
+  BatchingMetrics metrics_;
+  std::chrono::steady_clock::time_point last_report_;
+
+  std::condition_variable batches_cv_;  // batches ready, or the workers should stop
+  std::deque<Batch> batches_;
+  size_t busy_workers_ = 0;  // workers running a batch, plus batches waiting for a worker
+  bool stop_workers_ = false;
+
+  std::atomic<bool> merge_outputs_{true};
+
+  std::thread dispatcher_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace server
+}  // namespace onnxruntime
@@ -3,11 +3,15 @@
 
 #include <memory>
 #include "environment.h"
+#include "core/common/make_unique.h"
 #include "core/session/onnxruntime_cxx_api.h"
 
 namespace onnxruntime {
 namespace server {
 
+// How often the batching metrics of a busy model are logged.
+static constexpr std::chrono::milliseconds kBatchingMetricsInterval{10000};
+
 static spdlog::level::level_enum Convert(OrtLoggingLevel in) {
   switch (in) {
     case OrtLoggingLevel::ORT_LOGGING_LEVEL_VERBOSE:
@@ -42,6 +46,29 @@ ServerEnvironment::ServerEnvironment(OrtLoggingLevel severity, spdlog::sinks_ini
   spdlog::initialize_logger(default_logger_);
 }
 
+// A model can be batched when dimension 0 of all its inputs and outputs is a free (symbolic) dimension.
+static bool HasFreeBatchDimension(const Ort::TypeInfo& type_info) {
+  if (type_info.GetONNXType() != ONNX_TYPE_TENSOR) {
+    return false;
+  }
+  auto shape = type_info.GetTensorTypeAndShapeInfo().GetShape();
+  return !shape.empty() && shape[0] < 0;
+}
+
+static bool SupportsBatching(const Ort::Session& session) {
+  for (size_t i = 0, count = session.GetInputCount(); i < count; i++) {
+    if (!HasFreeBatchDimension(session.GetInputTypeInfo(i))) {
+      return false;
+    }
+  }
+  for (size_t i = 0, count = session.GetOutputCount(); i < count; i++) {
+    if (!HasFreeBatchDimension(session.GetOutputTypeInfo(i))) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void ServerEnvironment::InitializeModel(const std::string& model_path, const std::string& model_name, const std::string& model_version) {
   auto result = sessions_.emplace(std::piecewise_construct, std::forward_as_tuple(model_name, model_version), std::forward_as_tuple(runtime_environment_, model_path.c_str(), Ort::SessionOptions()));
 
@@ -58,6 +85,57 @@ void ServerEnvironment::InitializeModel(const std::string& model_path, const std
     (iterator->second).output_names.push_back(name);
     allocator.Free(name);
   }
+
+  if (batching_options_.Enabled()) {
+    if (SupportsBatching(iterator->second.session)) {
+      auto* session = &iterator->second.session;
+      auto runner = [session](const Ort::RunOptions& run_options,
+                              const std::vector<std::string>& input_names,
+                              std::vector<Ort::Value>& input_values,
+                              const std::vector<std::string>& output_names) {
+        std::vector<const char*> input_ptrs;
+        for (const auto& name : input_names) {
+          input_ptrs.push_back(name.c_str());
+        }
+        std::vector<const char*> output_ptrs;
+        for (const auto& name : output_names) {
+          output_ptrs.push_back(name.c_str());
+        }
+        return session->Run(run_options, input_ptrs.data(), input_values.data(), input_values.size(),
+                            output_ptrs.data(), output_ptrs.size());
+      };
+      auto logger = default_logger_;
+      auto reporter = [logger, model_name, model_version](const BatchingMetrics& metrics) {
+        logger->info("Batching model {} version {}. Queue depth: {}, batches: {}, requests: {}, "
+                     "average batch size: {:.2f}, max batch rows: {}",
+                     model_name, model_version, metrics.queue_depth, metrics.num_batches, metrics.num_requests,
+                     metrics.AverageBatchSize(), metrics.max_batch_rows);
+      };
+      iterator->second.batcher = onnxruntime::make_unique<RequestBatcher>(runner, batching_options_, reporter,
+                                                                          kBatchingMetricsInterval);
+      default_logger_->info("Batching requests for model {} version {}: max batch size {}, max queue delay {}us, "
+                            "max concurrent batches {}",
+                            model_name, model_version, batching_options_.max_batch_size,
+                            batching_options_.max_queue_delay.count(), batching_options_.max_concurrent_batches);
+    } else {
+      default_logger_->warn("Model {} version {} has no free batch dimension. Requests will not be batched.",
+                            model_name, model_version);
+    }
+  }
+}
+
+void ServerEnvironment::SetBatchingOptions(const BatchingOptions& options) {
+  batching_options_ = options;
+}
+
+RequestBatcher* ServerEnvironment::GetBatcher(const std::string& model_name, const std::string& model_version) const {
+  auto identifier = std::make_pair(model_name, model_version);
+  auto it = sessions_.find(identifier);
+  if (it == sessions_.end()) {
+    throw Ort::Exception("No model loaded of that name.", ORT_NO_MODEL);
+  }
+
+  return it->second.batcher.get();
 }
 
 const std::vector<std::string>& ServerEnvironment::GetModelOutputNames(const std::string& model_name, const std::string& model_version) const {
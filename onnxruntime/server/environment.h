@@ -11,6 +11,8 @@
 #include <unordered_map>
 #include <boost/functional/hash.hpp>
 
+#include "batcher.h"
+
 namespace onnxruntime {
 namespace server {
 
@@ -29,6 +31,11 @@ class ServerEnvironment {
   std::shared_ptr<spdlog::logger> GetAppLogger() const;
   void UnloadModel(const std::string& model_name, const std::string& model_version);
 
+  // Batching options applied to the models initialized after this call.
+  void SetBatchingOptions(const BatchingOptions& options);
+  // Returns the request batcher of the model, or nullptr if its requests are run one at a time.
+  RequestBatcher* GetBatcher(const std::string& model_name, const std::string& model_version) const;
+
  private:
   const OrtLoggingLevel severity_;
   const std::string logger_id_;
@@ -37,10 +44,13 @@ class ServerEnvironment {
 
   Ort::Env runtime_environment_;
   Ort::SessionOptions options_;
+  BatchingOptions batching_options_;
 
   struct SessionHolder {
     Ort::Session session;
     std::vector<std::string> output_names;
+    // Declared after the session so it is destroyed, and its queue drained, first.
+    std::unique_ptr<RequestBatcher> batcher;
     explicit SessionHolder(Ort::Env& env, std::string path, const Ort::SessionOptions& options) : session(nullptr) {
       session = Ort::Session(env, path.c_str(), options);
     };
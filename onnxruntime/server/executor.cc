@@ -14,6 +14,7 @@
 #include "onnx-ml.pb.h"
 #include "predict.pb.h"
 
+#include "batcher.h"
 #include "converter.h"
 #include "executor.h"
 #include "util.h"
@@ -31,6 +32,17 @@ protobufutil::Status Executor::SetMLValue(const onnx::TensorProto& input_tensor,
                                           /* out */ Ort::Value& ml_value) {
   auto logger = env_->GetLogger(request_id_);
 
+  // raw_data tensors of any size are used in place when TryWrapRawData can alias them; the others are
+  // copied below. The request outlives the run, so the aliased bytes stay valid.
+  try {
+    if (onnxruntime::server::TryWrapRawData(input_tensor, *cpu_memory_info, ml_value)) {
+      return protobufutil::Status::OK;
+    }
+  } catch (const Ort::Exception& e) {
+    logger->error("TryWrapRawData() failed. Error Message: {}", e.what());
+    return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  }
+
   size_t cpu_tensor_length = 0;
   try {
     onnxruntime::server::GetSizeInBytesFromTensorProto<0>(input_tensor, &cpu_tensor_length);
@@ -138,28 +150,36 @@ protobufutil::Status Executor::Predict(const std::string& model_name,
 
   std::vector<Ort::Value> outputs;
   try {
-    outputs = Run(env_->GetSession(model_name, model_version), run_options, input_names, input_values, output_names);
+    auto* batcher = env_->GetBatcher(model_name, model_version);
+    if (batcher != nullptr && RequestBatcher::CanBatch(input_values)) {
+      outputs = batcher->Run(run_options, input_names, input_values, output_names);
+    } else {
+      outputs = Run(env_->GetSession(model_name, model_version), run_options, input_names, input_values, output_names);
+    }
   } catch (const Ort::Exception& e) {
     return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
+  } catch (const std::exception& e) {
+    logger->error("Run failed. Error Message: {}", e.what());
+    return GenerateProtobufStatus(ORT_FAIL, e.what());
   }
 
-  // Build the response
+  // Build the response. Outputs are serialized straight into the response map entries.
+  auto& response_outputs = *response.mutable_outputs();
   for (size_t i = 0, sz = outputs.size(); i < sz; ++i) {
-    onnx::TensorProto output_tensor{};
+    auto insertion_result = response_outputs.insert({output_names[i], onnx::TensorProto{}});
+
+    if (!insertion_result.second) {
+      logger->error("SetNameMLValueMap() failed. Output name: {}. Trying to overwrite existing output value", output_names[i]);
+      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "SetNameMLValueMap() failed: Cannot have two outputs with the same name");
+    }
+
     try {
-      MLValueToTensorProto(outputs[i], using_raw_data_, logger, output_tensor);
+      MLValueToTensorProto(outputs[i], using_raw_data_, logger, insertion_result.first->second);
     } catch (const Ort::Exception& e) {
       logger = env_->GetLogger(request_id_);
       logger->error("MLValueToTensorProto() failed. Output name: {}. Error Message: {}", output_names[i], e.what());
       return GenerateProtobufStatus(e.GetOrtErrorCode(), e.what());
     }
-
-    auto insertion_result = response.mutable_outputs()->insert({output_names[i], output_tensor});
-
-    if (!insertion_result.second) {
-      logger->error("SetNameMLValueMap() failed. Output name: {}. Trying to overwrite existing output value", output_names[i]);
-      return protobufutil::Status(protobufutil::error::Code::INVALID_ARGUMENT, "SetNameMLValueMap() failed: Cannot have two outputs with the same name");
-    }
   }
 
   return protobufutil::Status::OK;
@@ -62,6 +62,12 @@ int main(int argc, char* argv[]) {
   auto logger = env->GetAppLogger();
   logger->info("Model path: {}", config.model_path);
 
+  server::BatchingOptions batching_options;
+  batching_options.max_batch_size = static_cast<size_t>(config.max_batch_size);
+  batching_options.max_queue_delay = std::chrono::microseconds(config.max_batch_delay_us);
+  batching_options.max_concurrent_batches = static_cast<size_t>(config.max_concurrent_batches);
+  env->SetBatchingOptions(batching_options);
+
   try {
     env->InitializeModel(config.model_path, "default", "1");
     logger->debug("Initialize Model Successfully!");
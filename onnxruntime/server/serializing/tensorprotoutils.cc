@@ -5,6 +5,7 @@
 
 #include <memory>
 #include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <gsl/gsl>
 #include "core/framework/data_types.h"
@@ -424,6 +425,42 @@ void TensorProtoToMLValue(const onnx::TensorProto& tensor_proto, const MemBuffer
   value = Ort::Value::CreateTensor(&allocator, tensor_data, m.GetLen(), tensor_shape_vec.data(), tensor_shape_vec.size(), (ONNXTensorElementDataType)tensor_proto.data_type());
   return;
 }
+
+bool TryWrapRawData(const onnx::TensorProto& tensor_proto, const OrtMemoryInfo& memory_info, Ort::Value& value) {
+  // raw_data is little endian, so it can only be used in place on little endian machines.
+  if (!IsLittleEndianOrder() || !tensor_proto.has_raw_data() ||
+      tensor_proto.data_location() == onnx::TensorProto_DataLocation::TensorProto_DataLocation_EXTERNAL) {
+    return false;
+  }
+
+  ONNXTensorElementDataType ele_type = server::GetTensorElementType(tensor_proto);
+  if (ele_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_STRING || ele_type == ONNX_TENSOR_ELEMENT_DATA_TYPE_UNDEFINED) {
+    return false;
+  }
+
+  size_t expected_size_in_bytes;
+  GetSizeInBytesFromTensorProto<0>(tensor_proto, &expected_size_in_bytes);
+  const std::string& raw_data = tensor_proto.raw_data();
+  if (expected_size_in_bytes == 0 || raw_data.size() != expected_size_in_bytes) {
+    return false;
+  }
+
+  size_t element_count = 1;
+  for (auto dim : tensor_proto.dims()) {
+    element_count *= static_cast<size_t>(dim);
+  }
+  // Element sizes are powers of two, so this is the alignment the kernels expect.
+  const size_t element_size = expected_size_in_bytes / element_count;
+  if (reinterpret_cast<uintptr_t>(raw_data.data()) % element_size != 0) {
+    return false;
+  }
+
+  std::vector<int64_t> tensor_shape_vec = GetTensorShapeFromTensorProto(tensor_proto);
+  value = Ort::Value::CreateTensor(&memory_info, const_cast<char*>(raw_data.data()), raw_data.size(),
+                                   tensor_shape_vec.data(), tensor_shape_vec.size(), ele_type);
+  return true;
+}
+
 template void GetSizeInBytesFromTensorProto<256>(const onnx::TensorProto& tensor_proto,
                                                  size_t* out);
 template void GetSizeInBytesFromTensorProto<0>(const onnx::TensorProto& tensor_proto, size_t* out);
@@ -27,6 +27,14 @@ void GetSizeInBytesFromTensorProto(const onnx::TensorProto& tensor_proto, size_t
  */
 void TensorProtoToMLValue(const onnx::TensorProto& input, const server::MemBuffer& m, /* out */ Ort::Value& value);
 
+/**
+ * Create a tensor that aliases the raw_data bytes of a TensorProto instead of copying them.
+ * Returns false, leaving value untouched, when the tensor can't be used in place: it has no raw_data,
+ * holds strings, has a raw_data size that doesn't match its dims, or its bytes are not aligned for the
+ * element type. The caller must keep the TensorProto alive while the value is in use.
+ */
+bool TryWrapRawData(const onnx::TensorProto& input, const OrtMemoryInfo& memory_info, /* out */ Ort::Value& value);
+
 template <typename T>
 void UnpackTensor(const onnx::TensorProto& tensor, const void* raw_data, size_t raw_data_len,
                   /*out*/ T* p_data, int64_t expected_size);
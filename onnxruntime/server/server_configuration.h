@@ -43,6 +43,9 @@ class ServerConfiguration {
   unsigned short http_port = 8001;
   unsigned short grpc_port = 50051;
   int num_http_threads = std::thread::hardware_concurrency();
+  int max_batch_size = 0;
+  int max_batch_delay_us = 1000;
+  int max_concurrent_batches = 4;
   OrtLoggingLevel logging_level{};
 
   ServerConfiguration() {
@@ -53,6 +56,9 @@ class ServerConfiguration {
     desc.add_options()("http_port", po::value(&http_port)->default_value(http_port), "HTTP port to listen to requests");
     desc.add_options()("num_http_threads", po::value(&num_http_threads)->default_value(num_http_threads), "Number of http threads");
     desc.add_options()("grpc_port", po::value(&grpc_port)->default_value(grpc_port), "GRPC port to listen to requests");
+    desc.add_options()("max_batch_size", po::value(&max_batch_size)->default_value(max_batch_size), "Maximum number of rows to merge concurrent requests into along the batch dimension. 0 disables batching");
+    desc.add_options()("max_batch_delay_us", po::value(&max_batch_delay_us)->default_value(max_batch_delay_us), "Maximum time in microseconds a request waits for others to join its batch");
+    desc.add_options()("max_concurrent_batches", po::value(&max_concurrent_batches)->default_value(max_concurrent_batches), "Maximum number of merged batches of a model run at the same time");
   }
 
   // Parses argc and argv and sets the values for the class
@@ -99,6 +105,15 @@ class ServerConfiguration {
     } else if (num_http_threads <= 0) {
       PrintHelp(std::cerr, "num_http_threads must be greater than 0");
       return Result::ExitFailure;
+    } else if (max_batch_size < 0) {
+      PrintHelp(std::cerr, "max_batch_size must be greater than or equal to 0");
+      return Result::ExitFailure;
+    } else if (max_batch_delay_us < 0) {
+      PrintHelp(std::cerr, "max_batch_delay_us must be greater than or equal to 0");
+      return Result::ExitFailure;
+    } else if (max_concurrent_batches <= 0) {
+      PrintHelp(std::cerr, "max_concurrent_batches must be greater than 0");
+      return Result::ExitFailure;
     } else if (!file_exists(model_path)) {
       PrintHelp(std::cerr, "model_path must be the location of a valid file");
       return Result::ExitFailure;
@@ -0,0 +1,205 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/threadpool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace onnxruntime::concurrency;
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+// Verifies that every index in [0, total) is visited exactly once.
+void ExpectAllVisitedOnce(const std::vector<std::atomic<int>>& visits) {
+  for (size_t i = 0; i < visits.size(); ++i) {
+    ASSERT_EQ(visits[i].load(), 1) << "index " << i;
+  }
+}
+}  // namespace
+
+TEST(ThreadPoolTest, ParallelForPerIteration) {
+  ThreadPool tp("test", 4);
+  for (int32_t total : {0, 1, 2, 3, 7, 64, 1000}) {
+    std::vector<std::atomic<int>> visits(total);
+    tp.ParallelFor(total, [&visits](int32_t i) { visits[i]++; });
+    ExpectAllVisitedOnce(visits);
+  }
+}
+
+TEST(ThreadPoolTest, ParallelForRangeIsHalfOpen) {
+  ThreadPool tp("test", 4);
+  const int64_t first = 10;
+  const int64_t last = 523;
+  std::vector<std::atomic<int>> visits(last - first);
+  tp.ParallelForRange(first, last, [&](int64_t begin, int64_t end) {
+    ASSERT_LE(first, begin);
+    ASSERT_LE(end, last);
+    for (int64_t i = begin; i < end; ++i) visits[i - first]++;
+  });
+  ExpectAllVisitedOnce(visits);
+}
+
+TEST(ThreadPoolTest, ParallelForWithCostCoversRange) {
+  ThreadPool tp("test", 4);
+  for (std::ptrdiff_t total : {1, 2, 5, 100, 4097, 100000}) {
+    for (double cost : {0.0, 1.0, 100.0, 1e6}) {
+      std::vector<std::atomic<int>> visits(total);
+      tp.ParallelFor(total, cost, [&visits](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t i = first; i < last; ++i) visits[i]++;
+      });
+      ExpectAllVisitedOnce(visits);
+    }
+  }
+}
+
+TEST(ThreadPoolTest, ParallelForWithCostRunsCheapWorkInline) {
+  ThreadPool tp("test", 4);
+  std::atomic<int> calls{0};
+  tp.ParallelFor(100, 1.0, [&calls](std::ptrdiff_t first, std::ptrdiff_t last) {
+    EXPECT_EQ(first, 0);
+    EXPECT_EQ(last, 100);
+    calls++;
+  });
+  EXPECT_EQ(calls.load(), 1);
+}
+
+TEST(ThreadPoolTest, ComputeNumBlocks) {
+  // no work
+  EXPECT_EQ(ThreadPool::ComputeNumBlocks(0, 1e6, 8), 0);
+  // single thread or tiny cost means one block
+  EXPECT_EQ(ThreadPool::ComputeNumBlocks(1000, 1e6, 1), 1);
+  EXPECT_EQ(ThreadPool::ComputeNumBlocks(1000, 1.0, 8), 1);
+  // expensive work is split into a bounded number of blocks per thread
+  const std::ptrdiff_t blocks = ThreadPool::ComputeNumBlocks(1000000, 1e6, 8);
+  EXPECT_GT(blocks, 8);
+  EXPECT_LE(blocks, 64);
+  // never more blocks than iterations
+  EXPECT_EQ(ThreadPool::ComputeNumBlocks(3, 1e9, 8), 3);
+}
+
+TEST(ThreadPoolTest, TryParallelForWithoutPool) {
+  std::vector<std::atomic<int>> visits(257);
+  ThreadPool::TryParallelFor(nullptr, 257, 1e6, [&visits](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t i = first; i < last; ++i) visits[i]++;
+  });
+  ExpectAllVisitedOnce(visits);
+}
+
+TEST(ThreadPoolTest, ConcurrentParallelForCallers) {
+  ThreadPool tp("test", 4);
+  const std::ptrdiff_t total = 10000;
+  std::vector<std::atomic<int>> visits(total);
+  std::atomic<int> outer_done{0};
+  // nested loops issued from pool threads must not deadlock
+  tp.ParallelFor(8, [&](int32_t) {
+    tp.ParallelFor(total, 1e5, [&visits](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t i = first; i < last; ++i) visits[i]++;
+    });
+    outer_done++;
+  });
+  EXPECT_EQ(outer_done.load(), 8);
+  for (auto& v : visits) ASSERT_EQ(v.load(), 8);
+}
+
+TEST(ThreadPoolTest, SharedPoolViewLimitsParallelism) {
+  ThreadPool shared("shared", 4);
+  ThreadPool view(shared, 2);
+  EXPECT_EQ(view.NumThreads(), 2);
+
+  // a limit larger than the shared pool is clamped, and <= 0 means the whole pool
+  EXPECT_EQ(ThreadPool(shared, 16).NumThreads(), 4);
+  EXPECT_EQ(ThreadPool(shared, 0).NumThreads(), 4);
+
+  const std::ptrdiff_t total = 4096;
+  std::vector<std::atomic<int>> visits(total);
+  std::atomic<int> running{0};
+  std::atomic<int> max_running{0};
+  view.ParallelFor(total, 1e6, [&](std::ptrdiff_t first, std::ptrdiff_t last) {
+    int now = ++running;
+    int prev = max_running.load();
+    while (now > prev && !max_running.compare_exchange_weak(prev, now)) {
+    }
+    for (std::ptrdiff_t i = first; i < last; ++i) visits[i]++;
+    --running;
+  });
+  ExpectAllVisitedOnce(visits);
+  // two helpers plus the calling thread
+  EXPECT_LE(max_running.load(), 3);
+}
+
+namespace {
+// Schedules num_tasks tasks through schedule and returns the most that ran at the same time.
+int MaxConcurrentTasks(int num_tasks, const std::function<void(std::function<void()>)>& schedule) {
+  std::mutex mutex;
+  std::condition_variable all_done;
+  int done = 0;
+  std::atomic<int> running{0};
+  std::atomic<int> max_running{0};
+  for (int i = 0; i < num_tasks; ++i) {
+    schedule([&]() {
+      int now = ++running;
+      int prev = max_running.load();
+      while (now > prev && !max_running.compare_exchange_weak(prev, now)) {
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      --running;
+      std::lock_guard<std::mutex> lock(mutex);
+      if (++done == num_tasks)
+        all_done.notify_one();
+    });
+  }
+  std::unique_lock<std::mutex> lock(mutex);
+  all_done.wait(lock, [&]() { return done == num_tasks; });
+  return max_running.load();
+}
+}  // namespace
+
+TEST(ThreadPoolTest, SharedPoolViewLimitsScheduledTasks) {
+  ThreadPool shared("shared", 4);
+  ThreadPool view(shared, 2);
+
+  // tasks beyond the limit wait in the view instead of taking more of the shared workers
+  EXPECT_LE(MaxConcurrentTasks(16, [&view](std::function<void()> fn) { view.Schedule(std::move(fn)); }), 2);
+
+  // Eigen devices built on the view's handler are limited the same way
+  Eigen::ThreadPoolInterface& handler = view.GetHandler();
+  EXPECT_LE(MaxConcurrentTasks(16, [&handler](std::function<void()> fn) { handler.Schedule(std::move(fn)); }), 2);
+
+  // the shared pool itself is not limited by its views
+  EXPECT_LE(MaxConcurrentTasks(16, [&shared](std::function<void()> fn) { shared.Schedule(std::move(fn)); }), 4);
+}
+
+TEST(ThreadPoolTest, SharedPoolViewsFromConcurrentCallers) {
+  ThreadPool shared("shared", 4);
+  std::vector<std::unique_ptr<ThreadPool>> views;
+  for (int i = 0; i < 3; ++i) {
+    views.push_back(std::unique_ptr<ThreadPool>(new ThreadPool(shared, 1)));
+  }
+
+  const std::ptrdiff_t total = 1000;
+  std::vector<std::vector<std::atomic<int>>> visits(views.size());
+  for (auto& v : visits) v = std::vector<std::atomic<int>>(total);
+
+  // each "session" issues a loop through its own view from a shared pool thread
+  shared.ParallelFor(static_cast<int32_t>(views.size()), [&](int32_t s) {
+    views[s]->ParallelFor(total, 1e5, [&visits, s](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t i = first; i < last; ++i) visits[s][i]++;
+    });
+  });
+
+  for (auto& v : visits) ExpectAllVisitedOnce(v);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
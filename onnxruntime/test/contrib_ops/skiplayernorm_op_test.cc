@@ -18,10 +18,19 @@ static void RunTest(
     int batch_size,
     int sequence_length,
     int hidden_size,
-    bool use_float16 = false) {
+    bool use_float16 = false,
+    float epsilon = 1e-12f) {
   int min_cuda_architecture = use_float16 ? 530 : 0;
-  if (HasCudaEnvironment(min_cuda_architecture)) {
+  bool enable_cuda = HasCudaEnvironment(min_cuda_architecture);
+  bool enable_cpu = !use_float16;
+
+  for (bool use_cuda : {false, true}) {
+    if (use_cuda ? !enable_cuda : !enable_cpu) {
+      continue;
+    }
+
     OpTester test("SkipLayerNormalization", 1, onnxruntime::kMSDomain);
+    test.AddAttribute<float>("epsilon", epsilon);
 
     // Input and output shapes
     //   Input 0 - input: (batch_size, sequence_length, hidden_size)
@@ -50,7 +59,7 @@ static void RunTest(
     }
 
     std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
-    execution_providers.push_back(DefaultCudaExecutionProvider());
+    execution_providers.push_back(use_cuda ? DefaultCudaExecutionProvider() : DefaultCpuExecutionProvider());
     test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
   }
 }
@@ -82,6 +91,34 @@ TEST(SkipLayerNormTest, SkipLayerNormBatch1) {
           batch_size, sequence_length, hidden_size);
 }
 
+TEST(SkipLayerNormTest, SkipLayerNormEpsilon) {
+  int batch_size = 1;
+  int sequence_length = 2;
+  int hidden_size = 4;
+
+  std::vector<float> input_data = {
+      0.8f, -0.5f, 0.0f, 1.f,
+      0.5f, 0.2f, 0.3f, -0.6f};
+
+  std::vector<float> skip_data = {
+      0.1f, -0.2f, 0.3f, 1.0f,
+      0.5f, 0.1f, 0.4f, 1.6f};
+
+  std::vector<float> gamma_data = {
+      0.3f, 0.2f, 4.0f, 2.2f};
+
+  std::vector<float> beta_data = {
+      0.2f, 0.1f, 0.4f, 1.6f};
+
+  // epsilon is added to the variance of each row
+  std::vector<float> output_data = {
+      0.28024946f, -0.157771f, -0.864537f, 4.5424803f,
+      0.37556172f, -0.11067406f, -0.068164589f, 2.8874526f};
+
+  RunTest(input_data, skip_data, gamma_data, beta_data, output_data,
+          batch_size, sequence_length, hidden_size, false, 0.1f);
+}
+
 TEST(SkipLayerNormTest, SkipLayerNormBatch1_Float16) {
   int batch_size = 1;
   int sequence_length = 2;
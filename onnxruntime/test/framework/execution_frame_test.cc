@@ -1,9 +1,13 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include <cctype>
+
 #include "core/framework/execution_frame.h"
+#include "core/framework/execution_frame_pool.h"
 #include "core/framework/op_kernel.h"
 #include "core/framework/session_state.h"
+#include "core/framework/symbolic_mem_planner.h"
 #include "core/graph/model.h"
 #include "core/providers/cpu/cpu_execution_provider.h"
 #include "core/session/inference_session.h"
@@ -110,6 +114,79 @@ TEST_F(ExecutionFrameTest, TensorAllocationTest) {
   EXPECT_EQ(tensor2->template Data<float>(), p_tensor->template Data<float>());
 }
 
+TEST_F(ExecutionFrameTest, RunArenaTest) {
+  onnxruntime::Model model("test");
+  onnxruntime::Graph& graph = model.MainGraph();
+  TypeProto tensor_float;
+  tensor_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def("X", &tensor_float), intermediate_def("T", &tensor_float),
+      output_def("Y", &tensor_float);
+
+  graph.AddNode("node1", "Relu", "Relu operator", ArgMap{&input_def}, ArgMap{&intermediate_def})
+      .SetExecutionProviderType(kCpuExecutionProvider);
+  graph.AddNode("node2", "Relu", "Relu operator", ArgMap{&intermediate_def}, ArgMap{&output_def})
+      .SetExecutionProviderType(kCpuExecutionProvider);
+  Status status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_typ = cpu_xp->Type();
+  AllocatorPtr cpu_allocator = cpu_xp->GetAllocator(0, OrtMemTypeDefault);
+  ExecutionProviders execution_providers;
+  execution_providers.Add(xp_typ, std::move(cpu_xp));
+  KernelRegistryManager kernel_registry_manager;
+  ASSERT_TRUE(kernel_registry_manager.RegisterKernels(execution_providers).IsOK());
+
+  // no memory pattern, so the intermediate value is allocated on its own
+  SessionState state{execution_providers, false, &tp_, nullptr};
+  status = state.SetGraphAndCreateKernels(graph, kernel_registry_manager);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan;
+  SequentialPlannerContext context(ExecutionMode::ORT_SEQUENTIAL);
+  status = SequentialPlanner::CreatePlan(nullptr, GraphViewer(graph), {}, execution_providers, kernel_registry_manager,
+                                         state.GetOrtValueNameIdxMap(), context, p_seq_exec_plan);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  state.SetExecutionPlan(std::move(p_seq_exec_plan));
+  state.EnableRunArena(cpu_allocator);
+
+  const OrtValueNameIdxMap& mlvalue_name_idx_map = state.GetOrtValueNameIdxMap();
+  int t_idx, y_idx;
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("T", t_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("Y", y_idx).IsOK());
+
+  TensorShape shape(std::vector<int64_t>{2, 3});
+  void* t_data = nullptr;
+  void* y_data = nullptr;
+  {
+    vector<OrtValue> outputs;
+    ExecutionFrame frame({}, {}, {y_idx}, outputs, {}, state);
+    OrtValue t_value;
+    OrtValue y_value;
+    status = frame.AllocateMLValueTensorSelfOwnBuffer(t_value, t_idx, DataTypeImpl::GetType<float>(),
+                                                      cpu_allocator->Info(), shape);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    status = frame.AllocateMLValueTensorSelfOwnBuffer(y_value, y_idx, DataTypeImpl::GetType<float>(),
+                                                      cpu_allocator->Info(), shape);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    t_data = t_value.GetMutable<Tensor>()->MutableDataRaw();
+    y_data = y_value.GetMutable<Tensor>()->MutableDataRaw();
+    EXPECT_EQ(t_value.Get<Tensor>().Location(), cpu_allocator->Info());
+  }
+
+  // the frame reset its arena and returned it to the pool, so the next run starts on the intermediate's memory
+  auto arena = state.GetRunArenaPool()->Acquire();
+  EXPECT_EQ(arena->Alloc(shape.Size() * sizeof(float)), t_data);
+
+  // the output outlives the run, so it came from the CPU allocator instead
+  auto block_begin = reinterpret_cast<uintptr_t>(t_data);
+  auto y_begin = reinterpret_cast<uintptr_t>(y_data);
+  EXPECT_TRUE(y_begin < block_begin || y_begin >= block_begin + arena->Capacity());
+
+  state.GetRunArenaPool()->Release(std::move(arena));
+}
+
 TEST_F(ExecutionFrameTest, FeedInDataTest) {
   onnxruntime::Model model("test", false, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(),
                            std::unordered_map<std::string, int>{{"", 10}});
@@ -265,6 +342,139 @@ TEST_F(ExecutionFrameTest, MemPatternTest) {
   EXPECT_EQ(p->GetBlock(4)->offset_, 64);
 }
 
+TEST_F(ExecutionFrameTest, SymbolicMemPatternTest) {
+  auto cpu_xp = CreateCPUExecutionProvider();
+  auto xp_type = cpu_xp->Type();
+  std::unordered_map<std::string, int> domain_to_version;
+  domain_to_version[onnxruntime::kOnnxDomain] = 7;
+  onnxruntime::Model model("test", true, ModelMetaData(), IOnnxRuntimeOpSchemaRegistryList(), domain_to_version);
+  onnxruntime::Graph& graph = model.MainGraph();
+
+  auto tensor_float = [](const std::vector<std::string>& dims) {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    auto* shape = type.mutable_tensor_type()->mutable_shape();
+    for (const auto& dim : dims) {
+      if (std::isdigit(dim[0])) {
+        shape->add_dim()->set_dim_value(std::stoi(dim));
+      } else {
+        shape->add_dim()->set_dim_param(dim);
+      }
+    }
+    return type;
+  };
+  TypeProto x1_type = tensor_float({"N", "2"}), x2_type = tensor_float({"2", "2"}), x3_type = tensor_float({"2", "3"});
+  TypeProto any_float;
+  any_float.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  onnxruntime::NodeArg input_def1("X1", &x1_type),
+      input_def2("X2", &x2_type),
+      input_def3("X3", &x3_type),
+      gemm1_out_def("T1", &any_float),
+      gemm2_out_def("T2", &any_float),
+      clip_out_def("T3", &any_float);
+
+  graph.AddNode("node1", "MatMul", "gemm1", ArgMap{&input_def1, &input_def2}, ArgMap{&gemm1_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node2", "MatMul", "gemm2", ArgMap{&gemm1_out_def, &input_def3}, ArgMap{&gemm2_out_def})
+      .SetExecutionProviderType(xp_type);
+  graph.AddNode("node3", "Clip", "clip1", ArgMap{&gemm2_out_def}, ArgMap{&clip_out_def})
+      .SetExecutionProviderType(xp_type);
+
+  auto status = graph.Resolve();
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  KernelRegistryManager kernel_registry_manager;
+  ExecutionProviders execution_providers;
+  execution_providers.Add(xp_type, std::move(cpu_xp));
+  kernel_registry_manager.RegisterKernels(execution_providers);
+  SessionState state{execution_providers, true, &tp_, nullptr};
+  status = state.SetGraphAndCreateKernels(graph, kernel_registry_manager);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+  const OrtValueNameIdxMap& mlvalue_name_idx_map(state.GetOrtValueNameIdxMap());
+  int x1_idx, x2_idx, x3_idx, t1_idx, t2_idx, t3_idx;
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("X1", x1_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("X2", x2_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("X3", x3_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("T1", t1_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("T2", t2_idx).IsOK());
+  ASSERT_TRUE(mlvalue_name_idx_map.GetIdx("T3", t3_idx).IsOK());
+
+  std::unique_ptr<SequentialExecutionPlan> p_seq_exec_plan;
+  SequentialPlannerContext context(ExecutionMode::ORT_SEQUENTIAL);
+  GraphViewer graph_viewer(graph);
+  status = SequentialPlanner::CreatePlan(nullptr, graph_viewer, {}, execution_providers, kernel_registry_manager,
+                                         mlvalue_name_idx_map, context, p_seq_exec_plan);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  state.SetExecutionPlan(std::move(p_seq_exec_plan));
+
+  auto planner = SymbolicMemoryPlanner::Create(graph_viewer, *state.GetExecutionPlan(), mlvalue_name_idx_map);
+  ASSERT_NE(planner, nullptr);
+  EXPECT_EQ(planner->NumSymbols(), 1u);
+
+  auto cpu_allocator = execution_providers.Get(xp_type)->GetAllocator(0, OrtMemTypeDefault);
+  OrtValue v1, v2, v3;
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{8, 2}, std::vector<float>(16, 1.0f), &v1);
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 2}, std::vector<float>(4, 1.0f), &v2);
+  CreateMLValue<float>(cpu_allocator, std::vector<int64_t>{2, 3}, std::vector<float>(6, 1.0f), &v3);
+
+  // T1 is {8, 2} and still alive when T2, {8, 3}, is allocated. the graph output T3 is not part of the pattern.
+  MemoryPatternGroup pattern;
+  status = planner->GeneratePatterns({x1_idx, x2_idx, x3_idx}, {v1, v2, v3}, pattern);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  auto p = pattern.GetPatterns(cpu_allocator->Info());
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(p->GetBlock(t1_idx)->offset_, 0u);
+  EXPECT_EQ(p->GetBlock(t1_idx)->size_, 64u);
+  EXPECT_EQ(p->GetBlock(t2_idx)->offset_, 64u);
+  EXPECT_EQ(p->GetBlock(t2_idx)->size_, 128u);  // 96 bytes, 64-byte aligned
+  EXPECT_EQ(p->GetBlock(t3_idx), nullptr);
+  EXPECT_EQ(p->PeakSize(), 192u);
+
+  // the feeds must bind the free dimension
+  MemoryPatternGroup unbound;
+  EXPECT_FALSE(planner->GeneratePatterns({x2_idx, x3_idx}, {v2, v3}, unbound).IsOK());
+
+  // with the planner in place, the first frame for these shapes uses a pattern instead of tracing one
+  state.SetSymbolicMemoryPlanner(std::move(planner));
+  vector<OrtValue> outputs;
+  ExecutionFrame frame({x1_idx, x2_idx, x3_idx}, {v1, v2, v3}, {t3_idx}, outputs, {}, state);
+  EXPECT_FALSE(frame.HasMemoryPatternPlanner());
+  EXPECT_EQ(state.GetMemoryPatternCacheStats().size, 1u);
+}
+
+TEST(ExecutionFramePoolTest, AcquireComparesFeedShapes) {
+  OrtMemoryInfo cpuinfo(kCpuExecutionProvider, OrtDeviceAllocator);
+  std::vector<float> fdata(6);
+  auto make_feed = [&](const TensorShape& shape) {
+    OrtValue value;
+    value.Init(new Tensor(DataTypeImpl::GetType<float>(), shape, fdata.data(), cpuinfo),
+               DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+    return value;
+  };
+  const std::vector<OrtValue> feeds_3x2{make_feed({3, 2})};
+  const std::vector<OrtValue> feeds_2x3{make_feed({2, 3})};
+  const std::vector<int> feed_idxs{0};
+  const std::vector<int> fetch_idxs{1};
+
+  ExecutionFramePool pool(4);
+  int64_t key = 0;
+  ASSERT_TRUE(ExecutionFramePool::ComputeKey(feed_idxs, feeds_3x2, fetch_idxs, key));
+  pool.Release(onnxruntime::make_unique<ExecutionFramePool::Entry>(key, feed_idxs, feeds_3x2, fetch_idxs, nullptr));
+
+  // an equal key is not enough. a colliding run with other shapes, indices or fetches gets no frame.
+  EXPECT_EQ(pool.Acquire(key, feed_idxs, feeds_2x3, fetch_idxs), nullptr);
+  EXPECT_EQ(pool.Acquire(key, {2}, feeds_3x2, fetch_idxs), nullptr);
+  EXPECT_EQ(pool.Acquire(key, feed_idxs, feeds_3x2, {2}), nullptr);
+
+  // the frame stays in the pool for the run it was built for
+  auto entry = pool.Acquire(key, feed_idxs, feeds_3x2, fetch_idxs);
+  ASSERT_NE(entry, nullptr);
+  EXPECT_EQ(pool.Acquire(key, feed_idxs, feeds_3x2, fetch_idxs), nullptr);
+  pool.Release(std::move(entry));
+  EXPECT_NE(pool.Acquire(key, feed_idxs, feeds_3x2, fetch_idxs), nullptr);
+}
+
 TEST(ExecutionFrameTestWithoutSessionState, BadModelInvalidDimParamUsage) {
   // load model with 2 Scan ops that both incorrectly use shapes of { 'None', 'None' } for their outputs.
   // as 'None' is not a special value it's treated as a variable name, leading to a runtime error when we
@@ -5,10 +5,13 @@
 
 #include <algorithm>
 #include <cfloat>
+#include <condition_variable>
 #include <functional>
 #include <iterator>
+#include <mutex>
 #include <thread>
 #include <fstream>
+#include <sstream>
 
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include "core/common/logging/logging.h"
@@ -31,6 +34,7 @@
 #endif
 #include "core/session/IOBinding.h"
 #include "dummy_provider.h"
+#include "file_util.h"
 #include "test_utils.h"
 #include "test/capturing_sink.h"
 #include "test/test_environment.h"
@@ -128,6 +132,10 @@ class InferenceSessionGetGraphWrapper : public InferenceSession {
   const Graph& GetGraph() {
     return model_->MainGraph();
   }
+
+  const SessionState& GetSessionState() {
+    return session_state_;
+  }
 };
 
 namespace test {
@@ -416,14 +424,77 @@ TEST(InferenceSessionTests, TestModelSerialization) {
   ASSERT_TRUE(session_object_emptyValidation.Load(test_model).IsOK());
   ASSERT_TRUE(session_object_emptyValidation.Initialize().IsOK());
 
-  // Assert that level 3 optimization doesn't result in serialized model.
-  so_opt.optimized_model_filepath = ToWideString("ShouldNotSerialize");
+  // Assert that level 3 optimization results in a serialized model that records how it was optimized.
+  FILE* fp;
+  std::basic_string<ORTCHAR_T> level3_model_path(ORT_TSTR("model_XXXXXX"));
+  CreateTestFile(fp, level3_model_path);
+  ASSERT_EQ(0, fclose(fp));
+  std::unique_ptr<ORTCHAR_T, decltype(&DeleteFileFromDisk)> level3_model_deleter(
+      const_cast<ORTCHAR_T*>(level3_model_path.c_str()), DeleteFileFromDisk);
+  so_opt.optimized_model_filepath = level3_model_path;
   so_opt.graph_optimization_level = TransformerLevel::Level3;
   InferenceSession session_object_Level3Test{so_opt, &DefaultLoggingManager()};
   ASSERT_TRUE(session_object_Level3Test.Load(test_model).IsOK());
   ASSERT_TRUE(session_object_Level3Test.Initialize().IsOK());
-  std::ifstream model_fs_Level3(so_opt.optimized_model_filepath, ios::in | ios::binary);
-  ASSERT_TRUE(model_fs_Level3.fail());
+  std::shared_ptr<Model> model_Level3;
+  ASSERT_TRUE(Model::Load(so_opt.optimized_model_filepath, model_Level3).IsOK());
+  const auto& metadata = model_Level3->MetaData();
+  ASSERT_EQ(metadata.at("onnxruntime.optimization_level"), "3");
+  ASSERT_EQ(metadata.at("onnxruntime.optimization_providers"), kCpuExecutionProvider);
+}
+
+TEST(InferenceSessionTests, LoadPreoptimizedModel) {
+  // save an optimized model, then load it with the same options. the saved model must not be optimized again.
+  const string test_model = "testdata/transform/abs-id-max.onnx";
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.LoadPreoptimizedModel";
+  so.graph_optimization_level = TransformerLevel::Level2;
+  FILE* fp;
+  std::basic_string<ORTCHAR_T> optimized_model_path(ORT_TSTR("model_XXXXXX"));
+  CreateTestFile(fp, optimized_model_path);
+  ASSERT_EQ(0, fclose(fp));
+  std::unique_ptr<ORTCHAR_T, decltype(&DeleteFileFromDisk)> optimized_model_deleter(
+      const_cast<ORTCHAR_T*>(optimized_model_path.c_str()), DeleteFileFromDisk);
+  so.optimized_model_filepath = optimized_model_path;
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(test_model).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  auto check_preoptimized = [&so](const std::string& logid, bool expected) {
+    SessionOptions reload_so = so;
+    reload_so.session_logid = logid;
+    reload_so.optimized_model_filepath.clear();
+    reload_so.session_log_severity_level = static_cast<int>(logging::Severity::kINFO);
+    auto capturing_sink = new CapturingSink();
+    auto logging_manager = onnxruntime::make_unique<logging::LoggingManager>(
+        std::unique_ptr<ISink>(capturing_sink), logging::Severity::kVERBOSE, false,
+        LoggingManager::InstanceType::Temporal);
+    InferenceSessionGetGraphWrapper reloaded{reload_so, logging_manager.get()};
+    ASSERT_TRUE(reloaded.Load(so.optimized_model_filepath).IsOK());
+    ASSERT_TRUE(reloaded.Initialize().IsOK());
+    ASSERT_EQ(CountOpsInGraph(reloaded.GetGraph())["Identity"], 0);
+
+    const auto& msgs = capturing_sink->Messages();
+    const bool skipped = std::any_of(msgs.begin(), msgs.end(), [](const std::string& msg) {
+      return msg.find("Skipping those graph transformers") != std::string::npos;
+    });
+    ASSERT_EQ(skipped, expected);
+  };
+
+  check_preoptimized("InferenceSessionTests.LoadPreoptimizedModel.Skip", true);
+
+  // a session asking for fewer optimizations uses the saved model as it is
+  so.graph_optimization_level = TransformerLevel::Level1;
+  check_preoptimized("InferenceSessionTests.LoadPreoptimizedModel.LowerLevel", true);
+
+  // one asking for more applies the transformers of the levels above
+  so.graph_optimization_level = TransformerLevel::Level3;
+  check_preoptimized("InferenceSessionTests.LoadPreoptimizedModel.HigherLevel", true);
+
+  // free dimension overrides are applied by a Level1 transformer, so a session with other overrides optimizes the
+  // model again
+  so.free_dimension_overrides.push_back(FreeDimensionOverride{"DATA_BATCH", 1});
+  check_preoptimized("InferenceSessionTests.LoadPreoptimizedModel.OtherFreeDimensionOverrides", false);
 }
 
 #ifdef ORT_RUN_EXTERNAL_ONNX_TESTS
@@ -654,6 +725,281 @@ TEST(InferenceSessionTests, MultipleSessionsNoTimeout) {
   thread2.join();
 }
 
+TEST(InferenceSessionTests, ExecutionFramePoolWithConcurrentRuns) {
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.ExecutionFramePoolWithConcurrentRuns";
+  so.enable_execution_frame_pool = true;
+
+  InferenceSession session_object{so, &DefaultLoggingManager()};
+  ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+  ASSERT_TRUE(session_object.Initialize().IsOK());
+
+  // the first runs trace the memory pattern, later ones take pooled frames. mix in preallocated outputs, which use
+  // the same frames with the fetches bound in.
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&session_object, t]() {
+      RunOptions run_options;
+      run_options.run_tag = "frame pool/thread " + std::to_string(t);
+      for (int i = 0; i < 20; ++i) {
+        RunModel(session_object, run_options, /* is_preallocate_output_vec */ i % 5 == 0);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+// RunAsync gets a thread of its own even when asked for a single one, which a default sized pool is on small machines
+TEST(InferenceSessionTests, RunAsyncWithOneThread) {
+  for (auto execution_mode : {ExecutionMode::ORT_SEQUENTIAL, ExecutionMode::ORT_PARALLEL}) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.RunAsyncWithOneThread";
+    so.execution_mode = execution_mode;
+    so.async_run_num_threads = 1;
+
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    ASSERT_TRUE(session_object.Load(MODEL_URI).IsOK());
+    ASSERT_TRUE(session_object.Initialize().IsOK());
+
+    std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {3, 2}, values_mul_x,
+                         &ml_value);
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    const int num_runs = 4;
+    int num_done = 0;
+    std::vector<Status> statuses(num_runs);
+    std::vector<std::vector<OrtValue>> fetches(num_runs);
+    for (int i = 0; i < num_runs; ++i) {
+      auto st = session_object.RunAsync(nullptr, {"X"}, {ml_value}, {"Y"}, {},
+                                        [&, i](const Status& status, std::vector<OrtValue>& run_fetches) {
+                                          std::lock_guard<std::mutex> lock(mutex);
+                                          statuses[i] = status;
+                                          fetches[i] = run_fetches;
+                                          ++num_done;
+                                          cv.notify_all();
+                                        });
+      ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&]() { return num_done == num_runs; });
+    for (int i = 0; i < num_runs; ++i) {
+      ASSERT_TRUE(statuses[i].IsOK()) << statuses[i].ErrorMessage();
+      VerifyOutputs(fetches[i], {3, 2}, {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f});
+    }
+  }
+}
+
+// Writes a model computing Y = X * W to file_name. W is 2 x cols and large enough for Model::LoadMapped to leave it
+// in the model file. The model doc string is padded so that the raw data of W starts at an offset in the file that
+// leaves the given remainder when divided by 64.
+static void WriteMmapTestModel(const std::string& file_name, int64_t cols, size_t offset_remainder,
+                               std::vector<float>& weight_values) {
+  onnxruntime::Model model("mmap");
+  auto& graph = model.MainGraph();
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("N");
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+
+  TensorProto weights;
+  weights.set_name("W");
+  weights.set_data_type(TensorProto_DataType_FLOAT);
+  weights.add_dims(2);
+  weights.add_dims(cols);
+  weight_values.resize(2 * cols);
+  for (size_t i = 0; i < weight_values.size(); ++i) {
+    weight_values[i] = static_cast<float>(i % 7);
+  }
+  weights.set_raw_data(weight_values.data(), weight_values.size() * sizeof(float));
+  graph.AddInitializedTensor(weights);
+
+  TypeProto weights_type;
+  weights_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  weights_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  weights_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(cols);
+  TypeProto output_type;
+  output_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& w = graph.GetOrCreateNodeArg("W", &weights_type);
+  auto& y = graph.GetOrCreateNodeArg("Y", &output_type);
+  graph.AddNode("matmul", "MatMul", "", {&x, &w}, {&y});
+  ASSERT_TRUE(graph.Resolve().IsOK());
+
+  // the doc string is serialized before the graph, so every byte added to it moves the weights by one byte
+  auto model_proto = model.ToProto();
+  const std::string raw_data = weights.raw_data();
+  std::string model_bytes;
+  size_t weights_offset = 0;
+  for (size_t padding = 0; padding < 128; ++padding) {
+    model_proto.set_doc_string(std::string(padding, ' '));
+    ASSERT_TRUE(model_proto.SerializeToString(&model_bytes));
+    weights_offset = model_bytes.find(raw_data);
+    ASSERT_NE(weights_offset, std::string::npos);
+    if (weights_offset % 64 == offset_remainder) {
+      break;
+    }
+  }
+  ASSERT_EQ(weights_offset % 64, offset_remainder);
+
+  std::ofstream file(file_name, std::ios::binary);
+  file.write(model_bytes.data(), model_bytes.size());
+  ASSERT_TRUE(file.good());
+}
+
+#ifdef __linux__
+// Whether p points into a mapping of the file whose path ends with file_name.
+static bool IsInMappedFile(const void* p, const std::string& file_name) {
+  const auto address = reinterpret_cast<uintptr_t>(p);
+  std::ifstream maps("/proc/self/maps");
+  std::string line;
+  while (std::getline(maps, line)) {
+    std::istringstream fields(line);
+    uintptr_t begin = 0, end = 0;
+    char dash;
+    if (!(fields >> std::hex >> begin >> dash >> end) || address < begin || address >= end) {
+      continue;
+    }
+    return line.size() >= file_name.size() &&
+           line.compare(line.size() - file_name.size(), file_name.size(), file_name) == 0;
+  }
+  return false;
+}
+#endif
+
+static std::vector<float> MmapTestModelOutput(const std::vector<float>& values_x,
+                                              const std::vector<float>& weight_values, int64_t cols) {
+  std::vector<float> expected_values(3 * cols);
+  for (int64_t r = 0; r < 3; ++r) {
+    for (int64_t c = 0; c < cols; ++c) {
+      expected_values[r * cols + c] = values_x[r * 2] * weight_values[c] + values_x[r * 2 + 1] * weight_values[cols + c];
+    }
+  }
+  return expected_values;
+}
+
+TEST(InferenceSessionTests, LoadModelWithMmap) {
+  const int64_t cols = 1024;
+  const std::vector<float> values_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue ml_value_x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {3, 2}, values_x,
+                       &ml_value_x);
+  NameMLValMap feeds{{"X", ml_value_x}};
+
+  // W is used in place when its data is aligned in the file, and copied otherwise
+  for (size_t offset_remainder : {0, 2}) {
+    const bool in_place = offset_remainder == 0;
+    const std::string model_file_name = "inference_session_test_mmap.onnx";
+    std::vector<float> weight_values;
+    ASSERT_NO_FATAL_FAILURE(WriteMmapTestModel(model_file_name, cols, offset_remainder, weight_values));
+    // deleted after the sessions below have unmapped it
+    const std::basic_string<ORTCHAR_T> model_file_path = ToWideString(model_file_name);
+    std::unique_ptr<ORTCHAR_T, decltype(&DeleteFileFromDisk)> model_file_deleter(
+        const_cast<ORTCHAR_T*>(model_file_path.c_str()), DeleteFileFromDisk);
+
+    // the weights reference the model file instead of being copied
+    std::shared_ptr<onnxruntime::Model> mapped_model;
+    auto status = onnxruntime::Model::LoadMapped(model_file_path, mapped_model);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    const TensorProto* mapped_weights = nullptr;
+    ASSERT_TRUE(mapped_model->MainGraph().GetInitializedTensor("W", mapped_weights));
+    ASSERT_EQ(mapped_weights->data_location(), TensorProto_DataLocation_EXTERNAL);
+    ASSERT_FALSE(utils::HasRawData(*mapped_weights));
+    EXPECT_EQ(utils::CanUseExternalDataInPlace(*mapped_weights), in_place);
+
+    const auto expected_values = MmapTestModelOutput(values_x, weight_values, cols);
+    for (bool enable_mem_pattern : {true, false}) {
+      SessionOptions so;
+      so.session_logid = "InferenceSessionTests.LoadModelWithMmap";
+      so.enable_model_mmap = true;
+      so.enable_mem_pattern = enable_mem_pattern;
+      InferenceSessionGetGraphWrapper session_object{so, &DefaultLoggingManager()};
+      status = session_object.Load(model_file_name);
+      ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+      status = session_object.Initialize();
+      ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+      const auto& session_state = session_object.GetSessionState();
+      int weights_idx;
+      ASSERT_TRUE(session_state.GetOrtValueNameIdxMap().GetIdx("W", weights_idx).IsOK());
+      const auto weights_it = session_state.GetInitializedTensors().find(weights_idx);
+      ASSERT_NE(weights_it, session_state.GetInitializedTensors().end());
+      const void* weights_data = weights_it->second.Get<Tensor>().DataRaw();
+      EXPECT_EQ(reinterpret_cast<uintptr_t>(weights_data) % 64 == offset_remainder, in_place);
+#ifdef __linux__
+      EXPECT_EQ(IsInMappedFile(weights_data, model_file_name), in_place);
+#endif
+
+      std::vector<OrtValue> fetches;
+      status = session_object.Run(RunOptions{}, feeds, {"Y"}, &fetches);
+      ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+      VerifyOutputs(fetches, {3, cols}, expected_values);
+    }
+  }
+}
+
+// A model saved from a mapped session holds its initializers inline, so it loads from anywhere.
+TEST(InferenceSessionTests, LoadModelWithMmapAndSaveOptimizedModel) {
+  const int64_t cols = 1024;
+  const std::string model_file_name = "inference_session_test_mmap_save.onnx";
+  std::vector<float> weight_values;
+  ASSERT_NO_FATAL_FAILURE(WriteMmapTestModel(model_file_name, cols, 0, weight_values));
+  const std::basic_string<ORTCHAR_T> model_file_path = ToWideString(model_file_name);
+  std::unique_ptr<ORTCHAR_T, decltype(&DeleteFileFromDisk)> model_file_deleter(
+      const_cast<ORTCHAR_T*>(model_file_path.c_str()), DeleteFileFromDisk);
+
+  const std::basic_string<ORTCHAR_T> optimized_model_path = ORT_TSTR("inference_session_test_mmap_saved.onnx");
+  std::unique_ptr<ORTCHAR_T, decltype(&DeleteFileFromDisk)> optimized_model_deleter(
+      const_cast<ORTCHAR_T*>(optimized_model_path.c_str()), DeleteFileFromDisk);
+  {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.LoadModelWithMmapAndSaveOptimizedModel";
+    so.enable_model_mmap = true;
+    so.optimized_model_filepath = optimized_model_path;
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    auto status = session_object.Load(model_file_name);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    status = session_object.Initialize();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  }
+
+  std::shared_ptr<onnxruntime::Model> saved_model;
+  auto status = onnxruntime::Model::Load(optimized_model_path, saved_model);
+  ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+  for (const auto& entry : saved_model->MainGraph().GetAllInitializedTensors()) {
+    EXPECT_NE(entry.second->data_location(), TensorProto_DataLocation_EXTERNAL) << entry.first;
+  }
+
+  const std::vector<float> values_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  OrtValue ml_value_x;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {3, 2}, values_x,
+                       &ml_value_x);
+  NameMLValMap feeds{{"X", ml_value_x}};
+  const auto expected_values = MmapTestModelOutput(values_x, weight_values, cols);
+  for (bool enable_model_mmap : {true, false}) {
+    SessionOptions so;
+    so.session_logid = "InferenceSessionTests.LoadModelWithMmapAndSaveOptimizedModel";
+    so.enable_model_mmap = enable_model_mmap;
+    InferenceSession session_object{so, &DefaultLoggingManager()};
+    status = session_object.Load(optimized_model_path);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    status = session_object.Initialize();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+
+    std::vector<OrtValue> fetches;
+    status = session_object.Run(RunOptions{}, feeds, {"Y"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    VerifyOutputs(fetches, {3, cols}, expected_values);
+  }
+}
+
 TEST(InferenceSessionTests, PreAllocateOutputVector) {
   SessionOptions so;
 
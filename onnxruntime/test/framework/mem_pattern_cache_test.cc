@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/mem_pattern_cache.h"
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+std::unique_ptr<MemoryPatternGroup> MakePatterns() {
+  return onnxruntime::make_unique<MemoryPatternGroup>();
+}
+
+}  // namespace
+
+TEST(MemoryPatternCacheTest, BucketDim) {
+  MemoryPatternCache cache({16, 32, 64}, 0);
+  EXPECT_EQ(cache.BucketDim(1), 16);
+  EXPECT_EQ(cache.BucketDim(16), 16);
+  EXPECT_EQ(cache.BucketDim(17), 32);
+  EXPECT_EQ(cache.BucketDim(64), 64);
+  // past the last boundary dims are used as they are
+  EXPECT_EQ(cache.BucketDim(65), 65);
+
+  MemoryPatternCache exact({}, 0);
+  EXPECT_EQ(exact.BucketDim(17), 17);
+}
+
+TEST(MemoryPatternCacheTest, ExactShapes) {
+  MemoryPatternCache cache({}, 0);
+  TensorShape a({1, 3, 5});
+  TensorShape b({1, 5, 3});
+
+  EXPECT_EQ(cache.Get({a}), nullptr);
+  cache.Put({a}, MakePatterns());
+  EXPECT_NE(cache.Get({a}), nullptr);
+  // the dims of 'b' XOR to the same value as those of 'a' but must not share its pattern
+  EXPECT_EQ(cache.Get({b}), nullptr);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 2u);
+  EXPECT_EQ(stats.size, 1u);
+}
+
+TEST(MemoryPatternCacheTest, BucketedShapesShareAPattern) {
+  MemoryPatternCache cache({32, 64, 128}, 0);
+  TensorShape traced({1, 40});
+  cache.Put({traced}, MakePatterns());
+  auto patterns = cache.Get({traced});
+  ASSERT_NE(patterns, nullptr);
+
+  // smaller shapes in the same bucket reuse the pattern
+  TensorShape smaller({1, 33});
+  EXPECT_EQ(cache.Get({smaller}), patterns);
+
+  // larger shapes in the same bucket don't fit in it
+  TensorShape larger({1, 60});
+  EXPECT_EQ(cache.Get({larger}), nullptr);
+
+  // and the pattern traced for them replaces it, serving the whole bucket seen so far
+  cache.Put({larger}, MakePatterns());
+  auto larger_patterns = cache.Get({smaller});
+  ASSERT_NE(larger_patterns, nullptr);
+  EXPECT_NE(larger_patterns, patterns);
+  EXPECT_EQ(cache.Get({traced}), larger_patterns);
+
+  // a smaller trace doesn't replace it
+  cache.Put({smaller}, MakePatterns());
+  EXPECT_EQ(cache.Get({larger}), larger_patterns);
+
+  // another bucket
+  TensorShape other({1, 100});
+  EXPECT_EQ(cache.Get({other}), nullptr);
+  EXPECT_EQ(cache.GetStats().size, 1u);
+}
+
+TEST(MemoryPatternCacheTest, EvictsLeastRecentlyUsed) {
+  MemoryPatternCache cache({}, 2);
+  TensorShape a({1});
+  TensorShape b({2});
+  TensorShape c({3});
+
+  cache.Put({a}, MakePatterns());
+  cache.Put({b}, MakePatterns());
+  auto a_patterns = cache.Get({a});
+  ASSERT_NE(a_patterns, nullptr);
+
+  // 'b' is the least recently used
+  cache.Put({c}, MakePatterns());
+  EXPECT_NE(cache.Get({a}), nullptr);
+  EXPECT_EQ(cache.Get({b}), nullptr);
+  EXPECT_NE(cache.Get({c}), nullptr);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.evictions, 1u);
+  EXPECT_EQ(stats.size, 2u);
+
+  // evicted patterns stay valid for their users
+  cache.Put({b}, MakePatterns());
+  EXPECT_EQ(cache.Get({a}), nullptr);
+  EXPECT_EQ(a_patterns->locations.size(), 0u);
+}
+
+TEST(MemoryPatternCacheTest, MultipleInputs) {
+  MemoryPatternCache cache({8, 16}, 0);
+  TensorShape a({2, 7});
+  TensorShape b({7});
+  cache.Put({a, b}, MakePatterns());
+
+  TensorShape a2({2, 5});
+  TensorShape b2({6});
+  EXPECT_NE(cache.Get({a2, b2}), nullptr);
+
+  // same total rank split differently across the inputs
+  TensorShape c({2});
+  TensorShape d({7, 7});
+  EXPECT_EQ(cache.Get({c, d}), nullptr);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -6,6 +6,12 @@
 #include "test/providers/provider_test_utils.h"
 #include "test_utils.h"
 #include "core/session/inference_session.h"
+#include "core/platform/ort_mutex.h"
+
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <thread>
 
 #include "gtest/gtest.h"
 
@@ -15,6 +21,51 @@ using namespace onnxruntime::common;
 namespace onnxruntime {
 namespace test {
 
+namespace {
+// names of the nodes that passed their input through, in the order they started, with the thread that ran them
+struct NodeRunLog {
+  OrtMutex mutex;
+  std::vector<std::pair<std::string, std::thread::id>> runs;
+
+  void Record(const std::string& node_name) {
+    std::lock_guard<OrtMutex> lock(mutex);
+    runs.emplace_back(node_name, std::this_thread::get_id());
+  }
+
+  void Clear() {
+    std::lock_guard<OrtMutex> lock(mutex);
+    runs.clear();
+  }
+
+  bool Contains(const std::string& node_name) {
+    std::lock_guard<OrtMutex> lock(mutex);
+    return std::any_of(runs.cbegin(), runs.cend(), [&node_name](const std::pair<std::string, std::thread::id>& run) {
+      return run.first == node_name;
+    });
+  }
+
+  // the node that the thread which ran node_name started next, or "" if there was none
+  std::string NextOnSameThread(const std::string& node_name) {
+    std::lock_guard<OrtMutex> lock(mutex);
+    auto run = std::find_if(runs.cbegin(), runs.cend(), [&node_name](const std::pair<std::string, std::thread::id>& r) {
+      return r.first == node_name;
+    });
+    if (run == runs.cend())
+      return "";
+    const auto thread_id = run->second;
+    run = std::find_if(run + 1, runs.cend(), [thread_id](const std::pair<std::string, std::thread::id>& r) {
+      return r.second == thread_id;
+    });
+    return run == runs.cend() ? "" : run->first;
+  }
+};
+
+NodeRunLog& RunLog() {
+  static NodeRunLog log;
+  return log;
+}
+}  // namespace
+
 // Test kernel that will return success, or failure, or throw based on the input
 struct TestOp {
   static constexpr const char* OpName = "TestOp";
@@ -28,13 +79,17 @@ struct TestOp {
         .SinceVersion(10)
         .Input(0, "action", "Action to take.", "T", OpSchema::Single)
         .Output(0, "action_out", "Return input as is", "T", OpSchema::Single)
-        .TypeConstraint("T", {"tensor(int64)"}, "Type of the action and values component");
+        .TypeConstraint("T", {"tensor(int64)"}, "Type of the action and values component")
+        .Attr("delay_ms", "Milliseconds to wait before returning success.", AttributeProto::INT,
+              static_cast<int64_t>(0));
     return schema;
   }
 
   class OpKernelImpl final : public OpKernel {
    public:
-    OpKernelImpl(const OpKernelInfo& info) : OpKernel{info} {}
+    OpKernelImpl(const OpKernelInfo& info) : OpKernel{info} {
+      delay_ms_ = info.GetAttrOrDefault<int64_t>("delay_ms", 0);
+    }
 
     Status Compute(OpKernelContext* ctx) const override {
       const Tensor& action_tensor = *ctx->Input<Tensor>(0);
@@ -45,6 +100,10 @@ struct TestOp {
       switch (*action) {
         case 0: {
           // success
+          RunLog().Record(Node().Name());
+          if (delay_ms_ > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms_));
+          }
           Tensor* Y = ctx->Output(0, action_tensor.Shape());
           void* target = Y->MutableData<int64_t>();
           memcpy(target, action, action_tensor.SizeInBytes());
@@ -62,6 +121,9 @@ struct TestOp {
 
       return status;
     }
+
+   private:
+    int64_t delay_ms_;
   };
 
   static KernelDefBuilder KernelDef() {
@@ -139,5 +201,190 @@ TEST(ParallelExecutor, TestNullInterOpThreadPool) {
   so.inter_op_num_threads = 1;
   tester.Run(so, OpTester::ExpectResult::kExpectSuccess, {}, {kTensorrtExecutionProvider}, nullptr, nullptr);
 }
+
+namespace {
+std::shared_ptr<CustomRegistry> CreateTestOpRegistry() {
+  auto registry = std::make_shared<CustomRegistry>();
+  std::vector<OpSchema> schemas{TestOp::OpSchema()};
+  ORT_THROW_IF_ERROR(registry->RegisterOpSet(schemas, TestOp::OpDomain, 10, 11));
+  KernelCreateFn kernel_create_fn = [](const OpKernelInfo& info) { return new typename TestOp::OpKernelImpl(info); };
+  auto kernel_def = TestOp::KernelDef();
+  ORT_THROW_IF_ERROR(registry->RegisterCustomKernel(kernel_def, kernel_create_fn));
+  return registry;
+}
+
+struct TestOpNode {
+  std::string name;
+  std::string input;
+  std::string output;
+  int64_t delay_ms;
+};
+
+// Load a model of TestOp nodes, added in the given order, into session. Values that no node produces are the
+// graph inputs and values that no node consumes are the graph outputs.
+void LoadTestOpModel(InferenceSession& session, const std::shared_ptr<CustomRegistry>& registry,
+                     const std::vector<TestOpNode>& nodes) {
+  Status st;
+  ASSERT_TRUE((st = session.RegisterCustomRegistry(registry)).IsOK()) << st;
+
+  IOnnxRuntimeOpSchemaRegistryList custom_schema_registries = {registry->GetOpschemaRegistry()};
+  std::unordered_map<std::string, int> domain_to_version = {{TestOp::OpDomain, 10}};
+  Model model("ParallelExecutorTest", false, ModelMetaData(), custom_schema_registries, domain_to_version);
+  auto& graph = model.MainGraph();
+
+  TypeProto action_type(*DataTypeImpl::GetTensorType<int64_t>()->GetTypeProto());
+  action_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(1);
+  for (const auto& test_node : nodes) {
+    auto& input = graph.GetOrCreateNodeArg(test_node.input, &action_type);
+    auto& output = graph.GetOrCreateNodeArg(test_node.output, &action_type);
+    auto& node = graph.AddNode(test_node.name, TestOp::OpName, "", {&input}, {&output}, nullptr, TestOp::OpDomain);
+    node.AddAttribute("delay_ms", test_node.delay_ms);
+  }
+  ASSERT_TRUE((st = graph.Resolve()).IsOK()) << st;
+
+  std::string serialized_model;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&serialized_model));
+  std::stringstream sstr(serialized_model);
+  ASSERT_TRUE((st = session.Load(sstr)).IsOK()) << st;
+  ASSERT_TRUE((st = session.Initialize()).IsOK()) << st;
+}
+
+// root feeds a single node and a chain of three nodes. The single node is added first, so it has the lower node
+// index and is the first successor of root.
+std::vector<TestOpNode> BranchingModel(int64_t single_node_delay_ms) {
+  return {{"root", "action", "root_out", 0},
+          {"single", "root_out", "single_out", single_node_delay_ms},
+          {"chain_0", "root_out", "chain_0_out", 0},
+          {"chain_1", "chain_0_out", "chain_1_out", 0},
+          {"chain_2", "chain_1_out", "chain_2_out", 0}};
+}
+
+SessionOptions ParallelSessionOptions(const std::string& logid) {
+  SessionOptions so;
+  so.session_logid = logid;
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.inter_op_num_threads = 4;
+  return so;
+}
+
+Status RunTestOpModel(InferenceSession& session, const RunOptions& run_options, const NameMLValMap& feeds,
+                      const std::vector<std::string>& output_names) {
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(session.Run(run_options, feeds, output_names, &fetches));
+  for (const auto& fetch : fetches) {
+    ORT_RETURN_IF_NOT(*fetch.Get<Tensor>().Data<int64_t>() == 0, "Unexpected output value");
+  }
+  return Status::OK();
+}
+
+NameMLValMap ActionFeeds(const std::vector<std::pair<std::string, int64_t>>& actions) {
+  NameMLValMap feeds;
+  for (const auto& action : actions) {
+    OrtValue value;
+    CreateMLValue<int64_t>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), {1}, {action.second},
+                           &value);
+    feeds.insert(std::make_pair(action.first, value));
+  }
+  return feeds;
+}
+}  // namespace
+
+// the successor with the longest remaining path runs next on the thread that finished its producer
+TEST(ParallelExecutor, CriticalPathRunsOnSameThread) {
+  InferenceSession session{ParallelSessionOptions("CriticalPathRunsOnSameThread"), &DefaultLoggingManager()};
+  ASSERT_NO_FATAL_FAILURE(LoadTestOpModel(session, CreateTestOpRegistry(), BranchingModel(0)));
+
+  const auto feeds = ActionFeeds({{"action", 0}});
+  Status st;
+  for (int i = 0; i < 5; ++i) {
+    RunLog().Clear();
+    ASSERT_TRUE((st = RunTestOpModel(session, RunOptions(), feeds, {"single_out", "chain_2_out"})).IsOK()) << st;
+    EXPECT_EQ(RunLog().NextOnSameThread("root"), "chain_0");
+    EXPECT_EQ(RunLog().NextOnSameThread("chain_0"), "chain_1");
+  }
+}
+
+// measured kernel run times replace the output size estimates on later runs, but only when asked for
+TEST(ParallelExecutor, MeasuredNodeCostsReorderSuccessors) {
+  // the single node is slower than the whole chain
+  const auto model = BranchingModel(/*single_node_delay_ms*/ 20);
+  const auto registry = CreateTestOpRegistry();
+  const auto feeds = ActionFeeds({{"action", 0}});
+
+  for (bool measure : {false, true}) {
+    auto so = ParallelSessionOptions("MeasuredNodeCostsReorderSuccessors");
+    so.enable_node_cost_measurement = measure;
+    InferenceSession session{so, &DefaultLoggingManager()};
+    ASSERT_NO_FATAL_FAILURE(LoadTestOpModel(session, registry, model));
+    Status st;
+
+    // the first run can only estimate, and the chain is longer
+    RunLog().Clear();
+    ASSERT_TRUE((st = RunTestOpModel(session, RunOptions(), feeds, {"single_out", "chain_2_out"})).IsOK()) << st;
+    EXPECT_EQ(RunLog().NextOnSameThread("root"), "chain_0");
+
+    RunLog().Clear();
+    ASSERT_TRUE((st = RunTestOpModel(session, RunOptions(), feeds, {"single_out", "chain_2_out"})).IsOK()) << st;
+    EXPECT_EQ(RunLog().NextOnSameThread("root"), measure ? "single" : "chain_0") << "measure: " << measure;
+  }
+}
+
+// a failing node fails the run without hanging it, and the session can still be run afterwards
+TEST(ParallelExecutor, ErrorInOneBranch) {
+  InferenceSession session{ParallelSessionOptions("ErrorInOneBranch"), &DefaultLoggingManager()};
+  ASSERT_NO_FATAL_FAILURE(LoadTestOpModel(session, CreateTestOpRegistry(),
+                                          {{"ok_0", "action", "ok_0_out", 0},
+                                           {"ok_1", "ok_0_out", "ok_1_out", 5},
+                                           {"ok_2", "ok_1_out", "ok_2_out", 0},
+                                           {"other", "other_action", "other_out", 0}}));
+  const std::vector<std::string> output_names{"ok_2_out", "other_out"};
+
+  auto status = RunTestOpModel(session, RunOptions(), ActionFeeds({{"action", 0}, {"other_action", 1}}),
+                               output_names);
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_THAT(status.ErrorMessage(), testing::HasSubstr("Action was 1"));
+
+  status = RunTestOpModel(session, RunOptions(), ActionFeeds({{"action", 0}, {"other_action", 2}}), output_names);
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_THAT(status.ErrorMessage(), testing::HasSubstr("Throwing as action was 2"));
+
+  status = RunTestOpModel(session, RunOptions(), ActionFeeds({{"action", 0}, {"other_action", 0}}), output_names);
+  ASSERT_TRUE(status.IsOK()) << status;
+}
+
+// setting the terminate flag stops a parallel run before its next node, and the session can still be run afterwards
+TEST(ParallelExecutor, TerminateRun) {
+  InferenceSession session{ParallelSessionOptions("TerminateRun"), &DefaultLoggingManager()};
+  ASSERT_NO_FATAL_FAILURE(LoadTestOpModel(session, CreateTestOpRegistry(),
+                                          {{"slow", "action", "slow_out", 100},
+                                           {"next_0", "slow_out", "next_0_out", 0},
+                                           {"next_1", "next_0_out", "next_1_out", 0}}));
+  const auto feeds = ActionFeeds({{"action", 0}});
+
+  // terminated before the run starts
+  RunOptions run_options;
+  run_options.terminate = true;
+  auto status = RunTestOpModel(session, run_options, feeds, {"next_1_out"});
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_THAT(status.ErrorMessage(), testing::HasSubstr("Exiting due to terminate flag being set to true"));
+
+  // terminated while the slow node runs
+  RunLog().Clear();
+  run_options.terminate = false;
+  auto terminator = std::async(std::launch::async, [&run_options]() {
+    while (!RunLog().Contains("slow")) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    run_options.terminate = true;
+  });
+  status = RunTestOpModel(session, run_options, feeds, {"next_1_out"});
+  terminator.get();
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_THAT(status.ErrorMessage(), testing::HasSubstr("Exiting due to terminate flag being set to true"));
+  EXPECT_FALSE(RunLog().Contains("next_0"));
+
+  status = RunTestOpModel(session, RunOptions(), feeds, {"next_1_out"});
+  ASSERT_TRUE(status.IsOK()) << status;
+}
 }  // namespace test
 }  // namespace onnxruntime
@@ -0,0 +1,272 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/run_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// counts the calls that reach the backing allocator
+class CountingAllocator : public IAllocator {
+ public:
+  void* Alloc(size_t size) override {
+    ++num_allocs;
+    return cpu_.Alloc(size);
+  }
+
+  void Free(void* p) override {
+    ++num_frees;
+    cpu_.Free(p);
+  }
+
+  const OrtMemoryInfo& Info() const override { return cpu_.Info(); }
+
+  int num_allocs = 0;
+  int num_frees = 0;
+
+ private:
+  CPUAllocator cpu_;
+};
+
+}  // namespace
+
+TEST(RunArenaTest, BumpsThroughOneBlock) {
+  auto backing = std::make_shared<CountingAllocator>();
+  RunArena arena(backing);
+
+  EXPECT_EQ(arena.Alloc(0), nullptr);
+
+  auto* a = static_cast<char*>(arena.Alloc(1));
+  auto* b = static_cast<char*>(arena.Alloc(100));
+  auto* c = static_cast<char*>(arena.Alloc(64));
+  EXPECT_EQ(backing->num_allocs, 1);
+
+  // consecutive and aligned, each after a header of kAlignment bytes
+  EXPECT_EQ(b - a, 128);
+  EXPECT_EQ(c - b, 192);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % RunArena::kAlignment, 0u);
+
+  arena.Free(b);
+  EXPECT_EQ(backing->num_frees, 0);
+  EXPECT_EQ(arena.Info(), backing->Info());
+}
+
+TEST(RunArenaTest, FreeReusesMemory) {
+  auto backing = std::make_shared<CountingAllocator>();
+  RunArena arena(backing);
+
+  void* a = arena.Alloc(100);
+  void* b = arena.Alloc(100);
+  void* c = arena.Alloc(100);
+
+  // the slice handed out last is reused right away, others once the whole block is free
+  arena.Free(c);
+  EXPECT_EQ(arena.Alloc(100), c);
+  arena.Free(a);
+  EXPECT_NE(arena.Alloc(100), a);
+
+  RunArena drained(backing);
+  a = drained.Alloc(100);
+  b = drained.Alloc(100);
+  drained.Free(a);
+  drained.Free(b);
+  EXPECT_EQ(drained.Alloc(100), a);
+}
+
+TEST(RunArenaTest, ResetKeepsWhatTheRunNeeded) {
+  auto backing = std::make_shared<CountingAllocator>();
+  RunArena arena(backing);
+
+  // a chain of values that are each freed once the next one exists. the run allocates four times the block size
+  // in total, but never holds more than half of it.
+  const auto run_chain = [&arena]() {
+    void* previous = nullptr;
+    for (int i = 0; i < 16; ++i) {
+      void* next = arena.Alloc(RunArena::kMinBlockSize / 4);
+      arena.Free(previous);
+      previous = next;
+    }
+    arena.Free(previous);
+    arena.Reset();
+  };
+
+  run_chain();
+  const size_t capacity = arena.Capacity();
+  EXPECT_LT(capacity, 4 * RunArena::kMinBlockSize);
+
+  // the next run fits in the blocks kept
+  const int num_allocs = backing->num_allocs;
+  run_chain();
+  EXPECT_EQ(backing->num_allocs, num_allocs);
+  EXPECT_EQ(arena.Capacity(), capacity);
+}
+
+TEST(RunArenaTest, ResetShrinksAfterSmallerRuns) {
+  auto backing = std::make_shared<CountingAllocator>();
+  RunArena arena(backing);
+
+  for (int i = 0; i < 16; ++i) {
+    arena.Alloc(RunArena::kMinBlockSize / 2);
+  }
+  arena.Reset();
+  EXPECT_GE(arena.Capacity(), 8 * RunArena::kMinBlockSize);
+
+  // the blocks the smaller runs don't touch go first, then the block they use shrinks to their peak
+  for (int i = 0; i < 32; ++i) {
+    arena.Alloc(1024);
+    arena.Reset();
+  }
+  EXPECT_EQ(arena.Capacity(), RunArena::kMinBlockSize);
+  EXPECT_EQ(backing->num_allocs - backing->num_frees, 1);
+
+  RunArena single_block(backing);
+  single_block.Alloc(16 * RunArena::kMinBlockSize);
+  single_block.Reset();
+  EXPECT_GT(single_block.Capacity(), 16 * RunArena::kMinBlockSize);
+  for (int i = 0; i < 32; ++i) {
+    single_block.Alloc(1024);
+    single_block.Reset();
+  }
+  EXPECT_LE(single_block.Capacity(), 2 * RunArena::kMinBlockSize);
+}
+
+TEST(RunArenaTest, ConcurrentAllocAndFree) {
+  auto backing = std::make_shared<CountingAllocator>();
+  RunArena arena(backing);
+
+  // every thread fills its slices with its own value, so slices handed out twice show up as corrupted
+  std::vector<std::thread> threads;
+  std::vector<int> num_corrupted(4, 0);
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&arena, &num_corrupted, t]() {
+      const char fill = static_cast<char>(t + 1);
+      std::vector<std::pair<char*, size_t>> live;
+      const auto check_and_free = [&](const std::pair<char*, size_t>& slice) {
+        if (std::any_of(slice.first, slice.first + slice.second, [fill](char v) { return v != fill; })) {
+          ++num_corrupted[t];
+        }
+        arena.Free(slice.first);
+      };
+
+      for (int i = 0; i < 5000; ++i) {
+        const size_t size = 1 + (i * 37 + t * 11) % 3000;
+        char* p = static_cast<char*>(arena.Alloc(size));
+        std::memset(p, fill, size);
+        live.emplace_back(p, size);
+        if (i % 3 == 0) {
+          check_and_free(live.back());
+          live.pop_back();
+        }
+        if (live.size() > 100) {
+          for (const auto& slice : live) check_and_free(slice);
+          live.clear();
+        }
+      }
+      for (const auto& slice : live) check_and_free(slice);
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(num_corrupted, std::vector<int>(4, 0));
+  arena.Reset();
+}
+
+TEST(RunArenaTest, ResetReusesTheBlock) {
+  auto backing = std::make_shared<CountingAllocator>();
+  RunArena arena(backing);
+
+  void* first = arena.Alloc(1024);
+  arena.Alloc(4096);
+  arena.Reset();
+
+  // the next run starts at the beginning of the same block
+  EXPECT_EQ(arena.Alloc(1024), first);
+  EXPECT_EQ(backing->num_allocs, 1);
+  EXPECT_EQ(backing->num_frees, 0);
+}
+
+TEST(RunArenaTest, ResetKeepsGrownBlocks) {
+  auto backing = std::make_shared<CountingAllocator>();
+  {
+    RunArena arena(backing);
+
+    // more than fits in the first block
+    for (int i = 0; i < 4; ++i) {
+      arena.Alloc(RunArena::kMinBlockSize / 2 + 1);
+    }
+    EXPECT_GT(backing->num_allocs, 1);
+    const size_t grown_capacity = arena.Capacity();
+
+    arena.Reset();
+    EXPECT_EQ(backing->num_frees, 0);
+    EXPECT_EQ(arena.Capacity(), grown_capacity);
+
+    // a run of the same size fits in the blocks kept
+    const int num_allocs = backing->num_allocs;
+    for (int i = 0; i < 4; ++i) {
+      arena.Alloc(RunArena::kMinBlockSize / 2 + 1);
+    }
+    EXPECT_EQ(backing->num_allocs, num_allocs);
+  }
+
+  EXPECT_EQ(backing->num_allocs, backing->num_frees);
+}
+
+TEST(RunArenaTest, PoolHandsOutResetArenas) {
+  auto backing = std::make_shared<CountingAllocator>();
+  RunArenaPool pool(backing);
+  EXPECT_EQ(pool.Info(), backing->Info());
+
+  auto first = pool.Acquire();
+  auto second = pool.Acquire();
+  EXPECT_NE(first, second);
+
+  void* p = first->Alloc(256);
+  RunArena* first_ptr = first.get();
+  pool.Release(std::move(first));
+
+  auto again = pool.Acquire();
+  EXPECT_EQ(again.get(), first_ptr);
+  EXPECT_EQ(again->Alloc(256), p);
+
+  pool.Release(std::move(again));
+  pool.Release(std::move(second));
+}
+
+TEST(RunArenaTest, PoolKeepsBoundedNumberOfArenas) {
+  auto backing = std::make_shared<CountingAllocator>();
+  {
+    RunArenaPool pool(backing, 2);
+
+    // a burst of concurrent runs
+    std::vector<std::shared_ptr<RunArena>> arenas;
+    for (int i = 0; i < 4; ++i) {
+      arenas.push_back(pool.Acquire());
+      arenas.back()->Alloc(1);
+    }
+    for (auto& arena : arenas) {
+      pool.Release(std::move(arena));
+    }
+    arenas.clear();
+
+    // the arenas beyond the limit are gone with their blocks
+    EXPECT_EQ(pool.NumFreeArenas(), 2u);
+    EXPECT_EQ(backing->num_allocs - backing->num_frees, 2);
+  }
+  EXPECT_EQ(backing->num_allocs, backing->num_frees);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -80,6 +80,36 @@ TEST(SessionStateTest, AddGetKernelTest) {
   EXPECT_EQ(orig_num_outputs, test_kernel->Node().OutputDefs().size());
 }
 
+TEST(SessionStateTest, PrePackedWeightsAreSharedPerFormat) {
+  PrePackedWeights prepacked_weights;
+  float buffers[2];
+  int num_packs = 0;
+  auto pack = [&](BufferUniquePtr& buffer) {
+    buffer = BufferUniquePtr(&buffers[num_packs++], BufferDeleter());
+    return true;
+  };
+
+  // kernels asking for the same format share the first copy
+  const void* packed = prepacked_weights.GetOrPack("format_a", pack);
+  EXPECT_EQ(packed, &buffers[0]);
+  EXPECT_EQ(prepacked_weights.GetOrPack("format_a", pack), packed);
+  EXPECT_EQ(num_packs, 1);
+
+  // another format gets its own copy
+  EXPECT_EQ(prepacked_weights.GetOrPack("format_b", pack), &buffers[1]);
+  EXPECT_EQ(num_packs, 2);
+
+  // a format that can't be packed is not retried
+  int num_failed_packs = 0;
+  auto fail = [&num_failed_packs](BufferUniquePtr&) {
+    ++num_failed_packs;
+    return false;
+  };
+  EXPECT_EQ(prepacked_weights.GetOrPack("format_c", fail), nullptr);
+  EXPECT_EQ(prepacked_weights.GetOrPack("format_c", fail), nullptr);
+  EXPECT_EQ(num_failed_packs, 1);
+}
+
 namespace {
 class TestParam {
  public:
@@ -3,6 +3,7 @@
 
 #include "core/common/common.h"
 #include "core/framework/callback.h"
+#include "core/framework/path_lib.h"
 #include "core/framework/tensorprotoutils.h"
 #include "gtest/gtest.h"
 #include "file_util.h"
@@ -137,6 +138,57 @@ TEST(CApiTest, load_float_tensor_with_external_data) {
   run_external_data_test<false>();
 }
 
+// An absolute location is only accepted when it is the model file itself, as written by Model::LoadMapped.
+TEST(CApiTest, load_float_tensor_with_absolute_external_data_location) {
+  FILE* fp;
+  std::basic_string<ORTCHAR_T> model_filename(ORT_TSTR("tensor_XXXXXX"));
+  CreateTestFile(fp, model_filename);
+  std::unique_ptr<ORTCHAR_T, decltype(&DeleteFileFromDisk)> model_file_deleter(
+      const_cast<ORTCHAR_T*>(model_filename.c_str()), DeleteFileFromDisk);
+  float test_data[] = {1.0f, 2.2f, 3.5f};
+  ASSERT_EQ(sizeof(test_data), fwrite(test_data, 1, sizeof(test_data), fp));
+  ASSERT_EQ(0, fclose(fp));
+
+  std::basic_string<ORTCHAR_T> other_filename(ORT_TSTR("tensor_XXXXXX"));
+  CreateTestFile(fp, other_filename);
+  std::unique_ptr<ORTCHAR_T, decltype(&DeleteFileFromDisk)> other_file_deleter(
+      const_cast<ORTCHAR_T*>(other_filename.c_str()), DeleteFileFromDisk);
+  ASSERT_EQ(sizeof(test_data), fwrite(test_data, 1, sizeof(test_data), fp));
+  ASSERT_EQ(0, fclose(fp));
+
+  std::basic_string<ORTCHAR_T> absolute_model_path;
+  ASSERT_TRUE(GetAbsolutePath(model_filename, absolute_model_path).IsOK());
+  onnx::TensorProto p;
+  onnx::StringStringEntryProto* location = p.mutable_external_data()->Add();
+  location->set_key("location");
+  location->set_value(ToMBString(absolute_model_path));
+  p.mutable_dims()->Add(3);
+  p.set_data_location(onnx::TensorProto_DataLocation_EXTERNAL);
+  p.set_data_type(onnx::TensorProto_DataType_FLOAT);
+
+  std::vector<float> output(3);
+  OrtMemoryInfo cpu_memory_info(onnxruntime::CPU, OrtDeviceAllocator, OrtDevice(), 0, OrtMemTypeDefault);
+  for (const auto* model_path : {model_filename.c_str(), other_filename.c_str()}) {
+    OrtValue value;
+    auto deleter = onnxruntime::make_unique<onnxruntime::OrtCallback>();
+    auto st = utils::TensorProtoToMLValue(Env::Default(), model_path, p,
+                                          MemBuffer(output.data(), output.size() * sizeof(float), cpu_memory_info),
+                                          value, *deleter);
+    if (model_path == model_filename.c_str()) {
+      ASSERT_TRUE(st.IsOK()) << st.ErrorMessage();
+      float* real_output;
+      auto ort_st = g_ort->GetTensorMutableData(&value, (void**)&real_output);
+      ASSERT_EQ(ort_st, nullptr) << g_ort->GetErrorMessage(ort_st);
+      ASSERT_EQ(real_output[2], 3.5f);
+    } else {
+      EXPECT_FALSE(st.IsOK());
+    }
+    if (deleter->f) {
+      OrtRunCallback(deleter.release());
+    }
+  }
+}
+
 #if defined(__amd64__) || defined(_M_X64)
 #ifndef __ANDROID__
 #ifdef NDEBUG
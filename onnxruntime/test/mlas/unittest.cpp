@@ -17,6 +17,7 @@ Abstract:
 #include <stdio.h>
 #include <memory.h>
 #include <algorithm>
+#include <cmath>
 #include <limits>
 #include <memory>
 #include <mlas.h>
@@ -459,6 +460,117 @@ public:
     }
 };
 
+class MlasSgemmPackedBTest : public MlasTestBase
+{
+private:
+    void
+    Test(
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        float beta
+        )
+    {
+        const float* A = BufferA.GetBuffer(K * M);
+        const float* B = BufferB.GetBuffer(N * K);
+        float* C = BufferC.GetBuffer(N * M);
+        float* CReference = BufferCReference.GetBuffer(N * M);
+
+        Test(CblasNoTrans, CblasNoTrans, M, N, K, alpha, A, K, B, N, beta, C, CReference, N);
+        Test(CblasNoTrans, CblasTrans, M, N, K, alpha, A, K, B, K, beta, C, CReference, N);
+        Test(CblasTrans, CblasNoTrans, M, N, K, alpha, A, M, B, N, beta, C, CReference, N);
+        Test(CblasTrans, CblasTrans, M, N, K, alpha, A, M, B, K, beta, C, CReference, N);
+    }
+
+    void
+    Test(
+        CBLAS_TRANSPOSE TransA,
+        CBLAS_TRANSPOSE TransB,
+        size_t M,
+        size_t N,
+        size_t K,
+        float alpha,
+        const float* A,
+        size_t lda,
+        const float* B,
+        size_t ldb,
+        float beta,
+        float* C,
+        float* CReference,
+        size_t ldc
+        )
+    {
+        //
+        // The packed buffer is allocated from the end of a guard buffer, so
+        // round the size up to keep the start of the buffer aligned.
+        //
+
+        size_t PackedBSize = (MlasGemmPackBSize(N, K) + 63) & ~size_t(63);
+        void* PackedB = BufferPackedB.GetBuffer(PackedBSize);
+
+        MlasGemmPackB(TransB, N, K, B, ldb, PackedB);
+
+        std::fill_n(C, M * N, -0.5f);
+        std::fill_n(CReference, M * N, -0.5f);
+
+        MlasGemm(TransA, M, N, K, alpha, A, lda, PackedB, beta, C, ldc, threadpool);
+        MlasGemm(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, CReference, ldc, threadpool);
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (C[f] != CReference[f]) {
+                printf("mismatch TransA=%d, TransB=%d, M=%zd, N=%zd, K=%zd, alpha=%f, beta=%f  %f %f!\n", TransA, TransB, M, N, K, alpha, beta, C[f], CReference[f]);
+                break;
+            }
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferA;
+    MatrixGuardBuffer<float> BufferB;
+    MatrixGuardBuffer<uint8_t> BufferPackedB;
+    MatrixGuardBuffer<float> BufferC;
+    MatrixGuardBuffer<float> BufferCReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t b = 1; b < 16; b++) {
+            Test(b, b, b, 1.0f, 0.0f);
+        }
+        for (size_t b = 16; b <= 256; b <<= 1) {
+            Test(b, b, b, 1.0f, 0.0f);
+        }
+        for (size_t b = 256; b < 320; b += 32) {
+            Test(b, b, b, 1.0f, 0.0f);
+        }
+        Test(1, 1000, 512, 1.0f, 0.0f);
+        Test(7, 300, 600, 1.0f, 1.0f);
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+        static const float multipliers[] = { 0.0f, -0.0f, 0.25f, -0.5f, 1.0f, -1.0f };
+
+        for (size_t a = 0; a < _countof(multipliers); a++) {
+            for (size_t b = 0; b < _countof(multipliers); b++) {
+                for (size_t M = 1; M < 40; M += 3) {
+                    for (size_t N = 1; N < 300; N += 13) {
+                        for (size_t K = 1; K < 600; K += 37) {
+                            Test(M, N, K, multipliers[a], multipliers[b]);
+                        }
+                    }
+                }
+            }
+        }
+    }
+};
+
 #ifdef MLAS_HAS_QGEMM_U8X8
 
 template <typename xint8_t>
@@ -509,6 +621,71 @@ private:
                 printf("mismatch M=%zd, N=%zd, K=%zd, offa=%d, offb=%d!\n", M, N, K, offa, offb);
             }
         }
+
+        //
+        // Repeat the operation with the requantizing output stage.
+        //
+
+        uint8_t* Output = BufferOutput.GetBuffer(N * M);
+        uint8_t* OutputReference = BufferOutputReference.GetBuffer(N * M);
+        int32_t* Bias = BufferBias.GetBuffer(M);
+
+        MLAS_REQUANTIZE_OUTPUT Requantize;
+        Requantize.Output = Output;
+        Requantize.ldo = ldc;
+        Requantize.Bias = Bias;
+        Requantize.Scale = 1.0f / (float(K) * 64.0f);
+        Requantize.ZeroPoint = 117;
+
+        std::fill_n(C, M * N, -1);
+
+        MlasGemm(M, N, K, A, lda, offa, B, ldb, offb, C, ldc, &Requantize, threadpool);
+        ReferenceRequantize(M, N, CReference, ldc, Requantize, OutputReference);
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (Output[f] != OutputReference[f]) {
+                printf("requantize mismatch M=%zd, N=%zd, K=%zd, offa=%d, offb=%d!\n", M, N, K, offa, offb);
+                break;
+            }
+        }
+
+        //
+        // Repeat with a scale that takes the values beyond the int32 range,
+        // which must still saturate to the uint8 range.
+        //
+
+        Requantize.Scale = 65536.0f * 65536.0f;
+
+        std::fill_n(C, M * N, -1);
+
+        MlasGemm(M, N, K, A, lda, offa, B, ldb, offb, C, ldc, &Requantize, threadpool);
+        ReferenceRequantize(M, N, CReference, ldc, Requantize, OutputReference);
+
+        for (size_t f = 0; f < M * N; f++) {
+            if (Output[f] != OutputReference[f]) {
+                printf("requantize overflow mismatch M=%zd, N=%zd, K=%zd, offa=%d, offb=%d!\n", M, N, K, offa, offb);
+                break;
+            }
+        }
+    }
+
+    void
+    ReferenceRequantize(
+        size_t M,
+        size_t N,
+        const int32_t* C,
+        size_t ldc,
+        const MLAS_REQUANTIZE_OUTPUT& Requantize,
+        uint8_t* Output
+        )
+    {
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+                const float scaled = float(C[m * ldc + n] + Requantize.Bias[m]) * Requantize.Scale;
+                const float clamped = (std::min)(255.0f, (std::max)(0.0f, std::nearbyintf(scaled) + Requantize.ZeroPoint));
+                Output[m * Requantize.ldo + n] = uint8_t(clamped);
+            }
+        }
     }
 
     void
@@ -550,6 +727,9 @@ private:
     MatrixGuardBuffer<xint8_t> BufferB;
     MatrixGuardBuffer<int32_t> BufferC;
     MatrixGuardBuffer<int32_t> BufferCReference;
+    MatrixGuardBuffer<int32_t> BufferBias;
+    MatrixGuardBuffer<uint8_t> BufferOutput;
+    MatrixGuardBuffer<uint8_t> BufferOutputReference;
 
 public:
     void
@@ -1971,6 +2151,184 @@ public:
     }
 };
 
+class MlasSoftmaxTest : public MlasTestBase
+{
+private:
+    void
+    Test(
+        size_t N,
+        size_t D,
+        float MinimumValue,
+        float MaximumValue
+        )
+    {
+        float* Input = BufferInput.GetBuffer(N * D);
+        float* Output = BufferOutput.GetBuffer(N * D);
+        float* OutputReference = BufferOutputReference.GetBuffer(N * D);
+
+        for (size_t nd = 0; nd < N * D; nd++) {
+            Input[nd] = MinimumValue + (MaximumValue - MinimumValue) * float((nd * 7919) % 1009) / 1008.0f;
+        }
+
+        Test(Input, Output, OutputReference, N, D, false);
+        Test(Input, Output, OutputReference, N, D, true);
+    }
+
+    void
+    Test(
+        const float* Input,
+        float* Output,
+        float* OutputReference,
+        size_t N,
+        size_t D,
+        bool LogSoftmax
+        )
+    {
+        MlasComputeSoftmax(Input, Output, N, D, LogSoftmax, threadpool);
+        ReferenceSoftmax(Input, OutputReference, N, D, LogSoftmax);
+
+        constexpr float AbsoluteTolerance = 1e-6f;
+        constexpr float RelativeTolerance = 1e-5f;
+
+        for (size_t nd = 0; nd < N * D; nd++) {
+            float diff = std::fabs(Output[nd] - OutputReference[nd]);
+            if (diff > AbsoluteTolerance && diff > std::fabs(OutputReference[nd]) * RelativeTolerance) {
+                printf("mismatch LogSoftmax=%d, N=%zd, D=%zd, i=%zd  %f %f!\n", int(LogSoftmax), N, D, nd, Output[nd], OutputReference[nd]);
+                break;
+            }
+        }
+    }
+
+    void
+    ReferenceSoftmax(
+        const float* Input,
+        float* Output,
+        size_t N,
+        size_t D,
+        bool LogSoftmax
+        )
+    {
+        for (size_t n = 0; n < N; n++) {
+
+            float MaximumValue = std::numeric_limits<float>::lowest();
+
+            for (size_t d = 0; d < D; d++) {
+                MaximumValue = (std::max)(MaximumValue, Input[d]);
+            }
+
+            double Sum = 0.0;
+
+            for (size_t d = 0; d < D; d++) {
+                Sum += std::exp(double(Input[d]) - double(MaximumValue));
+            }
+
+            for (size_t d = 0; d < D; d++) {
+                if (LogSoftmax) {
+                    Output[d] = float(double(Input[d]) - double(MaximumValue) - std::log(Sum));
+                } else {
+                    Output[d] = float(std::exp(double(Input[d]) - double(MaximumValue)) / Sum);
+                }
+            }
+
+            Input += D;
+            Output += D;
+        }
+    }
+
+    MatrixGuardBuffer<float> BufferInput;
+    MatrixGuardBuffer<float> BufferOutput;
+    MatrixGuardBuffer<float> BufferOutputReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t d = 1; d < 128; d++) {
+            Test(1, d, -10.f, 10.f);
+            Test(3, d, 20.f, 30.f);
+            Test(63, d, -100.f, 0.f);
+        }
+        Test(768, 128, -5.f, 5.f);
+        Test(4, 4096, -100.f, 100.f);
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
+
+template<typename ElementType>
+class MlasTransposeTest : public MlasTestBase
+{
+private:
+    void
+    Test(
+        size_t M,
+        size_t N
+        )
+    {
+        ElementType* Input = BufferInput.GetBuffer(M * N);
+        ElementType* Output = BufferOutput.GetBuffer(M * N);
+        ElementType* OutputReference = BufferOutputReference.GetBuffer(M * N);
+
+        for (size_t mn = 0; mn < M * N; mn++) {
+            Input[mn] = ElementType(mn * 7919 + 17);
+        }
+
+        MlasTranspose(Input, N, Output, M, M, N);
+        ReferenceTranspose(Input, OutputReference, M, N);
+
+        if (memcmp(Output, OutputReference, M * N * sizeof(ElementType)) != 0) {
+            printf("mismatch: %zd,%zd (element size %zd)\n", M, N, sizeof(ElementType));
+        }
+    }
+
+    void
+    ReferenceTranspose(
+        const ElementType* Input,
+        ElementType* Output,
+        size_t M,
+        size_t N
+        )
+    {
+        for (size_t m = 0; m < M; m++) {
+            for (size_t n = 0; n < N; n++) {
+                Output[n * M + m] = Input[m * N + n];
+            }
+        }
+    }
+
+    MatrixGuardBuffer<ElementType> BufferInput;
+    MatrixGuardBuffer<ElementType> BufferOutput;
+    MatrixGuardBuffer<ElementType> BufferOutputReference;
+
+public:
+    void
+    ExecuteShort(
+        void
+        ) override
+    {
+        for (size_t m = 1; m <= 32; m++) {
+            for (size_t n = 1; n <= 32; n++) {
+                Test(m, n);
+            }
+        }
+        Test(197, 301);
+    }
+
+    void
+    ExecuteLong(
+        void
+        ) override
+    {
+    }
+};
+
 int
 #if defined(_WIN32)
 __cdecl
@@ -1983,6 +2341,7 @@ main(
 
         printf("SGEMM tests.\n");
         onnxruntime::make_unique<MlasFgemmTest<float>>()->ExecuteShort();
+        onnxruntime::make_unique<MlasSgemmPackedBTest>()->ExecuteShort();
 #ifdef MLAS_HAS_DGEMM
         printf("DGEMM tests.\n");
         onnxruntime::make_unique<MlasFgemmTest<double>>()->ExecuteShort();
@@ -2012,6 +2371,13 @@ main(
         printf("Activation tests.\n");
         onnxruntime::make_unique<MlasActivationTest>()->ExecuteShort();
 
+        printf("Softmax tests.\n");
+        onnxruntime::make_unique<MlasSoftmaxTest>()->ExecuteShort();
+
+        printf("Transpose tests.\n");
+        onnxruntime::make_unique<MlasTransposeTest<uint32_t>>()->ExecuteShort();
+        onnxruntime::make_unique<MlasTransposeTest<uint8_t>>()->ExecuteShort();
+
         printf("Done.\n");
 #if !defined(MLAS_NO_ONNXRUNTIME_THREADPOOL)
         if(threadpool != nullptr) threadpool = new onnxruntime::concurrency::ThreadPool("test", 2);
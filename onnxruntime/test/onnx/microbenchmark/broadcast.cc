@@ -0,0 +1,62 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <core/platform/threadpool.h>
+#include <core/providers/cpu/math/element_wise_ops.h>
+
+#include <memory>
+#include <vector>
+
+using namespace onnxruntime;
+using onnxruntime::concurrency::ThreadPool;
+
+// Broadcast patterns of Add, as {A shape, B shape}.
+static const std::vector<int64_t> kBroadcastShapes[][2] = {
+    {{128, 768, 64}, {128, 768, 64}},    // same shape
+    {{128, 768, 64}, {}},                // scalar
+    {{128 * 64, 768}, {768}},            // matrix row, e.g. a bias add
+    {{8, 256, 56, 56}, {1, 256, 1, 1}},  // per channel of NCHW
+    {{2048, 1}, {1, 3072}},              // outer
+};
+
+static std::unique_ptr<ThreadPool> CreateThreadPool(int threads) {
+  return threads > 0 ? std::unique_ptr<ThreadPool>(new ThreadPool("bench", threads)) : nullptr;
+}
+
+static void BM_BroadcastAdd(benchmark::State& state) {
+  const auto& shapes = kBroadcastShapes[state.range(0)];
+  auto tp = CreateThreadPool(static_cast<int>(state.range(1)));
+  const OrtMemoryInfo cpu_info(CPU, OrtDeviceAllocator);
+
+  TensorShape a_shape(shapes[0]), b_shape(shapes[1]);
+  std::vector<float> a(a_shape.Size(), 1.0f), b(b_shape.Size(), 2.0f);
+  Tensor a_tensor(DataTypeImpl::GetType<float>(), a_shape, a.data(), cpu_info);
+  Tensor b_tensor(DataTypeImpl::GetType<float>(), b_shape, b.data(), cpu_info);
+
+  TBroadcaster<float, float> bc(a_tensor, b_tensor);
+  TensorShape c_shape = bc.GetOutputShape();
+  std::vector<float> c(c_shape.Size());
+  Tensor c_tensor(DataTypeImpl::GetType<float>(), c_shape, c.data(), cpu_info);
+
+  for (auto _ : state) {
+    TBroadcaster<float, float> run_bc(a_tensor, b_tensor);
+    ParallelBroadcastLoop<float>(
+        run_bc, c_tensor, tp.get(), 1.0,
+        [](EigenVectorMap<float> output, float input0, ConstEigenVectorMap<float> input1) { output = input0 + input1.array(); },
+        [](EigenVectorMap<float> output, ConstEigenVectorMap<float> input0, float input1) { output = input0.array() + input1; },
+        [](EigenVectorMap<float> output, ConstEigenVectorMap<float> input0, ConstEigenVectorMap<float> input1) { output = input0 + input1; });
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * c_shape.Size());
+}
+
+static void BroadcastArgs(benchmark::internal::Benchmark* b) {
+  for (int shape = 0; shape < 5; ++shape) {
+    for (int threads : {0, 2, 4, 8}) {
+      b->Args({shape, threads});
+    }
+  }
+}
+
+BENCHMARK(BM_BroadcastAdd)->Apply(BroadcastArgs)->UseRealTime();
@@ -0,0 +1,125 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <core/framework/tensor.h>
+#include <core/graph/model.h>
+#include <core/session/inference_session.h>
+
+#include <string>
+#include <vector>
+
+using namespace onnxruntime;
+
+// A wide graph in the shape of a multi-tower model: one long branch of MatMul + Relu pairs and several
+// short ones, all summed at the end. The ParallelExecutor should keep the long branch busy while the short
+// branches fill in the other threads.
+static const int64_t kRows = 16;
+static const int64_t kCols = 256;
+
+static std::string CreateWideModel(int branches, int long_branch_length, int short_branch_length) {
+  onnxruntime::Model model("wide");
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kRows);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kCols);
+
+  ONNX_NAMESPACE::TensorProto weights;
+  weights.set_name("W");
+  weights.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  weights.add_dims(kCols);
+  weights.add_dims(kCols);
+  for (int64_t i = 0; i < kCols * kCols; ++i) {
+    weights.add_float_data(static_cast<float>(i % 7) / (7.0f * kCols));
+  }
+  graph.AddInitializedTensor(weights);
+
+  auto& input = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& w = graph.GetOrCreateNodeArg("W", nullptr);
+
+  std::vector<NodeArg*> branch_outputs;
+  for (int b = 0; b < branches; ++b) {
+    const int length = b == 0 ? long_branch_length : short_branch_length;
+    NodeArg* prev = &input;
+    for (int i = 0; i < length; ++i) {
+      const std::string name = "b" + std::to_string(b) + "_" + std::to_string(i);
+      auto& matmul_out = graph.GetOrCreateNodeArg(name + "_matmul", &float_tensor);
+      auto& relu_out = graph.GetOrCreateNodeArg(name + "_relu", &float_tensor);
+      graph.AddNode(name + "_MatMul", "MatMul", "", {prev, &w}, {&matmul_out});
+      graph.AddNode(name + "_Relu", "Relu", "", {&matmul_out}, {&relu_out});
+      prev = &relu_out;
+    }
+    branch_outputs.push_back(prev);
+  }
+
+  auto& output = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("Sum", "Sum", "", branch_outputs, {&output});
+
+  if (!graph.Resolve().IsOK()) {
+    return {};
+  }
+
+  std::string serialized;
+  model.ToProto().SerializeToString(&serialized);
+  return serialized;
+}
+
+static void BM_WideModelExecutor(benchmark::State& state) {
+  const int branches = static_cast<int>(state.range(0));
+  const bool parallel = state.range(1) != 0;
+  const int inter_op_threads = static_cast<int>(state.range(2));
+
+  const std::string model_data = CreateWideModel(branches, 16, 2);
+  if (model_data.empty()) {
+    state.SkipWithError("failed to create the model");
+    return;
+  }
+
+  SessionOptions so;
+  so.session_logid = "BM_WideModelExecutor";
+  so.execution_mode = parallel ? ExecutionMode::ORT_PARALLEL : ExecutionMode::ORT_SEQUENTIAL;
+  so.intra_op_num_threads = 1;
+  so.inter_op_num_threads = inter_op_threads;
+
+  InferenceSession session{so};
+  auto status = session.Load(model_data.data(), static_cast<int>(model_data.size()));
+  if (status.IsOK()) {
+    status = session.Initialize();
+  }
+  if (!status.IsOK()) {
+    state.SkipWithError(status.ErrorMessage().c_str());
+    return;
+  }
+
+  const OrtMemoryInfo cpu_info(CPU, OrtDeviceAllocator);
+  std::vector<float> x(kRows * kCols, 1.0f);
+  auto x_tensor = onnxruntime::make_unique<Tensor>(DataTypeImpl::GetType<float>(), TensorShape({kRows, kCols}),
+                                                   x.data(), cpu_info);
+  OrtValue x_value;
+  x_value.Init(x_tensor.release(), DataTypeImpl::GetType<Tensor>(), DataTypeImpl::GetType<Tensor>()->GetDeleteFunc());
+
+  NameMLValMap feeds{{"X", x_value}};
+  std::vector<std::string> output_names{"Y"};
+
+  for (auto _ : state) {
+    std::vector<OrtValue> fetches;
+    status = session.Run(feeds, output_names, &fetches);
+    if (!status.IsOK()) {
+      state.SkipWithError(status.ErrorMessage().c_str());
+      break;
+    }
+  }
+}
+
+static void WideModelArgs(benchmark::internal::Benchmark* b) {
+  for (int branches : {4, 8, 16}) {
+    b->Args({branches, 0, 1});
+    for (int threads : {2, 4, 8}) {
+      b->Args({branches, 1, threads});
+    }
+  }
+}
+
+BENCHMARK(BM_WideModelExecutor)->Apply(WideModelArgs)->ArgNames({"branches", "parallel", "threads"})->UseRealTime();
@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <core/platform/threadpool.h>
+#include <core/providers/cpu/reduction/reduction_ops.h>
+
+#include <memory>
+#include <vector>
+
+using namespace onnxruntime;
+using onnxruntime::concurrency::ThreadPool;
+
+// Shapes as [outer, reduced, inner]:
+//   0: innermost, e.g. the mean over the hidden size of a BERT layer
+//   1: outermost, e.g. a bias gradient summed over the batch
+//   2: strided middle axis, e.g. a mean over H of an NHWC tensor
+static const FastReduceShape kReduceShapes[] = {
+    {64 * 128, 768, 1},
+    {1, 4096, 1024},
+    {16, 256, 256},
+};
+
+static std::unique_ptr<ThreadPool> CreateThreadPool(int threads) {
+  return threads > 0 ? std::unique_ptr<ThreadPool>(new ThreadPool("bench", threads)) : nullptr;
+}
+
+// The previous approach: copy the reduced axes to the head, then reduce on one thread.
+static void BM_ReduceSum_Transpose(benchmark::State& state) {
+  const FastReduceShape& shape = kReduceShapes[state.range(0)];
+  const int64_t kept = shape.outer * shape.inner;
+  std::vector<float> input(kept * shape.reduced, 1.0f);
+  std::vector<float> transposed(input.size());
+  std::vector<float> output(kept);
+  for (auto _ : state) {
+    for (int64_t o = 0; o < shape.outer; ++o) {
+      for (int64_t r = 0; r < shape.reduced; ++r) {
+        const float* from = input.data() + (o * shape.reduced + r) * shape.inner;
+        float* to = transposed.data() + r * kept + o * shape.inner;
+        std::copy(from, from + shape.inner, to);
+      }
+    }
+    EigenVectorMap<float>(output.data(), kept) =
+        ConstEigenMatrixMap<float>(transposed.data(), kept, shape.reduced).rowwise().sum();
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(input.size()));
+}
+
+static void BM_ReduceSum_NoTranspose(benchmark::State& state) {
+  const FastReduceShape& shape = kReduceShapes[state.range(0)];
+  auto tp = CreateThreadPool(static_cast<int>(state.range(1)));
+  std::vector<float> input(shape.outer * shape.reduced * shape.inner, 1.0f);
+  std::vector<float> output(shape.outer * shape.inner);
+  for (auto _ : state) {
+    NoTransposeReduce<float, ReduceAggregatorSum<float>>(input.data(), shape, output.data(), tp.get());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(input.size()));
+}
+
+static void BM_ReduceMax_NoTranspose(benchmark::State& state) {
+  const FastReduceShape& shape = kReduceShapes[state.range(0)];
+  auto tp = CreateThreadPool(static_cast<int>(state.range(1)));
+  std::vector<float> input(shape.outer * shape.reduced * shape.inner, 1.0f);
+  std::vector<float> output(shape.outer * shape.inner);
+  for (auto _ : state) {
+    NoTransposeReduce<float, ReduceAggregatorMax<float>>(input.data(), shape, output.data(), tp.get());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(input.size()));
+}
+
+static void ReduceArgs(benchmark::internal::Benchmark* b) {
+  for (int shape = 0; shape < 3; ++shape) {
+    for (int threads : {0, 2, 4, 8}) {
+      b->Args({shape, threads});
+    }
+  }
+}
+
+BENCHMARK(BM_ReduceSum_Transpose)->DenseRange(0, 2)->UseRealTime();
+BENCHMARK(BM_ReduceSum_NoTranspose)->Apply(ReduceArgs)->UseRealTime();
+BENCHMARK(BM_ReduceMax_NoTranspose)->Apply(ReduceArgs)->UseRealTime();
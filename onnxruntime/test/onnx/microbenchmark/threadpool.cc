@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <benchmark/benchmark.h>
+#include <core/platform/threadpool.h>
+
+#include <cmath>
+#include <functional>
+#include <vector>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#else
+#pragma warning(push)
+#pragma warning(disable : 4267)
+#endif
+#include <unsupported/Eigen/CXX11/src/ThreadPool/Barrier.h>
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#else
+#pragma warning(pop)
+#endif
+
+using onnxruntime::concurrency::ThreadPool;
+
+// Approximate cost in cycles of one iteration of ComputeElement
+static constexpr double kElementCost = 20.0;
+
+static inline void ComputeElement(float* data, std::ptrdiff_t i) {
+  data[i] = std::tanh(data[i] * 0.5f + 0.25f);
+}
+
+// The scheduling strategy used before ParallelFor took a cost model:
+// one task per iteration, synchronized on a barrier.
+static void LegacyParallelFor(ThreadPool& tp, int32_t total, const std::function<void(int32_t)>& fn) {
+  Eigen::Barrier barrier(static_cast<unsigned int>(total - 1));
+  for (int32_t id = 1; id < total; ++id) {
+    tp.Schedule([id, &fn, &barrier]() {
+      fn(id);
+      barrier.Notify();
+    });
+  }
+  fn(0);
+  barrier.Wait();
+}
+
+static void BM_ThreadPool_LegacyParallelFor(benchmark::State& state) {
+  const int32_t total = static_cast<int32_t>(state.range(0));
+  ThreadPool tp("bench", static_cast<int>(state.range(1)));
+  std::vector<float> data(total, 1.0f);
+  for (auto _ : state) {
+    LegacyParallelFor(tp, total, [&data](int32_t i) { ComputeElement(data.data(), i); });
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * total);
+}
+
+static void BM_ThreadPool_ParallelFor(benchmark::State& state) {
+  const std::ptrdiff_t total = static_cast<std::ptrdiff_t>(state.range(0));
+  ThreadPool tp("bench", static_cast<int>(state.range(1)));
+  std::vector<float> data(total, 1.0f);
+  for (auto _ : state) {
+    tp.ParallelFor(total, kElementCost, [&data](std::ptrdiff_t first, std::ptrdiff_t last) {
+      for (std::ptrdiff_t i = first; i < last; ++i) ComputeElement(data.data(), i);
+    });
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * total);
+}
+
+static void ParallelForArgs(benchmark::internal::Benchmark* b) {
+  for (int threads : {2, 4, 8}) {
+    for (int total : {16, 256, 4096, 65536, 1 << 20}) {
+      b->Args({total, threads});
+    }
+  }
+}
+
+BENCHMARK(BM_ThreadPool_LegacyParallelFor)->Apply(ParallelForArgs)->UseRealTime();
+BENCHMARK(BM_ThreadPool_ParallelFor)->Apply(ParallelForArgs)->UseRealTime();
@@ -15,6 +15,8 @@
 #include "core/optimizer/dropout_elimination.h"
 #include "core/optimizer/gemm_activation_fusion.h"
 #include "core/optimizer/gelu_fusion.h"
+#include "core/optimizer/attention_fusion.h"
+#include "core/optimizer/layer_norm_fusion.h"
 #include "core/optimizer/graph_transformer.h"
 #include "core/optimizer/graph_transformer_mgr.h"
 #include "core/optimizer/identity_elimination.h"
@@ -729,17 +731,17 @@ TEST(GraphTransformationTests, ReluClip11Fusion) {
         if (&node == &clip1) {
           // fusion with float16 data and min set to 0
           EXPECT_EQ(type, ONNX_NAMESPACE::TensorProto::DataType::TensorProto_DataType_FLOAT16);
-          MLFloat16 value = *Initializer(*min_input).data<MLFloat16>();
+          MLFloat16 value = *Initializer(*min_input, graph.ModelPath()).data<MLFloat16>();
           EXPECT_EQ(math::halfToFloat(value.val), 0.f) << "Min was not 0.f. Got:" << math::halfToFloat(value.val);
         } else if (&node == &clip2) {
           // fusion with float data and min untouched
           EXPECT_EQ(type, ONNX_NAMESPACE::TensorProto::DataType::TensorProto_DataType_FLOAT);
-          float value = *Initializer(*min_input).data<float>();
+          float value = *Initializer(*min_input, graph.ModelPath()).data<float>();
           EXPECT_EQ(value, 1.0) << "Min should have remained unchanged but is now " << value;
         } else if (&node == &clip3) {
           // fusion with no min so type comes from input
           EXPECT_EQ(type, ONNX_NAMESPACE::TensorProto::DataType::TensorProto_DataType_FLOAT);
-          float value = *Initializer(*min_input).data<float>();
+          float value = *Initializer(*min_input, graph.ModelPath()).data<float>();
           EXPECT_EQ(value, 0.f) << "Min was not 0.f. Got:" << value;
 
         } else {
@@ -769,6 +771,339 @@ TEST(GraphTransformationTests, GeluFusionTest) {
   ASSERT_TRUE(op_to_count["Mul"] == 0);
   ASSERT_TRUE(op_to_count["Gelu"] == 1);
 }
+
+static NodeArg& AddFloatInitializer(Graph& graph, const std::string& name, const std::vector<int64_t>& dims,
+                                    float value) {
+  Initializer initializer(TensorProto_DataType_FLOAT, name, dims);
+  std::fill_n(initializer.data<float>(), initializer.size(), value);
+  TensorProto tensor_proto;
+  initializer.ToProto(tensor_proto);
+  return graph_utils::AddInitializer(graph, tensor_proto);
+}
+
+static NodeArg& AddShapeInitializer(Graph& graph, const std::string& name, const std::vector<int64_t>& shape) {
+  TensorProto tensor_proto;
+  tensor_proto.set_name(name);
+  tensor_proto.set_data_type(TensorProto_DataType_INT64);
+  tensor_proto.add_dims(static_cast<int64_t>(shape.size()));
+  for (int64_t dim : shape) {
+    tensor_proto.add_int64_data(dim);
+  }
+  return graph_utils::AddInitializer(graph, tensor_proto);
+}
+
+// Adds the self attention subgraph of a BERT layer as exported from PyTorch, and returns its output.
+static NodeArg& AddBertSelfAttention(Graph& graph, NodeArg& input, NodeArg& additive_mask,
+                                     int64_t num_heads, int64_t head_size, const std::string& prefix) {
+  const int64_t hidden_size = num_heads * head_size;
+  auto& head_shape = AddShapeInitializer(graph, prefix + "head_shape", {0, 0, num_heads, head_size});
+  auto& output_shape = AddShapeInitializer(graph, prefix + "output_shape", {0, 0, hidden_size});
+  auto& scale = AddFloatInitializer(graph, prefix + "scale", {}, std::sqrt(static_cast<float>(head_size)));
+
+  NodeArg* heads[3];
+  const std::string head_names[] = {"query", "key", "value"};
+  for (int i = 0; i < 3; i++) {
+    const std::string name = prefix + head_names[i];
+    auto& weight = AddFloatInitializer(graph, name + "_weight", {hidden_size, hidden_size}, 0.1f * (i + 1));
+    auto& bias = AddFloatInitializer(graph, name + "_bias", {hidden_size}, 0.5f);
+    auto& matmul_out = graph.GetOrCreateNodeArg(name + "_matmul_out", nullptr);
+    auto& add_out = graph.GetOrCreateNodeArg(name + "_add_out", nullptr);
+    auto& reshape_out = graph.GetOrCreateNodeArg(name + "_reshape_out", nullptr);
+    auto& transpose_out = graph.GetOrCreateNodeArg(name + "_transpose_out", nullptr);
+    graph.AddNode(name + "_matmul", "MatMul", "", {&input, &weight}, {&matmul_out});
+    graph.AddNode(name + "_add", "Add", "", {&matmul_out, &bias}, {&add_out});
+    graph.AddNode(name + "_reshape", "Reshape", "", {&add_out, &head_shape}, {&reshape_out});
+    auto& transpose = graph.AddNode(name + "_transpose", "Transpose", "", {&reshape_out}, {&transpose_out});
+    transpose.AddAttribute("perm", i == 1 ? std::vector<int64_t>{0, 2, 3, 1} : std::vector<int64_t>{0, 2, 1, 3});
+    heads[i] = &transpose_out;
+  }
+
+  auto& qk_out = graph.GetOrCreateNodeArg(prefix + "qk_out", nullptr);
+  auto& div_out = graph.GetOrCreateNodeArg(prefix + "div_out", nullptr);
+  auto& add_mask_out = graph.GetOrCreateNodeArg(prefix + "add_mask_out", nullptr);
+  auto& softmax_out = graph.GetOrCreateNodeArg(prefix + "softmax_out", nullptr);
+  auto& context_out = graph.GetOrCreateNodeArg(prefix + "context_out", nullptr);
+  auto& transpose_out = graph.GetOrCreateNodeArg(prefix + "transpose_out", nullptr);
+  auto& output = graph.GetOrCreateNodeArg(prefix + "output", nullptr);
+  graph.AddNode(prefix + "qk", "MatMul", "", {heads[0], heads[1]}, {&qk_out});
+  graph.AddNode(prefix + "div", "Div", "", {&qk_out, &scale}, {&div_out});
+  graph.AddNode(prefix + "add_mask", "Add", "", {&div_out, &additive_mask}, {&add_mask_out});
+  auto& softmax = graph.AddNode(prefix + "softmax", "Softmax", "", {&add_mask_out}, {&softmax_out});
+  softmax.AddAttribute("axis", static_cast<int64_t>(3));
+  graph.AddNode(prefix + "context", "MatMul", "", {&softmax_out, heads[2]}, {&context_out});
+  auto& transpose = graph.AddNode(prefix + "transpose", "Transpose", "", {&context_out}, {&transpose_out});
+  transpose.AddAttribute("perm", std::vector<int64_t>{0, 2, 1, 3});
+  graph.AddNode(prefix + "reshape", "Reshape", "", {&transpose_out, &output_shape}, {&output});
+  return output;
+}
+
+static NodeArg& AddMaskInitializer(Graph& graph, const std::string& name, const std::vector<int64_t>& dims,
+                                   const std::vector<int64_t>& values) {
+  TensorProto tensor_proto;
+  tensor_proto.set_name(name);
+  tensor_proto.set_data_type(TensorProto_DataType_INT64);
+  for (int64_t dim : dims) {
+    tensor_proto.add_dims(dim);
+  }
+  for (int64_t value : values) {
+    tensor_proto.add_int64_data(value);
+  }
+  return graph_utils::AddInitializer(graph, tensor_proto);
+}
+
+// Adds two BERT self attention layers sharing the additive mask
+// Mul(Sub(1, Cast(Unsqueeze(Unsqueeze(mask)))), mask_filter_value).
+static void AddBertSelfAttentionLayers(Graph& graph, NodeArg& mask, float mask_filter_value,
+                                       int64_t num_heads, int64_t head_size) {
+  TypeProto input_type;
+  input_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch_size");
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("sequence_length");
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(num_heads * head_size);
+  auto& input = graph.GetOrCreateNodeArg("input", &input_type);
+
+  auto& one = AddFloatInitializer(graph, "one", {}, 1.0f);
+  auto& mask_filter = AddFloatInitializer(graph, "mask_filter_value", {}, mask_filter_value);
+  auto& unsqueeze1_out = graph.GetOrCreateNodeArg("unsqueeze1_out", nullptr);
+  auto& unsqueeze2_out = graph.GetOrCreateNodeArg("unsqueeze2_out", nullptr);
+  auto& cast_out = graph.GetOrCreateNodeArg("cast_out", nullptr);
+  auto& sub_out = graph.GetOrCreateNodeArg("sub_out", nullptr);
+  auto& additive_mask = graph.GetOrCreateNodeArg("additive_mask", nullptr);
+  auto& unsqueeze1 = graph.AddNode("unsqueeze1", "Unsqueeze", "", {&mask}, {&unsqueeze1_out});
+  unsqueeze1.AddAttribute("axes", std::vector<int64_t>{1});
+  auto& unsqueeze2 = graph.AddNode("unsqueeze2", "Unsqueeze", "", {&unsqueeze1_out}, {&unsqueeze2_out});
+  unsqueeze2.AddAttribute("axes", std::vector<int64_t>{2});
+  auto& cast = graph.AddNode("cast", "Cast", "", {&unsqueeze2_out}, {&cast_out});
+  cast.AddAttribute("to", static_cast<int64_t>(TensorProto_DataType_FLOAT));
+  graph.AddNode("sub", "Sub", "", {&one, &cast_out}, {&sub_out});
+  graph.AddNode("mul", "Mul", "", {&sub_out, &mask_filter}, {&additive_mask});
+
+  auto& layer1_output = AddBertSelfAttention(graph, input, additive_mask, num_heads, head_size, "layer1_");
+  AddBertSelfAttention(graph, layer1_output, additive_mask, num_heads, head_size, "layer2_");
+
+  auto status = graph.Resolve();
+  ASSERT_EQ(status, Status::OK());
+}
+
+// Adds the layers of AddBertSelfAttentionLayers and applies AttentionFusion.
+static void FuseBertSelfAttention(Graph& graph, NodeArg& mask, float mask_filter_value,
+                                  int64_t num_heads, int64_t head_size) {
+  ASSERT_NO_FATAL_FAILURE(AddBertSelfAttentionLayers(graph, mask, mask_filter_value, num_heads, head_size));
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<AttentionFusion>(), TransformerLevel::Level2);
+  auto ret = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2);
+  ASSERT_TRUE(ret.IsOK());
+}
+
+TEST(GraphTransformationTests, AttentionFusionTest) {
+  Model model("AttentionFusion");
+  auto& graph = model.MainGraph();
+
+  const int64_t num_heads = 2;
+  const int64_t head_size = 4;
+
+  auto& mask = AddMaskInitializer(graph, "mask", {2, 4}, {1, 1, 1, 0, 0, 1, 1, 0});
+  FuseBertSelfAttention(graph, mask, -10000.0f, num_heads, head_size);
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["Attention"] == 2);
+  ASSERT_TRUE(op_to_count["MatMul"] == 0);
+  ASSERT_TRUE(op_to_count["Add"] == 0);
+  ASSERT_TRUE(op_to_count["Reshape"] == 0);
+  ASSERT_TRUE(op_to_count["Transpose"] == 0);
+  ASSERT_TRUE(op_to_count["Softmax"] == 0);
+  ASSERT_TRUE(op_to_count["Unsqueeze"] == 0);
+  ASSERT_TRUE(op_to_count["Sub"] == 0);
+  ASSERT_TRUE(op_to_count["Mul"] == 0);
+
+  // The int64 mask is cast to int32 once for both layers.
+  ASSERT_TRUE(op_to_count["Cast"] == 1);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "Attention") {
+      ASSERT_EQ(graph_utils::GetNodeAttribute(node, "num_heads")->i(), num_heads);
+      const auto* weight = graph_utils::GetConstantInitializer(graph, node.InputDefs()[1]->Name());
+      ASSERT_TRUE(weight != nullptr);
+      ASSERT_EQ(weight->dims(0), num_heads * head_size);
+      ASSERT_EQ(weight->dims(1), 3 * num_heads * head_size);
+    }
+  }
+}
+
+static NodeArg& AddMaskInput(Graph& graph, const std::string& name) {
+  TypeProto mask_type;
+  mask_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_INT64);
+  mask_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch_size");
+  mask_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("sequence_length");
+  return graph.GetOrCreateNodeArg(name, &mask_type);
+}
+
+TEST(GraphTransformationTests, AttentionFusionMask) {
+  // a mask given at run time is passed to Attention as it is
+  {
+    Model model("AttentionFusion");
+    auto& graph = model.MainGraph();
+    FuseBertSelfAttention(graph, AddMaskInput(graph, "mask"), -10000.0f, 2, 4);
+    ASSERT_EQ(CountOpsInGraph(graph)["Attention"], 2);
+  }
+
+  // Attention masks the scores with -10000, so a subgraph using another value is left alone
+  {
+    Model model("AttentionFusion");
+    auto& graph = model.MainGraph();
+    FuseBertSelfAttention(graph, AddMaskInput(graph, "mask"), -1.0f, 2, 4);
+    ASSERT_EQ(CountOpsInGraph(graph)["Attention"], 0);
+  }
+}
+
+class InferenceSessionGetGraphWrapper : public InferenceSession {
+ public:
+  explicit InferenceSessionGetGraphWrapper(const SessionOptions& session_options,
+                                           logging::LoggingManager* logging_manager)
+      : InferenceSession(session_options, logging_manager) {}
+
+  const Graph& GetGraph() {
+    return model_->MainGraph();
+  }
+};
+
+// BERT feeds the attention mask as a graph input, which constant folding leaves alone, so the subgraph is fused
+// by a session at the optimization level the session APIs default to, and computes the same output.
+TEST(GraphTransformationTests, AttentionFusionInSession) {
+  const int64_t num_heads = 2;
+  const int64_t head_size = 4;
+  const int64_t hidden_size = num_heads * head_size;
+  Model model("AttentionFusion");
+  auto& graph = model.MainGraph();
+  ASSERT_NO_FATAL_FAILURE(AddBertSelfAttentionLayers(graph, AddMaskInput(graph, "mask"), -10000.0f,
+                                                     num_heads, head_size));
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+
+  // padded on either side, and fully masked
+  const std::vector<int64_t> mask_dims = {3, 4};
+  const std::vector<int64_t> mask_values = {1, 1, 1, 0, 0, 0, 1, 1, 0, 0, 0, 0};
+  const std::vector<int64_t> input_dims = {3, 4, hidden_size};
+  std::vector<float> input_values(3 * 4 * hidden_size);
+  for (size_t i = 0; i < input_values.size(); i++) {
+    input_values[i] = static_cast<float>(i % 11) / 10.0f - 0.5f;
+  }
+  OrtValue input, mask;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), input_dims, input_values,
+                       &input);
+  CreateMLValue<int64_t>(TestCPUExecutionProvider()->GetAllocator(0, OrtMemTypeDefault), mask_dims, mask_values,
+                         &mask);
+  NameMLValMap feeds{{"input", input}, {"mask", mask}};
+
+  std::vector<float> expected_values;
+  for (TransformerLevel level : {TransformerLevel::Level1, TransformerLevel::Level3}) {
+    SessionOptions so;
+    so.session_logid = "GraphTransformationTests.AttentionFusionInSession";
+    so.graph_optimization_level = level;
+    InferenceSessionGetGraphWrapper session_object{so, &DefaultLoggingManager()};
+    auto status = session_object.Load(model_data.data(), static_cast<int>(model_data.size()));
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    status = session_object.Initialize();
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    ASSERT_EQ(CountOpsInGraph(session_object.GetGraph())["Attention"], level == TransformerLevel::Level1 ? 0 : 2);
+
+    std::vector<OrtValue> fetches;
+    status = session_object.Run(RunOptions{}, feeds, {"layer2_output"}, &fetches);
+    ASSERT_TRUE(status.IsOK()) << status.ErrorMessage();
+    const auto& output = fetches[0].Get<Tensor>();
+    ASSERT_EQ(output.Shape(), TensorShape(input_dims));
+    const std::vector<float> values(output.Data<float>(), output.Data<float>() + output.Shape().Size());
+    if (level == TransformerLevel::Level1) {
+      expected_values = values;
+      continue;
+    }
+    for (size_t i = 0; i < values.size(); i++) {
+      EXPECT_NEAR(values[i], expected_values[i], 1e-4f * std::max(1.0f, std::abs(expected_values[i]))) << i;
+    }
+  }
+}
+
+TEST(GraphTransformationTests, LayerNormFusionTest) {
+  Model model("LayerNormFusion");
+  auto& graph = model.MainGraph();
+
+  const int64_t hidden_size = 8;
+
+  TypeProto input_type;
+  input_type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch_size");
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("sequence_length");
+  input_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(hidden_size);
+
+  auto& input = graph.GetOrCreateNodeArg("input", &input_type);
+  auto& skip = graph.GetOrCreateNodeArg("skip", &input_type);
+  auto& exponent = AddFloatInitializer(graph, "exponent", {}, 2.0f);
+  auto& epsilon = AddFloatInitializer(graph, "epsilon", {}, 1e-12f);
+  auto& gamma = AddFloatInitializer(graph, "gamma", {hidden_size}, 1.5f);
+  auto& beta = AddFloatInitializer(graph, "beta", {hidden_size}, 0.5f);
+
+  // The residual Add followed by LayerNorm as exported from PyTorch:
+  // (x - mean(x)) / sqrt(mean((x - mean(x)) ^ 2) + epsilon) * gamma + beta
+  auto& residual_out = graph.GetOrCreateNodeArg("residual_out", nullptr);
+  auto& mean_out = graph.GetOrCreateNodeArg("mean_out", nullptr);
+  auto& sub_out = graph.GetOrCreateNodeArg("sub_out", nullptr);
+  auto& pow_out = graph.GetOrCreateNodeArg("pow_out", nullptr);
+  auto& variance_out = graph.GetOrCreateNodeArg("variance_out", nullptr);
+  auto& add_epsilon_out = graph.GetOrCreateNodeArg("add_epsilon_out", nullptr);
+  auto& sqrt_out = graph.GetOrCreateNodeArg("sqrt_out", nullptr);
+  auto& div_out = graph.GetOrCreateNodeArg("div_out", nullptr);
+  auto& mul_out = graph.GetOrCreateNodeArg("mul_out", nullptr);
+  auto& output = graph.GetOrCreateNodeArg("output", nullptr);
+  graph.AddNode("residual", "Add", "", {&input, &skip}, {&residual_out});
+  auto& mean = graph.AddNode("mean", "ReduceMean", "", {&residual_out}, {&mean_out});
+  mean.AddAttribute("axes", std::vector<int64_t>{-1});
+  graph.AddNode("sub", "Sub", "", {&residual_out, &mean_out}, {&sub_out});
+  graph.AddNode("pow", "Pow", "", {&sub_out, &exponent}, {&pow_out});
+  auto& variance = graph.AddNode("variance", "ReduceMean", "", {&pow_out}, {&variance_out});
+  variance.AddAttribute("axes", std::vector<int64_t>{-1});
+  graph.AddNode("add_epsilon", "Add", "", {&variance_out, &epsilon}, {&add_epsilon_out});
+  graph.AddNode("sqrt", "Sqrt", "", {&add_epsilon_out}, {&sqrt_out});
+  graph.AddNode("div", "Div", "", {&sub_out, &sqrt_out}, {&div_out});
+  graph.AddNode("mul", "Mul", "", {&gamma, &div_out}, {&mul_out});
+  graph.AddNode("add_beta", "Add", "", {&mul_out, &beta}, {&output});
+
+  auto status = graph.Resolve();
+  EXPECT_EQ(status, Status::OK());
+
+  onnxruntime::GraphTransformerManager graph_transformation_mgr{5};
+  graph_transformation_mgr.Register(onnxruntime::make_unique<LayerNormFusion>(), TransformerLevel::Level2);
+  auto ret = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2);
+  ASSERT_TRUE(ret.IsOK());
+
+  std::map<std::string, int> op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["ReduceMean"] == 0);
+  ASSERT_TRUE(op_to_count["Sub"] == 0);
+  ASSERT_TRUE(op_to_count["Pow"] == 0);
+  ASSERT_TRUE(op_to_count["Sqrt"] == 0);
+  ASSERT_TRUE(op_to_count["Div"] == 0);
+  ASSERT_TRUE(op_to_count["Mul"] == 0);
+  ASSERT_TRUE(op_to_count["Add"] == 1);
+  ASSERT_TRUE(op_to_count["LayerNormalization"] == 1);
+
+  for (auto& node : graph.Nodes()) {
+    if (node.OpType() == "LayerNormalization") {
+      ASSERT_EQ(node.InputDefs()[1]->Name(), "gamma");
+      ASSERT_EQ(node.InputDefs()[2]->Name(), "beta");
+      ASSERT_EQ(graph_utils::GetNodeAttribute(node, "epsilon")->f(), 1e-12f);
+    }
+  }
+
+  // The residual Add is then folded into the normalization.
+  graph_transformation_mgr.Register(onnxruntime::make_unique<SkipLayerNormFusion>(), TransformerLevel::Level2);
+  ret = graph_transformation_mgr.ApplyTransformers(graph, TransformerLevel::Level2);
+  ASSERT_TRUE(ret.IsOK());
+
+  op_to_count = CountOpsInGraph(graph);
+  ASSERT_TRUE(op_to_count["Add"] == 0);
+  ASSERT_TRUE(op_to_count["LayerNormalization"] == 0);
+  ASSERT_TRUE(op_to_count["SkipLayerNormalization"] == 1);
+}
 #endif
 
 }  // namespace test
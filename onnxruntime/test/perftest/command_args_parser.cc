@@ -4,7 +4,9 @@
 #include "command_args_parser.h"
 
 #include <string.h>
+#include <climits>
 #include <iostream>
+#include <thread>
 
 // Windows Specific
 #ifdef _WIN32
@@ -17,6 +19,7 @@
 #include <core/graph/constants.h>
 #include <core/framework/path_lib.h>
 #include <core/optimizer/graph_transformer_level.h>
+#include <core/platform/env.h>
 
 #include "test_configuration.h"
 
@@ -31,6 +34,8 @@ namespace perftest {
       "\t\tProvide 'duration' to run the test for a fix duration, and 'times' to repeated for a certain times. \n"
       "\t-M: Disable memory pattern.\n"
       "\t-A: Disable memory arena\n"
+      "\t-F: Reuse execution frames across runs. Combine with -c to measure contention on a single session.\n"
+      "\t-R: Allocate the intermediate values of each run from a per-run arena.\n"
       "\t-c [parallel runs]: Specifies the (max) number of runs to invoke simultaneously. Default:1.\n"
       "\t-e [cpu|cuda|mkldnn|tensorrt|ngraph|openvino|nuphar|dml]: Specifies the provider 'cpu','cuda','mkldnn','tensorrt', "
       "'ngraph', 'openvino' or 'nuphar' or 'dml'. "
@@ -43,15 +48,30 @@ namespace perftest {
       "\t-v: Show verbose information.\n"
       "\t-x [intra_op_num_threads]: Sets the number of threads used to parallelize the execution within nodes, A value of 0 means ORT will pick a default. Must >=0.\n"
       "\t-y [inter_op_num_threads]: Sets the number of threads used to parallelize the execution of the graph (across nodes), A value of 0 means ORT will pick a default. Must >=0.\n"
+      "\t-a [processor_list]: Pins the intra op threads to the given logical processors, one thread per processor. e.g. '0-15,32-47'.\n"
+      "\t-n [numa_node]: Runs the session on the given NUMA node. Worker threads run on the node's processors and\n"
+      "\t\tinitializers and arena memory are allocated in its local memory.\n"
       "\t-P: Use parallel executor instead of sequential executor.\n"
       "\t-o [optimization level]: Default is 1. Valid values are 0 (disable), 1 (basic), 2 (extended), 99 (all).\n"
       "\t\tPlease see onnxruntime_c_api.h (enum GraphOptimizationLevel) for the full list of all optimization levels. \n"
       "\t-h: help\n");
 }
 
+// Parses a list of processor ids such as "0-3,8,10-11". Ids must exist on this machine.
+static bool ParseProcessorList(const ORTCHAR_T* list, std::vector<int>& processor_ids) {
+  const int num_processors = static_cast<int>(std::thread::hardware_concurrency());
+  const int max_processor_id = num_processors > 0 ? num_processors - 1 : INT_MAX;
+  auto status = Env::ParseProcessorList(ToMBString(list), max_processor_id, processor_ids);
+  if (!status.IsOK()) {
+    fprintf(stderr, "%s\n", status.ErrorMessage().c_str());
+    return false;
+  }
+  return true;
+}
+
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:y:c:o:AMPvhs"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:y:c:o:a:n:AFMPRvhs"))) != -1) {
     switch (ch) {
       case 'm':
         if (!CompareCString(optarg, ORT_TSTR("duration"))) {
@@ -116,6 +136,12 @@ namespace perftest {
       case 's':
         test_config.run_config.f_dump_statistics = true;
         break;
+      case 'F':
+        test_config.run_config.enable_execution_frame_pool = true;
+        break;
+      case 'R':
+        test_config.run_config.enable_run_arena = true;
+        break;
       case 'v':
         test_config.run_config.f_verbose = true;
         break;
@@ -131,6 +157,17 @@ namespace perftest {
           return false;
         }
         break;
+      case 'a':
+        if (!ParseProcessorList(optarg, test_config.run_config.intra_op_thread_affinity)) {
+          return false;
+        }
+        break;
+      case 'n':
+        test_config.run_config.numa_node = static_cast<int>(OrtStrtol<PATH_CHAR_TYPE>(optarg, nullptr));
+        if (test_config.run_config.numa_node < 0) {
+          return false;
+        }
+        break;
       case 'P':
         test_config.run_config.execution_mode = ExecutionMode::ORT_PARALLEL;
         break;
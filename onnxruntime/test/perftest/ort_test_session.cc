@@ -92,10 +92,24 @@ OnnxRuntimeTestSession::OnnxRuntimeTestSession(Ort::Env& env, std::random_device
     session_options.EnableMemPattern();
   else
     session_options.DisableMemPattern();
+  if (performance_test_config.run_config.enable_execution_frame_pool)
+    session_options.EnableExecutionFramePool();
+  if (performance_test_config.run_config.enable_run_arena)
+    session_options.EnableRunArena();
   session_options.SetExecutionMode(performance_test_config.run_config.execution_mode);
   fprintf(stdout, "Setting intra_op_num_threads to %d\n", performance_test_config.run_config.intra_op_num_threads);
   session_options.SetIntraOpNumThreads(performance_test_config.run_config.intra_op_num_threads);
 
+  const auto& thread_affinity = performance_test_config.run_config.intra_op_thread_affinity;
+  if (!thread_affinity.empty()) {
+    fprintf(stdout, "Pinning intra op threads to %d processors\n", static_cast<int>(thread_affinity.size()));
+    session_options.SetIntraOpThreadAffinity(thread_affinity.data(), thread_affinity.size());
+  }
+  if (performance_test_config.run_config.numa_node >= 0) {
+    fprintf(stdout, "Running on NUMA node %d\n", performance_test_config.run_config.numa_node);
+    session_options.SetNumaNode(performance_test_config.run_config.numa_node);
+  }
+
   if (performance_test_config.run_config.execution_mode == ExecutionMode::ORT_PARALLEL) {
     fprintf(stdout, "Setting inter_op_num_threads to %d\n", performance_test_config.run_config.inter_op_num_threads);
   }
@@ -77,7 +77,8 @@ Status PerformanceRunner::Run() {
             << "Total iterations:" << performance_result_.time_costs.size() << std::endl
             << "Average time cost:" << performance_result_.total_time_cost / performance_result_.time_costs.size() * 1000 << " ms" << std::endl
             // Time between start and end of run. Less than Total time cost when running requests in parallel.
-            << "Total run time:" << duration.count() << " s" << std::endl;
+            << "Total run time:" << duration.count() << " s" << std::endl
+            << "Throughput:" << performance_result_.time_costs.size() / duration.count() << " runs/s" << std::endl;
   return Status::OK();
 }
 
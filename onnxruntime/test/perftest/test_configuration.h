@@ -5,6 +5,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "core/graph/constants.h"
 #include "core/framework/session_options.h"
@@ -44,9 +45,13 @@ struct RunConfig {
   bool f_verbose{false};
   bool enable_memory_pattern{true};
   bool enable_cpu_mem_arena{true};
+  bool enable_execution_frame_pool{false};
+  bool enable_run_arena{false};
   ExecutionMode execution_mode{ExecutionMode::ORT_SEQUENTIAL};
   int intra_op_num_threads{0};
   int inter_op_num_threads{0};
+  std::vector<int> intra_op_thread_affinity;
+  int numa_node{-1};
   GraphOptimizationLevel optimization_level{ORT_ENABLE_EXTENDED};
 };
 
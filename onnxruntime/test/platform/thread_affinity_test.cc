@@ -0,0 +1,121 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/env.h"
+#include "core/util/thread_utils.h"
+
+#include <climits>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(ThreadAffinityTest, ParseProcessorList) {
+  std::vector<int> ids;
+  ASSERT_TRUE(Env::ParseProcessorList("3", INT_MAX, ids).IsOK());
+  EXPECT_EQ(ids, std::vector<int>({3}));
+
+  ASSERT_TRUE(Env::ParseProcessorList("0,2,5", INT_MAX, ids).IsOK());
+  EXPECT_EQ(ids, std::vector<int>({0, 2, 5}));
+
+  // ranges are inclusive and may be mixed with single ids
+  ASSERT_TRUE(Env::ParseProcessorList("0-3,8,10-11", INT_MAX, ids).IsOK());
+  EXPECT_EQ(ids, std::vector<int>({0, 1, 2, 3, 8, 10, 11}));
+
+  ASSERT_TRUE(Env::ParseProcessorList("4-4", INT_MAX, ids).IsOK());
+  EXPECT_EQ(ids, std::vector<int>({4}));
+}
+
+TEST(ThreadAffinityTest, ParseProcessorListRejectsMalformedInput) {
+  std::vector<int> ids;
+  for (const char* list : {"", ",", "1,", ",1", "1,,2", "a", "1a", "1-", "-1", "1-a", "1--2", "1-2-3",
+                           " 1", "1 ", "+1", "1;2"}) {
+    EXPECT_FALSE(Env::ParseProcessorList(list, INT_MAX, ids).IsOK()) << "'" << list << "'";
+  }
+}
+
+TEST(ThreadAffinityTest, ParseProcessorListRejectsOutOfRangeIds) {
+  std::vector<int> ids;
+  ASSERT_TRUE(Env::ParseProcessorList("0-7", 7, ids).IsOK());
+  EXPECT_EQ(ids.size(), 8u);
+
+  EXPECT_FALSE(Env::ParseProcessorList("8", 7, ids).IsOK());
+  EXPECT_FALSE(Env::ParseProcessorList("0-8", 7, ids).IsOK());
+  EXPECT_FALSE(Env::ParseProcessorList("0,99999999999999999999", INT_MAX, ids).IsOK());
+  // descending ranges
+  EXPECT_FALSE(Env::ParseProcessorList("3-1", 7, ids).IsOK());
+}
+
+TEST(ThreadAffinityTest, PoolSizeFromAffinity) {
+  concurrency::ThreadAffinity affinity;
+  affinity.processor_ids = {0, 1, 2, 3, 4, 5, 6, 7};
+
+  // one worker per processor when pinning one processor per thread
+  affinity.one_processor_per_thread = true;
+  auto tp = concurrency::CreateThreadPool("test", 0, affinity);
+  ASSERT_NE(tp, nullptr);
+  EXPECT_EQ(tp->NumThreads(), 8);
+
+  // roughly one worker per core otherwise, and never a pool without workers
+  affinity.one_processor_per_thread = false;
+  tp = concurrency::CreateThreadPool("test", 0, affinity);
+  ASSERT_NE(tp, nullptr);
+  EXPECT_EQ(tp->NumThreads(), 4);
+
+  affinity.processor_ids = {0, 1};
+  tp = concurrency::CreateThreadPool("test", 0, affinity);
+  ASSERT_NE(tp, nullptr);
+  EXPECT_EQ(tp->NumThreads(), 2);
+}
+
+TEST(ThreadAffinityTest, PoolOfOneThreadRejectsAffinity) {
+  concurrency::ThreadAffinity affinity;
+  affinity.processor_ids = {0};
+  affinity.one_processor_per_thread = true;
+  EXPECT_THROW(concurrency::CreateThreadPool("test", 0, affinity), OnnxRuntimeException);
+
+  affinity.processor_ids = {0, 1};
+  EXPECT_THROW(concurrency::CreateThreadPool("test", 1, affinity), OnnxRuntimeException);
+
+  // without an affinity a pool of one thread is simply not created
+  EXPECT_EQ(concurrency::CreateThreadPool("test", 1, concurrency::ThreadAffinity()), nullptr);
+}
+
+#ifdef __linux__
+TEST(ThreadAffinityTest, WorkersArePinnedWhenCreated) {
+  std::vector<int> allowed;
+  ASSERT_TRUE(Env::Default().GetThreadAffinity(allowed).IsOK());
+  ASSERT_FALSE(allowed.empty());
+
+  concurrency::ThreadAffinity affinity;
+  affinity.processor_ids = {allowed.front()};
+  concurrency::ThreadPool tp("test", 2, affinity);
+
+  std::mutex mutex;
+  std::condition_variable done;
+  std::vector<std::vector<int>> worker_affinities;
+  for (int i = 0; i < 8; ++i) {
+    tp.Schedule([&]() {
+      std::vector<int> ids;
+      auto status = Env::Default().GetThreadAffinity(ids);
+      ORT_UNUSED_PARAMETER(status);
+      std::lock_guard<std::mutex> lock(mutex);
+      worker_affinities.push_back(ids);
+      done.notify_one();
+    });
+  }
+
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [&]() { return worker_affinities.size() == 8; });
+  for (const auto& ids : worker_affinities) {
+    EXPECT_EQ(ids, affinity.processor_ids);
+  }
+}
+#endif
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -7,6 +7,7 @@
 #include "core/util/math.h"
 #include <algorithm>
 #include <cmath>
+#include <numeric>
 
 namespace onnxruntime {
 namespace test {
@@ -227,6 +228,54 @@ TEST(MathOpTest, Add_Broadcast_2x1x1_3x4) {
 #endif
 }
 
+// Adds inputs that are large enough to be split across threads, checking the result against
+// a plain walk over the broadcast output.
+static void TestAddBroadcastLarge(const std::vector<int64_t>& a_dims, const std::vector<int64_t>& b_dims) {
+  const size_t rank = std::max(a_dims.size(), b_dims.size());
+  std::vector<int64_t> a_full(rank, 1), b_full(rank, 1), c_dims(rank);
+  std::copy(a_dims.begin(), a_dims.end(), a_full.end() - a_dims.size());
+  std::copy(b_dims.begin(), b_dims.end(), b_full.end() - b_dims.size());
+  for (size_t i = 0; i < rank; ++i) {
+    c_dims[i] = std::max(a_full[i], b_full[i]);
+  }
+
+  const auto size_of = [](const std::vector<int64_t>& dims) {
+    return std::accumulate(dims.begin(), dims.end(), int64_t{1}, std::multiplies<int64_t>());
+  };
+  std::vector<float> a(size_of(a_dims)), b(size_of(b_dims)), c(size_of(c_dims));
+  for (size_t i = 0; i < a.size(); ++i) a[i] = static_cast<float>(i % 97);
+  for (size_t i = 0; i < b.size(); ++i) b[i] = static_cast<float>(i % 89) * 1000.0f;
+
+  std::vector<int64_t> index(rank, 0);
+  for (auto& value : c) {
+    int64_t a_offset = 0, b_offset = 0;
+    for (size_t i = 0; i < rank; ++i) {
+      a_offset = a_offset * a_full[i] + (a_full[i] == 1 ? 0 : index[i]);
+      b_offset = b_offset * b_full[i] + (b_full[i] == 1 ? 0 : index[i]);
+    }
+    value = a[a_offset] + b[b_offset];
+    for (size_t i = rank; i-- > 0;) {
+      if (++index[i] < c_dims[i]) break;
+      index[i] = 0;
+    }
+  }
+
+  OpTester test("Add");
+  test.AddInput<float>("A", a_dims, a);
+  test.AddInput<float>("B", b_dims, b);
+  test.AddOutput<float>("C", c_dims, c);
+  test.Run();
+}
+
+TEST(MathOpTest, Add_Broadcast_Large) {
+  TestAddBroadcastLarge({64, 1024}, {64, 1024});         // same shape
+  TestAddBroadcastLarge({}, {64, 1024});                 // scalar
+  TestAddBroadcastLarge({64, 1024}, {1024});             // row, e.g. a bias
+  TestAddBroadcastLarge({4, 32, 16, 16}, {1, 32, 1, 1});  // per channel
+  TestAddBroadcastLarge({256, 1}, {1, 300});             // outer
+  TestAddBroadcastLarge({3, 1, 20000}, {3, 2, 1});       // few large spans
+}
+
 // Validate runtime failure has useful error message when ORT_ENFORCE is used
 TEST(MathOpTest, Add_Invalid_Broadcast) {
   OpTester test("Add");
@@ -60,6 +60,30 @@ TEST(GemmOpTest, GemmNoTrans_f16) {
 }
 #endif
 
+// B as a constant initializer goes through the pre-packed path of the CPU kernel
+TEST(GemmOpTest, GemmConstantB) {
+  OpTester test("Gemm");
+
+  test.AddAttribute("transA", (int64_t)0);
+  test.AddAttribute("transB", (int64_t)1);
+  test.AddAttribute("alpha", 1.0f);
+  test.AddAttribute("beta", 1.0f);
+
+  test.AddInput<float>("A", {2, 4},
+                       {1.0f, 2.0f, 3.0f, 4.0f,
+                        -1.0f, -2.0f, -3.0f, -4.0f});
+  test.AddInput<float>("B", {3, 4},
+                       {1.0f, 1.0f, 1.0f, 1.0f,
+                        2.0f, 2.0f, 2.0f, 2.0f,
+                        1.0f, 0.0f, -1.0f, 0.0f},
+                       true);
+  test.AddInput<float>("C", {3}, std::vector<float>{1.0f, 2.0f, 3.0f});
+  test.AddOutput<float>("Y", {2, 3},
+                        {11.0f, 22.0f, 1.0f,
+                         -9.0f, -18.0f, 5.0f});
+  test.Run();
+}
+
 TEST(GemmOpTest, GemmBroadcast) {
   OpTester test("Gemm");
 
@@ -4,6 +4,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/common/tensor_op_test_utils.h"
 
 namespace onnxruntime {
 namespace test {
@@ -157,5 +158,24 @@ TEST(HardmaxOperator, ThreeDimsNegAxis2) {
   RunTest(x_vals_3dims, expected_vals, three_dimensions, /*axis*/ -1);
 }
 
+// ties resolve to the first maximum of each row
+TEST(HardmaxOperator, ManyRowsMatchesReference) {
+  const size_t N = 257;
+  const size_t D = 19;
+  std::vector<float> x_vals(N * D);
+  FillRandom(x_vals, -4.0f, 4.0f);
+  for (size_t n = 0; n < N; n += 3) {
+    x_vals[n * D + 5] = x_vals[n * D + 11] = 100.0f;
+  }
+
+  std::vector<float> expected_vals(N * D, 0.0f);
+  for (size_t n = 0; n < N; n++) {
+    const float* x = x_vals.data() + n * D;
+    expected_vals[n * D + (std::max_element(x, x + D) - x)] = 1.0f;
+  }
+
+  RunTest(x_vals, expected_vals, {static_cast<int64_t>(N), static_cast<int64_t>(D)});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
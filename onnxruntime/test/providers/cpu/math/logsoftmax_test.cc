@@ -5,6 +5,7 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/common/tensor_op_test_utils.h"
 
 namespace onnxruntime {
 namespace test {
@@ -197,5 +198,33 @@ TEST(LogSoftmaxOperator, InvalidAxis) {
           "-7 is not in valid range [-2,1]");//TensorRT parser: Assertion failed: axis >= 0 && axis < nbDims
 }
 
+// Reference log softmax computed in double precision over the N x D view of the input.
+static std::vector<float> ReferenceLogSoftmax(const std::vector<float>& x_vals, size_t N, size_t D) {
+  std::vector<float> y_vals(x_vals.size());
+  for (size_t n = 0; n < N; n++) {
+    const float* x = x_vals.data() + n * D;
+    float* y = y_vals.data() + n * D;
+    const double max_value = *std::max_element(x, x + D);
+    double sum = 0.0;
+    for (size_t d = 0; d < D; d++) {
+      sum += std::exp(x[d] - max_value);
+    }
+    for (size_t d = 0; d < D; d++) {
+      y[d] = static_cast<float>(x[d] - max_value - std::log(sum));
+    }
+  }
+  return y_vals;
+}
+
+// attention style [batch, heads, seq, seq] input with rows that are not a multiple of the vector width
+TEST(LogSoftmaxOperator, AttentionShapeMatchesReference) {
+  std::vector<int64_t> dimensions = {2, 4, 32, 33};
+  std::vector<float> x_vals(2 * 4 * 32 * 33);
+  FillRandom(x_vals, -10.0f, 10.0f);
+
+  RunTest(x_vals, ReferenceLogSoftmax(x_vals, 2 * 4 * 32, 33), dimensions, /*axis*/ 3);
+  RunTest(x_vals, ReferenceLogSoftmax(x_vals, 2, 4 * 32 * 33), dimensions, /*axis*/ 1);
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -58,5 +58,21 @@ TEST(QuantizeLinearMatmulOpTest, QLinearMatMul) {
   test.AddOutput<uint8_t>("T3", {2, 3}, {168, 115, 255, 1, 66, 151});
   test.Run();
 }
+
+TEST(QuantizeLinearMatmulOpTest, QLinearMatMulSaturatesBeyondInt32) {
+  OpTester test("QLinearMatMul", 10);
+  test.AddInput<uint8_t>("T1", {2, 4}, {208, 236, 0, 238, 3, 214, 255, 29});
+  test.AddInput<float>("a_scale", {}, {0.0066f});
+  test.AddInput<uint8_t>("a_zero_point", {}, {113});
+  test.AddInput<uint8_t>("T2", {4, 3}, {152, 51, 244, 60, 26, 255, 0, 127, 246, 127, 254, 247});
+  test.AddInput<float>("b_scale", {}, {0.00705f});
+  test.AddInput<uint8_t>("b_zero_point", {}, {114});
+  // scales the int32 accumulators {11475, -778, 31402, -26914, -11872, 7513} by about 465300,
+  // mostly well beyond the int32 range
+  test.AddInput<float>("y_scale", {}, {1e-10f});
+  test.AddInput<uint8_t>("y_zero_point", {}, {118});
+  test.AddOutput<uint8_t>("T3", {2, 3}, {255, 0, 255, 0, 0, 255});
+  test.Run();
+}
 }  // namespace test
 }  // namespace onnxruntime
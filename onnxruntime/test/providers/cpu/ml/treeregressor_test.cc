@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include "core/providers/cpu/ml/tree_ensemble_common.h"
 #include "gtest/gtest.h"
 #include "test/providers/provider_test_utils.h"
 
@@ -121,5 +122,115 @@ TEST(MLOpTest, TreeRegressorSingleTargetSum) {
   test.Run();
 }
 
+// every row must fill all its targets, including the ones no leaf voted for
+TEST(MLOpTest, TreeRegressorTargetWithoutVotes) {
+  OpTester test("TreeEnsembleRegressor", 1, onnxruntime::kMLDomain);
+
+  //tree
+  std::vector<int64_t> lefts = {1, 0, 0};
+  std::vector<int64_t> rights = {2, 0, 0};
+  std::vector<int64_t> treeids = {0, 0, 0};
+  std::vector<int64_t> nodeids = {0, 1, 2};
+  std::vector<int64_t> featureids = {0, 0, 0};
+  std::vector<float> thresholds = {1, 0, 0};
+  std::vector<std::string> modes = {"BRANCH_LEQ", "LEAF", "LEAF"};
+
+  std::vector<int64_t> target_treeids = {0, 0};
+  std::vector<int64_t> target_nodeids = {1, 2};
+  std::vector<int64_t> target_classids = {0, 1};
+  std::vector<float> target_weights = {2.f, 5.f};
+  std::vector<float> base_values = {10.f, 20.f};
+
+  //test data
+  std::vector<float> X = {0, 2, 0};
+  std::vector<float> results = {12.f, 20.f, 10.f, 25.f, 12.f, 20.f};
+
+  //add attributes
+  test.AddAttribute("nodes_truenodeids", lefts);
+  test.AddAttribute("nodes_falsenodeids", rights);
+  test.AddAttribute("nodes_treeids", treeids);
+  test.AddAttribute("nodes_nodeids", nodeids);
+  test.AddAttribute("nodes_featureids", featureids);
+  test.AddAttribute("nodes_values", thresholds);
+  test.AddAttribute("nodes_modes", modes);
+  test.AddAttribute("target_treeids", target_treeids);
+  test.AddAttribute("target_nodeids", target_nodeids);
+  test.AddAttribute("target_ids", target_classids);
+  test.AddAttribute("target_weights", target_weights);
+  test.AddAttribute("base_values", base_values);
+
+  test.AddAttribute("n_targets", (int64_t)2);
+
+  //fill input data
+  test.AddInput<float>("X", {3, 1}, X);
+  test.AddOutput<float>("Y", {3, 2}, results);
+  test.Run();
+}
+
+// With fewer rows than threads the trees are split across the threads and the partial scores merged, which must
+// give the same scores as evaluating all the trees on one thread.
+TEST(MLOpTest, TreeEnsembleSplitTreesMatchesSerial) {
+  // 40 trees of 3 branches and 4 leaves over 3 features. every leaf votes for one or two of 4 targets, so some
+  // batches of trees leave some targets without votes. the weights are small integers so that the sums are exact
+  // in any order.
+  const int64_t n_trees = 40;
+  std::vector<int64_t> treeids, nodeids, featureids, truenodeids, falsenodeids;
+  std::vector<float> thresholds;
+  std::vector<ml::NODE_MODE> modes;
+  std::vector<int64_t> target_treeids, target_nodeids, target_ids;
+  std::vector<float> target_weights;
+  for (int64_t tree = 0; tree < n_trees; ++tree) {
+    for (int64_t node = 0; node < 7; ++node) {
+      treeids.push_back(tree);
+      nodeids.push_back(node);
+      if (node < 3) {
+        featureids.push_back((tree + node) % 3);
+        thresholds.push_back(static_cast<float>((tree * 7 + node * 3) % 11) - 5.f);
+        modes.push_back(ml::NODE_MODE::BRANCH_LEQ);
+        truenodeids.push_back(2 * node + 1);
+        falsenodeids.push_back(2 * node + 2);
+      } else {
+        featureids.push_back(0);
+        thresholds.push_back(0.f);
+        modes.push_back(ml::NODE_MODE::LEAF);
+        truenodeids.push_back(0);
+        falsenodeids.push_back(0);
+        target_treeids.push_back(tree);
+        target_nodeids.push_back(node);
+        target_ids.push_back((tree + node) % 4);
+        target_weights.push_back(static_cast<float>((tree * 5 + node) % 9) - 4.f);
+        if (tree % 3 == 0) {
+          target_treeids.push_back(tree);
+          target_nodeids.push_back(node);
+          target_ids.push_back((tree + node + 1) % 4);
+          target_weights.push_back(static_cast<float>(node));
+        }
+      }
+    }
+  }
+
+  const std::vector<float> X = {-3.f, 0.5f, 4.f, 2.f, -1.f, -6.f, 5.f, 5.f, 0.f};
+  const std::vector<float> base_values = {1.f, -2.f};
+  concurrency::ThreadPool tp("test", 3);
+
+  for (auto aggregate_function : {ml::AGGREGATE_FUNCTION::SUM, ml::AGGREGATE_FUNCTION::MIN,
+                                  ml::AGGREGATE_FUNCTION::MAX}) {
+    ml::detail::TreeEnsembleCommon ensemble(treeids, nodeids, featureids, thresholds, modes, truenodeids,
+                                            falsenodeids, {}, target_treeids, target_nodeids, target_ids,
+                                            target_weights, aggregate_function, 4);
+    ASSERT_EQ(ensemble.NumScores(), 4);
+
+    for (int64_t n_rows : {1, 3}) {
+      std::vector<ml::detail::ScoreValue> serial(n_rows * 4), split(n_rows * 4);
+      ensemble.ComputeScores(X.data(), n_rows, 3, base_values, serial.data(), nullptr);
+      ensemble.ComputeScores(X.data(), n_rows, 3, base_values, split.data(), &tp);
+      for (size_t i = 0; i < serial.size(); ++i) {
+        EXPECT_EQ(split[i].has_score, serial[i].has_score) << "score " << i << " of " << n_rows << " rows";
+        EXPECT_EQ(split[i].score, serial[i].score) << "score " << i << " of " << n_rows << " rows";
+      }
+    }
+  }
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -176,6 +176,31 @@ TEST(ConvTest, QLinearConv3DTest) {
   test.Run();
 }
 
+TEST(ConvTest, QLinearConv2DGroupWithBiasTest) {
+  OpTester test("QLinearConv", 10);
+
+  test.AddAttribute("group", static_cast<int64_t>(2));
+
+  test.AddInput<uint8_t>("x", {1, 2, 3, 3},
+                         {10, 20, 30, 40, 50, 60, 70, 80, 90,
+                          5, 15, 25, 35, 45, 55, 65, 75, 85});
+  test.AddInput<float>("x_scale", {}, {0.02f});
+  test.AddInput<uint8_t>("x_zero_point", {}, {40});
+
+  test.AddInput<uint8_t>("w", {2, 1, 2, 2}, {1, 2, 3, 4, 250, 240, 230, 220});
+  test.AddInput<float>("w_scale", {}, {0.01f});
+  test.AddInput<uint8_t>("w_zero_point", {}, {128});
+
+  test.AddInput<float>("y_scale", {}, {0.05f});
+  test.AddInput<uint8_t>("y_zero_point", {}, {100});
+
+  test.AddInput<int32_t>("B", {2}, {1000, -2000});
+
+  test.AddOutput<uint8_t>("y", {1, 2, 2, 2}, {124, 104, 64, 44, 64, 81, 115, 132});
+
+  test.Run();
+}
+
 }  // namespace
 }  // namespace test
 }  // namespace onnxruntime
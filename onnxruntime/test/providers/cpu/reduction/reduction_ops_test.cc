@@ -837,6 +837,44 @@ TEST(ReductionOpTest, ReduceSum_keepdims) {
   test.Run();
 }
 
+// middle axis reduced in place, with more columns than a single accumulation block
+TEST(ReductionOpTest, ReduceSum_middle_axis_wide) {
+  const int64_t outer = 3, reduced = 5, inner = 300;
+  std::vector<float> data(outer * reduced * inner);
+  std::vector<float> expected(outer * inner, 0.f);
+  for (int64_t o = 0; o < outer; ++o) {
+    for (int64_t r = 0; r < reduced; ++r) {
+      for (int64_t i = 0; i < inner; ++i) {
+        const float value = static_cast<float>((o * 7 + r * 3 + i) % 11) - 5.f;
+        data[(o * reduced + r) * inner + i] = value;
+        expected[o * inner + i] += value;
+      }
+    }
+  }
+
+  OpTester test("ReduceSum");
+  test.AddAttribute("axes", std::vector<int64_t>{1});
+  test.AddAttribute("keepdims", (int64_t)0);
+  test.AddInput<float>("data", {outer, reduced, inner}, data);
+  test.AddOutput<float>("reduced", {outer, inner}, expected);
+  test.Run();
+}
+
+// axes that are only separated by dimensions of size 1 are still reduced in place
+TEST(ReductionOpTest, ReduceMax_axes_around_unit_dim) {
+  OpTester test("ReduceMax");
+  test.AddAttribute("axes", std::vector<int64_t>{1, 3});
+  test.AddAttribute("keepdims", (int64_t)1);
+  test.AddInput<float>("data", {2, 2, 1, 2},
+                       {1.0f, 6.0f,
+                        3.0f, 2.0f,
+
+                        -5.0f, -1.0f,
+                        -2.0f, -8.0f});
+  test.AddOutput<float>("reduced", {2, 1, 1, 1}, {6.0f, -1.0f});
+  test.Run();
+}
+
 TEST(ReductionOpTest, ReduceSumSquare) {
   OpTester test("ReduceSumSquare");
   test.AddAttribute("axes", std::vector<int64_t>{0, 2});
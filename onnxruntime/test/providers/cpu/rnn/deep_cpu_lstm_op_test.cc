@@ -47,99 +47,102 @@ static void RunLstmTest(const std::vector<float>& X_data,
                         std::vector<float> activation_alphas = {},
                         std::vector<float> activation_betas = {},
                         bool hasClip = true) {
-  OpTester test("LSTM");
+  // W and R are fed as graph inputs, and as initializers, which the kernel pre-packs
+  for (bool weights_are_initializers : {false, true}) {
+    OpTester test("LSTM");
 
-  int num_directions = (direction == "bidirectional") ? 2 : 1;
+    int num_directions = (direction == "bidirectional") ? 2 : 1;
 
-  if (activations.empty()) {
-    activations = {"sigmoid", "tanh", "tanh"};
-  }
+    if (activations.empty()) {
+      activations = {"sigmoid", "tanh", "tanh"};
+    }
 
-  if (num_directions == 2 && activations.size() == 3) {
-    activations = DuplicateContainer(activations);
-  }
+    if (num_directions == 2 && activations.size() == 3) {
+      activations = DuplicateContainer(activations);
+    }
 
-  test.AddAttribute<std::vector<string>>("activations", activations);
-  if (!activation_alphas.empty())
-    test.AddAttribute<std::vector<float>>("activation_alpha", activation_alphas);
-  if (!activation_betas.empty())
-    test.AddAttribute<std::vector<float>>("activation_beta", activation_betas);
-
-  test.AddAttribute("direction", direction);
-  test.AddAttribute("hidden_size", hidden_size);
-  // test.AddAttribute<int64_t>("output_sequence", output_sequence);
-  test.AddAttribute<int64_t>("input_forget", input_forget);
-  if (hasClip) {
-    test.AddAttribute<float>("clip", clip);
-  }
+    test.AddAttribute<std::vector<string>>("activations", activations);
+    if (!activation_alphas.empty())
+      test.AddAttribute<std::vector<float>>("activation_alpha", activation_alphas);
+    if (!activation_betas.empty())
+      test.AddAttribute<std::vector<float>>("activation_beta", activation_betas);
+
+    test.AddAttribute("direction", direction);
+    test.AddAttribute("hidden_size", hidden_size);
+    // test.AddAttribute<int64_t>("output_sequence", output_sequence);
+    test.AddAttribute<int64_t>("input_forget", input_forget);
+    if (hasClip) {
+      test.AddAttribute<float>("clip", clip);
+    }
 
-  std::vector<int64_t> X_dims = {seq_length, batch_size, input_size};
-  std::vector<int64_t> W_dims = {num_directions, 4 * hidden_size, input_size};
-  std::vector<int64_t> R_dims = {num_directions, 4 * hidden_size, hidden_size};
+    std::vector<int64_t> X_dims = {seq_length, batch_size, input_size};
+    std::vector<int64_t> W_dims = {num_directions, 4 * hidden_size, input_size};
+    std::vector<int64_t> R_dims = {num_directions, 4 * hidden_size, hidden_size};
 
-  test.AddInput<float>("X", X_dims, X_data);
-  test.AddInput<float>("W", W_dims, W_data);
-  test.AddInput<float>("R", R_dims, R_data);
+    test.AddInput<float>("X", X_dims, X_data);
+    test.AddInput<float>("W", W_dims, W_data, weights_are_initializers);
+    test.AddInput<float>("R", R_dims, R_data, weights_are_initializers);
 
-  if (B_data) {
-    std::vector<int64_t> B_dims = {num_directions, 8 * hidden_size};
-    test.AddInput<float>("B", B_dims, *B_data);
-  } else {
-    test.AddMissingOptionalInput<float>();
-  }
+    if (B_data) {
+      std::vector<int64_t> B_dims = {num_directions, 8 * hidden_size};
+      test.AddInput<float>("B", B_dims, *B_data);
+    } else {
+      test.AddMissingOptionalInput<float>();
+    }
 
-  if (sequence_lengths) {
-    std::vector<int64_t> sequence_lens_dims{batch_size};
-    test.AddInput<int>("sequence_lens", sequence_lens_dims, *sequence_lengths);
-  } else {
-    test.AddMissingOptionalInput<int>();
-  }
+    if (sequence_lengths) {
+      std::vector<int64_t> sequence_lens_dims{batch_size};
+      test.AddInput<int>("sequence_lens", sequence_lens_dims, *sequence_lengths);
+    } else {
+      test.AddMissingOptionalInput<int>();
+    }
 
-  if (initial_h_data && !initial_h_data->empty()) {
-    std::vector<int64_t> initial_h_dims = {num_directions, batch_size, hidden_size};
-    test.AddInput<float>("initial_h", initial_h_dims, *initial_h_data);
-  } else {
-    test.AddMissingOptionalInput<float>();
-  }
+    if (initial_h_data && !initial_h_data->empty()) {
+      std::vector<int64_t> initial_h_dims = {num_directions, batch_size, hidden_size};
+      test.AddInput<float>("initial_h", initial_h_dims, *initial_h_data);
+    } else {
+      test.AddMissingOptionalInput<float>();
+    }
 
-  if (initial_c_data && !initial_c_data->empty()) {
-    std::vector<int64_t> initial_c_dims = {num_directions, batch_size, hidden_size};
-    test.AddInput<float>("initial_c", initial_c_dims, *initial_c_data);
-  } else {
-    test.AddMissingOptionalInput<float>();
-  }
+    if (initial_c_data && !initial_c_data->empty()) {
+      std::vector<int64_t> initial_c_dims = {num_directions, batch_size, hidden_size};
+      test.AddInput<float>("initial_c", initial_c_dims, *initial_c_data);
+    } else {
+      test.AddMissingOptionalInput<float>();
+    }
 
-  if (P_data && !P_data->empty()) {
-    std::vector<int64_t> P_dims = {num_directions, 3 * hidden_size};
-    test.AddInput<float>("P", P_dims, *P_data);
-  } else {
-    test.AddMissingOptionalInput<float>();
-  }
+    if (P_data && !P_data->empty()) {
+      std::vector<int64_t> P_dims = {num_directions, 3 * hidden_size};
+      test.AddInput<float>("P", P_dims, *P_data);
+    } else {
+      test.AddMissingOptionalInput<float>();
+    }
 
-  if (output_sequence != 0 && !Y_data.empty()) {
-    std::vector<int64_t> Y_dims = {seq_length, num_directions, batch_size, hidden_size};
-    test.AddOutput<float>("Y", Y_dims, Y_data);
-  } else {
-    // add placeholder so node counts match as Y_h will always be the second Y_data,
-    // so Y must exist as the first Y_data
-    test.AddMissingOptionalOutput<float>();
-  }
+    if (output_sequence != 0 && !Y_data.empty()) {
+      std::vector<int64_t> Y_dims = {seq_length, num_directions, batch_size, hidden_size};
+      test.AddOutput<float>("Y", Y_dims, Y_data);
+    } else {
+      // add placeholder so node counts match as Y_h will always be the second Y_data,
+      // so Y must exist as the first Y_data
+      test.AddMissingOptionalOutput<float>();
+    }
 
-  if (!Y_h_data.empty()) {
-    std::vector<int64_t> Y_h_dims{num_directions, batch_size, hidden_size};
-    test.AddOutput<float>("Y_h", Y_h_dims, Y_h_data);
-  } else {
-    test.AddMissingOptionalOutput<float>();
-  }
+    if (!Y_h_data.empty()) {
+      std::vector<int64_t> Y_h_dims{num_directions, batch_size, hidden_size};
+      test.AddOutput<float>("Y_h", Y_h_dims, Y_h_data);
+    } else {
+      test.AddMissingOptionalOutput<float>();
+    }
 
-  if (!Y_c_data.empty()) {
-    std::vector<int64_t> Y_c_dims{num_directions, batch_size, hidden_size};
-    test.AddOutput<float>("Y_c", Y_c_dims, Y_c_data);
-  } else {
-    test.AddMissingOptionalOutput<float>();
-  }
+    if (!Y_c_data.empty()) {
+      std::vector<int64_t> Y_c_dims{num_directions, batch_size, hidden_size};
+      test.AddOutput<float>("Y_c", Y_c_dims, Y_c_data);
+    } else {
+      test.AddMissingOptionalOutput<float>();
+    }
 
-  test.Run();
+    test.Run();
+  }
 }
 
 void SimpleWeightsNoBiasTwoRows(std::string direction,
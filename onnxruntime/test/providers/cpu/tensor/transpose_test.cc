@@ -205,5 +205,77 @@ TEST(TransposeOpTest, NHWC2NCHW) {
   TransposeTest(input_shape, input_vals, &perm, expected_shape, expected_vals, false);
 }
 
+// Transposes input_vals with a plain index walk and checks the kernel against it. Used for the larger
+// shapes that take the tiled and blocked paths.
+template <class T>
+void TransposeReferenceTest(const std::vector<int64_t>& input_shape, const std::vector<int64_t>& perm) {
+  const size_t rank = input_shape.size();
+  std::vector<int64_t> input_strides(rank, 1);
+  for (size_t i = rank - 1; i > 0; --i) {
+    input_strides[i - 1] = input_strides[i] * input_shape[i];
+  }
+  const int64_t size = input_strides[0] * input_shape[0];
+
+  std::vector<T> input_vals(size);
+  for (int64_t i = 0; i < size; ++i) {
+    input_vals[i] = static_cast<T>(i % 251);
+  }
+
+  std::vector<int64_t> output_shape(rank);
+  for (size_t i = 0; i < rank; ++i) {
+    output_shape[i] = input_shape[perm[i]];
+  }
+
+  std::vector<T> expected_vals(size);
+  std::vector<int64_t> index(rank, 0);
+  for (int64_t i = 0; i < size; ++i) {
+    int64_t offset = 0;
+    for (size_t j = 0; j < rank; ++j) {
+      offset += index[j] * input_strides[perm[j]];
+    }
+    expected_vals[i] = input_vals[offset];
+    for (size_t j = rank; j-- > 0;) {
+      if (++index[j] < output_shape[j]) break;
+      index[j] = 0;
+    }
+  }
+
+  OpTester test("Transpose");
+  test.AddAttribute("perm", perm);
+  test.AddInput<T>("X", input_shape, input_vals);
+  test.AddOutput<T>("Y", output_shape, expected_vals);
+  test.Run();
+}
+
+TEST(TransposeOpTest, NCHW2NHWCLarge) {
+  TransposeReferenceTest<float>({2, 67, 13, 11}, {0, 2, 3, 1});
+  TransposeReferenceTest<uint8_t>({2, 67, 13, 11}, {0, 2, 3, 1});
+}
+
+TEST(TransposeOpTest, NHWC2NCHWLarge) {
+  TransposeReferenceTest<float>({2, 13, 11, 67}, {0, 3, 1, 2});
+  TransposeReferenceTest<uint8_t>({2, 13, 11, 67}, {0, 3, 1, 2});
+}
+
+// [batch, sequence, heads, head_size] -> [batch, heads, sequence, head_size] as used by attention.
+TEST(TransposeOpTest, SplitHeads) {
+  TransposeReferenceTest<float>({2, 37, 4, 16}, {0, 2, 1, 3});
+  TransposeReferenceTest<int64_t>({2, 37, 4, 16}, {0, 2, 1, 3});
+}
+
+TEST(TransposeOpTest, TwoDimLarge) {
+  TransposeReferenceTest<float>({97, 130}, {1, 0});
+  TransposeReferenceTest<uint8_t>({97, 130}, {1, 0});
+  TransposeReferenceTest<int16_t>({97, 130}, {1, 0});
+  TransposeReferenceTest<double>({97, 130}, {1, 0});
+}
+
+// Size 1 axes are dropped before the transpose is specialized.
+TEST(TransposeOpTest, UnitDims) {
+  TransposeReferenceTest<float>({1, 33, 1, 45}, {3, 2, 1, 0});
+  TransposeReferenceTest<float>({5, 1, 7, 1}, {1, 0, 3, 2});
+  TransposeReferenceTest<float>({3, 4, 5, 6}, {2, 0, 3, 1});
+}
+
 }  // namespace test
 }  // namespace onnxruntime
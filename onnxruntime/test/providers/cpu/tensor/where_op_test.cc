@@ -109,5 +109,29 @@ TEST(WhereOpTest, Broadcast) {
   WhereBroadcastTest<std::string>("true", "false");
 }
 
+TEST(WhereOpTest, BroadcastLarge) {
+  auto condition_values = {true, false};  // std::initializer_list<bool> for OpTester::AddInput<bool>()
+  std::vector<float> X_values(64 * 1024), Y_values(2 * 64);
+  for (size_t i = 0; i < X_values.size(); ++i) X_values[i] = static_cast<float>(i + 1);
+  for (size_t i = 0; i < Y_values.size(); ++i) Y_values[i] = -static_cast<float>(i + 1);
+
+  std::vector<float> result;
+  result.reserve(2 * 64 * 1024);
+  for (size_t n = 0; n < 2; ++n) {
+    for (size_t s = 0; s < 64; ++s) {
+      for (size_t d = 0; d < 1024; ++d) {
+        result.push_back(n == 0 ? X_values[s * 1024 + d] : Y_values[n * 64 + s]);
+      }
+    }
+  }
+
+  OpTester test{kOpName, kOpVersion};
+  test.AddInput<bool>("condition", {2, 1, 1}, condition_values);
+  test.AddInput<float>("X", {1, 64, 1024}, X_values);
+  test.AddInput<float>("Y", {2, 64, 1}, Y_values);
+  test.AddOutput<float>("output", {2, 64, 1024}, result);
+  test.Run();
+}
+
 }  // namespace test
 }  // namespace onnxruntime
@@ -7,6 +7,7 @@ import os
 import numpy as np
 import onnxruntime as onnxrt
 import threading
+from onnx import helper, TensorProto
 
 
 class TestInferenceSession(unittest.TestCase):
@@ -118,6 +119,53 @@ class TestInferenceSession(unittest.TestCase):
         np.testing.assert_allclose(
             output_expected, res[0], rtol=1e-05, atol=1e-08)
 
+    def testRunModelNonContiguousInput(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        # contiguous inputs are used in place, others are copied
+        x = np.array([[1.0, 3.0, 5.0], [2.0, 4.0, 6.0]], dtype=np.float32).T
+        self.assertFalse(x.flags['C_CONTIGUOUS'])
+        output_expected = np.array(
+            [[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+        for feed in [x, np.ascontiguousarray(x)]:
+            res = sess.run([], {"X": feed})
+            np.testing.assert_allclose(
+                output_expected, res[0], rtol=1e-05, atol=1e-08)
+            # either way the output is a view of the buffer ORT allocated for it
+            self.assertFalse(res[0].flags['OWNDATA'])
+            self.assertFalse(np.shares_memory(feed, res[0]))
+
+    def testRunModelOutputOwnsBuffer(self):
+        sess = onnxrt.InferenceSession(self.get_name("mul_1.onnx"))
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        res = sess.run([], {"X": x})
+        # the output shares the buffer ORT allocated, so it must stay valid after the session is gone
+        self.assertFalse(res[0].flags['OWNDATA'])
+        self.assertIsNotNone(res[0].base)
+        self.assertFalse(np.shares_memory(x, res[0]))
+        del sess
+        output_expected = np.array(
+            [[1.0, 4.0], [9.0, 16.0], [25.0, 36.0]], dtype=np.float32)
+        np.testing.assert_allclose(
+            output_expected, res[0], rtol=1e-05, atol=1e-08)
+
+    def testRunModelOutputOfAliasedInput(self):
+        # Identity may return its input buffer, but a graph output never shares the buffer of a feed that is
+        # used in place, so the output doesn't change with the input array
+        graph = helper.make_graph(
+            [helper.make_node("Identity", ["X"], ["Y"])], "identity",
+            [helper.make_tensor_value_info("X", TensorProto.FLOAT, [3, 2])],
+            [helper.make_tensor_value_info("Y", TensorProto.FLOAT, [3, 2])])
+        model = helper.make_model(graph, opset_imports=[helper.make_opsetid("", 10)])
+        sess = onnxrt.InferenceSession(model.SerializeToString())
+        x = np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32)
+        self.assertTrue(x.flags['C_CONTIGUOUS'])
+        res = sess.run([], {"X": x})
+        self.assertFalse(np.shares_memory(x, res[0]))
+        self.assertFalse(res[0].flags['OWNDATA'])
+        x[0, 0] = 7.0
+        np.testing.assert_equal(
+            np.array([[1.0, 2.0], [3.0, 4.0], [5.0, 6.0]], dtype=np.float32), res[0])
+
     def testRunModelMultipleThreads(self):
         so = onnxrt.SessionOptions()
         so.log_verbosity_level = 1
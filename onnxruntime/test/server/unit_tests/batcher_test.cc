@@ -0,0 +1,330 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "server/batcher.h"
+
+namespace onnxruntime {
+namespace server {
+namespace test {
+
+namespace {
+
+Ort::Value CreateFloatTensor(const std::vector<int64_t>& shape, float start) {
+  Ort::AllocatorWithDefaultOptions allocator;
+  auto value = Ort::Value::CreateTensor<float>(allocator, shape.data(), shape.size());
+  auto* data = value.GetTensorMutableData<float>();
+  size_t count = value.GetTensorTypeAndShapeInfo().GetElementCount();
+  for (size_t i = 0; i < count; ++i) {
+    data[i] = start + static_cast<float>(i);
+  }
+  return value;
+}
+
+// Doubles every element of the first input and records the batch sizes and run tags it was called with.
+class DoublingRunner {
+ public:
+  std::vector<Ort::Value> operator()(const Ort::RunOptions& run_options,
+                                     const std::vector<std::string>& /*input_names*/,
+                                     std::vector<Ort::Value>& input_values,
+                                     const std::vector<std::string>& /*output_names*/) {
+    auto info = input_values[0].GetTensorTypeAndShapeInfo();
+    auto shape = info.GetShape();
+    calls_.fetch_add(1);
+    rows_.fetch_add(shape[0]);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      run_tags_.push_back(run_options.GetRunTag());
+    }
+
+    Ort::AllocatorWithDefaultOptions allocator;
+    auto output = Ort::Value::CreateTensor<float>(allocator, shape.data(), shape.size());
+    const auto* in = input_values[0].GetTensorMutableData<float>();
+    auto* out = output.GetTensorMutableData<float>();
+    for (size_t i = 0, count = info.GetElementCount(); i < count; ++i) {
+      out[i] = in[i] * 2;
+    }
+
+    std::vector<Ort::Value> outputs;
+    outputs.push_back(std::move(output));
+    return outputs;
+  }
+
+  std::atomic<int> calls_{0};
+  std::atomic<int64_t> rows_{0};
+  std::mutex mutex_;
+  std::vector<std::string> run_tags_;
+};
+
+RequestBatcher::Runner Wrap(DoublingRunner& runner) {
+  return [&runner](const Ort::RunOptions& run_options, const std::vector<std::string>& input_names,
+                   std::vector<Ort::Value>& input_values, const std::vector<std::string>& output_names) {
+    return runner(run_options, input_names, input_values, output_names);
+  };
+}
+
+Ort::RunOptions CreateRunOptions(const std::string& tag, int log_verbosity_level = 0) {
+  Ort::RunOptions run_options;
+  run_options.SetRunTag(tag.c_str());
+  run_options.SetRunLogVerbosityLevel(log_verbosity_level);
+  return run_options;
+}
+
+}  // namespace
+
+TEST(RequestBatcherTests, CanBatch) {
+  std::vector<Ort::Value> inputs;
+  inputs.push_back(CreateFloatTensor({2, 3}, 0));
+  inputs.push_back(CreateFloatTensor({2}, 0));
+  EXPECT_TRUE(RequestBatcher::CanBatch(inputs));
+
+  // Dimension 0 must agree across inputs.
+  inputs.push_back(CreateFloatTensor({3, 3}, 0));
+  EXPECT_FALSE(RequestBatcher::CanBatch(inputs));
+
+  std::vector<Ort::Value> scalar;
+  scalar.push_back(CreateFloatTensor({}, 0));
+  EXPECT_FALSE(RequestBatcher::CanBatch(scalar));
+}
+
+TEST(RequestBatcherTests, MergesConcurrentRequests) {
+  constexpr int kRequests = 8;
+  DoublingRunner runner;
+  BatchingOptions options;
+  options.max_batch_size = kRequests;
+  options.max_queue_delay = std::chrono::seconds(10);
+
+  RequestBatcher batcher(Wrap(runner), options);
+
+  const std::vector<std::string> input_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  std::vector<std::thread> threads;
+  std::atomic<int> mismatches{0};
+  for (int r = 0; r < kRequests; ++r) {
+    threads.emplace_back([&, r]() {
+      std::vector<Ort::Value> inputs;
+      inputs.push_back(CreateFloatTensor({1, 4}, static_cast<float>(r * 100)));
+      auto run_options = CreateRunOptions(std::to_string(r));
+      auto outputs = batcher.Run(run_options, input_names, inputs, output_names);
+      auto shape = outputs[0].GetTensorTypeAndShapeInfo().GetShape();
+      if (shape != std::vector<int64_t>{1, 4}) {
+        mismatches.fetch_add(1);
+        return;
+      }
+      const auto* out = outputs[0].GetTensorMutableData<float>();
+      for (int i = 0; i < 4; ++i) {
+        if (out[i] != 2 * (r * 100 + i)) {
+          mismatches.fetch_add(1);
+        }
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  EXPECT_EQ(mismatches.load(), 0);
+  // The batch fills up long before the queue delay expires, so all requests share one run.
+  EXPECT_EQ(runner.calls_.load(), 1);
+  EXPECT_EQ(runner.rows_.load(), kRequests);
+  // the merged run is tagged with the tags of all requests
+  ASSERT_EQ(runner.run_tags_.size(), 1u);
+  for (int r = 0; r < kRequests; ++r) {
+    EXPECT_NE(runner.run_tags_[0].find(std::to_string(r)), std::string::npos);
+  }
+  EXPECT_EQ(std::count(runner.run_tags_[0].begin(), runner.run_tags_[0].end(), ','), kRequests - 1);
+
+  auto metrics = batcher.GetMetrics();
+  EXPECT_EQ(metrics.queue_depth, 0u);
+  EXPECT_EQ(metrics.num_batches, 1u);
+  EXPECT_EQ(metrics.num_requests, static_cast<uint64_t>(kRequests));
+  EXPECT_EQ(metrics.max_batch_rows, static_cast<uint64_t>(kRequests));
+}
+
+TEST(RequestBatcherTests, DispatchesAfterQueueDelay) {
+  DoublingRunner runner;
+  BatchingOptions options;
+  options.max_batch_size = 64;
+  options.max_queue_delay = std::chrono::microseconds(100);
+
+  RequestBatcher batcher(Wrap(runner), options);
+
+  std::vector<Ort::Value> inputs;
+  inputs.push_back(CreateFloatTensor({2, 2}, 1));
+  auto outputs = batcher.Run(CreateRunOptions("request"), {"X"}, inputs, {"Y"});
+  const auto* out = outputs[0].GetTensorMutableData<float>();
+  EXPECT_EQ(out[0], 2.f);
+  EXPECT_EQ(out[3], 8.f);
+  EXPECT_EQ(runner.calls_.load(), 1);
+  // a request that runs alone keeps its own run options
+  EXPECT_EQ(runner.run_tags_, std::vector<std::string>{"request"});
+}
+
+TEST(RequestBatcherTests, RunnerErrorIsReturnedToCaller) {
+  BatchingOptions options;
+  options.max_batch_size = 4;
+  options.max_queue_delay = std::chrono::microseconds(100);
+
+  RequestBatcher batcher([](const Ort::RunOptions&, const std::vector<std::string>&, std::vector<Ort::Value>&,
+                            const std::vector<std::string>&) -> std::vector<Ort::Value> {
+    throw Ort::Exception("run failed", ORT_FAIL);
+  },
+                         options);
+
+  std::vector<Ort::Value> inputs;
+  inputs.push_back(CreateFloatTensor({1, 2}, 0));
+  EXPECT_THROW(batcher.Run(CreateRunOptions("request"), {"X"}, inputs, {"Y"}), Ort::Exception);
+}
+
+TEST(RequestBatcherTests, NonOrtErrorFailsTheWholeBatch) {
+  constexpr int kRequests = 4;
+  BatchingOptions options;
+  options.max_batch_size = kRequests;
+  options.max_queue_delay = std::chrono::seconds(10);
+
+  RequestBatcher batcher([](const Ort::RunOptions&, const std::vector<std::string>&, std::vector<Ort::Value>&,
+                            const std::vector<std::string>&) -> std::vector<Ort::Value> {
+    throw std::bad_alloc();
+  },
+                         options);
+
+  std::atomic<int> failures{0};
+  std::vector<std::thread> threads;
+  for (int r = 0; r < kRequests; ++r) {
+    threads.emplace_back([&]() {
+      std::vector<Ort::Value> inputs;
+      inputs.push_back(CreateFloatTensor({1, 2}, 0));
+      auto run_options = CreateRunOptions("request");
+      try {
+        batcher.Run(run_options, {"X"}, inputs, {"Y"});
+      } catch (const std::bad_alloc&) {
+        failures.fetch_add(1);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  // every caller gets the error, and the batcher keeps serving requests
+  EXPECT_EQ(failures.load(), kRequests);
+  std::vector<Ort::Value> inputs;
+  inputs.push_back(CreateFloatTensor({1, 2}, 0));
+  EXPECT_THROW(batcher.Run(CreateRunOptions("request"), {"X"}, inputs, {"Y"}), std::bad_alloc);
+}
+
+TEST(RequestBatcherTests, DoesNotMergeDifferentLogVerbosity) {
+  DoublingRunner runner;
+  BatchingOptions options;
+  options.max_batch_size = 2;
+  options.max_queue_delay = std::chrono::milliseconds(200);
+
+  RequestBatcher batcher(Wrap(runner), options);
+
+  std::vector<std::thread> threads;
+  for (int r = 0; r < 2; ++r) {
+    threads.emplace_back([&, r]() {
+      std::vector<Ort::Value> inputs;
+      inputs.push_back(CreateFloatTensor({1, 2}, 0));
+      auto run_options = CreateRunOptions(std::to_string(r), r);
+      batcher.Run(run_options, {"X"}, inputs, {"Y"});
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  EXPECT_EQ(runner.calls_.load(), 2);
+  std::sort(runner.run_tags_.begin(), runner.run_tags_.end());
+  EXPECT_EQ(runner.run_tags_, (std::vector<std::string>{"0", "1"}));
+}
+
+TEST(RequestBatcherTests, RunsBatchesConcurrently) {
+  constexpr int kBatches = 2;
+  BatchingOptions options;
+  options.max_batch_size = 2;
+  options.max_queue_delay = std::chrono::microseconds(100);
+  options.max_concurrent_batches = kBatches;
+
+  // Each run waits, up to a timeout, for the other batch to start running too.
+  std::mutex mutex;
+  std::condition_variable cv;
+  int running = 0;
+  int max_running = 0;
+  DoublingRunner doubling;
+  RequestBatcher batcher([&](const Ort::RunOptions& run_options, const std::vector<std::string>& input_names,
+                             std::vector<Ort::Value>& input_values, const std::vector<std::string>& output_names) {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      max_running = std::max(max_running, ++running);
+      cv.notify_all();
+      cv.wait_for(lock, std::chrono::seconds(10), [&]() { return max_running == kBatches; });
+      --running;
+    }
+    return doubling(run_options, input_names, input_values, output_names);
+  },
+                         options);
+
+  std::vector<std::thread> threads;
+  for (int r = 0; r < kBatches; ++r) {
+    threads.emplace_back([&]() {
+      // two rows fill a batch on their own
+      std::vector<Ort::Value> inputs;
+      inputs.push_back(CreateFloatTensor({2, 2}, 0));
+      auto run_options = CreateRunOptions("request");
+      batcher.Run(run_options, {"X"}, inputs, {"Y"});
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  EXPECT_EQ(doubling.calls_.load(), kBatches);
+  EXPECT_EQ(max_running, kBatches);
+}
+
+TEST(RequestBatcherTests, ReportsMetrics) {
+  DoublingRunner runner;
+  BatchingOptions options;
+  options.max_batch_size = 4;
+  options.max_queue_delay = std::chrono::microseconds(100);
+
+  std::mutex mutex;
+  std::condition_variable reported;
+  std::vector<BatchingMetrics> reports;
+  RequestBatcher batcher(
+      Wrap(runner), options,
+      [&](const BatchingMetrics& metrics) {
+        std::lock_guard<std::mutex> lock(mutex);
+        reports.push_back(metrics);
+        reported.notify_all();
+      },
+      std::chrono::milliseconds::zero());
+
+  for (int r = 0; r < 3; ++r) {
+    std::vector<Ort::Value> inputs;
+    inputs.push_back(CreateFloatTensor({1, 2}, 0));
+    batcher.Run(CreateRunOptions("request"), {"X"}, inputs, {"Y"});
+  }
+
+  // the dispatcher reports after handing a batch to a worker, so the last report may come after the run
+  std::unique_lock<std::mutex> lock(mutex);
+  reported.wait_for(lock, std::chrono::seconds(10), [&]() { return reports.size() == 3; });
+  ASSERT_EQ(reports.size(), 3u);
+  EXPECT_EQ(reports.back().num_batches, 3u);
+  EXPECT_EQ(reports.back().num_requests, 3u);
+}
+
+}  // namespace test
+}  // namespace server
+}  // namespace onnxruntime
@@ -1094,6 +1094,43 @@ TEST(MLValueToTensorProtoTests, DoubleToInt64Data) {
   }
 }
 
+TEST(TryWrapRawDataTests, AliasesRawData) {
+  std::vector<int64_t> dims = {3, 2};
+  std::vector<float> values = {1.f, 2.f, 3.f, 4.f, 5.f, 6.f};
+
+  onnx::TensorProto tp;
+  for (auto dim : dims) {
+    tp.add_dims(dim);
+  }
+  tp.set_data_type(onnx::TensorProto_DataType_FLOAT);
+  tp.set_raw_data(values.data(), values.size() * sizeof(float));
+
+  Ort::AllocatorWithDefaultOptions allocator;
+  Ort::Value ml_value{nullptr};
+  ASSERT_TRUE(onnxruntime::server::TryWrapRawData(tp, *allocator.GetInfo(), ml_value));
+
+  // The value reads the request bytes in place.
+  EXPECT_EQ(ml_value.GetTensorMutableData<float>(), reinterpret_cast<const float*>(tp.raw_data().data()));
+  EXPECT_EQ(ml_value.GetTensorTypeAndShapeInfo().GetShape(), dims);
+}
+
+TEST(TryWrapRawDataTests, FallsBackWithoutRawData) {
+  onnx::TensorProto tp;
+  tp.add_dims(2);
+  tp.set_data_type(onnx::TensorProto_DataType_FLOAT);
+  tp.add_float_data(1.f);
+  tp.add_float_data(2.f);
+
+  Ort::AllocatorWithDefaultOptions allocator;
+  Ort::Value ml_value{nullptr};
+  EXPECT_FALSE(onnxruntime::server::TryWrapRawData(tp, *allocator.GetInfo(), ml_value));
+
+  // raw_data that doesn't match the dims is left to the copying path to report.
+  tp.clear_float_data();
+  tp.set_raw_data(std::string(3, '\0'));
+  EXPECT_FALSE(onnxruntime::server::TryWrapRawData(tp, *allocator.GetInfo(), ml_value));
+}
+
 void CreateMLValueBool(AllocatorPtr alloc, const std::vector<int64_t>& dims, const bool* value, Ort::Value& p_value) {
   TensorShape shape(dims);
   OrtValue* p_mlvalue = new OrtValue{};
@@ -43,6 +43,45 @@ TEST(ConfigParsingTests, Defaults) {
   EXPECT_EQ(config.http_port, 8001);
   EXPECT_EQ(config.num_http_threads, 3);
   EXPECT_EQ(config.logging_level, ORT_LOGGING_LEVEL_INFO);
+  EXPECT_EQ(config.max_batch_size, 0);
+}
+
+TEST(ConfigParsingTests, Batching) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--max_batch_size"), const_cast<char*>("32"),
+      const_cast<char*>("--max_batch_delay_us"), const_cast<char*>("500"),
+      const_cast<char*>("--max_concurrent_batches"), const_cast<char*>("2")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(9, test_argv);
+  EXPECT_EQ(res, Result::ContinueSuccess);
+  EXPECT_EQ(config.max_batch_size, 32);
+  EXPECT_EQ(config.max_batch_delay_us, 500);
+  EXPECT_EQ(config.max_concurrent_batches, 2);
+}
+
+TEST(ConfigParsingTests, ZeroConcurrentBatches) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--max_concurrent_batches"), const_cast<char*>("0")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
+}
+
+TEST(ConfigParsingTests, NegativeBatchSize) {
+  char* test_argv[] = {
+      const_cast<char*>("/path/to/binary"),
+      const_cast<char*>("--model_path"), const_cast<char*>("testdata/mul_1.onnx"),
+      const_cast<char*>("--max_batch_size"), const_cast<char*>("-1")};
+
+  onnxruntime::server::ServerConfiguration config{};
+  Result res = config.ParseInput(5, test_argv);
+  EXPECT_EQ(res, Result::ExitFailure);
 }
 
 TEST(ConfigParsingTests, Help) {
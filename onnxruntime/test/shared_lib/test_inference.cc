@@ -9,6 +9,8 @@
 #include <iostream>
 #include <fstream>
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <gtest/gtest.h>
 #include "test_allocator.h"
 #include "test_fixture.h"
@@ -175,6 +177,187 @@ TEST_F(CApiTest, dim_param) {
   ASSERT_EQ(strcmp(dim_param, ""), 0);
 }
 
+TEST(CApiTestGlobalThreadPool, sessions_share_global_thread_pools) {
+  Ort::ThreadingOptions tp_options;
+  tp_options.SetGlobalIntraOpNumThreads(2);
+  Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "GlobalThreadPools", tp_options);
+
+  std::vector<Input> inputs(1);
+  Input& input = inputs.back();
+  input.name = "X";
+  input.dims = {3, 2};
+  input.values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<int64_t> expected_dims_y = {3, 2};
+  std::vector<float> expected_values_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  Ort::SessionOptions session_options;
+  session_options.DisablePerSessionThreads();
+  session_options.SetIntraOpNumThreads(1);
+
+  // several sessions on the same global pools, including one using the parallel executor
+  Ort::Session session_1(env, MODEL_URI, session_options);
+  Ort::Session session_2(env, MODEL_URI, session_options);
+  session_options.SetExecutionMode(ORT_PARALLEL);
+  Ort::Session session_3(env, MODEL_URI, session_options);
+
+  auto default_allocator = onnxruntime::make_unique<MockedOrtAllocator>();
+  for (Ort::Session* session : {&session_1, &session_2, &session_3}) {
+    RunSession(default_allocator.get(), *session, inputs, "Y", expected_dims_y, expected_values_y, nullptr);
+  }
+}
+
+struct AsyncRunResult {
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool done = false;
+  OrtErrorCode error_code = ORT_OK;
+  std::vector<float> values;
+};
+
+static void ORT_API_CALL OnAsyncRunCompleted(void* user_data, OrtValue** outputs, size_t num_outputs,
+                                             OrtStatus* status) {
+  auto& result = *static_cast<AsyncRunResult*>(user_data);
+  std::lock_guard<std::mutex> lock(result.mutex);
+  if (status != nullptr) {
+    result.error_code = g_ort->GetErrorCode(status);
+  } else if (num_outputs == 1) {
+    float* data = nullptr;
+    Ort::ThrowOnError(g_ort->GetTensorMutableData(outputs[0], reinterpret_cast<void**>(&data)));
+    result.values.assign(data, data + 6);
+  }
+  result.done = true;
+  result.cv.notify_all();
+}
+
+static void WaitForAsyncRun(AsyncRunResult& result) {
+  std::unique_lock<std::mutex> lock(result.mutex);
+  result.cv.wait(lock, [&result] { return result.done; });
+}
+
+TEST_F(CApiTest, run_async) {
+  std::vector<int64_t> dims = {3, 2};
+  std::vector<float> x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<float> expected_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  Ort::Session session(env_, MODEL_URI, Ort::SessionOptions{});
+  auto memory_info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+  Ort::Value input = Ort::Value::CreateTensor<float>(memory_info, x.data(), x.size(), dims.data(), dims.size());
+  const char* input_name = "X";
+  const char* output_name = "Y";
+
+  // several runs in flight, each with its own output array
+  constexpr size_t num_runs = 4;
+  std::vector<Ort::Value> outputs;
+  for (size_t i = 0; i < num_runs; ++i)
+    outputs.emplace_back(nullptr);
+  std::vector<AsyncRunResult> results(num_runs);
+  for (size_t i = 0; i < num_runs; ++i) {
+    session.RunAsync(Ort::RunOptions{nullptr}, &input_name, &input, 1, &output_name, &outputs[i], 1,
+                     OnAsyncRunCompleted, &results[i]);
+  }
+
+  for (size_t i = 0; i < num_runs; ++i) {
+    WaitForAsyncRun(results[i]);
+    ASSERT_EQ(results[i].error_code, ORT_OK);
+    ASSERT_EQ(results[i].values, expected_y);
+  }
+
+  // a failing run reports its error through the callback
+  std::vector<int32_t> bad_x(x.size(), 1);
+  Ort::Value bad_input = Ort::Value::CreateTensor<int32_t>(memory_info, bad_x.data(), bad_x.size(), dims.data(),
+                                                           dims.size());
+  Ort::Value bad_output{nullptr};
+  AsyncRunResult bad_result;
+  session.RunAsync(Ort::RunOptions{nullptr}, &input_name, &bad_input, 1, &output_name, &bad_output, 1,
+                   OnAsyncRunCompleted, &bad_result);
+  WaitForAsyncRun(bad_result);
+  ASSERT_NE(bad_result.error_code, ORT_OK);
+}
+
+// runs queued on a parallel session with the global thread pools don't take the pool workers their nodes run on
+TEST(CApiTestGlobalThreadPool, run_async_parallel) {
+  Ort::ThreadingOptions tp_options;
+  tp_options.SetGlobalIntraOpNumThreads(2);
+  Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "GlobalThreadPoolsRunAsync", tp_options);
+
+  Ort::SessionOptions session_options;
+  session_options.DisablePerSessionThreads();
+  session_options.SetExecutionMode(ORT_PARALLEL);
+  Ort::Session session(env, MODEL_URI, session_options);
+
+  std::vector<int64_t> dims = {3, 2};
+  std::vector<float> x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  auto memory_info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+  Ort::Value input = Ort::Value::CreateTensor<float>(memory_info, x.data(), x.size(), dims.data(), dims.size());
+  const char* input_name = "X";
+  const char* output_name = "Y";
+
+  // more runs in flight than the global pool has workers
+  constexpr size_t num_runs = 8;
+  std::vector<Ort::Value> outputs;
+  for (size_t i = 0; i < num_runs; ++i)
+    outputs.emplace_back(nullptr);
+  std::vector<AsyncRunResult> results(num_runs);
+  for (size_t i = 0; i < num_runs; ++i) {
+    session.RunAsync(Ort::RunOptions{nullptr}, &input_name, &input, 1, &output_name, &outputs[i], 1,
+                     OnAsyncRunCompleted, &results[i]);
+  }
+
+  for (size_t i = 0; i < num_runs; ++i) {
+    WaitForAsyncRun(results[i]);
+    ASSERT_EQ(results[i].error_code, ORT_OK);
+    ASSERT_EQ(results[i].values, std::vector<float>({1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f}));
+  }
+}
+
+TEST_F(CApiTest, io_binding) {
+  std::vector<int64_t> dims = {3, 2};
+  std::vector<float> x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<float> y(6, 0.0f);
+
+  Ort::Session session(env_, MODEL_URI, Ort::SessionOptions{});
+  auto memory_info = Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeCPU);
+  Ort::Value input = Ort::Value::CreateTensor<float>(memory_info, x.data(), x.size(), dims.data(), dims.size());
+  Ort::Value output = Ort::Value::CreateTensor<float>(memory_info, y.data(), y.size(), dims.data(), dims.size());
+
+  Ort::IoBinding binding(session);
+  binding.BindInput("X", input);
+  binding.BindOutput("Y", output);
+
+  // runs read the bound input and write into the bound output in place
+  session.Run(Ort::RunOptions{nullptr}, binding);
+  ASSERT_EQ(y, std::vector<float>({1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f}));
+
+  x[0] = 7.0f;
+  session.Run(Ort::RunOptions{nullptr}, binding);
+  ASSERT_EQ(y[0], 49.0f);
+
+  // an output bound by name is allocated by the first run and reused by later ones
+  binding.ClearBoundOutputs();
+  binding.BindOutput("Y");
+  ASSERT_EQ(binding.GetOutputCount(), 1u);
+  session.Run(Ort::RunOptions{nullptr}, binding);
+  Ort::Value allocated = binding.GetOutputValue(0);
+  float* allocated_data = allocated.GetTensorMutableData<float>();
+  ASSERT_EQ(allocated_data[0], 49.0f);
+
+  x[0] = 2.0f;
+  session.Run(Ort::RunOptions{nullptr}, binding);
+  ASSERT_EQ(binding.GetOutputValue(0).GetTensorMutableData<float>(), allocated_data);
+  ASSERT_EQ(allocated_data[0], 4.0f);
+}
+
+TEST_F(CApiTest, disable_per_session_threads_requires_global_thread_pools) {
+  Ort::SessionOptions session_options;
+  session_options.DisablePerSessionThreads();
+  try {
+    Ort::Session session(env_, MODEL_URI, session_options);
+    FAIL() << "Creating a session without per session threads should fail without global thread pools";
+  } catch (const Ort::Exception& e) {
+    ASSERT_EQ(e.GetOrtErrorCode(), ORT_INVALID_ARGUMENT);
+  }
+}
+
 INSTANTIATE_TEST_CASE_P(CApiTestWithProviders,
                         CApiTestWithProvider,
                         ::testing::Values(0, 1, 2, 3, 4));